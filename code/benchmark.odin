@@ -0,0 +1,34 @@
+// Timer shared by the code/*_benchmark.odin programs
+//
+// `now` reads a monotonic clock in nanoseconds and `report` prints the time per
+// operation of a phase. Build the benchmarks optimized to get meaningful numbers.
+
+import (
+	"fmt.odin";
+	win32 "sys/windows.odin" when ODIN_OS == "windows";
+)
+
+foreign_system_library libc "c" when ODIN_OS != "windows";
+
+proc now() -> f64 {
+	when ODIN_OS == "windows" {
+		var counter: i64;
+		win32.query_performance_counter(&counter);
+		return f64(counter) * 1e9 / f64(win32.get_query_performance_frequency());
+	} else {
+		type Timespec struct #ordered {
+			seconds:     i64,
+			nanoseconds: i64,
+		}
+		foreign libc proc clock_gettime(clock_id: i32, ts: ^Timespec) -> i32 #link_name "clock_gettime";
+
+		const CLOCK_MONOTONIC = 1;
+		var ts: Timespec;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return f64(ts.seconds)*1e9 + f64(ts.nanoseconds);
+	}
+}
+
+proc report(name: string, start, end: f64, ops: int) {
+	fmt.printf("%s: %.2f ns/op\n", name, (end-start) / f64(ops));
+}
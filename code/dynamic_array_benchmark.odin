@@ -0,0 +1,89 @@
+// Temporary buffer benchmark
+//
+// Calls procedures which fill a small dynamic array or slice, read it back and
+// free it, the way a per-request scratch buffer is used. The arrays do not
+// outlive the call, so their buffers can live on the stack. One variant outgrows
+// its capacity every call and has to fall back to the heap. Prints the
+// nanoseconds per call.
+//
+//     odin build code/dynamic_array_benchmark.odin -opt=2
+
+import (
+	"fmt.odin";
+	"benchmark.odin";
+)
+
+const (
+	N      = 1<<22;
+	ROUNDS = 3;
+)
+
+// Collects the decimal digits of `x` and folds them back in reverse
+proc digits(x: int) -> int {
+	var buf = make([dynamic]u8, 0, 32);
+	defer free(buf);
+	for x > 0 {
+		append(&buf, u8(x % 10));
+		x /= 10;
+	}
+	var r = 0;
+	for d in buf {
+		r = r*10 + int(d);
+	}
+	return r;
+}
+
+// Same as `digits` but the capacity is too small for most numbers
+proc digits_grow(x: int) -> int {
+	var buf = make([dynamic]u8, 0, 4);
+	defer free(buf);
+	for x > 0 {
+		append(&buf, u8(x % 10));
+		x /= 10;
+	}
+	var r = 0;
+	for d in buf {
+		r = r*10 + int(d);
+	}
+	return r;
+}
+
+// A fixed-size histogram of the bytes of `x`
+proc histogram(x: int) -> int {
+	var counts = make([]int, 16);
+	defer free(counts);
+	for i in 0..<8 {
+		counts[(x >> uint(i*4)) & 15]++;
+	}
+	var r = 0;
+	for c, i in counts {
+		r += c*i;
+	}
+	return r;
+}
+
+proc main() {
+	var sink = 0;
+	for round in 0..<ROUNDS {
+		var t0 = benchmark.now();
+		for i in 0..<N {
+			sink += digits(i*7919 + 1000000);
+		}
+		var t1 = benchmark.now();
+		for i in 0..<N {
+			sink += digits_grow(i*7919 + 1000000);
+		}
+		var t2 = benchmark.now();
+		for i in 0..<N {
+			sink += histogram(i*0x9e3779b1);
+		}
+		var t3 = benchmark.now();
+
+		if round == ROUNDS-1 {
+			benchmark.report("dynamic array", t0, t1, N);
+			benchmark.report("dynamic array (grows)", t1, t2, N);
+			benchmark.report("slice", t2, t3, N);
+		}
+	}
+	if sink == 0 -> fmt.println("unexpected sink");
+}
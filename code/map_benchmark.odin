@@ -0,0 +1,108 @@
+// Runtime map throughput benchmark
+//
+// Inserts N keys into a map, then looks every one of them up (hits) and looks up
+// as many keys that are not in the map (misses), for integer keys and for string
+// keys of a few lengths. Prints the nanoseconds per operation for each phase.
+//
+//     odin build code/map_benchmark.odin -opt=2
+
+import (
+	"fmt.odin";
+	"benchmark.odin";
+)
+
+const (
+	N      = 1<<20;
+	ROUNDS = 3;
+)
+
+// Keys are spread with a multiplicative step so that neighbouring keys do not
+// land in neighbouring slots.
+proc int_key(i: int) -> int { return i * 0x9e3779b1; }
+
+proc bench_int_keys() {
+	var sink = 0;
+	for round in 0..<ROUNDS {
+		var m: map[int]int;
+		defer free(m);
+
+		var t0 = benchmark.now();
+		for i in 0..<N {
+			m[int_key(i)] = i;
+		}
+		var t1 = benchmark.now();
+		for i in 0..<N {
+			sink += m[int_key(i)];
+		}
+		var t2 = benchmark.now();
+		for i in N..<2*N {
+			var _, ok = m[int_key(i)];
+			if ok -> sink++;
+		}
+		var t3 = benchmark.now();
+
+		if round == ROUNDS-1 {
+			benchmark.report("int insert", t0, t1, N);
+			benchmark.report("int lookup (hit)", t1, t2, N);
+			benchmark.report("int lookup (miss)", t2, t3, N);
+		}
+	}
+	if sink == 0 -> fmt.println("unexpected sink");
+}
+
+proc bench_string_keys(key_len: int) {
+	const COUNT = N/4;
+
+	// Build the keys up front so that formatting them is not part of the timings
+	var keys = make([]string, 2*COUNT);
+	defer {
+		for k in keys -> free(k);
+		free(keys);
+	}
+	for _, i in keys {
+		var buf = make([]u8, key_len);
+		var x = u64(i) * 0x9e3779b97f4a7c15;
+		for _, j in buf {
+			buf[j] = 'a' + u8(x % 26);
+			x = x/26 + u64(j)*0x2545f491;
+		}
+		// Make every key unique regardless of its length
+		fmt.bprintf(buf[0..<min(16, key_len)], "%x", i);
+		keys[i] = string(buf);
+	}
+
+	var sink = 0;
+	for round in 0..<ROUNDS {
+		var m: map[string]int;
+		defer free(m);
+
+		var t0 = benchmark.now();
+		for i in 0..<COUNT {
+			m[keys[i]] = i;
+		}
+		var t1 = benchmark.now();
+		for i in 0..<COUNT {
+			sink += m[keys[i]];
+		}
+		var t2 = benchmark.now();
+		for i in COUNT..<2*COUNT {
+			var _, ok = m[keys[i]];
+			if ok -> sink++;
+		}
+		var t3 = benchmark.now();
+
+		if round == ROUNDS-1 {
+			benchmark.report(fmt.aprintf("string[%d] insert", key_len), t0, t1, COUNT);
+			benchmark.report(fmt.aprintf("string[%d] lookup (hit)", key_len), t1, t2, COUNT);
+			benchmark.report(fmt.aprintf("string[%d] lookup (miss)", key_len), t2, t3, COUNT);
+		}
+	}
+	if sink == 0 -> fmt.println("unexpected sink");
+}
+
+proc main() {
+	bench_int_keys();
+	bench_string_keys(8);
+	bench_string_keys(16);
+	bench_string_keys(64);
+}
@@ -0,0 +1,152 @@
+// `match` statement dispatch benchmark
+//
+// Classifies a stream of words with a string-keyed `match` over a set of
+// keywords, the way a tokenizer or a request router would, and runs a stream
+// of opcodes through an integer `match`, the way a bytecode interpreter
+// would. Prints the nanoseconds per dispatch.
+//
+//     odin build code/match_benchmark.odin -opt=2
+
+import (
+	"fmt.odin";
+	"benchmark.odin";
+)
+
+const (
+	N      = 1<<22;
+	ROUNDS = 3;
+)
+
+proc keyword(s: string) -> int {
+	match s {
+	case "break":       return 1;
+	case "case":        return 2;
+	case "const":       return 3;
+	case "continue":    return 4;
+	case "defer":       return 5;
+	case "else":        return 6;
+	case "enum":        return 7;
+	case "fallthrough": return 8;
+	case "for":         return 9;
+	case "foreign":     return 10;
+	case "if":          return 11;
+	case "import":      return 12;
+	case "in":          return 13;
+	case "map":         return 14;
+	case "match":       return 15;
+	case "proc":        return 16;
+	case "return":      return 17;
+	case "struct":      return 18;
+	case "type":        return 19;
+	case "union":       return 20;
+	case "var":         return 21;
+	case "when":        return 22;
+	}
+	return 0;
+}
+
+proc step(op: u8, acc, i: int) -> int {
+	match op {
+	case  0: return acc + 1;
+	case  1: return acc - 3;
+	case  2: return acc * 3;
+	case  3: return acc ~ 0x55;
+	case  4: return acc << 1;
+	case  5: return acc >> 1;
+	case  6: return acc | 0x100;
+	case  7: return acc & 0xffff;
+	case  8: return acc + i;
+	case  9: return acc - i;
+	case 10: return acc * 7;
+	case 11: return acc ~ i;
+	case 12: return acc + 17;
+	case 13: return acc - 29;
+	case 14: return acc * 5;
+	case 15: return acc ~ 0x3c3c;
+	case 16: return acc + 1;
+	case 17: return acc - 3;
+	case 18: return acc * 3;
+	case 19: return acc ~ 0x55;
+	case 20: return acc << 1;
+	case 21: return acc >> 1;
+	case 22: return acc | 0x100;
+	case 23: return acc & 0xffff;
+	case 24: return acc + i;
+	case 25: return acc - i;
+	case 26: return acc * 7;
+	case 27: return acc ~ i;
+	case 28: return acc + 17;
+	case 29: return acc - 29;
+	case 30: return acc * 5;
+	case 31: return acc ~ 0x3c3c;
+	case 32: return acc + 1;
+	case 33: return acc - 3;
+	case 34: return acc * 3;
+	case 35: return acc ~ 0x55;
+	case 36: return acc << 1;
+	case 37: return acc >> 1;
+	case 38: return acc | 0x100;
+	case 39: return acc & 0xffff;
+	case 40: return acc + i;
+	case 41: return acc - i;
+	case 42: return acc * 7;
+	case 43: return acc ~ i;
+	case 44: return acc + 17;
+	case 45: return acc - 29;
+	case 46: return acc * 5;
+	case 47: return acc ~ 0x3c3c;
+	}
+	return acc;
+}
+
+proc main() {
+	// Half keywords, half identifiers, some of which share a length or a prefix with a keyword
+	var words = []string{
+		"var", "x", "proc", "main", "return", "result", "for", "format", "match", "matches",
+		"when", "where", "struct", "strings", "if", "it", "import", "imports", "case", "cast",
+		"union", "unit", "fallthrough", "fall_through", "type", "typo", "const", "count",
+	};
+	// Copy the words so that the compares cannot take the same-pointer shortcut
+	for _, i in words {
+		words[i] = fmt.aprintf("%s", words[i]);
+	}
+
+	var sink = 0;
+	for round in 0..<ROUNDS {
+		var t0 = benchmark.now();
+		for i in 0..<N {
+			sink += keyword(words[i % len(words)]);
+		}
+		var t1 = benchmark.now();
+
+		if round == ROUNDS-1 {
+			benchmark.report("string match", t0, t1, N);
+		}
+	}
+
+	// A pseudo-random opcode stream so that the branch predictor cannot learn it
+	var ops = make([]u8, 4096);
+	defer free(ops);
+	var x: u32 = 0x12345678;
+	for _, i in ops {
+		x ~= x << 13;
+		x ~= x >> 17;
+		x ~= x << 5;
+		ops[i] = u8(x % 48);
+	}
+
+	for round in 0..<ROUNDS {
+		var acc = 0;
+		var t0 = benchmark.now();
+		for i in 0..<N {
+			acc = step(ops[i & 4095], acc, i);
+		}
+		var t1 = benchmark.now();
+		sink += acc;
+
+		if round == ROUNDS-1 {
+			benchmark.report("integer match", t0, t1, N);
+		}
+	}
+	if sink == 0 -> fmt.println("unexpected sink");
+}
@@ -0,0 +1,93 @@
+// `match` statement dispatch test
+//
+// Runs string and integer `match` statements whose cases repeat a value, within
+// a clause, across clauses or through overlapping ranges, and checks that the
+// first clause in source order wins, as it does when the cases are compared one
+// by one. Prints each failing check and a summary, and exits with 1 if any
+// failed.
+//
+//     odin run code/match_test.odin
+
+import (
+	"fmt.odin";
+	"testing.odin";
+)
+
+proc empty_twice(s: string) -> int {
+	match s {
+	case "":  return 1;
+	case "":  return 2;
+	case "a": return 3;
+	}
+	return 0;
+}
+
+// Fewer cases of each length than it takes to switch on the hash
+proc few(s: string) -> int {
+	match s {
+	case "ab", "cd": return 1;
+	case "cd":       return 2;
+	case "ab", "ab": return 3;
+	case "xyz":      return 4;
+	}
+	return 0;
+}
+
+// Enough cases of one length to switch on the hash
+proc many(s: string) -> int {
+	match s {
+	case "case":        return 1;
+	case "else", "enum": return 2;
+	case "case":        return 3;
+	case "proc":        return 4;
+	case "enum":        return 5;
+	case "type", "else": return 6;
+	case "when":        return 7;
+	case "type":        return 8;
+	}
+	return 0;
+}
+
+// Repeated integers are an error but overlapping ranges are not
+proc integers(x: int) -> int {
+	match x {
+	case 1, 2:  return 1;
+	case 0..<4: return 3;
+	case 7:     return 4;
+	case 5..7:  return 5;
+	case 2..6:  return 6;
+	}
+	return 0;
+}
+
+proc main() {
+	// Copy the strings so that the compares cannot take the same-pointer shortcut
+	proc copy(s: string) -> string { return fmt.aprintf("%s", s); }
+
+	testing.expect_int(`empty_twice("")`,  empty_twice(copy("")),  1);
+	testing.expect_int(`empty_twice("a")`, empty_twice(copy("a")), 3);
+	testing.expect_int(`empty_twice("b")`, empty_twice(copy("b")), 0);
+
+	testing.expect_int(`few("ab")`,  few(copy("ab")),  1);
+	testing.expect_int(`few("cd")`,  few(copy("cd")),  1);
+	testing.expect_int(`few("xyz")`, few(copy("xyz")), 4);
+	testing.expect_int(`few("ef")`,  few(copy("ef")),  0);
+
+	testing.expect_int(`many("case")`, many(copy("case")), 1);
+	testing.expect_int(`many("else")`, many(copy("else")), 2);
+	testing.expect_int(`many("enum")`, many(copy("enum")), 2);
+	testing.expect_int(`many("proc")`, many(copy("proc")), 4);
+	testing.expect_int(`many("type")`, many(copy("type")), 6);
+	testing.expect_int(`many("when")`, many(copy("when")), 7);
+	testing.expect_int(`many("cast")`, many(copy("cast")), 0);
+
+	testing.expect_int("integers(2)", integers(2), 1);
+	testing.expect_int("integers(0)", integers(0), 3);
+	testing.expect_int("integers(3)", integers(3), 3);
+	testing.expect_int("integers(7)", integers(7), 4);
+	testing.expect_int("integers(6)", integers(6), 5);
+	testing.expect_int("integers(4)", integers(4), 6);
+	testing.expect_int("integers(8)", integers(8), 0);
+
+	testing.report("match");
+}
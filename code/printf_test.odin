@@ -0,0 +1,52 @@
+// `#printf` specialisation test
+//
+// Formats each set of arguments twice with `bprintf`, once with a constant format
+// string, which the compiler lowers to typed writes, and once with the same format
+// in a variable, which goes through the `any` based formatting at run time. Each
+// pair of strings must be identical. Prints each pair that differs and a summary,
+// and exits with 1 if any differed.
+//
+//     odin run code/printf_test.odin
+
+import (
+	"fmt.odin";
+	"testing.odin";
+)
+
+proc main() {
+	var p: ^int;
+	var xs = []int{1, 2, 3};
+	var f: string;
+	var a, b: [256]u8;
+
+	f = "nil: %v|";
+	testing.expect_string("nil", fmt.bprintf(a[..], "nil: %v|", nil), fmt.bprintf(b[..], f, nil));
+
+	f = "nil and pointer: %v %v %T|";
+	testing.expect_string("nil and pointer", fmt.bprintf(a[..], "nil and pointer: %v %v %T|", nil, p, nil),
+	                                         fmt.bprintf(b[..], f, nil, p, nil));
+
+	f = "padded nil: [%8v] [%-8v]";
+	testing.expect_string("padded nil", fmt.bprintf(a[..], "padded nil: [%8v] [%-8v]", nil, nil),
+	                                    fmt.bprintf(b[..], f, nil, nil));
+
+	f = "basic: %d %x %5.2f %s %t %c";
+	testing.expect_string("basic", fmt.bprintf(a[..], "basic: %d %x %5.2f %s %t %c", -42, 255, 3.14159, "str", true, 'x'),
+	                               fmt.bprintf(b[..], f, -42, 255, 3.14159, "str", true, 'x'));
+
+	f = "untyped: %v %v %v";
+	testing.expect_string("untyped", fmt.bprintf(a[..], "untyped: %v %v %v", 1<<40, 2.5, "s"),
+	                                 fmt.bprintf(b[..], f, 1<<40, 2.5, "s"));
+
+	f = "composite: %v %T";
+	testing.expect_string("composite", fmt.bprintf(a[..], "composite: %v %T", xs, xs),
+	                                   fmt.bprintf(b[..], f, xs, xs));
+
+	// Longer than the buffer, so both must stop at the same byte
+	var small: [4]u8;
+	f = "truncated: %d";
+	testing.expect_string("truncated", fmt.bprintf(small[..], "truncated: %d", 12345),
+	                                   fmt.bprintf(b[0..<4], f, 12345));
+
+	testing.report("printf");
+}
@@ -0,0 +1,147 @@
+// Custom backend test
+//
+// Runs compound literals, `for ... in` ranges and `match` statements through the
+// custom SSA backend and checks each result. It writes through `os` directly, as
+// the backend does not build `fmt` yet. Prints each failing check and a summary,
+// and exits with 1 if any failed.
+//
+//     odin run code/ssa_test.odin -backend=ssa
+
+import "os.odin";
+
+var failures = 0;
+
+proc print(s: string) {
+	if len(s) > 0 {
+		os._unix_write(os.stdout, &s[0], len(s));
+	}
+}
+
+proc expect(name: string, got, want: int) {
+	if got != want {
+		print("FAIL ");
+		print(name);
+		print("\n");
+		failures++;
+	}
+}
+
+type Vec struct { x, y: i32, z: f64 }
+type Pair struct { a: Vec, n: int }
+
+var global_table = [3]i16{4, 5, 6};
+var global_vec   = Vec{1, 2, 0.25};
+
+proc struct_lit(a: i32) -> int {
+	var v = Vec{a, a*2, 1.5};
+	var w = Vec{z = 2.0, x = a};
+	var p = Pair{a = v, n = 3};
+	return int(v.x + v.y + w.x + w.y) + int(v.z + w.z) + p.n + int(p.a.y);
+}
+
+proc const_lit(i: int) -> int {
+	var t = [5]int{1, 1, 2, 3, 5};
+	var o = Vec{x = 7, z = 0.5};
+	return t[i] + int(o.x) + int(o.y) + int(o.z*10) + int(global_table[2]) + int(global_vec.y);
+}
+
+proc slice_lit(n: int) -> int {
+	var xs = []int{n, 10, 20, 30};
+	var s = 0;
+	for x, i in xs {
+		s += x*(i+1);
+	}
+	return s + len(xs);
+}
+
+proc array_range(n: int) -> int {
+	var xs = [4]int{n, n+1, n+2};
+	var s = 0;
+	for x in xs {
+		s += x;
+	}
+	for _, i in xs {
+		s += 100*i;
+	}
+	return s;
+}
+
+proc interval(n: int) -> int {
+	var s = 0;
+	for i in 0..<n {
+		if i == 3 { continue; }
+		if i == 8 { break; }
+		s += i;
+	}
+	for r in 'a'..'e' {
+		s += int(r);
+	}
+	return s;
+}
+
+proc classify(x: int) -> int {
+	match x {
+	case 0:     return 10;
+	case 1, 2:  return 20;
+	case 3..<5: return 30;
+	case 5..9:  return 40;
+	case 10:    fallthrough;
+	case 11:    return 50;
+	case:       return -1;
+	}
+	return 0;
+}
+
+proc classify_no_tag(x: int) -> int {
+	var r = 0;
+	match {
+	case x < 0:  r = 1;
+	case x == 0: r = 2;
+	case:        r = 3;
+	}
+	match var y = x*2; y {
+	case 4: r += 100;
+	}
+	return r;
+}
+
+proc match_in_loop() -> int {
+	var r = 0;
+	for i in 0..<4 {
+		match i {
+		case 1: continue;
+		case 2: r += 10;
+		}
+		r += 1;
+	}
+	return r;
+}
+
+proc main() {
+	expect("struct_lit",  struct_lit(3), 24);
+	expect("const_lit",   const_lit(4),  25);
+	expect("slice_lit",   slice_lit(2),  206);
+	expect("array_range", array_range(5), 618);
+	expect("interval",    interval(10),  520);
+	expect("interval(0)", interval(0),   495);
+
+	expect("classify(-1)", classify(-1), -1);
+	expect("classify(0)",  classify(0),  10);
+	expect("classify(2)",  classify(2),  20);
+	expect("classify(4)",  classify(4),  30);
+	expect("classify(9)",  classify(9),  40);
+	expect("classify(10)", classify(10), 50);
+	expect("classify(12)", classify(12), -1);
+
+	expect("classify_no_tag(-5)", classify_no_tag(-5), 1);
+	expect("classify_no_tag(0)",  classify_no_tag(0),  2);
+	expect("classify_no_tag(2)",  classify_no_tag(2),  103);
+	expect("match_in_loop",       match_in_loop(),     13);
+
+	if failures == 0 {
+		print("all ssa tests passed\n");
+	} else {
+		print("some ssa tests failed\n");
+		os.exit(1);
+	}
+}
@@ -0,0 +1,34 @@
+// Checks shared by the code/*_test.odin programs
+//
+// Each failing check prints its name, what it got and what it wanted. `report`
+// prints a summary and exits with 1 if any check failed.
+
+import (
+	"fmt.odin";
+	"os.odin";
+)
+
+var failures = 0;
+
+proc expect_int(name: string, got, want: int) {
+	if got != want {
+		fmt.printf("FAIL %s: got %d, want %d\n", name, got, want);
+		failures++;
+	}
+}
+
+proc expect_string(name: string, got, want: string) {
+	if got != want {
+		fmt.printf("FAIL %s: got \"%s\", want \"%s\"\n", name, got, want);
+		failures++;
+	}
+}
+
+proc report(name: string) {
+	if failures == 0 {
+		fmt.printf("all %s tests passed\n", name);
+	} else {
+		fmt.printf("%d %s tests failed\n", failures, name);
+		os.exit(1);
+	}
+}
@@ -353,20 +353,24 @@ proc panic(message = "", using location = #caller_location) #cc_contextless {
 
 
 proc __string_eq(a, b: string) -> bool #cc_contextless {
-	if len(a) != len(b) {
+	var n = len(a);
+	if n != len(b) {
 		return false;
 	}
-	if len(a) == 0 {
-		return true;
-	}
-	if &a[0] == &b[0] {
-		return true;
-	}
-	return __string_cmp(a, b) == 0;
+	var pa, pb = ^raw.String(&a).data, ^raw.String(&b).data;
+	return n == 0 || pa == pb || __mem_equal(pa, pb, n);
 }
 
 proc __string_cmp(a, b: string) -> int #cc_contextless {
-	return __mem_compare(&a[0], &b[0], min(len(a), len(b)));
+	var pa, pb = ^raw.String(&a).data, ^raw.String(&b).data;
+	var res = __mem_compare(pa, pb, min(len(a), len(b)));
+	if res == 0 {
+		match {
+		case len(a) < len(b): return -1;
+		case len(a) > len(b): return +1;
+		}
+	}
+	return res;
 }
 
 proc __string_ne(a, b: string) -> bool #cc_contextless #inline { return !__string_eq(a, b); }
@@ -461,18 +465,34 @@ proc __mem_copy_non_overlapping(dst, src: rawptr, len: int) -> rawptr #cc_contex
 	}
 }
 
+// NOTE: `memcmp` comes from the C runtime, which is also the default library of the Windows link.
+// LLVM knows its semantics, so it expands compares of a small constant length into word-wise loads
+// and turns the ones whose result is only tested against zero into `bcmp`.
+foreign_system_library (
+	__libc "libcmt.lib" when ODIN_OS == "windows";
+	__libc "c"          when ODIN_OS != "windows";
+)
+
+foreign __libc {
+	proc __libc_memcmp(a, b: rawptr, n: int) -> i32 #link_name "memcmp";
+}
+
 proc __mem_compare(a, b: ^u8, n: int) -> int #cc_contextless {
-	for i in 0..<n {
-		match {
-		case (a+i)^ < (b+i)^:
-			return -1;
-		case (a+i)^ > (b+i)^:
-			return +1;
-		}
+	if n <= 0 {
+		return 0;
+	}
+	var res = __libc_memcmp(a, b, n);
+	match {
+	case res < 0: return -1;
+	case res > 0: return +1;
 	}
 	return 0;
 }
 
+proc __mem_equal(a, b: rawptr, n: int) -> bool #cc_contextless #inline {
+	return n <= 0 || __libc_memcmp(a, b, n) == 0;
+}
+
 foreign __llvm_core {
 	proc __sqrt_f32(x: f32) -> f32 #link_name "llvm.sqrt.f32";
 	proc __sqrt_f64(x: f64) -> f64 #link_name "llvm.sqrt.f64";
@@ -501,6 +521,49 @@ proc __dynamic_array_make(array_: rawptr, elem_size, elem_align: int, len, cap:
 	}
 }
 
+// NOTE: The compiler places small dynamic arrays which do not escape their procedure in a buffer
+// on the stack. Their allocator hands out the buffer once and moves to the backing allocator when
+// the array outgrows it
+type __StackArrayBuffer struct #ordered {
+	data:    rawptr,
+	backing: Allocator,
+}
+
+proc __stack_array_allocator_proc(allocator_data: rawptr, mode: AllocatorMode,
+                                  size, alignment: int,
+                                  old_memory: rawptr, old_size: int, flags: u64) -> rawptr {
+	var buffer = ^__StackArrayBuffer(allocator_data);
+	var backing = buffer.backing;
+
+	if old_memory != nil && old_memory == buffer.data {
+		match mode {
+		case AllocatorMode.Free:
+			return nil;
+		case AllocatorMode.Resize:
+			var new_memory = backing.procedure(backing.data, AllocatorMode.Alloc, size, alignment, nil, 0, 0);
+			if new_memory != nil {
+				__mem_copy(new_memory, old_memory, min(old_size, size));
+			}
+			return new_memory;
+		}
+	}
+	return backing.procedure(backing.data, mode, size, alignment, old_memory, old_size, flags);
+}
+
+proc __dynamic_array_make_stack(array_: rawptr, elem_size, elem_align: int, len, cap: int,
+                                buffer: ^__StackArrayBuffer, data: rawptr) {
+	var array = ^raw.DynamicArray(array_);
+	buffer.data = data;
+	buffer.backing = context.allocator;
+	assert(buffer.backing.procedure != nil);
+
+	__mem_zero(data, len*elem_size);
+	array.data = data;
+	array.len = len;
+	array.cap = cap;
+	array.allocator = Allocator{__stack_array_allocator_proc, buffer};
+}
+
 proc __dynamic_array_reserve(array_: rawptr, elem_size, elem_align: int, cap: int) -> bool {
 	var array = ^raw.DynamicArray(array_);
 
@@ -596,38 +659,81 @@ proc __slice_append(slice_: rawptr, elem_size, elem_align: int,
 
 // Map stuff
 
-proc __default_hash(data: []u8) -> u128 {
-	proc fnv128a(data: []u8) -> u128 {
-		var h: u128 = 0x6c62272e07bb014262b821756295c58d;
-		for b in data {
-			h = (h ~ u128(b)) * 0x1000000000000000000013b;
+// MurmurHash64A, which reads the data a word at a time. Constant string keys are hashed by the
+// compiler with the same algorithm and seed (see MurmurHash64A in src/murmurhash3.cpp).
+proc __default_hash(data: []u8) -> u64 {
+	const (
+		SEED: u64 = 0x9747b28c;
+		M:    u64 = 0xc6a4a7935bd1e995;
+		R:    u64 = 47;
+	)
+	var (
+		n = len(data);
+		p = ^u8(^raw.Slice(&data).data);
+		h = SEED ~ (u64(n) * M);
+	)
+
+	for n >= 8 {
+		var k: u64;
+		__mem_copy(&k, p, 8);
+
+		k *= M;
+		k ~= k>>R;
+		k *= M;
+
+		h ~= k;
+		h *= M;
+
+		p += 8;
+		n -= 8;
+	}
+
+	if n > 0 {
+		var k: u64;
+		for i in 0..<n {
+			k |= u64((p+i)^) << u64(8*i);
 		}
-		return h;
+		h ~= k;
+		h *= M;
 	}
-	return fnv128a(data);
+
+	h ~= h>>R;
+	h *= M;
+	h ~= h>>R;
+
+	return h;
 }
-proc __default_hash_string(s: string) -> u128 {
+proc __default_hash_string(s: string) -> u64 {
 	return __default_hash([]u8(s));
 }
 
 const __INITIAL_MAP_CAP = 16;
 
+// A map keeps its entries densely in `entries`, in insertion order, and indexes them with an
+// open-addressing table of `slots` which is linearly probed and has a power of two length.
+// A slot is 0 when empty, otherwise its top byte is a control byte (0x80 | 7 bits of the hash)
+// and the rest is the index of the entry, so a probe only reads the entry when the control
+// byte matches.
+const (
+	__MAP_SLOT_INDEX_MASK: u64 = 1<<56 - 1;
+	__MAP_HASH_MULTIPLIER: u64 = 0x9e3779b97f4a7c15;
+)
+
 type (
 	__MapKey struct #ordered {
-		hash: u128,
-		str:  string,
+		hash: u64,
+		ptr:  rawptr, // Points to the key itself
 	}
 
 	__MapFindResult struct #ordered {
-		hash_index:  int,
-		entry_prev:  int,
+		slot_index:  int,
 		entry_index: int,
 	}
 
 	__MapEntryHeader struct #ordered {
-		key:  __MapKey,
-		next: int,
+		hash: u64,
 	/*
+		key:   Key_Type,
 		value: Value_Type,
 	*/
 	}
@@ -637,57 +743,61 @@ type (
 		is_key_string: bool,
 		entry_size:    int,
 		entry_align:   int,
+		key_offset:    int,
+		key_size:      int,
 		value_offset:  int,
 		value_size:    int,
 	}
 )
 
-proc __dynamic_map_reserve(using header: __MapHeader, cap: int)  {
-	__dynamic_array_reserve(&m.hashes, size_of(int), align_of(int), cap);
-	__dynamic_array_reserve(&m.entries, entry_size, entry_align,    cap);
+proc __dynamic_map_slots(m: ^raw.DynamicMap) -> ^u64 #cc_contextless {
+	return ^u64(^raw.DynamicArray(&m.slots).data);
 }
 
-proc __dynamic_map_rehash(using header: __MapHeader, new_count: int) {
-	var new_header: __MapHeader = header;
-	var nm: raw.DynamicMap;
-	new_header.m = &nm;
-
-	var header_hashes = ^raw.DynamicArray(&header.m.hashes);
-	var nm_hashes = ^raw.DynamicArray(&nm.hashes);
-
-	__dynamic_array_resize(nm_hashes, size_of(int), align_of(int), new_count);
-	__dynamic_array_reserve(&nm.entries, entry_size, entry_align, m.entries.len);
-	for i in 0..<new_count -> nm.hashes[i] = -1;
+proc __dynamic_map_slot_home(hash: u64, mask: int) -> int #cc_contextless {
+	var h = hash * __MAP_HASH_MULTIPLIER;
+	return int((h ~ (h >> 29)) & u64(mask));
+}
 
-	for var i = 0; i < m.entries.len; i++ {
-		if len(nm.hashes) == 0 {
-			__dynamic_map_grow(new_header);
-		}
+proc __dynamic_map_slot_ctrl(hash: u64) -> u64 #cc_contextless {
+	return 0x80 | ((hash * __MAP_HASH_MULTIPLIER) >> 57);
+}
 
-		var entry_header = __dynamic_map_get_entry(header, i);
-		var data = ^u8(entry_header);
+proc __dynamic_map_reserve(using header: __MapHeader, cap: int)  {
+	__dynamic_array_reserve(&m.entries, entry_size, entry_align, cap);
 
-		var fr = __dynamic_map_find(new_header, entry_header.key);
-		var j = __dynamic_map_add_entry(new_header, entry_header.key);
-		if fr.entry_prev < 0 {
-			nm.hashes[fr.hash_index] = j;
-		} else {
-			var e = __dynamic_map_get_entry(new_header, fr.entry_prev);
-			e.next = j;
-		}
+	var slot_count = __INITIAL_MAP_CAP;
+	for 3*slot_count < 4*cap {
+		slot_count *= 2;
+	}
+	if slot_count > len(m.slots) {
+		__dynamic_map_rehash(header, slot_count);
+	}
+}
 
-		var e = __dynamic_map_get_entry(new_header, j);
-		e.next = fr.entry_index;
-		var ndata = ^u8(e);
-		__mem_copy(ndata+value_offset, data+value_offset, value_size);
+// NOTE: Rebuilds the slots from the entries, which stay where they are
+proc __dynamic_map_rehash(using header: __MapHeader, new_count: int) {
+	var old_slots = ^raw.DynamicArray(&m.slots);
+	var new_slots: raw.DynamicArray;
+	new_slots.allocator = old_slots.allocator;
+	if !__dynamic_array_resize(&new_slots, size_of(u64), align_of(u64), new_count) {
+		return;
+	}
+	__mem_zero(new_slots.data, new_count*size_of(u64));
 
-		if __dynamic_map_full(new_header) {
-			__dynamic_map_grow(new_header);
+	var slots = ^u64(new_slots.data);
+	var mask = new_count-1;
+	for var i = 0; i < m.entries.len; i++ {
+		var hash = __dynamic_map_get_entry(header, i).hash;
+		var j = __dynamic_map_slot_home(hash, mask);
+		for (slots+j)^ != 0 {
+			j = (j+1) & mask;
 		}
+		(slots+j)^ = (__dynamic_map_slot_ctrl(hash) << 56) | u64(i);
 	}
-	free_ptr_with_allocator(header_hashes.allocator, header_hashes.data);
-	free_ptr_with_allocator(header.m.entries.allocator, header.m.entries.data);
-	header.m^ = nm;
+
+	free_ptr_with_allocator(old_slots.allocator, old_slots.data);
+	old_slots^ = new_slots;
 }
 
 proc __dynamic_map_get(h: __MapHeader, key: __MapKey) -> rawptr {
@@ -701,70 +811,69 @@ proc __dynamic_map_get(h: __MapHeader, key: __MapKey) -> rawptr {
 }
 
 proc __dynamic_map_set(using h: __MapHeader, key: __MapKey, value: rawptr) {
-	var index: int;
 	assert(value != nil);
 
-
-	if len(m.hashes) == 0 {
-		__dynamic_map_reserve(h, __INITIAL_MAP_CAP);
+	if __dynamic_map_full(h) {
 		__dynamic_map_grow(h);
+		if __dynamic_map_full(h) -> return;
 	}
 
 	var fr = __dynamic_map_find(h, key);
-	if fr.entry_index >= 0 {
-		index = fr.entry_index;
-	} else {
+	var index = fr.entry_index;
+	if index < 0 {
 		index = __dynamic_map_add_entry(h, key);
-		if fr.entry_prev >= 0 {
-			var entry = __dynamic_map_get_entry(h, fr.entry_prev);
-			entry.next = index;
-		} else {
-			m.hashes[fr.hash_index] = index;
-		}
-	}
-	{
-		var e = __dynamic_map_get_entry(h, index);
-		e.key = key;
-		var val = ^u8(e) + value_offset;
-		__mem_copy(val, value, value_size);
+		if index < 0 -> return;
+		(__dynamic_map_slots(m)+fr.slot_index)^ = (__dynamic_map_slot_ctrl(key.hash) << 56) | u64(index);
 	}
 
-	if __dynamic_map_full(h) {
-		__dynamic_map_grow(h);
-	}
+	var e = __dynamic_map_get_entry(h, index);
+	var val = ^u8(e) + value_offset;
+	__mem_copy(val, value, value_size);
 }
 
 
 proc __dynamic_map_grow(using h: __MapHeader) {
-	var new_count = max(2*m.entries.cap + 8, __INITIAL_MAP_CAP);
+	var new_count = max(2*len(m.slots), __INITIAL_MAP_CAP);
 	__dynamic_map_rehash(h, new_count);
 }
 
+// NOTE: Whether adding another entry would take the slots past a load factor of 3/4
 proc __dynamic_map_full(using h: __MapHeader) -> bool {
-	return int(0.75 * f64(len(m.hashes))) <= m.entries.cap;
+	return 4*(m.entries.len+1) > 3*len(m.slots);
 }
 
 
-proc __dynamic_map_hash_equal(h: __MapHeader, a, b: __MapKey) -> bool {
-	if a.hash == b.hash {
-		if h.is_key_string -> return a.str == b.str;
-		return true;
-	}
-	return false;
+proc __dynamic_map_key_equal(h: __MapHeader, entry: ^__MapEntryHeader, key: __MapKey) -> bool {
+	if entry.hash != key.hash -> return false;
+	var entry_key = ^u8(entry) + h.key_offset;
+	if h.is_key_string -> return ^string(entry_key)^ == ^string(key.ptr)^;
+	// NOTE: A key of up to 64 bits is its own hash
+	if h.key_size <= size_of(u64) -> return true;
+	return __mem_compare(entry_key, ^u8(key.ptr), h.key_size) == 0;
 }
 
+// NOTE: `slot_index` is where the key is, or the empty slot where it would be added
 proc __dynamic_map_find(using h: __MapHeader, key: __MapKey) -> __MapFindResult {
-	var fr = __MapFindResult{-1, -1, -1};
-	if len(m.hashes) > 0 {
-		fr.hash_index = int(key.hash % u128(len(m.hashes)));
-		fr.entry_index = m.hashes[fr.hash_index];
-		for fr.entry_index >= 0 {
-			var entry = __dynamic_map_get_entry(h, fr.entry_index);
-			if __dynamic_map_hash_equal(h, entry.key, key) {
+	var fr = __MapFindResult{-1, -1};
+	var n = len(m.slots);
+	if n == 0 -> return fr;
+
+	var slots = __dynamic_map_slots(m);
+	var mask = n-1;
+	var ctrl = __dynamic_map_slot_ctrl(key.hash);
+	for var i = __dynamic_map_slot_home(key.hash, mask); ; i = (i+1) & mask {
+		var slot = (slots+i)^;
+		if slot == 0 {
+			fr.slot_index = i;
+			return fr;
+		}
+		if slot >> 56 == ctrl {
+			var index = int(slot & __MAP_SLOT_INDEX_MASK);
+			if __dynamic_map_key_equal(h, __dynamic_map_get_entry(h, index), key) {
+				fr.slot_index  = i;
+				fr.entry_index = index;
 				return fr;
 			}
-			fr.entry_prev = fr.entry_index;
-			fr.entry_index = entry.next;
 		}
 	}
 	return fr;
@@ -773,11 +882,11 @@ proc __dynamic_map_find(using h: __MapHeader, key: __MapKey) -> __MapFindResult
 proc __dynamic_map_add_entry(using h: __MapHeader, key: __MapKey) -> int {
 	var prev = m.entries.len;
 	var c = __dynamic_array_append_nothing(&m.entries, entry_size, entry_align);
-	if c != prev {
-		var end = __dynamic_map_get_entry(h, c-1);
-		end.key = key;
-		end.next = -1;
-	}
+	if c == prev -> return -1;
+
+	var end = __dynamic_map_get_entry(h, prev);
+	end.hash = key.hash;
+	__mem_copy(^u8(end) + key_offset, key.ptr, key_size);
 	return prev;
 }
 
@@ -795,20 +904,33 @@ proc __dynamic_map_get_entry(using h: __MapHeader, index: int) -> ^__MapEntryHea
 }
 
 proc __dynamic_map_erase(using h: __MapHeader, fr: __MapFindResult) {
-	if fr.entry_prev < 0 {
-		m.hashes[fr.hash_index] = __dynamic_map_get_entry(h, fr.entry_index).next;
-	} else {
-		__dynamic_map_get_entry(h, fr.entry_prev).next = __dynamic_map_get_entry(h, fr.entry_index).next;
+	var slots = __dynamic_map_slots(m);
+	var mask = len(m.slots)-1;
+
+	// NOTE: Backward shift deletion, the following slots of the probe run are moved into the
+	// hole when their home slot is not after it, so no tombstones are needed
+	var hole = fr.slot_index;
+	for var i = (hole+1) & mask; (slots+i)^ != 0; i = (i+1) & mask {
+		var slot = (slots+i)^;
+		var hash = __dynamic_map_get_entry(h, int(slot & __MAP_SLOT_INDEX_MASK)).hash;
+		var home = __dynamic_map_slot_home(hash, mask);
+		if (i-home) & mask >= (i-hole) & mask {
+			(slots+hole)^ = slot;
+			hole = i;
+		}
 	}
+	(slots+hole)^ = 0;
 
-	if fr.entry_index == m.entries.len-1 {
-		m.entries.len--;
-	}
-	__mem_copy(__dynamic_map_get_entry(h, fr.entry_index), __dynamic_map_get_entry(h, m.entries.len-1), entry_size);
-	var last = __dynamic_map_find(h, __dynamic_map_get_entry(h, fr.entry_index).key);
-	if last.entry_prev >= 0 {
-		__dynamic_map_get_entry(h, last.entry_prev).next = fr.entry_index;
-	} else {
-		m.hashes[last.hash_index] = fr.entry_index;
+	// NOTE: The last entry is moved into the erased one to keep the entries dense
+	var last = m.entries.len-1;
+	if fr.entry_index != last {
+		var last_entry = __dynamic_map_get_entry(h, last);
+		var i = __dynamic_map_slot_home(last_entry.hash, mask);
+		for int((slots+i)^ & __MAP_SLOT_INDEX_MASK) != last {
+			i = (i+1) & mask;
+		}
+		(slots+i)^ = ((slots+i)^ & ~__MAP_SLOT_INDEX_MASK) | u64(fr.entry_index);
+		__mem_copy(__dynamic_map_get_entry(h, fr.entry_index), last_entry, entry_size);
 	}
+	m.entries.len--;
 }
@@ -123,13 +123,11 @@ proc fprintln(fd: os.Handle, args: ..any) -> int {
 	os.write(fd, res);
 	return len(res);
 }
-proc fprintf(fd: os.Handle, fmt: string, args: ..any) -> int {
+proc fprintf(fd: os.Handle, fmt: string, args: ..any) -> int #printf {
 	var data: [_BUFFER_SIZE]u8;
 	var buf = make_string_buffer_from_slice(data[0..<0]);
 	sbprintf(&buf, fmt, ..args);
-	var res = string_buffer_data(buf);
-	os.write(fd, res);
-	return len(res);
+	return _fprintf_flush(fd, &buf);
 }
 
 
@@ -138,8 +136,20 @@ proc print       (args: ..any)              -> int { return fprint(os.stdout, ..
 proc print_err   (args: ..any)              -> int { return fprint(os.stderr, ..args); }
 proc println     (args: ..any)              -> int { return fprintln(os.stdout, ..args); }
 proc println_err (args: ..any)              -> int { return fprintln(os.stderr, ..args); }
-proc printf      (fmt: string, args: ..any) -> int { return fprintf(os.stdout, fmt, ..args); }
-proc printf_err  (fmt: string, args: ..any) -> int { return fprintf(os.stderr, fmt, ..args); }
+proc printf      (fmt: string, args: ..any) -> int #printf { return fprintf(os.stdout, fmt, ..args); }
+proc printf_err  (fmt: string, args: ..any) -> int #printf { return fprintf(os.stderr, fmt, ..args); }
+
+
+// A `#printf` call with a constant format is checked at compile time and, when a `_<name>_flush`
+// procedure exists, the compiler formats the arguments straight into a `_BUFFER_SIZE` stack buffer
+// with the typed fmt_* procedures and passes that buffer to the flush procedure
+proc _fprintf_flush(fd: os.Handle, buf: ^StringBuffer) -> int {
+	var res = string_buffer_data(buf);
+	os.write(fd, res);
+	return len(res);
+}
+proc _printf_flush    (buf: ^StringBuffer) -> int { return _fprintf_flush(os.stdout, buf); }
+proc _printf_err_flush(buf: ^StringBuffer) -> int { return _fprintf_flush(os.stderr, buf); }
 
 
 // aprint* procedures return a string that was allocated with the current context
@@ -154,7 +164,7 @@ proc aprintln(args: ..any) -> string {
 	sbprintln(&buf, ..args);
 	return to_string(buf);
 }
-proc aprintf(fmt: string, args: ..any) -> string {
+proc aprintf(fmt: string, args: ..any) -> string #printf {
 	var buf = make_string_dynamic_buffer();
 	sbprintf(&buf, fmt, ..args);
 	return to_string(buf);
@@ -171,10 +181,14 @@ proc bprintln(buf: []u8, args: ..any) -> string {
 	var sb = make_string_buffer_from_slice(buf[0..<0..<len(buf)]);
 	return sbprintln(&sb, ..args);
 }
-proc bprintf(buf: []u8, fmt: string, args: ..any) -> string {
+proc bprintf(buf: []u8, fmt: string, args: ..any) -> string #printf {
 	var sb = make_string_buffer_from_slice(buf[0..<0..<len(buf)]);
 	return sbprintf(&sb, fmt, ..args);
 }
+proc _bprintf_flush(buf: []u8, sb: ^StringBuffer) -> string {
+	var n = copy(buf, string_buffer_data(sb));
+	return string(buf[0..<n]);
+}
 
 
 
@@ -873,13 +887,13 @@ proc fmt_value(fi: ^FmtInfo, v: any, verb: rune) {
 			if i > 0 -> write_string(fi.buf, ", ");
 
 			var data = ^u8(entries.data) + i*entry_size;
-			var header = ^__MapEntryHeader(data);
+			var key  = data + entry_type.offsets[1];
 
 			if types.is_string(info.key) {
-				write_string(fi.buf, header.key.str);
+				write_string(fi.buf, ^string(key)^);
 			} else {
 				var fi = FmtInfo{buf = fi.buf};
-				fmt_arg(&fi, any{rawptr(&header.key.hash), info.key}, 'v');
+				fmt_arg(&fi, any{rawptr(key), info.key}, 'v');
 			}
 
 			write_string(fi.buf, "=");
@@ -1040,7 +1054,7 @@ proc sbprintln(buf: ^StringBuffer, args: ..any) -> string {
 	return to_string(buf^);
 }
 
-proc sbprintf(b: ^StringBuffer, fmt: string, args: ..any) -> string {
+proc sbprintf(b: ^StringBuffer, fmt: string, args: ..any) -> string #printf {
 	var (
 		end            = len(fmt);
 		arg_index: int = 0;
@@ -21,7 +21,7 @@ proc copy_non_overlapping(dst, src: rawptr, len: int) -> rawptr {
 	return __mem_copy_non_overlapping(dst, src, len);
 }
 proc compare(a, b: []u8) -> int {
-	return __mem_compare(&a[0], &b[0], min(len(a), len(b)));
+	return __string_cmp(string(a), string(b));
 }
 
 
@@ -23,7 +23,7 @@ type (
 	};
 
 	DynamicMap struct #ordered {
-		hashes:  [dynamic]int,
+		slots:   [dynamic]u64,
 		entries: DynamicArray,
 	};
 )
@@ -0,0 +1,235 @@
+#!/bin/bash
+
+# Compiler throughput benchmark
+#
+# Generates synthetic Odin programs at several scales and runs the compiler on
+# each of them up to .ll emission (-llvm-ir-only), recording the per-phase
+# timings, counters and memory usage.
+#
+# Usage:
+#     misc/benchmark.sh [scale] [odin executable] [output directory]
+#
+#     scale  small, medium (default) or large
+#
+# For each workload, the timings are written as JSON to <output>/<workload>.json
+# and the printed report to <output>/<workload>.txt so that runs can be diffed
+# against a baseline.
+
+scale=${1:-medium}
+odin=${2:-./odin}
+out_dir=${3:-benchmark}
+
+case "$scale" in
+	small)  factor=1  ;;
+	medium) factor=4  ;;
+	large)  factor=16 ;;
+	*)
+		echo "Unknown scale: $scale (expected small, medium or large)"
+		exit 1
+		;;
+esac
+
+if [ ! -x "$odin" ]; then
+	echo "Cannot find the odin executable: $odin"
+	exit 1
+fi
+odin=$(cd "$(dirname "$odin")" && pwd)/$(basename "$odin")
+
+mkdir -p "$out_dir"
+out_dir=$(cd "$out_dir" && pwd)
+src_dir="$out_dir/src"
+
+
+# Many files, each with a handful of procedures, all imported by the main file
+gen_many_files() {
+	local dir="$src_dir/many_files"
+	local file_count=$((50*factor))
+	local proc_count=20
+	mkdir -p "$dir"
+
+	for ((i = 0; i < file_count; i++)); do
+		{
+			for ((j = 0; j < proc_count; j++)); do
+				echo "proc p$j(x: int) -> int {"
+				echo "	var y = x*$((j+1)) + $i;"
+				echo "	if y > 100 { y -= 100; }"
+				echo "	return y;"
+				echo "}"
+			done
+		} > "$dir/file_$i.odin"
+	done
+
+	{
+		for ((i = 0; i < file_count; i++)); do
+			echo "import \"file_$i.odin\";"
+		done
+		echo "proc main() {"
+		echo "	var x = 0;"
+		for ((i = 0; i < file_count; i++)); do
+			echo "	x = file_$i.p$((i % proc_count))(x);"
+		done
+		echo "}"
+	} > "$dir/main.odin"
+}
+
+# One file with many small procedures calling each other
+gen_many_procs() {
+	local dir="$src_dir/many_procs"
+	local proc_count=$((2000*factor))
+	mkdir -p "$dir"
+
+	{
+		echo "proc p0(a, b: int) -> int { return a + b; }"
+		for ((i = 1; i < proc_count; i++)); do
+			echo "proc p$i(a, b: int) -> int {"
+			echo "	var c = p$((i-1))(a, b);"
+			echo "	return c*2 - a;"
+			echo "}"
+		done
+		echo "proc main() {"
+		echo "	var x = p$((proc_count-1))(1, 2);"
+		echo "}"
+	} > "$dir/main.odin"
+}
+
+# A chain of parametric polymorphic procedures instantiated with many types
+gen_generics() {
+	local dir="$src_dir/generics"
+	local depth=10
+	local type_count=$((20*factor))
+	mkdir -p "$dir"
+
+	{
+		echo "proc g0(T: type, x: T) -> T { return x; }"
+		for ((i = 1; i < depth; i++)); do
+			echo "proc g$i(T: type, x: T) -> T {"
+			echo "	var y = g$((i-1))(T, x);"
+			echo "	return y;"
+			echo "}"
+		done
+		for ((t = 0; t < type_count; t++)); do
+			echo "type S$t struct { a: int, b: f32, c: [$((t+1))]u8 }"
+		done
+		echo "proc main() {"
+		for ((t = 0; t < type_count; t++)); do
+			echo "	var v$t: S$t;"
+			echo "	v$t = g$((depth-1))(S$t, v$t);"
+		done
+		echo "}"
+	} > "$dir/main.odin"
+}
+
+# Huge struct and enum declarations
+gen_big_decls() {
+	local dir="$src_dir/big_decls"
+	local field_count=$((500*factor))
+	local enum_count=$((2000*factor))
+	mkdir -p "$dir"
+
+	{
+		echo "type Big struct {"
+		for ((i = 0; i < field_count; i++)); do
+			echo "	f$i: int,"
+		done
+		echo "}"
+		echo "type Huge enum {"
+		for ((i = 0; i < enum_count; i++)); do
+			echo "	V$i,"
+		done
+		echo "}"
+		echo "proc main() {"
+		echo "	var b: Big;"
+		echo "	b.f$((field_count-1)) = 1;"
+		echo "	var e = Huge.V$((enum_count-1));"
+		echo "}"
+	} > "$dir/main.odin"
+}
+
+# Huge constant lookup tables
+gen_const_tables() {
+	local dir="$src_dir/const_tables"
+	local table_count=4
+	local element_count=$((4096*factor))
+	mkdir -p "$dir"
+
+	{
+		for ((t = 0; t < table_count; t++)); do
+			echo "var table$t = [$element_count]u8{"
+			seq 0 $((element_count-1)) | awk -v t=$t '{ printf "\t%d,\n", ($1*(t+7)) % 256 }'
+			echo "};"
+		done
+		echo "proc main() {"
+		echo "	var sum = 0;"
+		for ((t = 0; t < table_count; t++)); do
+			echo "	sum += int(table$t[$((element_count-1))]);"
+		done
+		echo "}"
+	} > "$dir/main.odin"
+}
+
+# Long chains of constant declarations folded with arithmetic wider than 64 bits
+# NOTE: This times the BigInt folding of src/exact_value.cpp, not src/integer128.cpp,
+# which is timed on its own below
+gen_const_exprs() {
+	local dir="$src_dir/const_exprs"
+	local const_count=$((2000*factor))
+	mkdir -p "$dir"
+
+	{
+		echo "const ("
+		echo "	M = 1<<127 - 1;"
+		echo "	c0 = 0x9e3779b97f4a7c15f39cc0605cedc834;"
+		echo "	d0 = -0x2545f4914f6cdd1d2545f4914f6cdd1d;"
+		for ((i = 1; i < const_count; i++)); do
+			echo "	c$i = (c$((i-1))*6364136223846793005 + 1442695040888963407) % M ~ c$((i-1))>>$((i % 61 + 1));"
+			echo "	d$i = (d$((i-1))/$((i % 97 + 2)) - c$i>>3) * -$((i % 13 + 1)) % M;"
+		done
+		echo ")"
+		echo "proc main() {"
+		echo "	var x = u128(c$((const_count-1)));"
+		echo "	var y = i128(d$((const_count-1)));"
+		echo "}"
+	} > "$dir/main.odin"
+}
+
+
+workloads="many_files many_procs generics big_decls const_tables const_exprs"
+
+for workload in $workloads; do
+	echo "Generating $workload ($scale)"
+	rm -rf "$src_dir/$workload"
+	gen_$workload
+done
+
+for workload in $workloads; do
+	echo
+	echo "== $workload ($scale) =="
+	"$odin" build "$src_dir/$workload/main.odin" \
+		-llvm-ir-only \
+		-show-timings \
+		-show-memory \
+		-export-timings="$out_dir/$workload.json" \
+		2>&1 | tee "$out_dir/$workload.txt"
+	if [ "${PIPESTATUS[0]}" -ne "0" ]; then
+		echo "Failed to compile $workload"
+		exit 1
+	fi
+done
+
+# src/integer128.cpp is timed by misc/integer128_test.cpp, with the compiler's
+# native __int128 and with the portable implementation
+cxx=${CXX:-g++}
+misc_dir=$(cd "$(dirname "$0")" && pwd)
+for path in native portable; do
+	flags=""
+	if [ "$path" = "portable" ]; then
+		flags="-DBIT128_NO_NATIVE"
+	fi
+	echo
+	echo "== integer128 ($path) =="
+	if ! "$cxx" -std=c++11 -O2 -w $flags "$misc_dir/integer128_test.cpp" -o "$out_dir/integer128_$path"; then
+		echo "Failed to build the integer128 benchmark"
+		exit 1
+	fi
+	"$out_dir/integer128_$path" bench $((100*factor)) 2>&1 | tee "$out_dir/integer128_$path.txt"
+done
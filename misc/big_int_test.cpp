@@ -0,0 +1,358 @@
+// Test of the arbitrary precision integers of src/big_int.cpp and the integer
+// constants of src/exact_value.cpp
+//
+// Compares every BigInt operation on pseudo-random operands that fit in an i128
+// with the compiler's own `__int128`, biased towards the 64-bit boundary where
+// values move between the inline word and heap limbs. Values wider than 128 bits
+// are checked with identities, e.g. (a*b)/b == a and (a<<n)>>n == a, and with
+// known decimal strings, and a few integer constant expressions are folded with
+// exact_binary_operator_value. Prints the first failures of each check and exits
+// with 1 if there were any.
+//
+// Requires GCC or Clang on a 64-bit target:
+//     g++ -std=c++11 -pthread misc/big_int_test.cpp -o big_int_test -ldl -lm && ./big_int_test [iterations] [seed]
+
+#include "../src/common.cpp"
+#include "../src/timings.cpp"
+#include "../src/trace.cpp"
+#include "../src/build_settings.cpp"
+#include "../src/tokenizer.cpp"
+#include "../src/exact_value.cpp"
+
+#include "test_common.cpp"
+
+
+// A magnitude of at most `bits` bits which is often on or next to a limb boundary
+ref_u128 rng_magnitude(u32 bits) {
+	ref_u128 m = (cast(ref_u128)rng_next() << 64) | rng_next();
+	switch (rng_next() % 8) {
+	case 0: m = rng_next() % 1000;                                        break;
+	case 1: m = (cast(ref_u128)1 << 64) + (rng_next() % 5) - 2;           break; // 2^64 - 2 .. 2^64 + 2
+	case 2: m = (cast(ref_u128)1 << (rng_next() % bits)) - (rng_next() % 2); break; // Powers of two, and minus one
+	case 3: m = rng_next();                                               break; // One limb
+	}
+	if (bits < 128) {
+		m &= (cast(ref_u128)1 << bits) - 1;
+	}
+	return m;
+}
+
+ref_i128 rng_value(u32 bits) {
+	ref_i128 v = cast(ref_i128)rng_magnitude(bits);
+	return (rng_next() & 1) ? -v : v;
+}
+
+BigInt to_big(ref_i128 v) {
+	ref_u128 m = v < 0 ? -cast(ref_u128)v : cast(ref_u128)v;
+	BigInt b = big_int_from_u128(u128_lo_hi(cast(u64)m, cast(u64)(m >> 64)));
+	return v < 0 ? big_int_neg(b) : b;
+}
+
+// NOTE: Only valid for values which fit in two limbs
+ref_i128 from_big(BigInt x) {
+	u64 const *limbs = big_int_limbs(&x);
+	ref_u128 m = 0;
+	if (x.len >= 1) m |= limbs[0];
+	if (x.len >= 2) m |= cast(ref_u128)limbs[1] << 64;
+	return x.neg ? -cast(ref_i128)m : cast(ref_i128)m;
+}
+
+// NOTE: Small values must be stored inline and zero must have no limbs
+bool is_normalized(BigInt x) {
+	if (x.len == 0) {
+		return !x.neg;
+	}
+	return big_int_limbs(&x)[x.len-1] != 0;
+}
+
+String big_string(BigInt x) {
+	return big_int_to_string(heap_allocator(), x);
+}
+
+BigInt big_from_cstring(char const *s) {
+	bool neg = s[0] == '-';
+	BigInt x = big_int_from_string(make_string_c(cast(char *)(neg ? s+1 : s)));
+	return neg ? big_int_neg(x) : x;
+}
+
+
+enum TestCheckKind {
+	Check_Normalized,
+	Check_Add, Check_Sub, Check_Mul, Check_Quo, Check_Rem, Check_Neg, Check_Abs, Check_Not,
+	Check_Bitwise, Check_Shl, Check_Shr, Check_Cmp, Check_Convert, Check_String,
+	Check_WideIdentity, Check_WideString, Check_AboveI128, Check_ExactValue,
+
+	Check_Count,
+};
+
+gb_global TestCheck test_checks[Check_Count] = {
+	{"normalized"},
+	{"add"}, {"sub"}, {"mul"}, {"quo"}, {"rem"}, {"neg"}, {"abs"}, {"not"},
+	{"bitwise"}, {"shl"}, {"shr"}, {"cmp"}, {"convert"}, {"string"},
+	{"wide identity"}, {"wide string"}, {"above i128"}, {"exact value"},
+};
+
+void report_failure(TestCheckKind kind, char const *what, String got, String want) {
+	TestCheck *c = &test_checks[kind];
+	if (count_failure(c)) {
+		printf("FAIL %s: %s got=%.*s want=%.*s\n", c->name, what, LIT(got), LIT(want));
+	}
+}
+
+void check_big(TestCheckKind kind, char const *what, BigInt got, BigInt want) {
+	if (!is_normalized(got)) {
+		report_failure(Check_Normalized, what, big_string(got), big_string(want));
+	}
+	if (big_int_cmp(got, want) != 0) {
+		report_failure(kind, what, big_string(got), big_string(want));
+	}
+}
+
+void check_ref(TestCheckKind kind, char const *op, ref_i128 a, ref_i128 b, BigInt got, ref_i128 want) {
+	if (big_int_cmp(got, to_big(want)) == 0 && is_normalized(got) &&
+	    (got.len <= 1) == (want < 0 ? -cast(ref_u128)want : cast(ref_u128)want) >> 64 == 0) {
+		return;
+	}
+	char abuf[64], bbuf[64], what[160];
+	gb_snprintf(what, gb_size_of(what), "%s %s %s", ref_to_string(a, abuf, gb_size_of(abuf)), op, ref_to_string(b, bbuf, gb_size_of(bbuf)));
+	if (!is_normalized(got) || got.len > 2) {
+		report_failure(Check_Normalized, what, big_string(got), big_string(to_big(want)));
+	} else {
+		report_failure(kind, what, big_string(got), big_string(to_big(want)));
+	}
+}
+
+
+void test_against_i128(void) {
+	ref_i128 a = rng_value(126);
+	ref_i128 b = rng_value(126);
+	BigInt x = to_big(a);
+	BigInt y = to_big(b);
+
+	check_ref(Check_Add, "+", a, b, big_int_add(x, y), a + b);
+	check_ref(Check_Sub, "-", a, b, big_int_sub(x, y), a - b);
+	check_ref(Check_Neg, "neg", a, 0, big_int_neg(x), -a);
+	check_ref(Check_Abs, "abs", a, 0, big_int_abs(x), a < 0 ? -a : a);
+	check_ref(Check_Not, "not", a, 0, big_int_not(x), ~a);
+	check_ref(Check_Bitwise, "&",  a, b, big_int_and(x, y),     a & b);
+	check_ref(Check_Bitwise, "|",  a, b, big_int_or(x, y),      a | b);
+	check_ref(Check_Bitwise, "~",  a, b, big_int_xor(x, y),     a ^ b);
+	check_ref(Check_Bitwise, "&~", a, b, big_int_and_not(x, y), a & ~b);
+
+	ref_i128 c = rng_value(63);
+	ref_i128 d = rng_value(63);
+	check_ref(Check_Mul, "*", c, d, big_int_mul(to_big(c), to_big(d)), c * d);
+	check_ref(Check_Mul, "*", a, d >> 62, big_int_mul(x, to_big(d >> 62)), a * (d >> 62));
+	if (b != 0) {
+		check_ref(Check_Quo, "/", a, b, big_int_quo(x, y), a / b);
+		check_ref(Check_Rem, "%", a, b, big_int_rem(x, y), a % b);
+	}
+	if (c != 0) {
+		check_ref(Check_Quo, "/", a, c, big_int_quo(x, to_big(c)), a / c);
+		check_ref(Check_Rem, "%", a, c, big_int_rem(x, to_big(c)), a % c);
+	}
+
+	u32 n = cast(u32)(rng_next() % 64);
+	ref_i128 e = rng_value(126-n);
+	check_ref(Check_Shl, "<<", e, n, big_int_shl(to_big(e), n), e * (cast(ref_i128)1 << n));
+	u32 m = cast(u32)(rng_next() % 130);
+	check_ref(Check_Shr, ">>", a, m, big_int_shr(x, m), m < 127 ? a >> m : (a < 0 ? -1 : 0));
+
+	i32 want_cmp = a < b ? -1 : a > b ? +1 : 0;
+	if (big_int_cmp(x, y) != want_cmp) {
+		report_failure(Check_Cmp, "cmp", big_string(x), big_string(y));
+	}
+	if (big_int_cmp_i64(x, cast(i64)c) != (a < c ? -1 : a > c ? +1 : 0)) {
+		report_failure(Check_Cmp, "cmp_i64", big_string(x), big_string(to_big(c)));
+	}
+	if (big_int_is_zero(x) != (a == 0) || big_int_is_neg(x) != (a < 0)) {
+		report_failure(Check_Cmp, "is_zero/is_neg", big_string(x), big_string(x));
+	}
+
+	// NOTE: The conversions truncate to the lower 64 bits of the two's complement value
+	if (big_int_to_u64(x) != cast(u64)a || big_int_to_i64(x) != cast(i64)a) {
+		report_failure(Check_Convert, "to_u64/to_i64", big_string(x), big_string(to_big(cast(i64)a)));
+	}
+	f64 f = big_int_to_f64(x);
+	if (fabs(f - cast(f64)a) > fabs(cast(f64)a) * 2.3e-16) {
+		report_failure(Check_Convert, "to_f64", big_string(x), big_string(x));
+	}
+	f64 g = cast(f64)a;
+	BigInt from_f = {};
+	if (!big_int_from_f64(g, &from_f) || big_int_cmp(from_f, to_big(cast(ref_i128)g)) != 0 || !is_normalized(from_f)) {
+		report_failure(Check_Convert, "from_f64", big_string(from_f), big_string(to_big(cast(ref_i128)g)));
+	}
+
+	char buf[64];
+	char *want = ref_to_string(a, buf, gb_size_of(buf));
+	String s = big_string(x);
+	if (s != make_string_c(want)) {
+		report_failure(Check_String, "to_string", s, make_string_c(want));
+	}
+	BigInt back = big_from_cstring(want);
+	if (big_int_cmp(back, x) != 0 || !is_normalized(back)) {
+		report_failure(Check_String, "from_string", big_string(back), s);
+	}
+}
+
+BigInt rng_wide(void) {
+	// NOTE: Up to 8 limbs, often with runs of all ones or zeros so that carries and borrows propagate
+	isize len = 1 + cast(isize)(rng_next() % 8);
+	BigInt x = BIG_INT_ZERO;
+	for (isize i = 0; i < len; i++) {
+		u64 limb = rng_next();
+		switch (rng_next() % 4) {
+		case 0: limb = 0;                  break;
+		case 1: limb = BIT128_U64_ALLBITS; break;
+		}
+		x = big_int_add(big_int_shl(x, 64), big_int_from_u64(limb));
+	}
+	return (rng_next() & 1) ? big_int_neg(x) : x;
+}
+
+void test_wide(void) {
+	BigInt a = rng_wide();
+	BigInt b = rng_wide();
+	BigInt zero = BIG_INT_ZERO;
+
+	check_big(Check_WideIdentity, "(a+b)-b == a", big_int_sub(big_int_add(a, b), b), a);
+	check_big(Check_WideIdentity, "a-a == 0", big_int_sub(a, a), zero);
+	check_big(Check_WideIdentity, "~~a == a", big_int_not(big_int_not(a)), a);
+	check_big(Check_WideIdentity, "a^b^b == a", big_int_xor(big_int_xor(a, b), b), a);
+	check_big(Check_WideIdentity, "(a&b)+(a|b) == a+b", big_int_add(big_int_and(a, b), big_int_or(a, b)), big_int_add(a, b));
+	check_big(Check_WideIdentity, "(a&~b)|(a&b) == a", big_int_or(big_int_and_not(a, b), big_int_and(a, b)), a);
+
+	if (!big_int_is_zero(b)) {
+		BigInt p = big_int_mul(a, b);
+		check_big(Check_WideIdentity, "(a*b)/b == a", big_int_quo(p, b), a);
+		check_big(Check_WideIdentity, "(a*b)%b == 0", big_int_rem(p, b), zero);
+
+		// NOTE: Truncated division, a == (a/b)*b + a%b with |a%b| < |b| and the sign of a
+		BigInt q = big_int_quo(a, b);
+		BigInt r = big_int_rem(a, b);
+		check_big(Check_WideIdentity, "(a/b)*b + a%b == a", big_int_add(big_int_mul(q, b), r), a);
+		if (big_int_cmp(big_int_abs(r), big_int_abs(b)) >= 0 || (!big_int_is_zero(r) && big_int_is_neg(r) != big_int_is_neg(a))) {
+			report_failure(Check_WideIdentity, "|a%b| < |b| with the sign of a", big_string(r), big_string(b));
+		}
+	}
+
+	u64 n = rng_next() % 300;
+	BigInt pow2 = big_int_shl(big_int_from_u64(1), n);
+	check_big(Check_WideIdentity, "(a<<n)>>n == a", big_int_shr(big_int_shl(a, n), n), a);
+	check_big(Check_WideIdentity, "a<<n == a*2^n", big_int_shl(a, n), big_int_mul(a, pow2));
+	// NOTE: Arithmetic shifts round towards negative infinity, unlike the truncating division
+	BigInt floor_q = big_int_quo(a, pow2);
+	if (big_int_is_neg(a) && !big_int_is_zero(big_int_rem(a, pow2))) {
+		floor_q = big_int_sub(floor_q, big_int_from_u64(1));
+	}
+	check_big(Check_WideIdentity, "a>>n == floor(a/2^n)", big_int_shr(a, n), floor_q);
+
+	String s = big_string(a);
+	BigInt back = big_int_is_neg(a) ? big_int_neg(big_int_from_string(make_string(s.text+1, s.len-1)))
+	                                : big_int_from_string(s);
+	check_big(Check_WideString, "from_string(to_string(a))", back, a);
+}
+
+void test_above_i128(void) {
+	struct Case {
+		char const *decimal;
+		BigInt      value;
+	};
+	BigInt one   = big_int_from_u64(1);
+	BigInt p127  = big_int_shl(one, 127);
+	BigInt p128  = big_int_shl(one, 128);
+	BigInt p192  = big_int_shl(one, 192);
+	Case cases[] = {
+		{"170141183460469231731687303715884105727",  big_int_sub(p127, one)}, // i128 max
+		{"170141183460469231731687303715884105728",  p127},
+		{"-170141183460469231731687303715884105728", big_int_neg(p127)},       // i128 min
+		{"-170141183460469231731687303715884105729", big_int_sub(big_int_neg(p127), one)},
+		{"340282366920938463463374607431768211455",  big_int_from_u128(U128_NEG_ONE)}, // u128 max
+		{"340282366920938463463374607431768211456",  p128},
+		{"340282366920938463463374607431768211457",  big_int_add(p128, one)},
+		{"6277101735386680763835789423207666416102355444464034512896", p192},
+	};
+	for (isize i = 0; i < gb_count_of(cases); i++) {
+		BigInt want = big_from_cstring(cases[i].decimal);
+		check_big(Check_AboveI128, cases[i].decimal, cases[i].value, want);
+		String s = big_string(cases[i].value);
+		if (s != make_string_c(cast(char *)cases[i].decimal)) {
+			report_failure(Check_AboveI128, "to_string", s, make_string_c(cast(char *)cases[i].decimal));
+		}
+	}
+
+	// NOTE: Carries and borrows which run through every limb
+	check_big(Check_AboveI128, "(2^192-1)+1", big_int_add(big_int_sub(p192, one), one), p192);
+	check_big(Check_AboveI128, "(2^128+1)-2", big_int_sub(big_int_add(p128, one), big_int_from_u64(2)), big_int_from_u128(U128_NEG_ONE));
+	check_big(Check_AboveI128, "2^128-2^128", big_int_sub(p128, p128), BIG_INT_ZERO);
+	check_big(Check_AboveI128, "(2^64)*(2^64)", big_int_mul(big_int_shl(one, 64), big_int_shl(one, 64)), p128);
+	check_big(Check_AboveI128, "2^128/(2^64+1)", big_int_quo(p128, big_int_add(big_int_shl(one, 64), one)), big_from_cstring("18446744073709551615"));
+	check_big(Check_AboveI128, "2^128%(2^64+1)", big_int_rem(p128, big_int_add(big_int_shl(one, 64), one)), one);
+	check_big(Check_AboveI128, "-2^128/3", big_int_quo(big_int_neg(p128), big_int_from_u64(3)), big_from_cstring("-113427455640312821154458202477256070485"));
+	check_big(Check_AboveI128, "-2^128%3", big_int_rem(big_int_neg(p128), big_int_from_u64(3)), big_from_cstring("-1"));
+	check_big(Check_AboveI128, "-2^128>>127", big_int_shr(big_int_neg(p128), 127), big_from_cstring("-2"));
+	check_big(Check_AboveI128, "(-2^128-1)>>128", big_int_shr(big_int_sub(big_int_neg(p128), one), 128), big_from_cstring("-2"));
+	check_big(Check_AboveI128, "2^128>>64 is small", big_int_shr(p128, 64), big_int_shl(one, 64));
+	check_big(Check_AboveI128, "(2^128+5)-2^128 is small", big_int_sub(big_int_add(p128, big_int_from_u64(5)), p128), big_int_from_u64(5));
+	if (big_int_sub(big_int_add(p128, big_int_from_u64(5)), p128).len != 1) {
+		report_failure(Check_Normalized, "(2^128+5)-2^128 is stored inline", big_string(p128), big_string(p128));
+	}
+}
+
+ExactValue exact_integer(char const *s) {
+	return exact_value_integer_from_string(make_string_c(cast(char *)s));
+}
+
+void check_exact(char const *what, ExactValue got, char const *want) {
+	if (got.kind != ExactValue_Integer) {
+		report_failure(Check_ExactValue, what, str_lit("(not an integer)"), make_string_c(cast(char *)want));
+		return;
+	}
+	check_big(Check_ExactValue, what, got.value_integer, big_from_cstring(want));
+}
+
+void test_exact_values(void) {
+	ExactValue one  = exact_value_i64(1);
+	ExactValue p128 = exact_value_shift(Token_Shl, one, exact_value_i64(128));
+
+	check_exact("0x1_0000_0000_0000_0000", exact_integer("0x1_0000_0000_0000_0000"), "18446744073709551616");
+	check_exact("0b1 followed by 128 zeros", exact_integer("0b100000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000"), "340282366920938463463374607431768211456");
+	check_exact("1<<128", p128, "340282366920938463463374607431768211456");
+	check_exact("(1<<128)>>127", exact_value_shift(Token_Shr, p128, exact_value_i64(127)), "2");
+	check_exact("(1<<128)-1", exact_value_sub(p128, one), "340282366920938463463374607431768211455");
+	check_exact("~0 as u128", exact_unary_operator_value(Token_Xor, exact_value_i64(0), 128), "340282366920938463463374607431768211455");
+	check_exact("~0 as i128", exact_unary_operator_value(Token_Xor, exact_value_i64(0), 0), "-1");
+	check_exact("-(1<<128)", exact_unary_operator_value(Token_Sub, p128, 0), "-340282366920938463463374607431768211456");
+	check_exact("(1<<128)*(1<<128)", exact_value_mul(p128, p128), "115792089237316195423570985008687907853269984665640564039457584007913129639936");
+	check_exact("-7/2", exact_binary_operator_value(Token_QuoEq, exact_value_i64(-7), exact_value_i64(2)), "-3");
+	check_exact("-7%2", exact_binary_operator_value(Token_Mod, exact_value_i64(-7), exact_value_i64(2)), "-1");
+	check_exact("-7%%3", exact_binary_operator_value(Token_ModMod, exact_value_i64(-7), exact_value_i64(3)), "2");
+	check_exact("-(1<<128)%%3", exact_binary_operator_value(Token_ModMod, exact_unary_operator_value(Token_Sub, p128, 0), exact_value_i64(3)), "2");
+
+	// NOTE: Equal values which are stored out of line must compare and hash the same
+	ExactValue a = exact_value_add(p128, one);
+	ExactValue b = exact_integer("340282366920938463463374607431768211457");
+	if (!compare_exact_values(Token_CmpEq, a, b) || compare_exact_values(Token_Lt, a, b) ||
+	    !compare_exact_values(Token_Gt, a, p128) ||
+	    !hash_key_equal(hash_exact_value(a), hash_exact_value(b))) {
+		report_failure(Check_ExactValue, "(1<<128)+1 compares and hashes equal", big_string(a.value_integer), big_string(b.value_integer));
+	}
+	if (hash_key_equal(hash_exact_value(a), hash_exact_value(exact_unary_operator_value(Token_Sub, a, 0)))) {
+		report_failure(Check_ExactValue, "hash of x and -x differ", big_string(a.value_integer), big_string(a.value_integer));
+	}
+}
+
+
+int main(int arg_count, char **arg_ptr) {
+	isize iterations = parse_test_args(arg_count, arg_ptr);
+	printf("Testing with %td iterations, seed 0x%llx\n", iterations, cast(unsigned long long)rng_state);
+
+	test_above_i128();
+	test_exact_values();
+	for (isize i = 0; i < iterations; i++) {
+		test_against_i128();
+		test_wide();
+	}
+
+	return report_test_checks("big_int", test_checks, Check_Count);
+}
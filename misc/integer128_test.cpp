@@ -0,0 +1,332 @@
+// Randomized differential test of src/integer128.cpp
+//
+// Runs every u128/i128 operation on pseudo-random operands, biased towards the
+// edges (zero, one, the 64-bit boundary, powers of two and the extremes), and
+// compares the results with the compiler's own `unsigned __int128`. Build it
+// once as is to test the native path and once with -DBIT128_NO_NATIVE to test
+// the portable path. Prints the first failures of each operation and exits
+// with 1 if there were any.
+//
+// With `bench`, it instead times each operation on the same kind of operands,
+// next to the same operation on `__int128`, and prints the nanoseconds per call.
+// Build it with optimizations for that, as misc/benchmark.sh does.
+//
+// Requires GCC or Clang on a 64-bit target:
+//     g++ -std=c++11 misc/integer128_test.cpp -o integer128_test && ./integer128_test [iterations] [seed]
+//     g++ -std=c++11 -DBIT128_NO_NATIVE misc/integer128_test.cpp -o integer128_test && ./integer128_test
+//     g++ -std=c++11 -O2 misc/integer128_test.cpp -o integer128_test && ./integer128_test bench [rounds]
+
+#define GB_IMPLEMENTATION
+#include "../src/gb/gb.h"
+
+#include <math.h>
+
+gbAllocator heap_allocator(void) {
+	return gb_heap_allocator();
+}
+
+#include "../src/unicode.cpp"
+#include "../src/string.cpp"
+#include "../src/integer128.cpp"
+
+#include "test_common.cpp"
+
+
+u64 rng_u64_edge(void) {
+	u64 shift = rng_next() % 64;
+	switch (rng_next() % 8) {
+	case 0: return 0;
+	case 1: return 1;
+	case 2: return BIT128_U64_ALLBITS;
+	case 3: return BIT128_U64_HIGHBIT;
+	case 4: return BIT128_U64_BITS62;
+	case 5: return (1ull << shift);
+	case 6: return (1ull << shift) - 1;
+	}
+	return rng_next() % 1000;
+}
+
+ref_u128 rng_ref_u128(void) {
+	u64 lo = rng_next();
+	u64 hi = rng_next();
+	switch (rng_next() % 6) {
+	case 0: lo = rng_u64_edge();                    break; // Random high half
+	case 1: hi = rng_u64_edge();                    break; // Random low half
+	case 2: lo = rng_u64_edge(); hi = rng_u64_edge(); break;
+	case 3: hi = 0;                                 break; // Fits in 64 bits
+	case 4: hi = BIT128_U64_ALLBITS;                break; // Small negative as i128
+	}
+	return (cast(ref_u128)hi << 64) | lo;
+}
+
+u128 to_u128(ref_u128 a) { return u128_lo_hi(cast(u64)a, cast(u64)(a >> 64)); }
+i128 to_i128(ref_i128 a) { return i128_lo_hi(cast(u64)a, cast(i64)(cast(ref_u128)a >> 64)); }
+ref_u128 from_u128(u128 a) { return (cast(ref_u128)a.hi << 64) | a.lo; }
+ref_i128 from_i128(i128 a) { return cast(ref_i128)((cast(ref_u128)cast(u64)a.hi << 64) | a.lo); }
+
+void report_failure(TestCheck *op, ref_u128 a, ref_u128 b, ref_u128 got, ref_u128 want) {
+	if (count_failure(op)) {
+		printf("FAIL %s a=%016llx%016llx b=%016llx%016llx got=%016llx%016llx want=%016llx%016llx\n", op->name,
+		       cast(unsigned long long)(a>>64),    cast(unsigned long long)a,
+		       cast(unsigned long long)(b>>64),    cast(unsigned long long)b,
+		       cast(unsigned long long)(got>>64),  cast(unsigned long long)got,
+		       cast(unsigned long long)(want>>64), cast(unsigned long long)want);
+	}
+}
+
+void check(TestCheck *op, ref_u128 a, ref_u128 b, ref_u128 got, ref_u128 want) {
+	if (got != want) {
+		report_failure(op, a, b, got, want);
+	}
+}
+
+void check_f64(TestCheck *op, ref_u128 a, f64 got, f64 want) {
+#if defined(BIT128_NATIVE)
+	bool ok = got == want;
+#else
+	// NOTE: The portable conversion rounds both halves separately so it may be off by an ulp
+	bool ok = fabs(got - want) <= fabs(want) * 2.3e-16;
+#endif
+	if (!ok) {
+		if (count_failure(op)) {
+			printf("FAIL %s a=%016llx%016llx got=%.17g want=%.17g\n", op->name,
+			       cast(unsigned long long)(a>>64), cast(unsigned long long)a, got, want);
+		}
+	}
+}
+
+
+enum TestCheckKind {
+	Op_u128_add, Op_u128_sub, Op_u128_mul, Op_u128_quo, Op_u128_mod, Op_u128_neg, Op_u128_not,
+	Op_u128_shl, Op_u128_shr, Op_u128_cmp, Op_u128_to_f64, Op_u128_from_f64, Op_u128_string,
+
+	Op_i128_add, Op_i128_sub, Op_i128_mul, Op_i128_quo, Op_i128_mod, Op_i128_neg, Op_i128_abs,
+	Op_i128_shl, Op_i128_shr, Op_i128_cmp, Op_i128_to_f64, Op_i128_from_f64, Op_i128_string,
+
+	Op_Count,
+};
+
+gb_global TestCheck test_ops[Op_Count] = {
+	{"u128_add"}, {"u128_sub"}, {"u128_mul"}, {"u128_quo"}, {"u128_mod"}, {"u128_neg"}, {"u128_not"},
+	{"u128_shl"}, {"u128_shr"}, {"u128_cmp"}, {"u128_to_f64"}, {"u128_from_f64"}, {"u128_string"},
+
+	{"i128_add"}, {"i128_sub"}, {"i128_mul"}, {"i128_quo"}, {"i128_mod"}, {"i128_neg"}, {"i128_abs"},
+	{"i128_shl"}, {"i128_shr"}, {"i128_cmp"}, {"i128_to_f64"}, {"i128_from_f64"}, {"i128_string"},
+};
+
+void test_u128(ref_u128 ra, ref_u128 rb) {
+	u128 a = to_u128(ra);
+	u128 b = to_u128(rb);
+	u32 n = cast(u32)(rng_next() % 130);
+
+	check(&test_ops[Op_u128_add], ra, rb, from_u128(u128_add(a, b)), ra + rb);
+	check(&test_ops[Op_u128_sub], ra, rb, from_u128(u128_sub(a, b)), ra - rb);
+	check(&test_ops[Op_u128_mul], ra, rb, from_u128(u128_mul(a, b)), ra * rb);
+	if (rb != 0) {
+		check(&test_ops[Op_u128_quo], ra, rb, from_u128(u128_quo(a, b)), ra / rb);
+		check(&test_ops[Op_u128_mod], ra, rb, from_u128(u128_mod(a, b)), ra % rb);
+	}
+	check(&test_ops[Op_u128_neg], ra, 0, from_u128(u128_neg(a)), -ra);
+	check(&test_ops[Op_u128_not], ra, 0, from_u128(u128_not(a)), ~ra);
+	check(&test_ops[Op_u128_shl], ra, n, from_u128(u128_shl(a, n)), n < 128 ? ra << n : 0);
+	check(&test_ops[Op_u128_shr], ra, n, from_u128(u128_shr(a, n)), n < 128 ? ra >> n : 0);
+
+	i32 want_cmp = ra < rb ? -1 : ra > rb ? +1 : 0;
+	u32 got_flags  = u128_eq(a, b) | u128_ne(a, b)<<1 | u128_lt(a, b)<<2 | u128_gt(a, b)<<3 | u128_le(a, b)<<4 | u128_ge(a, b)<<5;
+	u32 want_flags = (ra == rb) | (ra != rb)<<1 | (ra < rb)<<2 | (ra > rb)<<3 | (ra <= rb)<<4 | (ra >= rb)<<5;
+	check(&test_ops[Op_u128_cmp], ra, rb, cast(ref_u128)cast(u32)u128_cmp(a, b), cast(ref_u128)cast(u32)want_cmp);
+	check(&test_ops[Op_u128_cmp], ra, rb, got_flags, want_flags);
+
+	check_f64(&test_ops[Op_u128_to_f64], ra, u128_to_f64(a), cast(f64)ra);
+
+#if defined(BIT128_NATIVE)
+	f64 f = cast(f64)(ra >> (rng_next() % 128));
+	if (f < 340282366920938463463374607431768211456.0) {
+		check(&test_ops[Op_u128_from_f64], ra, 0, from_u128(u128_from_f64(f)), cast(ref_u128)f);
+	}
+#else
+	// NOTE: The portable conversion only handles values which fit in 64 bits
+	f64 f = cast(f64)(cast(u64)ra >> (rng_next() % 63 + 1));
+	check(&test_ops[Op_u128_from_f64], ra, 0, from_u128(u128_from_f64(f)), cast(ref_u128)f);
+#endif
+
+	char buf[64];
+	char want_buf[64];
+	char *want = ref_to_string(ra, false, want_buf, gb_size_of(want_buf));
+	String s = u128_to_string(a, buf, gb_size_of(buf));
+	if (s != make_string_c(want) || u128_ne(u128_from_string(s), a)) {
+		report_failure(&test_ops[Op_u128_string], ra, 0, from_u128(u128_from_string(s)), ra);
+	}
+}
+
+void test_i128(ref_i128 ra, ref_i128 rb) {
+	i128 a = to_i128(ra);
+	i128 b = to_i128(rb);
+	u32 n = cast(u32)(rng_next() % 130);
+	ref_i128 min = cast(ref_i128)(cast(ref_u128)1 << 127);
+
+	// NOTE: The reference wraps around through unsigned arithmetic, as the implementation does
+	ref_u128 ua = cast(ref_u128)ra;
+	ref_u128 ub = cast(ref_u128)rb;
+	check(&test_ops[Op_i128_add], ua, ub, from_i128(i128_add(a, b)), ua + ub);
+	check(&test_ops[Op_i128_sub], ua, ub, from_i128(i128_sub(a, b)), ua - ub);
+	check(&test_ops[Op_i128_mul], ua, ub, from_i128(i128_mul(a, b)), ua * ub);
+	if (rb != 0 && !(ra == min && rb == -1)) {
+		check(&test_ops[Op_i128_quo], ua, ub, from_i128(i128_quo(a, b)), ra / rb);
+		check(&test_ops[Op_i128_mod], ua, ub, from_i128(i128_mod(a, b)), ra % rb);
+	}
+	check(&test_ops[Op_i128_neg], ua, 0, from_i128(i128_neg(a)), -ua);
+	check(&test_ops[Op_i128_abs], ua, 0, from_i128(i128_abs(a)), ra < 0 ? -ua : ua);
+	check(&test_ops[Op_i128_shl], ua, n, from_i128(i128_shl(a, n)), n < 128 ? ua << n : 0);
+	check(&test_ops[Op_i128_shr], ua, n, from_i128(i128_shr(a, n)), ra >> (n < 128 ? n : 127));
+
+	i32 want_cmp = ra < rb ? -1 : ra > rb ? +1 : 0;
+	u32 got_flags  = i128_eq(a, b) | i128_ne(a, b)<<1 | i128_lt(a, b)<<2 | i128_gt(a, b)<<3 | i128_le(a, b)<<4 | i128_ge(a, b)<<5;
+	u32 want_flags = (ra == rb) | (ra != rb)<<1 | (ra < rb)<<2 | (ra > rb)<<3 | (ra <= rb)<<4 | (ra >= rb)<<5;
+	check(&test_ops[Op_i128_cmp], ua, ub, cast(ref_u128)cast(u32)i128_cmp(a, b), cast(ref_u128)cast(u32)want_cmp);
+	check(&test_ops[Op_i128_cmp], ua, ub, got_flags, want_flags);
+
+	check_f64(&test_ops[Op_i128_to_f64], ua, i128_to_f64(a), cast(f64)ra);
+
+#if defined(BIT128_NATIVE)
+	f64 f = cast(f64)(ra >> (rng_next() % 127 + 1));
+	check(&test_ops[Op_i128_from_f64], ua, 0, from_i128(i128_from_f64(f)), cast(ref_u128)cast(ref_i128)f);
+#else
+	// NOTE: The portable conversion only handles non-negative values which fit in 64 bits
+	f64 f = cast(f64)(cast(u64)ra >> (rng_next() % 63 + 1));
+	check(&test_ops[Op_i128_from_f64], ua, 0, from_i128(i128_from_f64(f)), cast(ref_u128)cast(ref_i128)f);
+#endif
+
+	// NOTE: `i128_from_string` does not take a sign
+	char buf[64];
+	char want_buf[64];
+	char *want = ref_to_string(ra < 0 ? -ua : ua, ra < 0, want_buf, gb_size_of(want_buf));
+	String s = i128_to_string(a, buf, gb_size_of(buf));
+	bool round_trip = ra < 0 || i128_eq(i128_from_string(s), a);
+	if (s != make_string_c(want) || !round_trip) {
+		report_failure(&test_ops[Op_i128_string], ua, 0, from_i128(i128_from_string(s)), ua);
+	}
+}
+
+
+// NOTE: The benchmark runs each operation over the same edge-biased operands
+// with u128/i128 and with the compiler's `__int128`
+gb_global isize const bench_operand_count = 1024;
+
+gb_global u128     bench_ua[bench_operand_count];
+gb_global u128     bench_ub[bench_operand_count];
+gb_global i128     bench_ia[bench_operand_count];
+gb_global i128     bench_ib[bench_operand_count];
+gb_global ref_u128 bench_ra[bench_operand_count];
+gb_global ref_u128 bench_rb[bench_operand_count];
+gb_global ref_i128 bench_sa[bench_operand_count];
+gb_global ref_i128 bench_sb[bench_operand_count];
+gb_global u32      bench_n[bench_operand_count];
+gb_global char     bench_buf[64];
+gb_global ref_u128 bench_sink = 0; // NOTE: Every result is folded in so that no loop can be removed
+
+// NOTE: Sets `ns` to the time per evaluation of `result`, with `a`, `b` and `n` bound to each operand
+#define BENCH_TIME(ns, rounds, T, as, bs, result) do { \
+	f64 start = gb_time_now(); \
+	for (isize r = 0; r < (rounds); r++) { \
+		for (isize i = 0; i < bench_operand_count; i++) { \
+			T a = as[i]; T b = bs[i]; u32 n = bench_n[i]; \
+			bench_sink = bench_sink*3 + cast(ref_u128)(result); \
+		} \
+	} \
+	ns = (gb_time_now() - start) * 1.0e9 / (cast(f64)(rounds) * bench_operand_count); \
+} while (0)
+
+#define BENCH_U128(name, rounds, result, ref_result) do { \
+	f64 ns, ref_ns; \
+	BENCH_TIME(ns,     rounds, u128,     bench_ua, bench_ub, result); \
+	BENCH_TIME(ref_ns, rounds, ref_u128, bench_ra, bench_rb, ref_result); \
+	printf("%-14s %10.2f %10.2f\n", name, ns, ref_ns); \
+} while (0)
+
+#define BENCH_I128(name, rounds, result, ref_result) do { \
+	f64 ns, ref_ns; \
+	BENCH_TIME(ns,     rounds, i128,     bench_ia, bench_ib, result); \
+	BENCH_TIME(ref_ns, rounds, ref_i128, bench_sa, bench_sb, ref_result); \
+	printf("%-14s %10.2f %10.2f\n", name, ns, ref_ns); \
+} while (0)
+
+int run_benchmark(isize rounds) {
+	for (isize i = 0; i < bench_operand_count; i++) {
+		ref_u128 a = rng_ref_u128();
+		ref_u128 b = rng_ref_u128();
+		// NOTE: Keep the divisors valid for both signednesses
+		if (b == 0 || cast(ref_i128)b == -1) {
+			b = 3;
+		}
+		bench_ra[i] = a;           bench_rb[i] = b;
+		bench_sa[i] = cast(ref_i128)a; bench_sb[i] = cast(ref_i128)b;
+		bench_ua[i] = to_u128(a);  bench_ub[i] = to_u128(b);
+		bench_ia[i] = to_i128(cast(ref_i128)a); bench_ib[i] = to_i128(cast(ref_i128)b);
+		bench_n[i]  = cast(u32)(rng_next() % 128);
+	}
+
+#if defined(BIT128_NATIVE)
+	char const *path = "native";
+#else
+	char const *path = "portable";
+#endif
+	printf("Benchmarking the %s path, %td operations each\n", path, rounds*bench_operand_count);
+	printf("%-14s %10s %10s\n", "ns/op", "integer128", "__int128");
+
+	BENCH_U128("u128_add",    rounds, from_u128(u128_add(a, b)), a + b);
+	BENCH_U128("u128_sub",    rounds, from_u128(u128_sub(a, b)), a - b);
+	BENCH_U128("u128_mul",    rounds, from_u128(u128_mul(a, b)), a * b);
+	BENCH_U128("u128_quo",    rounds, from_u128(u128_quo(a, b)), a / b);
+	BENCH_U128("u128_mod",    rounds, from_u128(u128_mod(a, b)), a % b);
+	BENCH_U128("u128_shl",    rounds, from_u128(u128_shl(a, n)), a << n);
+	BENCH_U128("u128_shr",    rounds, from_u128(u128_shr(a, n)), a >> n);
+	BENCH_U128("u128_cmp",    rounds, u128_cmp(a, b) + u128_lt(a, b), (a < b ? -1 : a > b) + (a < b));
+	BENCH_U128("u128_to_f64", rounds, u128_to_f64(a) > 1.0e19, cast(f64)a > 1.0e19);
+	BENCH_U128("u128_string", rounds, u128_to_string(a, bench_buf, gb_size_of(bench_buf)).len,
+	                                  ref_to_string(a, false, bench_buf, gb_size_of(bench_buf))[0]);
+
+	BENCH_I128("i128_add",    rounds, from_i128(i128_add(a, b)), a + b);
+	BENCH_I128("i128_sub",    rounds, from_i128(i128_sub(a, b)), a - b);
+	BENCH_I128("i128_mul",    rounds, from_i128(i128_mul(a, b)), cast(ref_u128)a * cast(ref_u128)b);
+	BENCH_I128("i128_quo",    rounds, from_i128(i128_quo(a, b)), a / b);
+	BENCH_I128("i128_mod",    rounds, from_i128(i128_mod(a, b)), a % b);
+	BENCH_I128("i128_shl",    rounds, from_i128(i128_shl(a, n)), cast(ref_u128)a << n);
+	BENCH_I128("i128_shr",    rounds, from_i128(i128_shr(a, n)), a >> n);
+	BENCH_I128("i128_cmp",    rounds, i128_cmp(a, b) + i128_lt(a, b), (a < b ? -1 : a > b) + (a < b));
+	BENCH_I128("i128_to_f64", rounds, i128_to_f64(a) > 1.0e19, cast(f64)a > 1.0e19);
+	BENCH_I128("i128_string", rounds, i128_to_string(a, bench_buf, gb_size_of(bench_buf)).len,
+	                                  ref_to_string(a, bench_buf, gb_size_of(bench_buf))[0]);
+
+	// NOTE: Printed so that the results are used
+	printf("(checksum %016llx)\n", cast(unsigned long long)(bench_sink ^ (bench_sink >> 64)));
+	return 0;
+}
+
+int main(int arg_count, char **arg_ptr) {
+	if (arg_count > 1 && str_eq(make_string_c(arg_ptr[1]), str_lit("bench"))) {
+		isize rounds = 500;
+		if (arg_count > 2) {
+			rounds = cast(isize)strtoll(arg_ptr[2], NULL, 10);
+		}
+		return run_benchmark(rounds);
+	}
+
+	isize iterations = parse_test_args(arg_count, arg_ptr);
+
+#if defined(BIT128_NATIVE)
+	char const *path = "native";
+#else
+	char const *path = "portable";
+#endif
+	printf("Testing the %s path with %td iterations, seed 0x%llx\n", path, iterations, cast(unsigned long long)rng_state);
+
+	for (isize i = 0; i < iterations; i++) {
+		ref_u128 a = rng_ref_u128();
+		ref_u128 b = rng_ref_u128();
+		test_u128(a, b);
+		test_i128(cast(ref_i128)a, cast(ref_i128)b);
+	}
+
+	return report_test_checks("integer128", test_ops, Op_Count);
+}
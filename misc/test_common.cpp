@@ -0,0 +1,81 @@
+// Shared fixture of the randomized tests in misc/
+//
+// A seeded xorshift64* generator, the failure counters of each named check, the
+// compiler's `__int128` as the reference and the `[iterations] [seed]` command
+// line. Include it after src/gb/gb.h.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#if !defined(__SIZEOF_INT128__)
+	#error "The tests compare against the compiler's __int128"
+#endif
+
+typedef unsigned __int128 ref_u128;
+typedef          __int128 ref_i128;
+
+struct TestCheck {
+	char const *name;
+	isize       failures;
+};
+
+gb_global u64   rng_state = 0x9e3779b97f4a7c15ull;
+gb_global isize failure_count = 0;
+gb_global isize const max_reported_failures = 8; // Per check
+
+
+u64 rng_next(void) {
+	// NOTE: xorshift64*
+	rng_state ^= rng_state >> 12;
+	rng_state ^= rng_state << 25;
+	rng_state ^= rng_state >> 27;
+	return rng_state * 0x2545f4914f6cdd1dull;
+}
+
+// Counts a failure of `c` and returns whether it should still be printed
+bool count_failure(TestCheck *c) {
+	failure_count++;
+	return c->failures++ < max_reported_failures;
+}
+
+char *ref_to_string(ref_u128 magnitude, bool negative, char *buf, isize len) {
+	char *s = buf+len;
+	*--s = 0;
+	do {
+		*--s = cast(char)('0' + cast(int)(magnitude % 10));
+		magnitude /= 10;
+	} while (magnitude != 0);
+	if (negative) {
+		*--s = '-';
+	}
+	return s;
+}
+char *ref_to_string(ref_i128 v, char *buf, isize len) {
+	return ref_to_string(v < 0 ? -cast(ref_u128)v : cast(ref_u128)v, v < 0, buf, len);
+}
+
+// Returns the iteration count and seeds the generator
+isize parse_test_args(int arg_count, char **arg_ptr) {
+	isize iterations = 100000;
+	if (arg_count > 1) {
+		iterations = cast(isize)strtoll(arg_ptr[1], NULL, 10);
+	}
+	if (arg_count > 2) {
+		rng_state = cast(u64)strtoull(arg_ptr[2], NULL, 0);
+	}
+	return iterations;
+}
+
+// Prints the summary and returns the exit code
+int report_test_checks(char const *name, TestCheck *checks, isize count) {
+	if (failure_count == 0) {
+		printf("All %s tests passed\n", name);
+		return 0;
+	}
+	for (isize i = 0; i < count; i++) {
+		if (checks[i].failures > 0) {
+			printf("%s: %td failures\n", checks[i].name, checks[i].failures);
+		}
+	}
+	return 1;
+}
@@ -0,0 +1,634 @@
+// NOTE: Arbitrary precision integers, used for integer constants (ExactValue)
+// Sign and magnitude; the magnitude is stored inline when it fits in 64 bits, which is by far
+// the most common case, and in heap allocated 64-bit limbs (least significant first) otherwise.
+// Constants live for the whole compilation so out of line limbs are never freed once they
+// are part of a result.
+
+struct BigInt {
+	union {
+		u64  word;
+		u64 *words;
+	} d;
+	i32  len; // NOTE: Number of limbs in use; zero has no limbs and `d.word` is used when len <= 1
+	bool neg;
+};
+
+gb_global BigInt const BIG_INT_ZERO = {};
+
+BigInt big_int_from_u64   (u64 u);
+BigInt big_int_from_i64   (i64 i);
+BigInt big_int_from_u128  (u128 u);
+bool   big_int_from_f64   (f64 f, BigInt *out);
+BigInt big_int_from_string(String string);
+
+u64    big_int_to_u64     (BigInt x);
+i64    big_int_to_i64     (BigInt x);
+f64    big_int_to_f64     (BigInt x);
+String big_int_to_string  (gbAllocator allocator, BigInt x);
+
+bool   big_int_is_zero    (BigInt x);
+bool   big_int_is_neg     (BigInt x);
+i32    big_int_cmp        (BigInt x, BigInt y);
+i32    big_int_cmp_i64    (BigInt x, i64 y);
+
+BigInt big_int_neg        (BigInt x);
+BigInt big_int_abs        (BigInt x);
+BigInt big_int_not        (BigInt x);
+BigInt big_int_add        (BigInt x, BigInt y);
+BigInt big_int_sub        (BigInt x, BigInt y);
+BigInt big_int_mul        (BigInt x, BigInt y);
+BigInt big_int_quo        (BigInt x, BigInt y);
+BigInt big_int_rem        (BigInt x, BigInt y);
+BigInt big_int_and        (BigInt x, BigInt y);
+BigInt big_int_or         (BigInt x, BigInt y);
+BigInt big_int_xor        (BigInt x, BigInt y);
+BigInt big_int_and_not    (BigInt x, BigInt y);
+BigInt big_int_shl        (BigInt x, u64 shift);
+BigInt big_int_shr        (BigInt x, u64 shift);
+
+
+////////////////////////////////////////////////////////////////
+
+
+gb_inline u64 const *big_int_limbs(BigInt const *x) {
+	return x->len <= 1 ? &x->d.word : x->d.words;
+}
+
+gb_inline BigInt big_int__small(u64 magnitude, bool neg) {
+	BigInt r = {};
+	r.d.word = magnitude;
+	r.len    = magnitude != 0;
+	r.neg    = neg && magnitude != 0;
+	return r;
+}
+
+u64 *big_int__alloc(isize len) {
+	u64 *limbs = gb_alloc_array(heap_allocator(), u64, len);
+	gb_zero_size(limbs, len*gb_size_of(u64));
+	return limbs;
+}
+
+// NOTE: Takes ownership of `limbs` which must have come from `big_int__alloc`
+BigInt big_int__from_limbs(u64 *limbs, isize len, bool neg) {
+	while (len > 0 && limbs[len-1] == 0) {
+		len--;
+	}
+	if (len <= 1) {
+		BigInt r = big_int__small(len == 1 ? limbs[0] : 0, neg);
+		gb_free(heap_allocator(), limbs);
+		return r;
+	}
+	BigInt r = {};
+	r.d.words = limbs;
+	r.len     = cast(i32)len;
+	r.neg     = neg;
+	return r;
+}
+
+
+i32 big_int__mag_cmp(u64 const *a, isize an, u64 const *b, isize bn) {
+	for (isize i = gb_max(an, bn)-1; i >= 0; i--) {
+		u64 x = i < an ? a[i] : 0;
+		u64 y = i < bn ? b[i] : 0;
+		if (x != y) {
+			return x < y ? -1 : +1;
+		}
+	}
+	return 0;
+}
+
+// NOTE: `out` must hold max(an, bn)+1 limbs
+isize big_int__mag_add(u64 *out, u64 const *a, isize an, u64 const *b, isize bn) {
+	if (an < bn) {
+		gb_swap(u64 const *, a, b);
+		gb_swap(isize, an, bn);
+	}
+	u64 carry = 0;
+	for (isize i = 0; i < an; i++) {
+		u64 y = i < bn ? b[i] : 0;
+		u64 s = a[i] + y;
+		u64 c = s < y;
+		s += carry;
+		c |= s < carry;
+		out[i] = s;
+		carry = c;
+	}
+	out[an] = carry;
+	return an+1;
+}
+
+// NOTE: Requires a >= b, `out` must hold `an` limbs and may alias `a`
+void big_int__mag_sub(u64 *out, u64 const *a, isize an, u64 const *b, isize bn) {
+	u64 borrow = 0;
+	for (isize i = 0; i < an; i++) {
+		u64 x = a[i];
+		u64 y = i < bn ? b[i] : 0;
+		u64 d = x - y;
+		u64 c = x < y;
+		c |= d < borrow;
+		out[i] = d - borrow;
+		borrow = c;
+	}
+}
+
+u64 big_int__mul_word(u64 a, u64 b, u64 *hi) {
+	u64 a0 = a & 0xffffffffull, a1 = a >> 32;
+	u64 b0 = b & 0xffffffffull, b1 = b >> 32;
+	u64 p00 = a0*b0;
+	u64 p01 = a0*b1;
+	u64 p10 = a1*b0;
+	u64 p11 = a1*b1;
+	u64 mid = (p00 >> 32) + (p01 & 0xffffffffull) + (p10 & 0xffffffffull);
+	*hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+	return (mid << 32) | (p00 & 0xffffffffull);
+}
+
+// NOTE: `out` must hold an+bn zeroed limbs
+void big_int__mag_mul(u64 *out, u64 const *a, isize an, u64 const *b, isize bn) {
+	for (isize i = 0; i < an; i++) {
+		u64 carry = 0;
+		for (isize j = 0; j < bn; j++) {
+			u64 hi = 0;
+			u64 lo = big_int__mul_word(a[i], b[j], &hi);
+			u64 t = out[i+j] + lo;
+			hi += t < lo;
+			t += carry;
+			hi += t < carry;
+			out[i+j] = t;
+			carry = hi;
+		}
+		out[i+bn] = carry;
+	}
+}
+
+// NOTE: Returns the remainder, `quo` must hold `an` limbs and may alias `a`
+u32 big_int__mag_div_small(u64 *quo, u64 const *a, isize an, u32 d) {
+	u64 r = 0;
+	for (isize i = an-1; i >= 0; i--) {
+		u64 x = a[i];
+		u64 hi = (r << 32) | (x >> 32);
+		r = hi % d;
+		u64 lo = (r << 32) | (x & 0xffffffffull);
+		r = lo % d;
+		quo[i] = ((hi / d) << 32) | (lo / d);
+	}
+	return cast(u32)r;
+}
+
+// NOTE: Shift-subtract long division; `quo` must hold `an` zeroed limbs and `rem` bn+1 zeroed limbs
+void big_int__mag_divmod(u64 *quo, u64 *rem, u64 const *a, isize an, u64 const *b, isize bn) {
+	isize rn = bn+1;
+	for (isize i = an*64-1; i >= 0; i--) {
+		u64 carry = (a[i/64] >> (i%64)) & 1;
+		for (isize j = 0; j < rn; j++) {
+			u64 next = rem[j] >> 63;
+			rem[j] = (rem[j] << 1) | carry;
+			carry = next;
+		}
+		if (big_int__mag_cmp(rem, rn, b, bn) >= 0) {
+			big_int__mag_sub(rem, rem, rn, b, bn);
+			quo[i/64] |= 1ull << (i%64);
+		}
+	}
+}
+
+void big_int__divmod(BigInt x, BigInt y, BigInt *quo, BigInt *rem) {
+	GB_ASSERT_MSG(y.len > 0, "Integer division by zero");
+	if (x.len <= 1 && y.len <= 1) {
+		if (quo) *quo = big_int__small(x.d.word / y.d.word, x.neg != y.neg);
+		if (rem) *rem = big_int__small(x.d.word % y.d.word, x.neg);
+		return;
+	}
+
+	u64 const *a = big_int_limbs(&x);
+	u64 const *b = big_int_limbs(&y);
+	isize an = x.len;
+	isize bn = y.len;
+	if (big_int__mag_cmp(a, an, b, bn) < 0) {
+		if (quo) *quo = BIG_INT_ZERO;
+		if (rem) *rem = x;
+		return;
+	}
+
+	u64 *q = big_int__alloc(an);
+	u64 *r = big_int__alloc(bn+1);
+	if (bn == 1 && b[0] <= 0xffffffffull) {
+		r[0] = big_int__mag_div_small(q, a, an, cast(u32)b[0]);
+	} else {
+		big_int__mag_divmod(q, r, a, an, b, bn);
+	}
+
+	if (quo) {
+		*quo = big_int__from_limbs(q, an, x.neg != y.neg);
+	} else {
+		gb_free(heap_allocator(), q);
+	}
+	if (rem) {
+		*rem = big_int__from_limbs(r, bn+1, x.neg);
+	} else {
+		gb_free(heap_allocator(), r);
+	}
+}
+
+// NOTE: Writes the two's complement form of `x` into `n` limbs, which must leave room for the sign bit
+void big_int__to_twos(u64 *out, isize n, BigInt const *x) {
+	u64 const *a = big_int_limbs(x);
+	for (isize i = 0; i < n; i++) {
+		out[i] = i < x->len ? a[i] : 0;
+	}
+	if (x->neg) {
+		u64 carry = 1;
+		for (isize i = 0; i < n; i++) {
+			out[i] = ~out[i] + carry;
+			carry = carry && out[i] == 0;
+		}
+	}
+}
+
+BigInt big_int__from_twos(u64 *limbs, isize n) {
+	bool neg = (limbs[n-1] >> 63) != 0;
+	if (neg) {
+		u64 carry = 1;
+		for (isize i = 0; i < n; i++) {
+			limbs[i] = ~limbs[i] + carry;
+			carry = carry && limbs[i] == 0;
+		}
+	}
+	return big_int__from_limbs(limbs, n, neg);
+}
+
+enum BigIntBitOp {
+	BigIntBitOp_And,
+	BigIntBitOp_Or,
+	BigIntBitOp_Xor,
+	BigIntBitOp_AndNot,
+};
+
+u64 big_int__bit_op(BigIntBitOp op, u64 a, u64 b) {
+	switch (op) {
+	case BigIntBitOp_And:    return a & b;
+	case BigIntBitOp_Or:     return a | b;
+	case BigIntBitOp_Xor:    return a ^ b;
+	case BigIntBitOp_AndNot: return a & ~b;
+	}
+	return 0;
+}
+
+// NOTE: Bitwise operations behave as if the values were stored in infinitely wide two's complement
+BigInt big_int__bitwise(BigIntBitOp op, BigInt x, BigInt y) {
+	if (x.len <= 1 && y.len <= 1 && !x.neg && !y.neg) {
+		return big_int__small(big_int__bit_op(op, x.d.word, y.d.word), false);
+	}
+
+	isize n = gb_max(x.len, y.len) + 1;
+	u64 *a = big_int__alloc(n);
+	u64 *b = big_int__alloc(n);
+	big_int__to_twos(a, n, &x);
+	big_int__to_twos(b, n, &y);
+	for (isize i = 0; i < n; i++) {
+		a[i] = big_int__bit_op(op, a[i], b[i]);
+	}
+	gb_free(heap_allocator(), b);
+	return big_int__from_twos(a, n);
+}
+
+
+////////////////////////////////////////////////////////////////
+
+
+BigInt big_int_from_u64(u64 u) {
+	return big_int__small(u, false);
+}
+
+BigInt big_int_from_i64(i64 i) {
+	if (i < 0) {
+		return big_int__small(0ull - cast(u64)i, true);
+	}
+	return big_int__small(cast(u64)i, false);
+}
+
+BigInt big_int_from_u128(u128 u) {
+	if (u.hi == 0) {
+		return big_int_from_u64(u.lo);
+	}
+	u64 *limbs = big_int__alloc(2);
+	limbs[0] = u.lo;
+	limbs[1] = u.hi;
+	return big_int__from_limbs(limbs, 2, false);
+}
+
+// NOTE: Only succeeds if `f` is an integer value
+bool big_int_from_f64(f64 f, BigInt *out) {
+	if (f != f || f-f != 0 || floor(f) != f) {
+		return false;
+	}
+	bool neg = f < 0;
+	if (neg) {
+		f = -f;
+	}
+
+	BigInt r = {};
+	if (f < 18446744073709551616.0) {
+		r = big_int_from_u64(cast(u64)f);
+	} else {
+		int exp = 0;
+		f64 mantissa = frexp(f, &exp);
+		r = big_int_shl(big_int_from_u64(cast(u64)ldexp(mantissa, 64)), exp-64);
+	}
+	if (neg) {
+		r = big_int_neg(r);
+	}
+	if (out) *out = r;
+	return true;
+}
+
+BigInt big_int_from_string(String string) {
+	u64 base = 10;
+	bool has_prefix = false;
+	if (string.len > 2 && string[0] == '0') {
+		switch (string[1]) {
+		case 'b': base = 2;  has_prefix = true; break;
+		case 'o': base = 8;  has_prefix = true; break;
+		case 'd': base = 10; has_prefix = true; break;
+		case 'z': base = 12; has_prefix = true; break;
+		case 'x': base = 16; has_prefix = true; break;
+		}
+	}
+
+	u8 *text = string.text;
+	isize len = string.len;
+	if (has_prefix) {
+		text += 2;
+		len -= 2;
+	}
+
+	// NOTE: Accumulate in a single word and only switch to limbs once it overflows
+	u64 result = 0;
+	bool is_big = false;
+	BigInt big = {};
+	for (isize i = 0; i < len; i++) {
+		Rune r = cast(Rune)text[i];
+		if (r == '_') {
+			continue;
+		}
+		u64 v = bit128__digit_value(r);
+		if (v >= base) {
+			break;
+		}
+		if (!is_big) {
+			if (result <= (U64_MAX - v) / base) {
+				result = result*base + v;
+				continue;
+			}
+			big = big_int_from_u64(result);
+			is_big = true;
+		}
+		big = big_int_add(big_int_mul(big, big_int_from_u64(base)), big_int_from_u64(v));
+	}
+
+	if (is_big) {
+		return big;
+	}
+	return big_int_from_u64(result);
+}
+
+
+// NOTE: Truncates to the lower 64 bits of the two's complement value
+u64 big_int_to_u64(BigInt x) {
+	u64 lo = x.len > 0 ? big_int_limbs(&x)[0] : 0;
+	return x.neg ? 0ull - lo : lo;
+}
+
+i64 big_int_to_i64(BigInt x) {
+	return cast(i64)big_int_to_u64(x);
+}
+
+f64 big_int_to_f64(BigInt x) {
+	u64 const *a = big_int_limbs(&x);
+	f64 r = 0;
+	for (isize i = x.len-1; i >= 0; i--) {
+		r = r*18446744073709551616.0 + cast(f64)a[i];
+	}
+	return x.neg ? -r : r;
+}
+
+String big_int_to_string(gbAllocator allocator, BigInt x) {
+	isize cap = x.len*20 + 2;
+	u8 *buf = gb_alloc_array(allocator, u8, cap);
+	isize i = cap;
+
+	if (x.len <= 1) {
+		u64 v = x.d.word;
+		do {
+			buf[--i] = cast(u8)('0' + v%10);
+			v /= 10;
+		} while (v != 0);
+	} else {
+		isize n = x.len;
+		u64 *tmp = gb_alloc_array(heap_allocator(), u64, n);
+		gb_memcopy(tmp, x.d.words, n*gb_size_of(u64));
+		while (n > 0) {
+			u32 r = big_int__mag_div_small(tmp, tmp, n, 1000000000u);
+			while (n > 0 && tmp[n-1] == 0) {
+				n--;
+			}
+			for (isize j = 0; j < 9; j++) {
+				buf[--i] = cast(u8)('0' + r%10);
+				r /= 10;
+				if (n == 0 && r == 0) {
+					break;
+				}
+			}
+		}
+		gb_free(heap_allocator(), tmp);
+	}
+
+	if (x.neg) {
+		buf[--i] = '-';
+	}
+	// NOTE: Move the digits to the start so the string can be freed with `allocator`
+	gb_memmove(buf, buf+i, cap-i);
+	return make_string(buf, cap-i);
+}
+
+
+bool big_int_is_zero(BigInt x) {
+	return x.len == 0;
+}
+
+bool big_int_is_neg(BigInt x) {
+	return x.neg;
+}
+
+i32 big_int_cmp(BigInt x, BigInt y) {
+	if (x.neg != y.neg) {
+		return x.neg ? -1 : +1;
+	}
+	i32 c = 0;
+	if (x.len <= 1 && y.len <= 1) {
+		c = (x.d.word > y.d.word) - (x.d.word < y.d.word);
+	} else {
+		c = big_int__mag_cmp(big_int_limbs(&x), x.len, big_int_limbs(&y), y.len);
+	}
+	return x.neg ? -c : c;
+}
+
+i32 big_int_cmp_i64(BigInt x, i64 y) {
+	return big_int_cmp(x, big_int_from_i64(y));
+}
+
+
+BigInt big_int_neg(BigInt x) {
+	x.neg = !x.neg && x.len > 0;
+	return x;
+}
+
+BigInt big_int_abs(BigInt x) {
+	x.neg = false;
+	return x;
+}
+
+BigInt big_int_not(BigInt x) {
+	// NOTE: ~x == -x - 1
+	return big_int_sub(big_int_neg(x), big_int_from_u64(1));
+}
+
+BigInt big_int_add(BigInt x, BigInt y) {
+	if (x.len <= 1 && y.len <= 1) {
+		u64 a = x.d.word;
+		u64 b = y.d.word;
+		if (x.neg != y.neg) {
+			if (a >= b) {
+				return big_int__small(a-b, x.neg);
+			}
+			return big_int__small(b-a, y.neg);
+		}
+		if (a+b >= a) {
+			return big_int__small(a+b, x.neg);
+		}
+	}
+
+	u64 const *a = big_int_limbs(&x);
+	u64 const *b = big_int_limbs(&y);
+	isize an = x.len;
+	isize bn = y.len;
+	if (x.neg == y.neg) {
+		isize n = gb_max(an, bn)+1;
+		u64 *out = big_int__alloc(n);
+		big_int__mag_add(out, a, an, b, bn);
+		return big_int__from_limbs(out, n, x.neg);
+	}
+
+	i32 c = big_int__mag_cmp(a, an, b, bn);
+	if (c == 0) {
+		return BIG_INT_ZERO;
+	} else if (c > 0) {
+		u64 *out = big_int__alloc(an);
+		big_int__mag_sub(out, a, an, b, bn);
+		return big_int__from_limbs(out, an, x.neg);
+	}
+	u64 *out = big_int__alloc(bn);
+	big_int__mag_sub(out, b, bn, a, an);
+	return big_int__from_limbs(out, bn, y.neg);
+}
+
+BigInt big_int_sub(BigInt x, BigInt y) {
+	return big_int_add(x, big_int_neg(y));
+}
+
+BigInt big_int_mul(BigInt x, BigInt y) {
+	bool neg = x.neg != y.neg;
+	if (x.len == 0 || y.len == 0) {
+		return BIG_INT_ZERO;
+	}
+	if (x.len == 1 && y.len == 1) {
+		u64 hi = 0;
+		u64 lo = big_int__mul_word(x.d.word, y.d.word, &hi);
+		if (hi == 0) {
+			return big_int__small(lo, neg);
+		}
+		u64 *out = big_int__alloc(2);
+		out[0] = lo;
+		out[1] = hi;
+		return big_int__from_limbs(out, 2, neg);
+	}
+
+	isize n = x.len + y.len;
+	u64 *out = big_int__alloc(n);
+	big_int__mag_mul(out, big_int_limbs(&x), x.len, big_int_limbs(&y), y.len);
+	return big_int__from_limbs(out, n, neg);
+}
+
+// NOTE: Truncates towards zero
+BigInt big_int_quo(BigInt x, BigInt y) {
+	BigInt q = {};
+	big_int__divmod(x, y, &q, NULL);
+	return q;
+}
+
+// NOTE: Has the sign of the dividend
+BigInt big_int_rem(BigInt x, BigInt y) {
+	BigInt r = {};
+	big_int__divmod(x, y, NULL, &r);
+	return r;
+}
+
+BigInt big_int_and    (BigInt x, BigInt y) { return big_int__bitwise(BigIntBitOp_And,    x, y); }
+BigInt big_int_or     (BigInt x, BigInt y) { return big_int__bitwise(BigIntBitOp_Or,     x, y); }
+BigInt big_int_xor    (BigInt x, BigInt y) { return big_int__bitwise(BigIntBitOp_Xor,    x, y); }
+BigInt big_int_and_not(BigInt x, BigInt y) { return big_int__bitwise(BigIntBitOp_AndNot, x, y); }
+
+BigInt big_int_shl(BigInt x, u64 shift) {
+	if (x.len == 0 || shift == 0) {
+		return x;
+	}
+	if (x.len == 1 && shift < 64 && (x.d.word >> (63-shift)) >> 1 == 0) {
+		return big_int__small(x.d.word << shift, x.neg);
+	}
+
+	isize words = cast(isize)(shift/64);
+	u32 bits = cast(u32)(shift%64);
+	isize n = x.len + words + 1;
+	u64 const *a = big_int_limbs(&x);
+	u64 *out = big_int__alloc(n);
+	for (isize i = 0; i < x.len; i++) {
+		out[i+words] |= a[i] << bits;
+		if (bits != 0) {
+			out[i+words+1] |= a[i] >> (64-bits);
+		}
+	}
+	return big_int__from_limbs(out, n, x.neg);
+}
+
+// NOTE: Arithmetic shift, rounds towards negative infinity
+BigInt big_int_shr(BigInt x, u64 shift) {
+	if (x.len == 0 || shift == 0) {
+		return x;
+	}
+	if (x.neg) {
+		// NOTE: -x >> n == -((x-1) >> n) - 1
+		BigInt one = big_int_from_u64(1);
+		BigInt m = big_int_sub(big_int_neg(x), one);
+		return big_int_sub(big_int_neg(big_int_shr(m, shift)), one);
+	}
+	if (x.len == 1) {
+		return big_int__small(shift < 64 ? x.d.word >> shift : 0, false);
+	}
+
+	isize words = cast(isize)gb_min(shift/64, cast(u64)x.len);
+	u32 bits = cast(u32)(shift%64);
+	isize n = x.len - words;
+	if (n <= 0) {
+		return BIG_INT_ZERO;
+	}
+	u64 const *a = big_int_limbs(&x);
+	u64 *out = big_int__alloc(n);
+	for (isize i = 0; i < n; i++) {
+		u64 v = a[i+words] >> bits;
+		if (bits != 0 && i+words+1 < x.len) {
+			v |= a[i+words+1] << (64-bits);
+		}
+		out[i] = v;
+	}
+	return big_int__from_limbs(out, n, false);
+}
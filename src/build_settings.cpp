@@ -18,6 +18,14 @@ struct BuildContext {
 	bool   is_dll;
 	bool   generate_docs;
 	i32    optimization_level;
+	bool   optimize_for_size; // -opt=size
+	String target_cpu;        // -mcpu=<cpu>, passed to both `opt` and `llc`
+	bool   show_memory;
+	bool   show_timings;
+	String export_timings_file;
+	String trace_file;
+	bool   llvm_ir_only;
+	bool   use_ssa_backend; // NOTE: Custom backend instead of LLVM, only for linux/amd64
 };
 
 
@@ -340,18 +348,37 @@ void init_build_context(void) {
 	}
 
 
+	// NOTE: The optimization level selects the whole `opt` pass pipeline, not just the `llc` code generation
 	isize opt_max = 1023;
 	char *opt_flags_string = gb_alloc_array(heap_allocator(), char, opt_max+1);
 	isize opt_len = 0;
 	bc->optimization_level = gb_clamp(bc->optimization_level, 0, 3);
-	if (bc->optimization_level != 0) {
+	if (bc->optimize_for_size) {
+		// NOTE: `llc` has no size level, the size is decided by the `opt` pipeline
+		bc->optimization_level = 2;
+		opt_len = gb_snprintf(opt_flags_string, opt_max, "-Os");
+	} else if (bc->optimization_level != 0) {
 		opt_len = gb_snprintf(opt_flags_string, opt_max, "-O%d", bc->optimization_level);
 	} else {
-		opt_len = gb_snprintf(opt_flags_string, opt_max, "");
+		opt_len = gb_snprintf(opt_flags_string, opt_max, "-mem2reg -memcpyopt -dce");
 	}
 	if (opt_len > 0) {
 		opt_len--;
 	}
+	if (bc->target_cpu.len > 0) {
+		opt_len += gb_snprintf(opt_flags_string+opt_len, opt_max-opt_len, " -mcpu=%.*s", LIT(bc->target_cpu));
+		if (opt_len > 0) {
+			opt_len--;
+		}
+
+		isize llc_max = bc->llc_flags.len + bc->target_cpu.len + 16;
+		char *llc_flags_string = gb_alloc_array(heap_allocator(), char, llc_max+1);
+		isize llc_len = gb_snprintf(llc_flags_string, llc_max, "%.*s-mcpu=%.*s", LIT(bc->llc_flags), LIT(bc->target_cpu));
+		if (llc_len > 0) {
+			llc_len--;
+		}
+		bc->llc_flags = make_string(cast(u8 *)llc_flags_string, llc_len);
+	}
 	bc->opt_flags = make_string(cast(u8 *)opt_flags_string, opt_len);
 
 
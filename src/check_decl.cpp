@@ -78,7 +78,7 @@ void check_init_variables(Checker *c, Entity **lhs, isize lhs_count, Array<AstNo
 	}
 
 
-	gbTempArenaMemory tmp = gb_temp_arena_memory_begin(&c->tmp_arena);
+	DynamicArenaTempMemory tmp = dynamic_arena_temp_memory_begin(&c->tmp_arena);
 
 	// NOTE(bill): If there is a bad syntax error, rhs > lhs which would mean there would need to be
 	// an extra allocation
@@ -102,7 +102,7 @@ void check_init_variables(Checker *c, Entity **lhs, isize lhs_count, Array<AstNo
 	}
 
 
-	gb_temp_arena_memory_end(tmp);
+	dynamic_arena_temp_memory_end(tmp);
 }
 
 void check_init_constant(Checker *c, Entity *e, Operand *operand) {
@@ -116,6 +116,14 @@ void check_init_constant(Checker *c, Entity *e, Operand *operand) {
 	}
 
 	if (operand->mode != Addressing_Constant) {
+		if (unparen_expr(operand->expr)->kind == AstNode_RunExpr) {
+			// NOTE: #run expressions are only executed once the whole program has been checked
+			error(operand->expr, "`#run` results can only initialise variables, not constants");
+			if (e->type == NULL) {
+				e->type = t_invalid;
+			}
+			return;
+		}
 		// TODO(bill): better error
 		gbString str = expr_to_string(operand->expr);
 		error(operand->expr, "`%s` is not a constant", str);
@@ -337,6 +345,7 @@ void check_proc_decl(Checker *c, Entity *e, DeclInfo *d) {
 	bool is_inline          = (pd->tags & ProcTag_inline)    != 0;
 	bool is_no_inline       = (pd->tags & ProcTag_no_inline) != 0;
 	bool is_require_results = (pd->tags & ProcTag_require_results) != 0;
+	bool is_printf          = (pd->tags & ProcTag_printf)    != 0;
 
 
 	TypeProc *pt = &proc_type->Proc;
@@ -363,6 +372,10 @@ void check_proc_decl(Checker *c, Entity *e, DeclInfo *d) {
 		error(pd->type, "A foreign procedure cannot have an `export` tag");
 	}
 
+	if (is_printf && !is_printf_procedure_type(proc_type)) {
+		error(pd->type, "`#printf` expects a procedure whose last parameters are `(fmt: string, args: ..any)`");
+	}
+
 
 	if (pt->is_generic) {
 		if (pd->body == NULL) {
@@ -546,6 +559,9 @@ void check_entity_decl(Checker *c, Entity *e, DeclInfo *d, Type *named_type) {
 		}
 	}
 
+	isize trace = trace_begin(str_lit("check_entity_decl"), e->token.string);
+	defer (trace_end(trace));
+
 	CheckerContext prev = c->context;
 	c->context.scope = d->scope;
 	c->context.decl  = d;
@@ -586,6 +602,9 @@ void check_proc_body(Checker *c, Token token, DeclInfo *decl, Type *type, AstNod
 		proc_name = str_lit("(anonymous-procedure)");
 	}
 
+	isize trace = trace_begin(str_lit("check_proc_body"), proc_name);
+	defer (trace_end(trace));
+
 	CheckerContext old_context = c->context;
 	c->context.scope = decl->scope;
 	c->context.decl = decl;
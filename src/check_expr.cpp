@@ -434,7 +434,7 @@ void populate_using_entity_map(Checker *c, AstNode *node, Type *t, Map<Entity *>
 isize check_fields(Checker *c, AstNode *node, Array<AstNode *> decls,
                    Entity **fields, isize field_count,
                    String context) {
-	gbTempArenaMemory tmp = gb_temp_arena_memory_begin(&c->tmp_arena);
+	DynamicArenaTempMemory tmp = dynamic_arena_temp_memory_begin(&c->tmp_arena);
 
 	Map<Entity *> entity_map = {};
 	map_init_with_reserve(&entity_map, c->tmp_allocator, 2*field_count);
@@ -534,7 +534,7 @@ isize check_fields(Checker *c, AstNode *node, Array<AstNode *> decls,
 		}
 	}
 
-	gb_temp_arena_memory_end(tmp);
+	dynamic_arena_temp_memory_end(tmp);
 
 	return field_index;
 }
@@ -658,7 +658,7 @@ void check_struct_type(Checker *c, Type *struct_type, AstNode *node) {
 		Type *type = base_type(o.type);
 		if (is_type_untyped(type) || is_type_integer(type)) {
 			if (o.value.kind == ExactValue_Integer) {
-				i64 align = i128_to_i64(o.value.value_integer);
+				i64 align = big_int_to_i64(o.value.value_integer);
 				if (align < 1 || !gb_is_power_of_two(align)) {
 					error(st->align, "#align must be a power of 2, got %lld", align);
 					return;
@@ -694,7 +694,7 @@ void check_union_type(Checker *c, Type *named_type, Type *union_type, AstNode *n
 		}
 	}
 
-	gbTempArenaMemory tmp = gb_temp_arena_memory_begin(&c->tmp_arena);
+	DynamicArenaTempMemory tmp = dynamic_arena_temp_memory_begin(&c->tmp_arena);
 
 	Map<Entity *> entity_map = {}; // Key: String
 	map_init_with_reserve(&entity_map, c->tmp_allocator, 2*variant_count);
@@ -796,7 +796,7 @@ void check_union_type(Checker *c, Type *named_type, Type *union_type, AstNode *n
 
 	type_set_offsets(c->allocator, union_type);
 
-	gb_temp_arena_memory_end(tmp);
+	dynamic_arena_temp_memory_end(tmp);
 
 	union_type->Record.variants      = variants;
 	union_type->Record.variant_count = variant_index;
@@ -831,7 +831,7 @@ void check_enum_type(Checker *c, Type *enum_type, Type *named_type, AstNode *nod
 	ast_node(et, EnumType, node);
 	GB_ASSERT(is_type_enum(enum_type));
 
-	gbTempArenaMemory tmp = gb_temp_arena_memory_begin(&c->tmp_arena);
+	DynamicArenaTempMemory tmp = dynamic_arena_temp_memory_begin(&c->tmp_arena);
 
 	Type *base_type = t_int;
 	if (et->base_type != NULL) {
@@ -947,7 +947,7 @@ void check_enum_type(Checker *c, Type *enum_type, Type *named_type, AstNode *nod
 		}
 	}
 	GB_ASSERT(field_count <= et->fields.count);
-	gb_temp_arena_memory_end(tmp);
+	dynamic_arena_temp_memory_end(tmp);
 
 
 	enum_type->Record.fields = fields;
@@ -968,7 +968,7 @@ void check_bit_field_type(Checker *c, Type *bit_field_type, Type *named_type, As
 	ast_node(bft, BitFieldType, node);
 	GB_ASSERT(is_type_bit_field(bit_field_type));
 
-	gbTempArenaMemory tmp = gb_temp_arena_memory_begin(&c->tmp_arena);
+	DynamicArenaTempMemory tmp = dynamic_arena_temp_memory_begin(&c->tmp_arena);
 
 
 	Map<Entity *> entity_map = {}; // Key: String
@@ -1003,7 +1003,7 @@ void check_bit_field_type(Checker *c, Type *bit_field_type, Type *named_type, As
 			error(value, "Bit field bit size must be a constant integer");
 			continue;
 		}
-		i64 bits = i128_to_i64(v.value_integer);
+		i64 bits = big_int_to_i64(v.value_integer);
 		if (bits < 0 || bits > 128) {
 			error(value, "Bit field's bit size must be within the range 1..<128, got %lld", cast(long long)bits);
 			continue;
@@ -1032,7 +1032,7 @@ void check_bit_field_type(Checker *c, Type *bit_field_type, Type *named_type, As
 		}
 	}
 	GB_ASSERT(field_count <= bft->fields.count);
-	gb_temp_arena_memory_end(tmp);
+	dynamic_arena_temp_memory_end(tmp);
 
 	bit_field_type->BitField.fields      = fields;
 	bit_field_type->BitField.field_count = field_count;
@@ -1053,7 +1053,7 @@ void check_bit_field_type(Checker *c, Type *bit_field_type, Type *named_type, As
 		Type *type = base_type(o.type);
 		if (is_type_untyped(type) || is_type_integer(type)) {
 			if (o.value.kind == ExactValue_Integer) {
-				i64 align = i128_to_i64(o.value.value_integer);
+				i64 align = big_int_to_i64(o.value.value_integer);
 				if (align < 1 || !gb_is_power_of_two(align)) {
 					error(bft->align, "#align must be a power of 2, got %lld", align);
 					return;
@@ -1451,6 +1451,10 @@ Type *type_to_abi_compat_param_type(gbAllocator a, Type *original_type) {
 	} else if (build_context.ODIN_OS == "linux" ||
 	           build_context.ODIN_OS == "osx") {
 		Type *bt = core_type(original_type);
+		if (is_type_simd_vector(bt) && type_size_of(a, original_type) <= 16) {
+			// NOTE: Passed by value in a single SSE register like `__m128`
+			return new_type;
+		}
 		switch (bt->kind) {
 		// Okay to pass by value (usually)
 		// Especially the only Odin types
@@ -1700,7 +1704,7 @@ Entity *check_ident(Checker *c, Operand *o, AstNode *n, Type *named_type, Type *
 		Entity **procs = gb_alloc_array(heap_allocator(), Entity *, overload_count);
 		multi_map_get_all(&s->elements, key, procs);
 		if (type_hint != NULL) {
-			gbTempArenaMemory tmp = gb_temp_arena_memory_begin(&c->tmp_arena);
+			DynamicArenaTempMemory tmp = dynamic_arena_temp_memory_begin(&c->tmp_arena);
 			// NOTE(bill): These should be done
 			for (isize i = 0; i < overload_count; i++) {
 				Type *t = base_type(procs[i]->type);
@@ -1717,7 +1721,7 @@ Entity *check_ident(Checker *c, Operand *o, AstNode *n, Type *named_type, Type *
 					break;
 				}
 			}
-			gb_temp_arena_memory_end(tmp);
+			dynamic_arena_temp_memory_end(tmp);
 
 		}
 
@@ -1834,7 +1838,7 @@ i64 check_array_or_map_count(Checker *c, AstNode *e, bool is_map) {
 	Type *type = base_type(o.type);
 	if (is_type_untyped(type) || is_type_integer(type)) {
 		if (o.value.kind == ExactValue_Integer) {
-			i64 count = i128_to_i64(o.value.value_integer);
+			i64 count = big_int_to_i64(o.value.value_integer);
 			if (is_map) {
 				if (count > 0) {
 					return count;
@@ -1906,8 +1910,7 @@ void check_map_type(Checker *c, Type *type, AstNode *node) {
 
 		/*
 		struct {
-			hash:  Map_Key,
-			next:  int,
+			hash:  u64,
 			key:   Key_Type,
 			value: Value_Type,
 		}
@@ -1918,9 +1921,9 @@ void check_map_type(Checker *c, Type *type, AstNode *node) {
 
 		isize field_count = 3;
 		Entity **fields = gb_alloc_array(a, Entity *, field_count);
-		fields[0] = make_entity_field(a, c->context.scope, make_token_ident(str_lit("key")),   t_map_key, false, 0);
-		fields[1] = make_entity_field(a, c->context.scope, make_token_ident(str_lit("next")),  t_int,     false, 1);
-		fields[2] = make_entity_field(a, c->context.scope, make_token_ident(str_lit("value")), value,     false, 2);
+		fields[0] = make_entity_field(a, c->context.scope, make_token_ident(str_lit("hash")),  t_u64, false, 0);
+		fields[1] = make_entity_field(a, c->context.scope, make_token_ident(str_lit("key")),   key,   false, 1);
+		fields[2] = make_entity_field(a, c->context.scope, make_token_ident(str_lit("value")), value, false, 2);
 
 		check_close_scope(c);
 
@@ -1937,7 +1940,7 @@ void check_map_type(Checker *c, Type *type, AstNode *node) {
 
 		/*
 		struct {
-			hashes:  [dynamic]int,
+			slots:   [dynamic]u64,
 			entries; [dynamic]Entry_Type,
 		}
 		*/
@@ -1945,12 +1948,12 @@ void check_map_type(Checker *c, Type *type, AstNode *node) {
 		dummy_node->kind = AstNode_Invalid;
 		check_open_scope(c, dummy_node);
 
-		Type *hashes_type  = make_type_dynamic_array(a, t_int);
+		Type *slots_type   = make_type_dynamic_array(a, t_u64);
 		Type *entries_type = make_type_dynamic_array(a, type->Map.entry_type);
 
 		isize field_count = 2;
 		Entity **fields = gb_alloc_array(a, Entity *, field_count);
-		fields[0] = make_entity_field(a, c->context.scope, make_token_ident(str_lit("hashes")),  hashes_type,  false, 0);
+		fields[0] = make_entity_field(a, c->context.scope, make_token_ident(str_lit("slots")),   slots_type,   false, 0);
 		fields[1] = make_entity_field(a, c->context.scope, make_token_ident(str_lit("entries")), entries_type, false, 1);
 
 		check_close_scope(c);
@@ -2375,17 +2378,11 @@ bool check_representable_as_constant(Checker *c, ExactValue in_value, Type *type
 			return true;
 		}
 
-		i128 i = v.value_integer;
-		u128 u = *cast(u128 *)&i;
+		BigInt i = v.value_integer;
 		i64 s = 8*type_size_of(c->allocator, type);
-		u128 umax = U128_NEG_ONE;
-		if (s < 128) {
-			umax = u128_sub(u128_shl(U128_ONE, s), U128_ONE);
-		} else {
-			// IMPORTANT TODO(bill): I NEED A PROPER BIG NUMBER LIBRARY THAT CAN SUPPORT 128 bit floats
-			s = 128;
-		}
-		i128 imax = i128_shl(I128_ONE, s-1ll);
+		BigInt one = big_int_from_u64(1);
+		BigInt umax = big_int_sub(big_int_shl(one, s), one);
+		BigInt imax = big_int_shl(one, s-1ll);
 
 		switch (type->Basic.kind) {
 		case Basic_rune:
@@ -2395,7 +2392,7 @@ bool check_representable_as_constant(Checker *c, ExactValue in_value, Type *type
 		case Basic_i64:
 		case Basic_i128:
 		case Basic_int:
-			return i128_le(i128_neg(imax), i) && i128_le(i, i128_sub(imax, I128_ONE));
+			return big_int_cmp(big_int_neg(imax), i) <= 0 && big_int_cmp(i, imax) < 0;
 
 		case Basic_u8:
 		case Basic_u16:
@@ -2403,7 +2400,7 @@ bool check_representable_as_constant(Checker *c, ExactValue in_value, Type *type
 		case Basic_u64:
 		case Basic_u128:
 		case Basic_uint:
-			return !(u128_lt(u, U128_ZERO) || u128_gt(u, umax));
+			return !big_int_is_neg(i) && big_int_cmp(i, umax) <= 0;
 
 		case Basic_UntypedInteger:
 			return true;
@@ -2474,15 +2471,9 @@ void check_is_expressible(Checker *c, Operand *o, Type *type) {
 			if (!is_type_integer(o->type) && is_type_integer(type)) {
 				error(o->expr, "`%s` truncated to `%s`", a, b);
 			} else {
-				char buf[127] = {};
-				String str = {};
-				i128 i = o->value.value_integer;
-				if (is_type_unsigned(o->type)) {
-					str = u128_to_string(*cast(u128 *)&i, buf, gb_size_of(buf));
-				} else {
-					str = i128_to_string(i, buf, gb_size_of(buf));
-				}
-				error(o->expr, "`%s = %.*s` overflows `%s`", a, str, b);
+				String str = big_int_to_string(heap_allocator(), o->value.value_integer);
+				error(o->expr, "`%s = %.*s` overflows `%s`", a, LIT(str), b);
+				gb_free(heap_allocator(), str.text);
 			}
 		} else {
 			error(o->expr, "Cannot convert `%s` to `%s`", a, b);
@@ -2610,7 +2601,7 @@ void check_comparison(Checker *c, Operand *x, Operand *y, TokenKind op) {
 	}
 
 	gbString err_str = NULL;
-	gbTempArenaMemory tmp = gb_temp_arena_memory_begin(&c->tmp_arena);
+	DynamicArenaTempMemory tmp = dynamic_arena_temp_memory_begin(&c->tmp_arena);
 	if (check_is_assignable_to(c, x, y->type) ||
 	    check_is_assignable_to(c, y, x->type)) {
 		Type *err_type = x->type;
@@ -2663,6 +2654,25 @@ void check_comparison(Checker *c, Operand *x, Operand *y, TokenKind op) {
 
 			update_expr_type(c, x->expr, default_type(x->type), true);
 			update_expr_type(c, y->expr, default_type(y->type), true);
+
+			// NOTE: These comparisons are calls into the runtime
+			Type *t = base_type(default_type(is_type_untyped(x->type) ? y->type : x->type));
+			if (is_type_string(t)) {
+				switch (op) {
+				case Token_CmpEq: add_preload_dependency(c, "__string_eq"); break;
+				case Token_NotEq: add_preload_dependency(c, "__string_ne"); break;
+				case Token_Lt:    add_preload_dependency(c, "__string_lt"); break;
+				case Token_Gt:    add_preload_dependency(c, "__string_gt"); break;
+				case Token_LtEq:  add_preload_dependency(c, "__string_le"); break;
+				case Token_GtEq:  add_preload_dependency(c, "__string_ge"); break;
+				}
+			} else if (is_type_complex(t)) {
+				bool is_64 = type_size_of(c->allocator, t) == 8;
+				switch (op) {
+				case Token_CmpEq: add_preload_dependency(c, is_64 ? cast(char *)"__complex64_eq" : cast(char *)"__complex128_eq"); break;
+				case Token_NotEq: add_preload_dependency(c, is_64 ? cast(char *)"__complex64_ne" : cast(char *)"__complex128_ne"); break;
+				}
+			}
 		}
 
 		if (is_type_vector(base_type(y->type))) {
@@ -2675,7 +2685,7 @@ void check_comparison(Checker *c, Operand *x, Operand *y, TokenKind op) {
 	if (err_str != NULL) {
 		gb_string_free(err_str);
 	}
-	gb_temp_arena_memory_end(tmp);
+	dynamic_arena_temp_memory_end(tmp);
 }
 
 void check_shift(Checker *c, Operand *x, Operand *y, AstNode *node) {
@@ -2724,7 +2734,7 @@ void check_shift(Checker *c, Operand *x, Operand *y, AstNode *node) {
 				return;
 			}
 
-			i64 amount = i128_to_i64(y_val.value_integer);
+			i64 amount = big_int_to_i64(y_val.value_integer);
 			if (amount > 128) {
 				gbString err_str = expr_to_string(y->expr);
 				error(node, "Shift amount too large: `%s`", err_str);
@@ -2759,7 +2769,7 @@ void check_shift(Checker *c, Operand *x, Operand *y, AstNode *node) {
 		}
 	}
 
-	if (y->mode == Addressing_Constant && i128_lt(y->value.value_integer, I128_ZERO)) {
+	if (y->mode == Addressing_Constant && big_int_is_neg(y->value.value_integer)) {
 		gbString err_str = expr_to_string(y->expr);
 		error(node, "Shift amount cannot be negative: `%s`", err_str);
 		gb_string_free(err_str);
@@ -2840,7 +2850,7 @@ Operand check_ptr_addition(Checker *c, TokenKind op, Operand *ptr, Operand *offs
 
 	if (ptr->mode == Addressing_Constant && offset->mode == Addressing_Constant) {
 		i64 ptr_val = ptr->value.value_pointer;
-		i64 offset_val = i128_to_i64(exact_value_to_integer(offset->value).value_integer);
+		i64 offset_val = big_int_to_i64(exact_value_to_integer(offset->value).value_integer);
 		i64 new_ptr_val = ptr_val;
 		if (op == Token_Add) {
 			new_ptr_val += elem_size*offset_val;
@@ -3143,7 +3153,7 @@ void check_binary_expr(Checker *c, Operand *x, AstNode *node) {
 			bool fail = false;
 			switch (y->value.kind) {
 			case ExactValue_Integer:
-				if (i128_eq(y->value.value_integer, I128_ZERO)) {
+				if (big_int_is_zero(y->value.value_integer)) {
 					fail = true;
 				}
 				break;
@@ -3275,7 +3285,7 @@ void convert_untyped_error(Checker *c, Operand *operand, Type *target_type) {
 	char *extra_text = "";
 
 	if (operand->mode == Addressing_Constant) {
-		if (i128_eq(operand->value.value_integer, I128_ZERO)) {
+		if (big_int_is_zero(operand->value.value_integer)) {
 			if (make_string_c(expr_str) != "nil") { // HACK NOTE(bill): Just in case
 				// NOTE(bill): Doesn't matter what the type is as it's still zero in the union
 				extra_text = " - Did you want `nil`?";
@@ -3305,6 +3315,37 @@ ExactValue convert_exact_value_for_type(ExactValue v, Type *type) {
 	return v;
 }
 
+// NOTE: Returns NULL if the element type cannot be packed
+PackedArray *make_packed_array(gbAllocator a, Type *elem_type, i64 count) {
+	Type *t = core_type(elem_type);
+	if (t->kind != Type_Basic || is_type_untyped(t) || count <= 0) {
+		return NULL;
+	}
+	PackedElemKind kind = PackedElem_Int;
+	if (is_type_boolean(t)) {
+		kind = PackedElem_Bool;
+	} else if (is_type_float(t)) {
+		kind = PackedElem_Float;
+	} else if (is_type_integer(t) || is_type_rune(t)) {
+		kind = is_type_unsigned(t) ? PackedElem_Uint : PackedElem_Int;
+	} else {
+		return NULL;
+	}
+	i64 elem_size = type_size_of(a, t);
+	if (elem_size <= 0 || elem_size > 8) {
+		return NULL;
+	}
+
+	PackedArray *packed = gb_alloc_item(a, PackedArray);
+	packed->elem_type = elem_type;
+	packed->elem_kind = kind;
+	packed->elem_size = elem_size;
+	packed->count     = count;
+	packed->data      = gb_alloc_array(a, u8, count*elem_size);
+	gb_zero_size(packed->data, count*elem_size);
+	return packed;
+}
+
 // NOTE(bill): Set initial level to 0
 void convert_to_typed(Checker *c, Operand *operand, Type *target_type, i32 level) {
 	GB_ASSERT_NOT_NULL(target_type);
@@ -3427,7 +3468,7 @@ bool check_index_value(Checker *c, bool open_range, AstNode *index_value, i64 ma
 
 	if (operand.mode == Addressing_Constant &&
 	    (c->context.stmt_state_flags & StmtStateFlag_no_bounds_check) == 0) {
-		i64 i = i128_to_i64(exact_value_to_integer(operand.value).value_integer);
+		i64 i = big_int_to_i64(exact_value_to_integer(operand.value).value_integer);
 		if (i < 0) {
 			gbString expr_str = expr_to_string(operand.expr);
 			error(operand.expr, "Index `%s` cannot be a negative value", expr_str);
@@ -3661,7 +3702,7 @@ Entity *check_selector(Checker *c, Operand *operand, AstNode *node, Type *type_h
 				operand->expr = node;
 				return NULL;
 			}
-			i64 index = i128_to_i64(o.value.value_integer);
+			i64 index = big_int_to_i64(o.value.value_integer);
 			if (index < 0) {
 				error(o.expr, "Index %lld cannot be a negative value", index);
 				operand->mode = Addressing_Invalid;
@@ -3772,6 +3813,13 @@ Entity *check_selector(Checker *c, Operand *operand, AstNode *node, Type *type_h
 	return entity;
 }
 
+// NOTE: Hashing a string key needs the runtime, other keys are hashed inline
+void add_map_key_dependency(Checker *c, Type *key) {
+	if (is_type_string(key)) {
+		add_preload_dependency(c, "__default_hash_string");
+	}
+}
+
 bool check_builtin_procedure(Checker *c, Operand *operand, AstNode *call, i32 id) {
 	GB_ASSERT(call->kind == AstNode_CallExpr);
 	ast_node(ce, CallExpr, call);
@@ -3853,6 +3901,7 @@ bool check_builtin_procedure(Checker *c, Operand *operand, AstNode *call, i32 id
 		}
 
 
+		add_preload_dependency(c, "make_source_code_location");
 		operand->type = t_source_code_location;
 		operand->mode = Addressing_Value;
 	} break;
@@ -4009,6 +4058,17 @@ bool check_builtin_procedure(Checker *c, Operand *operand, AstNode *call, i32 id
 			// No need quit
 		}
 
+		if (is_type_slice(type)) {
+			add_preload_dependency(c, "alloc");
+			add_preload_dependency(c, "__slice_expr_error");
+		} else if (is_type_dynamic_map(type)) {
+			add_preload_dependency(c, "__dynamic_map_reserve");
+		} else {
+			add_preload_dependency(c, "__dynamic_array_make");
+			add_preload_dependency(c, "__dynamic_array_make_stack");
+			add_preload_dependency(c, "__slice_expr_error");
+		}
+
 		operand->mode = Addressing_Value;
 		operand->type = type;
 	} break;
@@ -4039,6 +4099,11 @@ bool check_builtin_procedure(Checker *c, Operand *operand, AstNode *call, i32 id
 			return false;
 		}
 
+		if (is_type_dynamic_array(type) || is_type_dynamic_map(type)) {
+			add_preload_dependency(c, "free_ptr_with_allocator");
+		} else {
+			add_preload_dependency(c, "free_ptr");
+		}
 
 		operand->mode = Addressing_NoValue;
 	} break;
@@ -4067,6 +4132,12 @@ bool check_builtin_procedure(Checker *c, Operand *operand, AstNode *call, i32 id
 			return false;
 		}
 
+		if (is_type_dynamic_array(type)) {
+			add_preload_dependency(c, "__dynamic_array_reserve");
+		} else {
+			add_preload_dependency(c, "__dynamic_map_reserve");
+		}
+
 		operand->type = NULL;
 		operand->mode = Addressing_NoValue;
 	} break;
@@ -4130,6 +4201,11 @@ bool check_builtin_procedure(Checker *c, Operand *operand, AstNode *call, i32 id
 		if (prev_operand.mode == Addressing_Invalid) {
 			return false;
 		}
+		if (is_type_dynamic_array(type)) {
+			add_preload_dependency(c, "__dynamic_array_append");
+		} else {
+			add_preload_dependency(c, "__slice_append");
+		}
 		operand->mode = Addressing_Value;
 		operand->type = t_int;
 	} break;
@@ -4162,6 +4238,9 @@ bool check_builtin_procedure(Checker *c, Operand *operand, AstNode *call, i32 id
 			return false;
 		}
 
+		add_map_key_dependency(c, key);
+		add_preload_dependency(c, "__dynamic_map_delete");
+
 		operand->mode = Addressing_NoValue;
 	} break;
 
@@ -4352,6 +4431,8 @@ bool check_builtin_procedure(Checker *c, Operand *operand, AstNode *call, i32 id
 			return false;
 		}
 
+		add_preload_dependency(c, "__mem_copy");
+
 		operand->type = t_int; // Returns number of elems copied
 		operand->mode = Addressing_Value;
 	} break;
@@ -4369,7 +4450,6 @@ bool check_builtin_procedure(Checker *c, Operand *operand, AstNode *call, i32 id
 		}
 
 		isize max_count = vector_type->Vector.count;
-		i128 max_count128 = i128_from_i64(max_count);
 		isize arg_count = 0;
 		for_array(i, ce->args) {
 			if (i == 0) {
@@ -4387,12 +4467,12 @@ bool check_builtin_procedure(Checker *c, Operand *operand, AstNode *call, i32 id
 				return false;
 			}
 
-			if (i128_lt(op.value.value_integer, I128_ZERO)) {
+			if (big_int_is_neg(op.value.value_integer)) {
 				error(op.expr, "Negative `swizzle` index");
 				return false;
 			}
 
-			if (i128_le(max_count128, op.value.value_integer)) {
+			if (big_int_cmp_i64(op.value.value_integer, max_count) >= 0) {
 				error(op.expr, "`swizzle` index exceeds vector length");
 				return false;
 			}
@@ -4761,7 +4841,7 @@ bool check_builtin_procedure(Checker *c, Operand *operand, AstNode *call, i32 id
 		if (operand->mode == Addressing_Constant) {
 			switch (operand->value.kind) {
 			case ExactValue_Integer:
-				operand->value.value_integer = i128_abs(operand->value.value_integer);
+				operand->value.value_integer = big_int_abs(operand->value.value_integer);
 				break;
 			case ExactValue_Float:
 				operand->value.value_float = gb_abs(operand->value.value_float);
@@ -4777,6 +4857,12 @@ bool check_builtin_procedure(Checker *c, Operand *operand, AstNode *call, i32 id
 			}
 		} else {
 			operand->mode = Addressing_Value;
+			if (is_type_complex(operand->type)) {
+				switch (8*type_size_of(c->allocator, operand->type)) {
+				case 64:  add_preload_dependency(c, "__abs_complex64");  break;
+				case 128: add_preload_dependency(c, "__abs_complex128"); break;
+				}
+			}
 		}
 
 		if (is_type_complex(operand->type)) {
@@ -4873,6 +4959,254 @@ bool check_builtin_procedure(Checker *c, Operand *operand, AstNode *call, i32 id
 		}
 	} break;
 
+	case BuiltinProc_shuffle: {
+		// proc shuffle(a, b: {N}T, indices: ..int) -> {M}T
+		Type *vector_type = base_type(operand->type);
+		if (!is_type_simd_vector(vector_type)) {
+			gbString type_str = type_to_string(operand->type);
+			error(call, "You can only `shuffle` an integer or float vector, got `%s`", type_str);
+			gb_string_free(type_str);
+			return false;
+		}
+
+		Operand b = {};
+		check_expr(c, &b, ce->args[1]);
+		if (b.mode == Addressing_Invalid) {
+			return false;
+		}
+		if (!are_types_identical(operand->type, b.type)) {
+			gbString type_a = type_to_string(operand->type);
+			gbString type_b = type_to_string(b.type);
+			error(call, "Mismatched types to `shuffle`, `%s` vs `%s`", type_a, type_b);
+			gb_string_free(type_b);
+			gb_string_free(type_a);
+			return false;
+		}
+
+		// NOTE: Indices in [N, 2N) select from the second vector
+		isize max_count = 2*vector_type->Vector.count;
+		isize arg_count = 0;
+		for (isize i = 2; i < ce->args.count; i++) {
+			AstNode *arg = ce->args[i];
+			Operand op = {};
+			check_expr(c, &op, arg);
+			if (op.mode == Addressing_Invalid) {
+				return false;
+			}
+			Type *arg_type = base_type(op.type);
+			if (!is_type_integer(arg_type) || op.mode != Addressing_Constant) {
+				error(op.expr, "Indices to `shuffle` must be constant integers");
+				return false;
+			}
+
+			if (big_int_is_neg(op.value.value_integer)) {
+				error(op.expr, "Negative `shuffle` index");
+				return false;
+			}
+
+			if (big_int_cmp_i64(op.value.value_integer, max_count) >= 0) {
+				error(op.expr, "`shuffle` index exceeds the length of both vectors");
+				return false;
+			}
+
+			arg_count++;
+		}
+
+		Type *elem_type = vector_type->Vector.elem;
+		operand->type = make_type_vector(c->allocator, elem_type, arg_count);
+		operand->mode = Addressing_Value;
+	} break;
+
+	case BuiltinProc_reduce_add:
+	case BuiltinProc_reduce_min:
+	case BuiltinProc_reduce_max: {
+		// proc reduce_add(v: {N}T) -> T
+		if (!is_type_simd_vector(operand->type)) {
+			gbString type_str = type_to_string(operand->type);
+			error(call, "Expected an integer or float vector to `%.*s`, got `%s`", LIT(bp->name), type_str);
+			gb_string_free(type_str);
+			return false;
+		}
+
+		operand->type = base_vector_type(operand->type);
+		operand->mode = Addressing_Value;
+	} break;
+
+	case BuiltinProc_fma: {
+		// proc fma(a, b, c: float_type) -> float_type
+		Operand x = *operand;
+		Operand y = {};
+		Operand z = {};
+
+		check_expr(c, &y, ce->args[1]);
+		if (y.mode == Addressing_Invalid) {
+			return false;
+		}
+		check_expr(c, &z, ce->args[2]);
+		if (z.mode == Addressing_Invalid) {
+			return false;
+		}
+
+		convert_to_typed(c, &x, y.type, 0);
+		if (x.mode == Addressing_Invalid) { return false; }
+		convert_to_typed(c, &y, x.type, 0);
+		if (y.mode == Addressing_Invalid) { return false; }
+		convert_to_typed(c, &x, z.type, 0);
+		if (x.mode == Addressing_Invalid) { return false; }
+		convert_to_typed(c, &z, x.type, 0);
+		if (z.mode == Addressing_Invalid) { return false; }
+		convert_to_typed(c, &y, z.type, 0);
+		if (y.mode == Addressing_Invalid) { return false; }
+		if (is_type_untyped(x.type)) {
+			Type *t = default_type(x.type);
+			convert_to_typed(c, &x, t, 0);
+			if (x.mode == Addressing_Invalid) { return false; }
+			convert_to_typed(c, &y, t, 0);
+			if (y.mode == Addressing_Invalid) { return false; }
+			convert_to_typed(c, &z, t, 0);
+			if (z.mode == Addressing_Invalid) { return false; }
+		}
+
+		if (!are_types_identical(x.type, y.type) || !are_types_identical(x.type, z.type)) {
+			gbString type_x = type_to_string(x.type);
+			gbString type_y = type_to_string(y.type);
+			gbString type_z = type_to_string(z.type);
+			error(call,
+			      "Mismatched types to `fma`, `%s`, `%s`, `%s`",
+			      type_x, type_y, type_z);
+			gb_string_free(type_z);
+			gb_string_free(type_y);
+			gb_string_free(type_x);
+			return false;
+		}
+
+		if (!is_type_float(base_vector_type(x.type))) {
+			gbString type_str = type_to_string(x.type);
+			error(call, "Expected a float or float vector type to `fma`, got `%s`", type_str);
+			gb_string_free(type_str);
+			return false;
+		}
+
+		operand->type = x.type;
+		operand->mode = Addressing_Value;
+	} break;
+
+	case BuiltinProc_select: {
+		// proc select(mask: {N}bool, a, b: {N}T) -> {N}T
+		Type *mask_type = base_type(operand->type);
+		if (!is_type_vector(mask_type) ||
+		    !(is_type_boolean(mask_type->Vector.elem) || is_type_integer(mask_type->Vector.elem))) {
+			gbString type_str = type_to_string(operand->type);
+			error(call, "Expected a boolean or integer vector mask to `select`, got `%s`", type_str);
+			gb_string_free(type_str);
+			return false;
+		}
+
+		Operand a = {};
+		Operand b = {};
+		check_expr(c, &a, ce->args[1]);
+		if (a.mode == Addressing_Invalid) {
+			return false;
+		}
+		check_expr(c, &b, ce->args[2]);
+		if (b.mode == Addressing_Invalid) {
+			return false;
+		}
+
+		convert_to_typed(c, &a, b.type, 0);
+		if (a.mode == Addressing_Invalid) { return false; }
+		convert_to_typed(c, &b, a.type, 0);
+		if (b.mode == Addressing_Invalid) { return false; }
+
+		if (!are_types_identical(a.type, b.type)) {
+			gbString type_a = type_to_string(a.type);
+			gbString type_b = type_to_string(b.type);
+			error(call, "Mismatched types to `select`, `%s` vs `%s`", type_a, type_b);
+			gb_string_free(type_b);
+			gb_string_free(type_a);
+			return false;
+		}
+
+		if (!is_type_simd_vector(a.type)) {
+			gbString type_str = type_to_string(a.type);
+			error(call, "Expected integer or float vectors to `select`, got `%s`", type_str);
+			gb_string_free(type_str);
+			return false;
+		}
+
+		if (base_type(a.type)->Vector.count != mask_type->Vector.count) {
+			error(call, "Mismatched lane counts to `select`, %lld vs %lld",
+			      mask_type->Vector.count, base_type(a.type)->Vector.count);
+			return false;
+		}
+
+		operand->type = a.type;
+		operand->mode = Addressing_Value;
+	} break;
+
+	case BuiltinProc_gather:
+	case BuiltinProc_scatter: {
+		// proc gather(s: []T, indices: {N}int) -> {N}T
+		// proc scatter(s: []T, indices: {N}int, values: {N}T)
+		Type *slice_type = base_type(operand->type);
+		if (!is_type_slice(slice_type)) {
+			gbString type_str = type_to_string(operand->type);
+			error(call, "Expected a slice to `%.*s`, got `%s`", LIT(bp->name), type_str);
+			gb_string_free(type_str);
+			return false;
+		}
+		Type *elem_type = slice_type->Slice.elem;
+		if (!is_type_integer(elem_type) && !is_type_float(elem_type)) {
+			gbString type_str = type_to_string(elem_type);
+			error(call, "`%.*s` requires a slice of integers or floats, got `[]%s`", LIT(bp->name), type_str);
+			gb_string_free(type_str);
+			return false;
+		}
+
+		Operand indices = {};
+		check_expr(c, &indices, ce->args[1]);
+		if (indices.mode == Addressing_Invalid) {
+			return false;
+		}
+		if (!is_type_simd_vector(indices.type) || !is_type_integer(base_vector_type(indices.type))) {
+			gbString type_str = type_to_string(indices.type);
+			error(indices.expr, "Expected an integer vector of indices to `%.*s`, got `%s`", LIT(bp->name), type_str);
+			gb_string_free(type_str);
+			return false;
+		}
+
+		// NOTE: Every lane is bounds checked against the length of the slice
+		add_preload_dependency(c, "__bounds_check_error");
+
+		Type *vector_type = make_type_vector(c->allocator, elem_type, base_type(indices.type)->Vector.count);
+		if (id == BuiltinProc_gather) {
+			operand->type = vector_type;
+			operand->mode = Addressing_Value;
+			break;
+		}
+
+		Operand values = {};
+		check_expr(c, &values, ce->args[2]);
+		if (values.mode == Addressing_Invalid) {
+			return false;
+		}
+		convert_to_typed(c, &values, vector_type, 0);
+		if (values.mode == Addressing_Invalid) {
+			return false;
+		}
+		if (!are_types_identical(base_type(values.type), vector_type)) {
+			gbString type_str = type_to_string(values.type);
+			gbString expected = type_to_string(vector_type);
+			error(values.expr, "Expected `%s` values to `scatter`, got `%s`", expected, type_str);
+			gb_string_free(expected);
+			gb_string_free(type_str);
+			return false;
+		}
+
+		operand->type = NULL;
+		operand->mode = Addressing_NoValue;
+	} break;
+
 	case BuiltinProc_transmute: {
 		Operand op = {};
 		check_expr_or_type(c, &op, ce->args[0]);
@@ -4922,6 +5256,60 @@ bool check_builtin_procedure(Checker *c, Operand *operand, AstNode *call, i32 id
 		o->mode = Addressing_Value;
 		o->type = t;
 	} break;
+
+	case BuiltinProc_load: {
+		// #load(path: string) -> [N]u8
+		// NOTE: The file's bytes are used as the packed constant data directly, no per byte nodes are made
+		if (operand->mode != Addressing_Constant || operand->value.kind != ExactValue_String) {
+			gbString str = expr_to_string(ce->args[0]);
+			error(ce->args[0], "`#load` expected a constant string path, got `%s`", str);
+			gb_string_free(str);
+			return false;
+		}
+		String file_str = operand->value.value_string;
+		String base_dir = ast_node_token(call).pos.file;
+		while (base_dir.len > 0 &&
+		       base_dir[base_dir.len-1] != '\\' &&
+		       base_dir[base_dir.len-1] != '/') {
+			base_dir.len--;
+		}
+
+		gbAllocator a = heap_allocator();
+		String path = get_fullpath_relative(a, base_dir, file_str);
+		if (!gb_file_exists(cast(char *)path.text)) { // NOTE: This is null terminated
+			error(ce->args[0], "`#load` could not find the file `%.*s`", LIT(file_str));
+			return false;
+		}
+		// NOTE: A directory can be opened but not read so the whole file must be read back
+		gbFile f = {};
+		if (gb_file_open(&f, cast(char *)path.text) != gbFileError_None) {
+			error(ce->args[0], "`#load` could not open the file `%.*s`", LIT(path));
+			return false;
+		}
+		defer (gb_file_close(&f));
+		isize size = cast(isize)gb_file_size(&f);
+		u8 *data = NULL;
+		if (size > 0) {
+			data = cast(u8 *)gb_alloc(a, size);
+			isize bytes_read = 0;
+			if (!gb_file_read_at_check(&f, data, size, 0, &bytes_read) || bytes_read != size) {
+				error(ce->args[0], "`#load` could not read the file `%.*s`", LIT(path));
+				gb_free(a, data);
+				return false;
+			}
+		}
+
+		PackedArray *packed = gb_alloc_item(c->allocator, PackedArray);
+		packed->elem_type = t_u8;
+		packed->elem_kind = PackedElem_Uint;
+		packed->elem_size = 1;
+		packed->count     = size;
+		packed->data      = data;
+
+		operand->mode  = Addressing_Constant;
+		operand->value = exact_value_packed(packed);
+		operand->type  = make_type_array(c->allocator, t_u8, size);
+	} break;
 	}
 
 	return true;
@@ -4999,7 +5387,10 @@ Entity *find_or_generate_polymorphic_procedure(Checker *c, Entity *base_entity,
 	DeclInfo *old_decl = decl_info_of_entity(&c->info, base_entity);
 	GB_ASSERT(old_decl != NULL);
 
-	gbAllocator a = heap_allocator();
+	isize trace = trace_begin(str_lit("find_or_generate_polymorphic_procedure"), base_entity->token.string);
+	defer (trace_end(trace));
+
+	gbAllocator a = c->allocator;
 
 	CheckerContext prev_context = c->context;
 	defer (c->context = prev_context);
@@ -5110,6 +5501,9 @@ CALL_ARGUMENT_CHECKER(check_call_arguments_internal) {
 			}
 
 			GB_ASSERT(e->kind == Entity_Variable);
+			if (e->Variable.default_is_location) {
+				add_preload_dependency(c, "make_source_code_location");
+			}
 			if (e->Variable.default_value.kind != ExactValue_Invalid ||
 			    e->Variable.default_is_nil ||
 			    e->Variable.default_is_location) {
@@ -5312,8 +5706,8 @@ CALL_ARGUMENT_CHECKER(check_named_call_arguments) {
 	bool show_error = show_error_mode == CallArgumentMode_ShowErrors;
 	CallArgumentError err = CallArgumentError_None;
 
-	gbTempArenaMemory tmp = gb_temp_arena_memory_begin(&c->tmp_arena);
-	defer (gb_temp_arena_memory_end(tmp));
+	DynamicArenaTempMemory tmp = dynamic_arena_temp_memory_begin(&c->tmp_arena);
+	defer (dynamic_arena_temp_memory_end(tmp));
 
 	isize param_count = pt->param_count;
 	bool *visited = gb_alloc_array(c->tmp_allocator, bool, param_count);
@@ -5587,6 +5981,293 @@ Entity *find_using_index_expr(Type *t) {
 	return NULL;
 }
 
+// NOTE: A piece of a constant `#printf` format string, either literal text or one `%` directive
+struct FormatVerb {
+	String text; // Literal text, when `verb` is 0
+	Rune   verb;
+	bool   plus, minus, space, zero, hash;
+	bool   width_set, prec_set;
+	i64    width, prec;
+};
+
+enum FormatParseResult {
+	FormatParse_Ok,
+	FormatParse_Dynamic, // Uses `*` or `[n]`, which depend on the arguments at run time
+	FormatParse_NoVerb,
+};
+
+i64 parse_format_int(String fmt, isize *offset, bool *ok) {
+	i64 n = 0;
+	*ok = false;
+	while (*offset < fmt.len && gb_char_is_digit(fmt[*offset])) {
+		n = n*10 + (fmt[*offset] - '0');
+		*ok = true;
+		*offset += 1;
+	}
+	return n;
+}
+
+// NOTE: Follows the grammar `sbprintf` in core/fmt.odin accepts at run time
+FormatParseResult parse_format_string(String fmt, Array<FormatVerb> *verbs) {
+	isize i = 0;
+	while (i < fmt.len) {
+		isize start = i;
+		while (i < fmt.len && fmt[i] != '%') {
+			i++;
+		}
+		if (i > start) {
+			FormatVerb text = {};
+			text.text = make_string(fmt.text+start, i-start);
+			array_add(verbs, text);
+		}
+		if (i >= fmt.len) {
+			break;
+		}
+		i++;
+
+		FormatVerb v = {};
+		for (; i < fmt.len; i++) {
+			switch (fmt[i]) {
+			case '+': v.plus  = true;                  continue;
+			case '-': v.minus = true; v.zero = false;  continue;
+			case ' ': v.space = true;                  continue;
+			case '#': v.hash  = true;                  continue;
+			case '0': v.zero  = !v.minus;              continue;
+			}
+			break;
+		}
+
+		if (i < fmt.len && (fmt[i] == '[' || fmt[i] == '*')) {
+			return FormatParse_Dynamic;
+		}
+		v.width = parse_format_int(fmt, &i, &v.width_set);
+		if (i < fmt.len && fmt[i] == '.') {
+			i++;
+			if (i < fmt.len && (fmt[i] == '[' || fmt[i] == '*')) {
+				return FormatParse_Dynamic;
+			}
+			v.prec = parse_format_int(fmt, &i, &v.prec_set);
+		}
+		if (i < fmt.len && fmt[i] == '[') {
+			return FormatParse_Dynamic;
+		}
+
+		if (i >= fmt.len) {
+			return FormatParse_NoVerb;
+		}
+		isize width = gb_utf8_decode(fmt.text+i, fmt.len-i, &v.verb);
+		if (v.verb == '%') {
+			v.verb = 0;
+			v.text = make_string(fmt.text+i, width);
+		}
+		i += width;
+		array_add(verbs, v);
+	}
+	return FormatParse_Ok;
+}
+
+// NOTE: Whether the `fmt_*` procedure used at run time for `type` accepts `verb`
+bool is_format_verb_valid(Type *type, Rune verb) {
+	if (verb == 'v' || verb == 'T') {
+		return true;
+	}
+	Type *t = base_type(default_type(type));
+	if (t->kind != Type_Basic) {
+		return true;
+	}
+	if (is_type_boolean(t)) {
+		return verb == 't';
+	}
+	if (is_type_rune(t)) {
+		return verb == 'c' || verb == 'r';
+	}
+	if (is_type_integer(t)) {
+		switch (verb) {
+		case 'b': case 'o': case 'd': case 'x': case 'X': case 'c': case 'r': case 'U':
+			return true;
+		}
+		return false;
+	}
+	if (is_type_float(t) || is_type_complex(t)) {
+		return verb == 'f' || verb == 'F';
+	}
+	if (is_type_string(t)) {
+		return verb == 's' || verb == 'x' || verb == 'X';
+	}
+	return true;
+}
+
+bool is_printf_procedure_type(Type *t) {
+	t = base_type(t);
+	if (t == NULL || t->kind != Type_Proc || !t->Proc.variadic || t->Proc.c_vararg || t->Proc.param_count < 2) {
+		return false;
+	}
+	Entity **params = t->Proc.params->Tuple.variables;
+	isize n = t->Proc.param_count;
+	Type *args = base_type(params[n-1]->type);
+	return is_type_string(params[n-2]->type) &&
+	       args->kind == Type_Slice && is_type_any(args->Slice.elem);
+}
+
+Entity *entity_of_call_proc(CheckerInfo *info, AstNode *proc) {
+	proc = unparen_expr(proc);
+	if (proc->kind == AstNode_SelectorExpr) {
+		proc = proc->SelectorExpr.selector;
+	}
+	if (proc->kind != AstNode_Ident) {
+		return NULL;
+	}
+	return entity_of_ident(info, proc);
+}
+
+// NOTE: The fmt procedures a `#printf` call with a constant format is lowered to
+// All of them are looked up in the scope of the `#printf` procedure
+struct PrintfHelpers {
+	Entity *flush;        // `_<name>_flush`, which takes the rendered `^StringBuffer`
+	Entity *make_buffer;  // `make_string_buffer_from_slice`
+	Entity *buffer_size;  // `_BUFFER_SIZE`
+	Entity *fmt_info;     // `FmtInfo`
+	Entity *write_string;
+	Entity *fmt_bool;
+	Entity *fmt_rune;
+	Entity *fmt_int;
+	Entity *fmt_float;
+	Entity *fmt_string;
+	Entity *fmt_arg;
+};
+
+bool find_printf_helpers(Entity *e, PrintfHelpers *h) {
+	Scope *s = e->scope;
+	if (s == NULL) {
+		return false;
+	}
+	String flush_name = make_string_c(gb_bprintf("_%.*s_flush", LIT(e->token.string)));
+	h->flush        = current_scope_lookup_entity(s, flush_name);
+	h->make_buffer  = current_scope_lookup_entity(s, str_lit("make_string_buffer_from_slice"));
+	h->buffer_size  = current_scope_lookup_entity(s, str_lit("_BUFFER_SIZE"));
+	h->fmt_info     = current_scope_lookup_entity(s, str_lit("FmtInfo"));
+	h->write_string = current_scope_lookup_entity(s, str_lit("write_string"));
+	h->fmt_bool     = current_scope_lookup_entity(s, str_lit("fmt_bool"));
+	h->fmt_rune     = current_scope_lookup_entity(s, str_lit("fmt_rune"));
+	h->fmt_int      = current_scope_lookup_entity(s, str_lit("fmt_int"));
+	h->fmt_float    = current_scope_lookup_entity(s, str_lit("fmt_float"));
+	h->fmt_string   = current_scope_lookup_entity(s, str_lit("fmt_string"));
+	h->fmt_arg      = current_scope_lookup_entity(s, str_lit("fmt_arg"));
+
+	Entity *procs[] = {h->flush, h->make_buffer, h->write_string, h->fmt_bool, h->fmt_rune,
+	                   h->fmt_int, h->fmt_float, h->fmt_string, h->fmt_arg};
+	for (isize i = 0; i < gb_count_of(procs); i++) {
+		if (procs[i] == NULL || procs[i]->kind != Entity_Procedure || procs[i]->type == NULL) {
+			return false;
+		}
+	}
+	if (h->buffer_size == NULL || h->buffer_size->kind != Entity_Constant ||
+	    h->fmt_info == NULL || h->fmt_info->kind != Entity_TypeName) {
+		return false;
+	}
+
+	// NOTE: The flush takes the leading parameters of the `#printf` procedure then the buffer
+	TypeProc *pt = &base_type(e->type)->Proc;
+	TypeProc *ft = &base_type(h->flush->type)->Proc;
+	isize lead_count = pt->param_count-2;
+	if (ft->param_count != lead_count+1 || !are_types_identical(pt->results, ft->results)) {
+		return false;
+	}
+	for (isize i = 0; i < lead_count; i++) {
+		if (!are_types_identical(pt->params->Tuple.variables[i]->type, ft->params->Tuple.variables[i]->type)) {
+			return false;
+		}
+	}
+	return is_type_pointer(ft->params->Tuple.variables[lead_count]->type);
+}
+
+// NOTE: Checks the arguments of a `#printf` call against its constant format string and,
+// if fmt provides the procedures to do so, records the call to be lowered to typed writes
+// NOTE: The arguments of the call have not been finalized yet, so untyped constants
+// are still in `untyped` rather than `types`
+Type *check_printf_arg_type(Checker *c, AstNode *arg, ExactValue *value_) {
+	ExprInfo *found = check_get_expr_info(&c->info, arg);
+	if (found != NULL) {
+		if (value_) *value_ = found->value;
+		return found->type;
+	}
+	if (value_) *value_ = type_and_value_of_expr(&c->info, arg).value;
+	return type_of_expr(&c->info, arg);
+}
+
+void check_printf_call(Checker *c, AstNode *call, Entity *e) {
+	ast_node(ce, CallExpr, call);
+	if (ce->ellipsis.pos.line != 0 || is_call_expr_field_value(ce)) {
+		return;
+	}
+	isize format_index = base_type(e->type)->Proc.param_count-2;
+	if (ce->args.count <= format_index) {
+		return;
+	}
+	AstNode *format = ce->args[format_index];
+	ExactValue value = {};
+	check_printf_arg_type(c, format, &value);
+	if (value.kind != ExactValue_String) {
+		return;
+	}
+
+	Array<FormatVerb> verbs = {};
+	array_init(&verbs, heap_allocator());
+	defer (array_free(&verbs));
+
+	switch (parse_format_string(value.value_string, &verbs)) {
+	case FormatParse_Dynamic:
+		return;
+	case FormatParse_NoVerb:
+		error(format, "Missing verb at the end of the format string");
+		return;
+	}
+
+	for (isize i = format_index+1; i < ce->args.count; i++) {
+		Type *t = check_printf_arg_type(c, ce->args[i], NULL);
+		if (t == NULL || t->kind == Type_Tuple) {
+			return;
+		}
+	}
+
+	isize arg_index = format_index+1;
+	for_array(i, verbs) {
+		Rune verb = verbs[i].verb;
+		if (verb == 0) {
+			continue;
+		}
+		u8 verb_text[4] = {};
+		isize verb_len = gb_utf8_encode_rune(verb_text, verb);
+		if (arg_index >= ce->args.count) {
+			error(format, "Missing argument for `%%%.*s` in the format string", cast(int)verb_len, verb_text);
+			return;
+		}
+		AstNode *arg = ce->args[arg_index++];
+		Type *t = check_printf_arg_type(c, arg, NULL);
+		if (!is_format_verb_valid(t, verb)) {
+			gbString type_str = type_to_string(t);
+			error(arg, "Invalid verb `%%%.*s` for a value of type `%s`", cast(int)verb_len, verb_text, type_str);
+			gb_string_free(type_str);
+		}
+	}
+	if (arg_index < ce->args.count) {
+		error(ce->args[arg_index], "Too many arguments for the format string, expected %td, got %td",
+		      arg_index-format_index-1, ce->args.count-format_index-1);
+		return;
+	}
+
+	PrintfHelpers h = {};
+	if (!find_printf_helpers(e, &h)) {
+		return;
+	}
+	Entity *deps[] = {h.flush, h.make_buffer, h.write_string, h.fmt_bool, h.fmt_rune,
+	                  h.fmt_int, h.fmt_float, h.fmt_string, h.fmt_arg};
+	for (isize i = 0; i < gb_count_of(deps); i++) {
+		add_declaration_dependency(c, deps[i]);
+	}
+	map_set(&c->info.printf_calls, hash_node(call), h.flush);
+}
+
 ExprKind check_call_expr(Checker *c, Operand *operand, AstNode *call) {
 	GB_ASSERT(call->kind == AstNode_CallExpr);
 	ast_node(ce, CallExpr, call);
@@ -5594,9 +6275,13 @@ ExprKind check_call_expr(Checker *c, Operand *operand, AstNode *call) {
 	    ce->proc->kind == AstNode_BasicDirective) {
 		ast_node(bd, BasicDirective, ce->proc);
 		String name = bd->name;
-		GB_ASSERT(name == "location");
 		operand->mode = Addressing_Builtin;
-		operand->builtin_id = BuiltinProc_DIRECTIVE;
+		if (name == "load") {
+			operand->builtin_id = BuiltinProc_load;
+		} else {
+			GB_ASSERT(name == "location");
+			operand->builtin_id = BuiltinProc_DIRECTIVE;
+		}
 		operand->expr = ce->proc;
 		operand->type = t_invalid;
 		add_type_and_value(&c->info, ce->proc, operand->mode, operand->type, operand->value);
@@ -5701,6 +6386,12 @@ ExprKind check_call_expr(Checker *c, Operand *operand, AstNode *call) {
 	if (data.gen_entity != NULL) {
 		add_entity_use(c, ce->proc, data.gen_entity);
 	}
+	if (result_type != t_invalid) {
+		Entity *e = entity_of_call_proc(&c->info, ce->proc);
+		if (e != NULL && e->kind == Entity_Procedure && (e->Procedure.tags & ProcTag_printf) != 0) {
+			check_printf_call(c, call, e);
+		}
+	}
 	gb_zero_item(operand);
 	operand->expr = call;
 
@@ -6018,6 +6709,7 @@ ExprKind check_expr_base_internal(Checker *c, Operand *o, AstNode *node, Type *t
 		Type *type = type_hint;
 		bool is_to_be_determined_array_count = false;
 		bool is_constant = true;
+		ExactValue packed_value = {};
 		if (cl->type != NULL) {
 			type = NULL;
 
@@ -6191,6 +6883,10 @@ ExprKind check_expr_base_internal(Checker *c, Operand *o, AstNode *node, Type *t
 				elem_type = t->DynamicArray.elem;
 				context_name = str_lit("dynamic array literal");
 				is_constant = false;
+				if (cl->elems.count > 0) {
+					add_preload_dependency(c, "__dynamic_array_reserve");
+					add_preload_dependency(c, "__dynamic_array_append");
+				}
 			} else {
 				GB_PANIC("unreachable");
 			}
@@ -6204,6 +6900,11 @@ ExprKind check_expr_base_internal(Checker *c, Operand *o, AstNode *node, Type *t
 				is_constant = false;
 			}
 
+			PackedArray *packed = NULL;
+			if (is_constant && (t->kind == Type_Array || t->kind == Type_Slice)) {
+				packed = make_packed_array(c->allocator, elem_type, gb_max(elem_count, max_type_count));
+			}
+
 			for (; index < elem_count; index++) {
 				GB_ASSERT(cl->elems.data != NULL);
 				AstNode *e = cl->elems[index];
@@ -6228,10 +6929,16 @@ ExprKind check_expr_base_internal(Checker *c, Operand *o, AstNode *node, Type *t
 				if (is_constant) {
 					is_constant = operand.mode == Addressing_Constant;
 				}
+				if (is_constant && packed != NULL && index < packed->count) {
+					packed_array_set(packed, index, operand.value);
+				}
 			}
 			if (max < index) {
 				max = index;
 			}
+			if (is_constant && packed != NULL) {
+				packed_value = exact_value_packed(packed);
+			}
 
 			if (t->kind == Type_Vector) {
 				if (t->Vector.count > 1 && gb_is_between(index, 2, t->Vector.count-1)) {
@@ -6328,6 +7035,9 @@ ExprKind check_expr_base_internal(Checker *c, Operand *o, AstNode *node, Type *t
 				break;
 			}
 			is_constant = false;
+			add_map_key_dependency(c, t->Map.key);
+			add_preload_dependency(c, "__dynamic_map_reserve");
+			add_preload_dependency(c, "__dynamic_map_set");
 			{ // Checker values
 				for_array(i, cl->elems) {
 					AstNode *elem = cl->elems[i];
@@ -6359,6 +7069,9 @@ ExprKind check_expr_base_internal(Checker *c, Operand *o, AstNode *node, Type *t
 		if (is_constant) {
 			o->mode = Addressing_Constant;
 			o->value = exact_value_compound(node);
+			if (packed_value.kind == ExactValue_Packed) {
+				o->value = packed_value;
+			}
 		} else {
 			o->mode = Addressing_Value;
 		}
@@ -6380,9 +7093,26 @@ ExprKind check_expr_base_internal(Checker *c, Operand *o, AstNode *node, Type *t
 	case_end;
 
 	case_ast_node(re, RunExpr, node);
-		// TODO(bill): Tag expressions
 		kind = check_expr_base(c, o, re->expr, type_hint);
 		o->expr = node;
+		if (o->mode == Addressing_Invalid || o->mode == Addressing_Constant) {
+			return kind;
+		}
+		if (o->mode == Addressing_NoValue) {
+			error(node, "#run expression does not produce a value");
+			o->mode = Addressing_Invalid;
+			return kind;
+		}
+		if (!is_type_cte_safe(o->type)) {
+			gbString type_str = type_to_string(o->type);
+			error(node, "`%s` cannot be the result of a #run expression", type_str);
+			gb_string_free(type_str);
+			o->mode = Addressing_Invalid;
+			return kind;
+		}
+		// NOTE: The result is folded into a constant by the compile time execution stage
+		array_add(&c->info.run_exprs, node);
+		o->mode = Addressing_Value;
 	case_end;
 
 	case_ast_node(ta, TypeAssertion, node);
@@ -6453,6 +7183,7 @@ ExprKind check_expr_base_internal(Checker *c, Operand *o, AstNode *node, Type *t
 
 			add_type_info_type(c, o->type);
 			add_type_info_type(c, t);
+			add_preload_dependency(c, "__type_assertion_check");
 
 			o->type = t;
 			o->mode = Addressing_OptionalOk;
@@ -6462,6 +7193,7 @@ ExprKind check_expr_base_internal(Checker *c, Operand *o, AstNode *node, Type *t
 
 			add_type_info_type(c, o->type);
 			add_type_info_type(c, t);
+			add_preload_dependency(c, "__type_assertion_check");
 		} else {
 			error(o->expr, "Type assertions can only operate on unions");
 			o->mode = Addressing_Invalid;
@@ -6519,6 +7251,9 @@ ExprKind check_expr_base_internal(Checker *c, Operand *o, AstNode *node, Type *t
 				o->expr = node;
 				return kind;
 			}
+			add_map_key_dependency(c, t->Map.key);
+			add_preload_dependency(c, "__dynamic_map_get");
+			add_preload_dependency(c, "__dynamic_map_set");
 			o->mode = Addressing_MapIndex;
 			o->type = t->Map.value;
 			o->expr = node;
@@ -6563,7 +7298,7 @@ ExprKind check_expr_base_internal(Checker *c, Operand *o, AstNode *node, Type *t
 
 		i64 index = 0;
 		bool ok = check_index_value(c, false, ie->index, max_count, &index);
-
+		add_preload_dependency(c, "__bounds_check_error");
 	case_end;
 
 
@@ -6633,6 +7368,12 @@ ExprKind check_expr_base_internal(Checker *c, Operand *o, AstNode *node, Type *t
 			o->mode = Addressing_Value;
 		}
 
+		if (is_type_string(t)) {
+			add_preload_dependency(c, "__substring_expr_error");
+		} else {
+			add_preload_dependency(c, "__slice_expr_error");
+		}
+
 		if (se->low == NULL && se->high != NULL) {
 			error(se->interval0, "1st index is required if a 2nd index is specified");
 			// It is okay to continue as it will assume the 1st index is zero
@@ -6884,6 +7625,11 @@ gbString write_expr_to_string(gbString str, AstNode *node) {
 		str = write_expr_to_string(str, te->expr);
 	case_end;
 
+	case_ast_node(re, RunExpr, node);
+		str = gb_string_appendc(str, "#run ");
+		str = write_expr_to_string(str, re->expr);
+	case_end;
+
 	case_ast_node(ue, UnaryExpr, node);
 		str = string_append_token(str, ue->op);
 		str = write_expr_to_string(str, ue->expr);
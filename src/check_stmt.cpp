@@ -262,16 +262,12 @@ Type *check_assignment_variable(Checker *c, Operand *rhs, AstNode *lhs_node) {
 			if (rhs->mode == Addressing_Constant) {
 				ExactValue v = exact_value_to_integer(rhs->value);
 				if (v.kind == ExactValue_Integer) {
-					i128 i = v.value_integer;
-					u128 u = *cast(u128 *)&i;
-					u128 umax = U128_NEG_ONE;
-					if (lhs_bits < 128) {
-						umax = u128_sub(u128_shl(U128_ONE, lhs_bits), U128_ONE);
-					}
-					i128 imax = i128_shl(I128_ONE, lhs_bits-1ll);
+					BigInt i = v.value_integer;
+					BigInt one = big_int_from_u64(1);
+					BigInt umax = big_int_sub(big_int_shl(one, lhs_bits), one);
 
 					bool ok = false;
-					ok = !(u128_lt(u, U128_ZERO) || u128_gt(u, umax));
+					ok = !big_int_is_neg(i) && big_int_cmp(i, umax) <= 0;
 
 					if (ok) {
 						return rhs->type;
@@ -682,7 +678,7 @@ void check_stmt_internal(Checker *c, AstNode *node, u32 flags) {
 				return;
 			}
 
-			gbTempArenaMemory tmp = gb_temp_arena_memory_begin(&c->tmp_arena);
+			DynamicArenaTempMemory tmp = dynamic_arena_temp_memory_begin(&c->tmp_arena);
 
 			// NOTE(bill): If there is a bad syntax error, rhs > lhs which would mean there would need to be
 			// an extra allocation
@@ -705,7 +701,7 @@ void check_stmt_internal(Checker *c, AstNode *node, u32 flags) {
 				error(as->lhs[0], "Assignment count mismatch `%td` = `%td`", lhs_count, rhs_count);
 			}
 
-			gb_temp_arena_memory_end(tmp);
+			dynamic_arena_temp_memory_end(tmp);
 		} break;
 
 		default: {
@@ -1067,6 +1063,7 @@ void check_stmt_internal(Checker *c, AstNode *node, u32 flags) {
 					val = operand.type;
 					idx = t_int;
 					add_type_info_type(c, operand.type);
+					add_preload_dependency(c, "__type_assertion_check");
 					goto skip_expr;
 				}
 			} else if (operand.mode != Addressing_Invalid) {
@@ -1076,6 +1073,7 @@ void check_stmt_internal(Checker *c, AstNode *node, u32 flags) {
 					if (is_type_string(t)) {
 						val = t_rune;
 						idx = t_int;
+						add_preload_dependency(c, "__string_decode_rune");
 					}
 					break;
 				case Type_Array:
@@ -1199,6 +1197,11 @@ void check_stmt_internal(Checker *c, AstNode *node, u32 flags) {
 			gb_string_free(str);
 			break;
 		}
+		if (is_type_string(x.type)) {
+			// NOTE: A match on constant strings may dispatch on the hash of the tag
+			add_preload_dependency(c, "__default_hash_string");
+			add_preload_dependency(c, "__mem_equal");
+		}
 
 
 		// NOTE(bill): Check for multiple defaults
@@ -1323,7 +1326,7 @@ void check_stmt_internal(Checker *c, AstNode *node, u32 flags) {
 						HashKey key = hash_exact_value(y.value);
 						TypeAndToken *found = map_get(&seen, key);
 						if (found != NULL) {
-							gbTempArenaMemory tmp = gb_temp_arena_memory_begin(&c->tmp_arena);
+							DynamicArenaTempMemory tmp = dynamic_arena_temp_memory_begin(&c->tmp_arena);
 							isize count = multi_map_count(&seen, key);
 							TypeAndToken *taps = gb_alloc_array(c->tmp_allocator, TypeAndToken, count);
 
@@ -1346,7 +1349,7 @@ void check_stmt_internal(Checker *c, AstNode *node, u32 flags) {
 								}
 							}
 
-							gb_temp_arena_memory_end(tmp);
+							dynamic_arena_temp_memory_end(tmp);
 
 							if (continue_outer) {
 								continue;
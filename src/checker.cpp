@@ -63,8 +63,19 @@ enum BuiltinProcId {
 	BuiltinProc_abs,
 	BuiltinProc_clamp,
 
+	BuiltinProc_shuffle,
+	BuiltinProc_reduce_add,
+	BuiltinProc_reduce_min,
+	BuiltinProc_reduce_max,
+	BuiltinProc_fma,
+	BuiltinProc_select,
+	BuiltinProc_gather,
+	BuiltinProc_scatter,
+
 	BuiltinProc_transmute,
 
+	BuiltinProc_load, // NOTE: #load("path"), which has no name within the universe scope
+
 	BuiltinProc_DIRECTIVE, // NOTE(bill): This is used for specialized hash-prefixed procedures
 
 	BuiltinProc_COUNT,
@@ -111,8 +122,19 @@ gb_global BuiltinProc builtin_procs[BuiltinProc_COUNT] = {
 	{STR_LIT("abs"),              1, false, Expr_Expr},
 	{STR_LIT("clamp"),            3, false, Expr_Expr},
 
+	{STR_LIT("shuffle"),          3, true,  Expr_Expr},
+	{STR_LIT("reduce_add"),       1, false, Expr_Expr},
+	{STR_LIT("reduce_min"),       1, false, Expr_Expr},
+	{STR_LIT("reduce_max"),       1, false, Expr_Expr},
+	{STR_LIT("fma"),              3, false, Expr_Expr},
+	{STR_LIT("select"),           3, false, Expr_Expr},
+	{STR_LIT("gather"),           2, false, Expr_Expr},
+	{STR_LIT("scatter"),          3, false, Expr_Stmt},
+
 	{STR_LIT("transmute"),        2, false, Expr_Expr},
 
+	{STR_LIT(""),                 1, false, Expr_Expr}, // load
+
 	{STR_LIT(""),                 0, true,  Expr_Expr}, // DIRECTIVE
 };
 
@@ -282,6 +304,8 @@ struct CheckerInfo {
 	Map<AstFile *>        files;           // Key: String (full path)
 	Map<isize>            type_info_map;   // Key: Type *
 	isize                 type_info_count;
+	Array<AstNode *>      run_exprs;       // #run expressions to execute at compile time
+	Map<Entity *>         printf_calls;    // Key: AstNode * | `#printf` call with a constant format -> its flush procedure
 };
 
 struct Checker {
@@ -296,8 +320,8 @@ struct Checker {
 	Array<DelayedDecl>         delayed_foreign_libraries;
 	Array<CheckerFileNode>     file_nodes;
 
-	gbArena                    arena;
-	gbArena                    tmp_arena;
+	DynamicArena               arena;
+	DynamicArena               tmp_arena;
 	gbAllocator                allocator;
 	gbAllocator                tmp_allocator;
 
@@ -611,6 +635,15 @@ void add_declaration_dependency(Checker *c, Entity *e) {
 	}
 }
 
+// NOTE: Used for the runtime procedures within the preload which the backend calls implicitly
+// e.g. `__bounds_check_error`, `__dynamic_map_get`, so that only those which are needed are generated
+void add_preload_dependency(Checker *c, char *name) {
+	String s = make_string_c(name);
+	Entity *e = current_scope_lookup_entity(c->global_scope, s);
+	GB_ASSERT_MSG(e != NULL, "Missing runtime procedure `%.*s`", LIT(s));
+	add_declaration_dependency(c, e);
+}
+
 
 Entity *add_global_entity(Entity *entity) {
 	String name = entity->token.string;
@@ -713,6 +746,8 @@ void init_checker_info(CheckerInfo *i) {
 	map_init(&i->gen_procs,     a);
 	map_init(&i->type_info_map, a);
 	map_init(&i->files,         a);
+	map_init(&i->printf_calls,  a);
+	array_init(&i->run_exprs,   a);
 	i->type_info_count = 0;
 
 }
@@ -729,6 +764,8 @@ void destroy_checker_info(CheckerInfo *i) {
 	map_destroy(&i->gen_procs);
 	map_destroy(&i->type_info_map);
 	map_destroy(&i->files);
+	map_destroy(&i->printf_calls);
+	array_free(&i->run_exprs);
 }
 
 
@@ -758,20 +795,13 @@ void init_checker(Checker *c, Parser *parser) {
 		array_add(&c->file_nodes, node);
 	}
 
-	// NOTE(bill): Is this big enough or too small?
-	isize item_size = gb_max3(gb_size_of(Entity), gb_size_of(Type), gb_size_of(Scope));
-	isize total_token_count = 0;
-	for_array(i, c->parser->files) {
-		AstFile *f = &c->parser->files[i];
-		total_token_count += f->tokens.count;
-	}
-	isize arena_size = 2 * item_size * total_token_count;
-	gb_arena_init_from_allocator(&c->arena, a, arena_size);
-	gb_arena_init_from_allocator(&c->tmp_arena, a, arena_size);
-
+	// NOTE: The arenas grow in blocks as needed so they no longer have to be sized
+	// from the total token count up front
+	init_dynamic_arena(&c->arena,     gb_megabytes(4));
+	init_dynamic_arena(&c->tmp_arena, gb_megabytes(1));
 
-	c->allocator     = gb_arena_allocator(&c->arena);
-	c->tmp_allocator = gb_arena_allocator(&c->tmp_arena);
+	c->allocator     = dynamic_arena_allocator(&c->arena);
+	c->tmp_allocator = dynamic_arena_allocator(&c->tmp_arena);
 
 	c->global_scope = make_scope(universal_scope, c->allocator);
 	c->context.scope = c->global_scope;
@@ -786,7 +816,8 @@ void destroy_checker(Checker *c) {
 	array_free(&c->delayed_foreign_libraries);
 	array_free(&c->file_nodes);
 
-	gb_arena_free(&c->arena);
+	destroy_dynamic_arena(&c->arena);
+	destroy_dynamic_arena(&c->tmp_arena);
 }
 
 
@@ -997,12 +1028,13 @@ bool add_entity(Checker *c, Scope *scope, AstNode *identifier, Entity *entity) {
 
 void add_entity_use(Checker *c, AstNode *identifier, Entity *entity) {
 	GB_ASSERT(identifier != NULL);
+	// NOTE: Polymorphic specializations are used through selectors too, e.g. `fmt.foo(x)`
+	add_declaration_dependency(c, entity); // TODO(bill): Should this be here?
 	if (identifier->kind != AstNode_Ident) {
 		return;
 	}
 	HashKey key = hash_node(identifier);
 	map_set(&c->info.uses, key, entity);
-	add_declaration_dependency(c, entity); // TODO(bill): Should this be here?
 }
 
 
@@ -1213,14 +1245,14 @@ void add_curr_ast_file(Checker *c, AstFile *file) {
 }
 
 
-void add_dependency_to_map(Map<Entity *> *map, CheckerInfo *info, Entity *entity) {
+void add_dependency_to_map(Map<Entity *> *map, Array<Entity *> *queue, CheckerInfo *info, Entity *entity) {
 	if (entity == NULL) {
 		return;
 	}
 	if (entity->type != NULL &&
 	    is_type_gen_proc(entity->type)) {
 		DeclInfo *decl = decl_info_of_entity(info, entity);
-		if (decl->gen_proc_type == NULL) {
+		if (decl == NULL || decl->gen_proc_type == NULL) {
 			return;
 		}
 	}
@@ -1229,41 +1261,54 @@ void add_dependency_to_map(Map<Entity *> *map, CheckerInfo *info, Entity *entity
 		return;
 	}
 	map_set(map, hash_entity(entity), entity);
-
-
-	DeclInfo *decl = decl_info_of_entity(info, entity);
-	if (decl == NULL) {
-		return;
-	}
-
-	for_array(i, decl->deps.entries) {
-		Entity *e = cast(Entity *)decl->deps.entries[i].key.ptr;
-		add_dependency_to_map(map, info, e);
-	}
+	array_add(queue, entity);
 }
 
-Map<Entity *> generate_minimum_dependency_map(CheckerInfo *info, Entity *start) {
+// NOTE: `keep_preload` keeps what the LLVM backend needs from the preload even when nothing refers to it.
+// The custom backend calls nothing implicitly, so it only needs what the program depends upon
+Map<Entity *> generate_minimum_dependency_map(CheckerInfo *info, Entity *start, bool keep_preload = true) {
 	Map<Entity *> map = {}; // Key: Entity *
 	map_init(&map, heap_allocator());
+	Array<Entity *> queue = {};
+	array_init(&queue, heap_allocator());
+	defer (array_free(&queue));
 
 	for_array(i, info->definitions.entries) {
 		Entity *e = info->definitions.entries[i].value;
 		if (e->scope->is_global) {
-			if (!is_type_gen_proc(e->type))  {
-				// NOTE(bill): Require runtime stuff
-				add_dependency_to_map(&map, info, e);
+			if (!keep_preload) {
+				continue;
+			}
+			// NOTE: Runtime procedures are only required if something depends upon them (see add_preload_dependency)
+			// but the types and variables of the preload are used implicitly and procedures with a link name
+			// may be called by the code LLVM generates, e.g. `__multi3`
+			if (e->kind != Entity_Procedure) {
+				add_dependency_to_map(&map, &queue, info, e);
+			} else if (e->Procedure.link_name.len > 0 || e->token.string == "__init_context") {
+				add_dependency_to_map(&map, &queue, info, e);
 			}
 		} else if (e->kind == Entity_Procedure) {
 			if ((e->Procedure.tags & ProcTag_export) != 0) {
-				add_dependency_to_map(&map, info, e);
+				add_dependency_to_map(&map, &queue, info, e);
 			}
 			if (e->Procedure.is_foreign) {
-				add_dependency_to_map(&map, info, e->Procedure.foreign_library);
+				add_dependency_to_map(&map, &queue, info, e->Procedure.foreign_library);
 			}
 		}
 	}
 
-	add_dependency_to_map(&map, info, start);
+	add_dependency_to_map(&map, &queue, info, start);
+
+	for (isize i = 0; i < queue.count; i++) {
+		DeclInfo *decl = decl_info_of_entity(info, queue[i]);
+		if (decl == NULL) {
+			continue;
+		}
+		for_array(j, decl->deps.entries) {
+			Entity *e = cast(Entity *)decl->deps.entries[j].key.ptr;
+			add_dependency_to_map(&map, &queue, info, e);
+		}
+	}
 
 	return map;
 }
@@ -1425,7 +1470,7 @@ void check_procedure_overloading(Checker *c, Entity *e) {
 	GB_ASSERT(overload_count > 1);
 
 
-	gbTempArenaMemory tmp = gb_temp_arena_memory_begin(&c->tmp_arena);
+	DynamicArenaTempMemory tmp = dynamic_arena_temp_memory_begin(&c->tmp_arena);
 	Entity **procs = gb_alloc_array(c->tmp_allocator, Entity *, overload_count);
 	multi_map_get_all(&s->elements, key, procs);
 
@@ -1496,7 +1541,7 @@ void check_procedure_overloading(Checker *c, Entity *e) {
 		}
 	}
 
-	gb_temp_arena_memory_end(tmp);
+	dynamic_arena_temp_memory_end(tmp);
 }
 
 
@@ -2236,6 +2281,7 @@ void check_parsed_files(Checker *c) {
 	}
 
 	// Collect Entities
+	timings_begin_sub_section(&global_timings, str_lit("collect entities"));
 	for_array(i, c->parser->files) {
 		AstFile *f = &c->parser->files[i];
 		CheckerContext prev_context = c->context;
@@ -2243,14 +2289,20 @@ void check_parsed_files(Checker *c) {
 		check_collect_entities(c, f->decls, true);
 		c->context = prev_context;
 	}
+	timings_end_sub_section(&global_timings);
 
+	timings_begin_sub_section(&global_timings, str_lit("import entities"));
 	check_import_entities(c, &file_scopes);
+	timings_end_sub_section(&global_timings);
 
+	timings_begin_sub_section(&global_timings, str_lit("global entities"));
 	check_all_global_entities(c);
 	init_preload(c); // NOTE(bill): This could be setup previously through the use of `type_info(_of_val)`
+	timings_end_sub_section(&global_timings);
 
 	// Check procedure bodies
 	// NOTE(bill): Nested procedures bodies will be added to this "queue"
+	timings_begin_sub_section(&global_timings, str_lit("procedure bodies"));
 	for_array(i, c->procs.entries) {
 		ProcedureInfo *pi = &c->procs.entries[i].value;
 		if (pi->type == NULL) {
@@ -2282,6 +2334,7 @@ void check_parsed_files(Checker *c) {
 
 		check_proc_body(c, pi->token, pi->decl, pi->type, pi->body);
 	}
+	timings_end_sub_section(&global_timings);
 
 	// Add untyped expression values
 	for_array(i, c->info.untyped.entries) {
@@ -2303,12 +2356,14 @@ void check_parsed_files(Checker *c) {
 
 #if 1
 	// Add "Basic" type information
+	timings_begin_sub_section(&global_timings, str_lit("basic type info"));
 	for (isize i = 0; i < gb_count_of(basic_types)-1; i++) {
 		Type *t = &basic_types[i];
 		if (t->Basic.size > 0) {
 			add_type_info_type(c, t);
 		}
 	}
+	timings_end_sub_section(&global_timings);
 
 	/*
 	for (isize i = 0; i < gb_count_of(basic_type_aliases)-1; i++) {
@@ -21,19 +21,9 @@ gbAllocator heap_allocator(void) {
 #include "string.cpp"
 #include "array.cpp"
 #include "integer128.cpp"
+#include "big_int.cpp"
 #include "murmurhash3.cpp"
 
-u128 fnv128a(void const *data, isize len) {
-	u128 o = u128_lo_hi(0x13bull, 0x1000000ull);
-	u128 h = u128_lo_hi(0x62b821756295c58dull, 0x6c62272e07bb0142ull);
-	u8 const *bytes = cast(u8 const *)data;
-	for (isize i = 0; i < len; i++) {
-		h.lo ^= bytes[i];
-		h = h * o;
-	}
-	return h;
-}
-
 #include "map.cpp"
 
 
@@ -67,14 +57,29 @@ struct DynamicArena {
 	DynamicArenaBlock *start_block;
 	DynamicArenaBlock *current_block;
 	isize              block_size;
+
+	isize              prev_blocks_used; // NOTE: Bytes used in the blocks before `current_block`
+	isize              peak_used;
+	isize              temp_count;
 };
 
-DynamicArenaBlock *add_dynamic_arena_block(DynamicArena *a) {
+struct DynamicArenaTempMemory {
+	DynamicArena *     arena;
+	DynamicArenaBlock *block;
+	isize              count;
+	isize              prev_blocks_used;
+};
+
+DynamicArenaBlock *add_dynamic_arena_block(DynamicArena *a, isize min_size) {
 	GB_ASSERT(a != NULL);
 	GB_ASSERT(a->block_size > 0);
 
-	gbVirtualMemory vm = gb_vm_alloc(NULL, a->block_size);
+	isize size = gb_size_of(DynamicArenaBlock) + GB_DEFAULT_MEMORY_ALIGNMENT + min_size;
+	size = gb_max(size, a->block_size);
+
+	gbVirtualMemory vm = gb_vm_alloc(NULL, size);
 	DynamicArenaBlock *block = cast(DynamicArenaBlock *)vm.data;
+	GB_ASSERT_MSG(block != NULL, "Out of memory");
 
 	u8 *start = cast(u8 *)gb_align_forward(cast(u8 *)(block + 1), GB_DEFAULT_MEMORY_ALIGNMENT);
 	u8 *end = cast(u8 *)vm.data + vm.size;
@@ -83,48 +88,131 @@ DynamicArenaBlock *add_dynamic_arena_block(DynamicArena *a) {
 	block->start    = start;
 	block->count    = 0;
 	block->capacity = end-start;
+	block->prev     = NULL;
+	block->next     = NULL;
 
+	// NOTE: Insert the block straight after the current one so that any blocks
+	// kept around from a previous temporary section can still be reused
 	if (a->current_block != NULL) {
+		block->next = a->current_block->next;
+		if (block->next != NULL) {
+			block->next->prev = block;
+		}
 		a->current_block->next = block;
 		block->prev = a->current_block;
 	}
-	a->current_block = block;
 	return block;
 }
 
 void init_dynamic_arena(DynamicArena *a, isize block_size) {
 	isize size = gb_size_of(DynamicArenaBlock) + block_size;
 	size = cast(isize)gb_align_forward(cast(void *)cast(uintptr)size, GB_DEFAULT_MEMORY_ALIGNMENT);
-	a->block_size = size;
-	a->start_block = add_dynamic_arena_block(a);
+	a->block_size       = size;
+	a->current_block    = NULL;
+	a->prev_blocks_used = 0;
+	a->peak_used        = 0;
+	a->temp_count       = 0;
+	a->start_block      = add_dynamic_arena_block(a, 0);
+	a->current_block    = a->start_block;
 }
 
 void destroy_dynamic_arena(DynamicArena *a) {
-	DynamicArenaBlock *b = a->current_block;
+	DynamicArenaBlock *b = a->start_block;
 	while (b != NULL) {
-		gbVirtualMemory vm = b->vm;
-		b = b->prev;
+		DynamicArenaBlock *next = b->next;
 		gb_vm_free(b->vm);
+		b = next;
 	}
+	a->start_block   = NULL;
+	a->current_block = NULL;
 }
 
+// NOTE: Moves on to a block which can fit `size` bytes, reusing the next block if it is big enough
+DynamicArenaBlock *dynamic_arena_next_block(DynamicArena *a, isize size) {
+	DynamicArenaBlock *curr = a->current_block;
+	DynamicArenaBlock *next = curr->next;
+	if (next == NULL || next->capacity < size) {
+		next = add_dynamic_arena_block(a, size);
+	}
+	a->prev_blocks_used += curr->count;
+	next->count = 0;
+	a->current_block = next;
+	return next;
+}
+
+isize dynamic_arena_used(DynamicArena *a) {
+	if (a->current_block == NULL) {
+		return 0;
+	}
+	return a->prev_blocks_used + a->current_block->count;
+}
+
+isize dynamic_arena_reserved(DynamicArena *a) {
+	isize reserved = 0;
+	for (DynamicArenaBlock *b = a->start_block; b != NULL; b = b->next) {
+		reserved += b->vm.size;
+	}
+	return reserved;
+}
+
+isize dynamic_arena_block_count(DynamicArena *a) {
+	isize count = 0;
+	for (DynamicArenaBlock *b = a->start_block; b != NULL; b = b->next) {
+		count++;
+	}
+	return count;
+}
+
+gbAllocator dynamic_arena_allocator(DynamicArena *a);
+
 GB_ALLOCATOR_PROC(dynamic_arena_allocator_proc) {
 	DynamicArena *a = cast(DynamicArena *)allocator_data;
 	void *ptr = NULL;
 
 	switch (type) {
 	case gbAllocation_Alloc: {
+		DynamicArenaBlock *b = a->current_block;
+		u8 *end = b->start + b->count;
+		u8 *p = cast(u8 *)gb_align_forward(end, alignment);
+		if (p+size > b->start + b->capacity) {
+			b = dynamic_arena_next_block(a, size + alignment);
+			p = cast(u8 *)gb_align_forward(b->start, alignment);
+		}
+		b->count = (p+size) - b->start;
+		ptr = p;
 
+		a->peak_used = gb_max(a->peak_used, a->prev_blocks_used + b->count);
+		if (flags & gbAllocatorFlag_ClearToZero) {
+			// NOTE: Blocks are reused after a temporary section ends so they may not be zeroed
+			gb_zero_size(ptr, size);
+		}
 	} break;
 
-	case gbAllocation_Free: {
-	} break;
+	case gbAllocation_Free:
+		// NOTE: Free all at once
+		// Use DynamicArenaTempMemory if you want to free a block
+		break;
 
 	case gbAllocation_Resize: {
+		DynamicArenaBlock *b = a->current_block;
+		u8 *old = cast(u8 *)old_memory;
+		if (old != NULL && size > 0 &&
+		    old >= b->start && old+old_size == b->start+b->count &&
+		    old+size <= b->start+b->capacity) {
+			// NOTE: The last allocation can be extended (or shrunk) in place
+			b->count = (old+size) - b->start;
+			a->peak_used = gb_max(a->peak_used, a->prev_blocks_used + b->count);
+			ptr = old;
+		} else {
+			ptr = gb_default_resize_align(dynamic_arena_allocator(a), old_memory, old_size, size, alignment);
+		}
 	} break;
 
 	case gbAllocation_FreeAll:
-		GB_PANIC("free_all is not supported by this allocator");
+		// NOTE: Keep the blocks around so that they can be reused
+		a->current_block = a->start_block;
+		a->current_block->count = 0;
+		a->prev_blocks_used = 0;
 		break;
 	}
 
@@ -136,6 +224,26 @@ gbAllocator dynamic_arena_allocator(DynamicArena *a) {
 	return allocator;
 }
 
+DynamicArenaTempMemory dynamic_arena_temp_memory_begin(DynamicArena *a) {
+	DynamicArenaTempMemory tmp = {};
+	tmp.arena            = a;
+	tmp.block            = a->current_block;
+	tmp.count            = a->current_block->count;
+	tmp.prev_blocks_used = a->prev_blocks_used;
+	a->temp_count++;
+	return tmp;
+}
+
+void dynamic_arena_temp_memory_end(DynamicArenaTempMemory tmp) {
+	DynamicArena *a = tmp.arena;
+	GB_ASSERT(a->temp_count > 0);
+	GB_ASSERT(dynamic_arena_used(a) >= tmp.prev_blocks_used + tmp.count);
+	a->current_block        = tmp.block;
+	a->current_block->count = tmp.count;
+	a->prev_blocks_used     = tmp.prev_blocks_used;
+	a->temp_count--;
+}
+
 
 
 
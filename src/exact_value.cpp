@@ -1,10 +1,8 @@
 #include <math.h>
 
-// TODO(bill): Big numbers
-// IMPORTANT TODO(bill): This needs to be completely fixed!!!!!!!!
-
 struct AstNode;
 struct HashKey;
+struct Type;
 
 struct Complex128 {
 	f64 real, imag;
@@ -20,26 +18,54 @@ enum ExactValueKind {
 	ExactValue_Complex,
 	ExactValue_Pointer,
 	ExactValue_Compound, // TODO(bill): Is this good enough?
+	ExactValue_Packed,
 
 	ExactValue_Count,
 };
 
+enum PackedElemKind {
+	PackedElem_Bool,
+	PackedElem_Int,
+	PackedElem_Uint,
+	PackedElem_Float,
+};
+
+// NOTE: A constant array of scalars stored as little-endian element data instead of as
+// a compound literal, so large tables do not need to be re-walked element by element
+struct PackedArray {
+	Type *         elem_type;
+	PackedElemKind elem_kind;
+	i64            elem_size;
+	i64            count;
+	u8 *           data;
+};
+
 struct ExactValue {
 	ExactValueKind kind;
 	union {
 		bool          value_bool;
 		String        value_string;
-		i128          value_integer; // NOTE(bill): This must be an integer and not a pointer
+		BigInt        value_integer;
 		f64           value_float;
 		i64           value_pointer;
 		Complex128    value_complex;
 		AstNode *     value_compound;
+		PackedArray * value_packed;
 	};
 };
 
 gb_global ExactValue const empty_exact_value = {};
 
 HashKey hash_exact_value(ExactValue v) {
+	if (v.kind == ExactValue_Integer) {
+		// NOTE: Large integers are stored out of line so hash the limbs rather than the pointer
+		u64 const *limbs = big_int_limbs(&v.value_integer);
+		HashKey h = hashing_proc(limbs, v.value_integer.len*gb_size_of(u64));
+		if (v.value_integer.neg) {
+			h.key = ~h.key;
+		}
+		return h;
+	}
 	return hashing_proc(&v, gb_size_of(ExactValue));
 }
 
@@ -50,6 +76,12 @@ ExactValue exact_value_compound(AstNode *node) {
 	return result;
 }
 
+ExactValue exact_value_packed(PackedArray *packed) {
+	ExactValue result = {ExactValue_Packed};
+	result.value_packed = packed;
+	return result;
+}
+
 ExactValue exact_value_bool(bool b) {
 	ExactValue result = {ExactValue_Bool};
 	result.value_bool = (b != 0);
@@ -65,18 +97,25 @@ ExactValue exact_value_string(String string) {
 
 ExactValue exact_value_i64(i64 i) {
 	ExactValue result = {ExactValue_Integer};
-	result.value_integer = i128_from_i64(i);
+	result.value_integer = big_int_from_i64(i);
 	return result;
 }
 
-ExactValue exact_value_i128(i128 i) {
+ExactValue exact_value_u64(u64 i) {
 	ExactValue result = {ExactValue_Integer};
-	result.value_integer = i;
+	result.value_integer = big_int_from_u64(i);
 	return result;
 }
+
 ExactValue exact_value_u128(u128 i) {
 	ExactValue result = {ExactValue_Integer};
-	result.value_integer = u128_to_i128(i);
+	result.value_integer = big_int_from_u128(i);
+	return result;
+}
+
+ExactValue exact_value_big_int(BigInt i) {
+	ExactValue result = {ExactValue_Integer};
+	result.value_integer = i;
 	return result;
 }
 
@@ -101,7 +140,7 @@ ExactValue exact_value_pointer(i64 ptr) {
 
 
 ExactValue exact_value_integer_from_string(String string) {
-	return exact_value_u128(u128_from_string(string));
+	return exact_value_big_int(big_int_from_string(string));
 }
 
 f64 float_from_string(String string) {
@@ -255,10 +294,9 @@ ExactValue exact_value_to_integer(ExactValue v) {
 	case ExactValue_Integer:
 		return v;
 	case ExactValue_Float: {
-		i128 i = i128_from_f64(v.value_float);
-		f64 f = i128_to_f64(i);
-		if (f == v.value_float) {
-			return exact_value_i128(i);
+		BigInt i = {};
+		if (big_int_from_f64(v.value_float, &i)) {
+			return exact_value_big_int(i);
 		}
 	} break;
 
@@ -272,7 +310,7 @@ ExactValue exact_value_to_integer(ExactValue v) {
 ExactValue exact_value_to_float(ExactValue v) {
 	switch (v.kind) {
 	case ExactValue_Integer:
-		return exact_value_float(i128_to_f64(v.value_integer));
+		return exact_value_float(big_int_to_f64(v.value_integer));
 	case ExactValue_Float:
 		return v;
 	}
@@ -283,7 +321,7 @@ ExactValue exact_value_to_float(ExactValue v) {
 ExactValue exact_value_to_complex(ExactValue v) {
 	switch (v.kind) {
 	case ExactValue_Integer:
-		return exact_value_complex(i128_to_f64(v.value_integer), 0);
+		return exact_value_complex(big_int_to_f64(v.value_integer), 0);
 	case ExactValue_Float:
 		return exact_value_complex(v.value_float, 0);
 	case ExactValue_Complex:
@@ -332,6 +370,61 @@ ExactValue exact_value_make_imag(ExactValue v) {
 }
 
 
+void packed_array_set(PackedArray *packed, i64 index, ExactValue v) {
+	GB_ASSERT(0 <= index && index < packed->count);
+	u64 bits = 0;
+	switch (packed->elem_kind) {
+	case PackedElem_Bool:
+		bits = v.kind == ExactValue_Bool && v.value_bool;
+		break;
+	case PackedElem_Int:
+	case PackedElem_Uint:
+		bits = big_int_to_u64(exact_value_to_integer(v).value_integer);
+		break;
+	case PackedElem_Float: {
+		f64 f = exact_value_to_float(v).value_float;
+		if (packed->elem_size == 4) {
+			f32 f32_value = cast(f32)f;
+			bits = *cast(u32 *)&f32_value;
+		} else {
+			bits = *cast(u64 *)&f;
+		}
+	} break;
+	}
+
+	u8 *dst = packed->data + index*packed->elem_size;
+	for (i64 i = 0; i < packed->elem_size; i++) {
+		dst[i] = cast(u8)(bits >> (8*i));
+	}
+}
+
+ExactValue packed_array_get(PackedArray *packed, i64 index) {
+	GB_ASSERT(0 <= index && index < packed->count);
+	u8 *src = packed->data + index*packed->elem_size;
+	u64 bits = 0;
+	for (i64 i = 0; i < packed->elem_size; i++) {
+		bits |= cast(u64)src[i] << (8*i);
+	}
+
+	i64 shift = 64 - 8*packed->elem_size;
+	switch (packed->elem_kind) {
+	case PackedElem_Bool:
+		return exact_value_bool(bits != 0);
+	case PackedElem_Int:
+		return exact_value_i64(cast(i64)(bits << shift) >> shift);
+	case PackedElem_Uint:
+		return exact_value_u64(bits);
+	case PackedElem_Float:
+		if (packed->elem_size == 4) {
+			u32 bits32 = cast(u32)bits;
+			return exact_value_float(*cast(f32 *)&bits32);
+		}
+		return exact_value_float(*cast(f64 *)&bits);
+	}
+	return empty_exact_value;
+}
+
+
 ExactValue exact_unary_operator_value(TokenKind op, ExactValue v, i32 precision) {
 	switch (op) {
 	case Token_Add:	{
@@ -350,7 +443,7 @@ ExactValue exact_unary_operator_value(TokenKind op, ExactValue v, i32 precision)
 			return v;
 		case ExactValue_Integer: {
 			ExactValue i = v;
-			i.value_integer = -i.value_integer;
+			i.value_integer = big_int_neg(i.value_integer);
 			return i;
 		}
 		case ExactValue_Float: {
@@ -367,12 +460,12 @@ ExactValue exact_unary_operator_value(TokenKind op, ExactValue v, i32 precision)
 	} break;
 
 	case Token_Xor: {
-		i128 i = I128_ZERO;
+		BigInt i = {};
 		switch (v.kind) {
 		case ExactValue_Invalid:
 			return v;
 		case ExactValue_Integer:
-			i = ~v.value_integer;
+			i = big_int_not(v.value_integer);
 			break;
 		default:
 			goto failure;
@@ -380,12 +473,12 @@ ExactValue exact_unary_operator_value(TokenKind op, ExactValue v, i32 precision)
 
 		// NOTE(bill): unsigned integers will be negative and will need to be
 		// limited to the types precision
-		// IMPORTANT NOTE(bill): Max precision is 64 bits as that's how integers are stored
-		if (0 < precision && precision < 128) {
-			i = i & ~(I128_NEG_ONE << precision);
+		if (0 < precision) {
+			BigInt one = big_int_from_u64(1);
+			i = big_int_and(i, big_int_sub(big_int_shl(one, precision), one));
 		}
 
-		return exact_value_i128(i);
+		return exact_value_big_int(i);
 	} break;
 
 	case Token_Not: {
@@ -449,10 +542,10 @@ void match_exact_values(ExactValue *x, ExactValue *y) {
 			return;
 		case ExactValue_Float:
 			// TODO(bill): Is this good enough?
-			*x = exact_value_float(i128_to_f64(x->value_integer));
+			*x = exact_value_float(big_int_to_f64(x->value_integer));
 			return;
 		case ExactValue_Complex:
-			*x = exact_value_complex(i128_to_f64(x->value_integer), 0);
+			*x = exact_value_complex(big_int_to_f64(x->value_integer), 0);
 			return;
 		}
 		break;
@@ -490,27 +583,27 @@ ExactValue exact_binary_operator_value(TokenKind op, ExactValue x, ExactValue y)
 		break;
 
 	case ExactValue_Integer: {
-		i128 a = x.value_integer;
-		i128 b = y.value_integer;
-		i128 c = I128_ZERO;
+		BigInt a = x.value_integer;
+		BigInt b = y.value_integer;
+		BigInt c = {};
 		switch (op) {
-		case Token_Add:    c = a + b;               break;
-		case Token_Sub:    c = a - b;               break;
-		case Token_Mul:    c = a * b;               break;
-		case Token_Quo:    return exact_value_float(fmod(i128_to_f64(a), i128_to_f64(b)));
-		case Token_QuoEq:  c = a / b;               break; // NOTE(bill): Integer division
-		case Token_Mod:    c = a % b;               break;
-		case Token_ModMod: c = ((a % b) + b) % b;   break;
-		case Token_And:    c = a & b;               break;
-		case Token_Or:     c = a | b;               break;
-		case Token_Xor:    c = a ^ b;               break;
-		case Token_AndNot: c = i128_and_not(a, b);  break;
-		case Token_Shl:    c = a << i128_to_u64(b); break;
-		case Token_Shr:    c = a >> i128_to_u64(b); break;
+		case Token_Add:    c = big_int_add(a, b);                                 break;
+		case Token_Sub:    c = big_int_sub(a, b);                                 break;
+		case Token_Mul:    c = big_int_mul(a, b);                                 break;
+		case Token_Quo:    return exact_value_float(fmod(big_int_to_f64(a), big_int_to_f64(b)));
+		case Token_QuoEq:  c = big_int_quo(a, b);                                 break; // NOTE(bill): Integer division
+		case Token_Mod:    c = big_int_rem(a, b);                                 break;
+		case Token_ModMod: c = big_int_rem(big_int_add(big_int_rem(a, b), b), b); break;
+		case Token_And:    c = big_int_and(a, b);                                 break;
+		case Token_Or:     c = big_int_or(a, b);                                  break;
+		case Token_Xor:    c = big_int_xor(a, b);                                 break;
+		case Token_AndNot: c = big_int_and_not(a, b);                             break;
+		case Token_Shl:    c = big_int_shl(a, big_int_to_u64(b));                 break;
+		case Token_Shr:    c = big_int_shr(a, big_int_to_u64(b));                 break;
 		default: goto error;
 		}
 
-		return exact_value_i128(c);
+		return exact_value_big_int(c);
 	} break;
 
 	case ExactValue_Float: {
@@ -590,15 +683,14 @@ bool compare_exact_values(TokenKind op, ExactValue x, ExactValue y) {
 		break;
 
 	case ExactValue_Integer: {
-		i128 a = x.value_integer;
-		i128 b = y.value_integer;
+		i32 c = big_int_cmp(x.value_integer, y.value_integer);
 		switch (op) {
-		case Token_CmpEq: return a == b;
-		case Token_NotEq: return a != b;
-		case Token_Lt:    return a <  b;
-		case Token_LtEq:  return a <= b;
-		case Token_Gt:    return a >  b;
-		case Token_GtEq:  return a >= b;
+		case Token_CmpEq: return c == 0;
+		case Token_NotEq: return c != 0;
+		case Token_Lt:    return c <  0;
+		case Token_LtEq:  return c <= 0;
+		case Token_Gt:    return c >  0;
+		case Token_GtEq:  return c >= 0;
 		}
 	} break;
 
@@ -3,6 +3,10 @@
 	#define MSVC_AMD64_INTRINSICS
 	#include <intrin.h>
 	#pragma intrinsic(_mul128)
+#elif defined(__SIZEOF_INT128__) && !defined(BIT128_NO_NATIVE)
+	// NOTE: GCC and Clang provide a native 128-bit integer on 64-bit targets
+	// BIT128_NO_NATIVE forces the portable implementation, e.g. to test it against the native one
+	#define BIT128_NATIVE
 #endif
 
 #define BIT128_U64_HIGHBIT 0x8000000000000000ull
@@ -95,6 +99,16 @@ void i128_divide (i128 num, i128 den, i128 *quo, i128 *rem);
 i128 i128_quo    (i128 a, i128 b);
 i128 i128_mod    (i128 a, i128 b);
 
+#if defined(BIT128_NATIVE)
+typedef unsigned __int128 bit128__u128;
+typedef          __int128 bit128__i128;
+
+gb_inline bit128__u128 u128_to_native(u128 a) { return (cast(bit128__u128)a.hi << 64) | a.lo; }
+gb_inline bit128__i128 i128_to_native(i128 a) { return cast(bit128__i128)((cast(bit128__u128)cast(u64)a.hi << 64) | a.lo); }
+gb_inline u128 u128_from_native(bit128__u128 a) { u128 r = {cast(u64)a, cast(u64)(a >> 64)}; return r; }
+gb_inline i128 i128_from_native(bit128__i128 a) { i128 r = {cast(u64)a, cast(i64)(a >> 64)}; return r; }
+#endif
+
 bool operator==(u128 a, u128 b) { return u128_eq(a, b); }
 bool operator!=(u128 a, u128 b) { return u128_ne(a, b); }
 bool operator< (u128 a, u128 b) { return u128_lt(a, b); }
@@ -161,8 +175,13 @@ u128 u128_lo_hi(u64 lo, u64 hi) {
 u128 u128_from_u32(u32 u)       { return u128_lo_hi(cast(u64)u, 0); }
 u128 u128_from_u64(u64 u)       { return u128_lo_hi(cast(u64)u, 0); }
 u128 u128_from_i64(i64 u)       { return u128_lo_hi(cast(u64)u, u < 0 ? -1 : 0); }
+#if defined(BIT128_NATIVE)
+u128 u128_from_f32(f32 f)       { return u128_from_native(cast(bit128__u128)f); }
+u128 u128_from_f64(f64 f)       { return u128_from_native(cast(bit128__u128)f); }
+#else
 u128 u128_from_f32(f32 f)       { return u128_lo_hi(cast(u64)f, 0); }
 u128 u128_from_f64(f64 f)       { return u128_lo_hi(cast(u64)f, 0); }
+#endif
 u128 u128_from_string(String string) {
 	// TODO(bill): Allow for numbers with underscores in them
 	u64 base = 10;
@@ -212,8 +231,13 @@ i128 i128_lo_hi(u64 lo, i64 hi) {
 i128 i128_from_u32(u32 u)       { return i128_lo_hi(cast(u64)u, 0); }
 i128 i128_from_u64(u64 u)       { return i128_lo_hi(cast(u64)u, 0); }
 i128 i128_from_i64(i64 u)       { return i128_lo_hi(cast(u64)u, u < 0 ? -1 : 0); }
+#if defined(BIT128_NATIVE)
+i128 i128_from_f32(f32 f)       { return i128_from_native(cast(bit128__i128)f); }
+i128 i128_from_f64(f64 f)       { return i128_from_native(cast(bit128__i128)f); }
+#else
 i128 i128_from_f32(f32 f)       { return i128_lo_hi(cast(u64)f, 0); }
 i128 i128_from_f64(f64 f)       { return i128_lo_hi(cast(u64)f, 0); }
+#endif
 i128 i128_from_string(String string) {
 	// TODO(bill): Allow for numbers with underscores in them
 	u64 base = 10;
@@ -263,6 +287,9 @@ i64 u128_to_i64(u128 a) {
 	return a.lo;
 }
 f64 u128_to_f64(u128 a) {
+#if defined(BIT128_NATIVE)
+	return cast(f64)u128_to_native(a);
+#else
 	if (a.hi >= 0) {
 		return (cast(f64)a.hi * 18446744073709551616.0) + cast(f64)a.lo;
 	}
@@ -276,6 +303,7 @@ f64 u128_to_f64(u128 a) {
 	}
 
 	return -((cast(f64)h * 18446744073709551616.0) + cast(f64)l);
+#endif
 }
 i128 u128_to_i128(u128 a) {
 	return *cast(i128 *)&a;
@@ -291,10 +319,14 @@ i64 i128_to_i64(i128 a) {
 	return cast(i64)a.lo;
 }
 f64 i128_to_f64(i128 a) {
+#if defined(BIT128_NATIVE)
+	return cast(f64)i128_to_native(a);
+#else
 	if (a.hi >= 0) {
 		return (cast(f64)a.hi * 18446744073709551616.0) + cast(f64)a.lo;
 	}
-	i64 h = a.hi;
+	// NOTE: The magnitude is unsigned as the negation of the minimum value does not fit in an i64
+	u64 h = cast(u64)a.hi;
 	u64 l = a.lo;
 	h = ~h;
 	l = ~l;
@@ -304,6 +336,7 @@ f64 i128_to_f64(i128 a) {
 	}
 
 	return -((cast(f64)h * 18446744073709551616.0) + cast(f64)l);
+#endif
 }
 u128 i128_to_u128(i128 a) {
 	return *cast(u128 *)&a;
@@ -357,7 +390,7 @@ String i128_to_string(i128 a, char *out_buf, isize out_buf_len) {
 ////////////////////////////////////////////////////////////////
 
 i32 u128_cmp(u128 a, u128 b) {
-	if (a.hi == b.hi && b.lo == b.lo) {
+	if (a.hi == b.hi && a.lo == b.lo) {
 		return 0;
 	}
 	if (a.hi == b.hi) {
@@ -374,6 +407,9 @@ bool u128_le(u128 a, u128 b) { return !u128_gt(a, b); }
 bool u128_ge(u128 a, u128 b) { return !u128_lt(a, b); }
 
 u128 u128_add(u128 a, u128 b) {
+#if defined(BIT128_NATIVE)
+	return u128_from_native(u128_to_native(a) + u128_to_native(b));
+#else
 	u128 old_a = a;
 	a.lo += b.lo;
 	a.hi += b.hi;
@@ -381,6 +417,7 @@ u128 u128_add(u128 a, u128 b) {
 		a.hi += 1;
 	}
 	return a;
+#endif
 }
 u128 u128_not(u128 a) { return u128_lo_hi(~a.lo, ~a.hi); }
 
@@ -400,7 +437,9 @@ u128 u128_shl(u128 a, u32 n) {
 	if (n >= 128) {
 		return u128_lo_hi(0, 0);
 	}
-#if 0 && defined(MSVC_AMD64_INTRINSICS)
+#if defined(BIT128_NATIVE)
+	return u128_from_native(u128_to_native(a) << n);
+#elif 0 && defined(MSVC_AMD64_INTRINSICS)
 	a.hi = __shiftleft128(a.lo, a.hi, n);
 	a.lo = a.lo << n;
 	return a;
@@ -426,7 +465,9 @@ u128 u128_shr(u128 a, u32 n) {
 	if (n >= 128) {
 		return u128_lo_hi(0, 0);
 	}
-#if 0 && defined(MSVC_AMD64_INTRINSICS)
+#if defined(BIT128_NATIVE)
+	return u128_from_native(u128_to_native(a) >> n);
+#elif 0 && defined(MSVC_AMD64_INTRINSICS)
 	a.lo = __shiftright128(a.lo, a.hi, n);
 	a.hi = a.hi >> n;
 	return a;
@@ -461,7 +502,9 @@ u128 u128_mul(u128 a, u128 b) {
 		return a;
 	}
 
-
+#if defined(BIT128_NATIVE)
+	return u128_from_native(u128_to_native(a) * u128_to_native(b));
+#else
 #if defined(MSVC_AMD64_INTRINSICS)
 	if (a.hi == 0 && b.hi == 0) {
 		a.lo = _umul128(a.lo, b.lo, &a.hi);
@@ -480,11 +523,21 @@ u128 u128_mul(u128 a, u128 b) {
 	}
 
 	return res;
+#endif
 }
 
 bool u128_hibit(u128 *d) { return (d->hi & BIT128_U64_HIGHBIT) != 0; }
 
 void u128_divide(u128 num, u128 den, u128 *quo, u128 *rem) {
+#if defined(BIT128_NATIVE)
+	if (!u128_eq(den, U128_ZERO)) {
+		bit128__u128 n = u128_to_native(num);
+		bit128__u128 d = u128_to_native(den);
+		if (quo) *quo = u128_from_native(n / d);
+		if (rem) *rem = u128_from_native(n % d);
+		return;
+	}
+#endif
 	if (u128_eq(den, U128_ZERO)) {
 		if (quo) *quo = u128_from_u64(num.lo/den.lo);
 		if (rem) *rem = U128_ZERO;
@@ -542,7 +595,7 @@ i128 i128_abs(i128 a) {
 }
 
 i32 i128_cmp(i128 a, i128 b) {
-	if (a.hi == b.hi && b.lo == b.lo) {
+	if (a.hi == b.hi && a.lo == b.lo) {
 		return 0;
 	}
 	if (a.hi == b.hi) {
@@ -559,6 +612,9 @@ bool i128_le(i128 a, i128 b) { return a.hi == b.hi ? a.lo <= b.lo : a.hi <= b.hi
 bool i128_ge(i128 a, i128 b) { return a.hi == b.hi ? a.lo >= b.lo : a.hi >= b.hi; }
 
 i128 i128_add(i128 a, i128 b) {
+#if defined(BIT128_NATIVE)
+	return i128_from_native(cast(bit128__i128)(cast(bit128__u128)i128_to_native(a) + cast(bit128__u128)i128_to_native(b)));
+#else
 	i128 old_a = a;
 	a.lo += b.lo;
 	a.hi += b.hi;
@@ -566,6 +622,7 @@ i128 i128_add(i128 a, i128 b) {
 		a.hi += 1;
 	}
 	return a;
+#endif
 }
 i128 i128_not(i128 a) { return i128_lo_hi(~a.lo, ~a.hi); }
 
@@ -586,7 +643,9 @@ i128 i128_shl(i128 a, u32 n) {
 		return i128_lo_hi(0, 0);
 	}
 
-#if 0 && defined(MSVC_AMD64_INTRINSICS)
+#if defined(BIT128_NATIVE)
+	return i128_from_native(cast(bit128__i128)(cast(bit128__u128)i128_to_native(a) << n));
+#elif 0 && defined(MSVC_AMD64_INTRINSICS)
 	a.hi = __shiftleft128(a.lo, a.hi, n);
 	a.lo = a.lo << n;
 	return a;
@@ -608,20 +667,25 @@ i128 i128_shl(i128 a, u32 n) {
 #endif
 }
 
+// NOTE: Arithmetic shift
 i128 i128_shr(i128 a, u32 n) {
 	if (n >= 128) {
-		return i128_lo_hi(0, 0);
+		n = 127;
 	}
 
-#if 0 && defined(MSVC_AMD64_INTRINSICS)
+#if defined(BIT128_NATIVE)
+	return i128_from_native(i128_to_native(a) >> n);
+#elif 0 && defined(MSVC_AMD64_INTRINSICS)
 	a.lo = __shiftright128(a.lo, a.hi, n);
 	a.hi = a.hi >> n;
 	return a;
 #else
 	if (n >= 64) {
 		n -= 64;
-		a.lo = a.hi;
-		a.hi = 0;
+		a.lo = cast(u64)a.hi;
+		a.hi = a.hi < 0 ? -1 : 0;
+		a.lo = cast(u64)(cast(i64)a.lo >> n);
+		return a;
 	}
 
 	if (n != 0) {
@@ -648,6 +712,9 @@ i128 i128_mul(i128 a, i128 b) {
 		return a;
 	}
 
+#if defined(BIT128_NATIVE)
+	return i128_from_native(cast(bit128__i128)(cast(bit128__u128)i128_to_native(a) * cast(bit128__u128)i128_to_native(b)));
+#else
 #if defined(MSVC_AMD64_INTRINSICS)
 	if (a.hi == 0 && b.hi == 0) {
 		a.lo = _mul128(a.lo, b.lo, &a.hi);
@@ -666,52 +733,30 @@ i128 i128_mul(i128 a, i128 b) {
 	}
 
 	return res;
+#endif
 }
 
+// NOTE: Truncates towards zero, the remainder has the sign of the dividend
 void i128_divide(i128 a, i128 b, i128 *quo, i128 *rem) {
-	// TODO(bill): Which one is correct?!
-#if 1
-	i128 s = i128_shr(b, 127);
-	b = i128_sub(i128_xor(b, s), s);
-	s = i128_shr(a, 127);
-	b = i128_sub(i128_xor(a, s), s);
-
-	u128 n, r = {0};
-	u128_divide(*cast(u128 *)&a, *cast(u128 *)&b, &n, &r);
-	i128 ni = *cast(i128 *)&n;
-	i128 ri = *cast(i128 *)&r;
-
-	if (quo) *quo = i128_sub(i128_xor(ni, s), s);
-	if (rem) *rem = i128_sub(i128_xor(ri, s), s);
-#else
-	if (i128_eq(b, I128_ZERO)) {
-		if (quo) *quo = i128_from_u64(a.lo/b.lo);
-		if (rem) *rem = I128_ZERO;
-	} else {
-		i128 n = a;
-		i128 d = b;
-		i128 x = I128_ONE;
-		i128 r = I128_ZERO;
-
-		while (i128_ge(n, d) && ((i128_shr(d, 128-1).lo&1) == 0)) {
-			x = i128_shl(x, 1);
-			d = i128_shl(d, 1);
-		}
-
-		while (i128_ne(x, I128_ZERO)) {
-			if (i128_ge(n, d)) {
-				n = i128_sub(n, d);
-				r = i128_or(r, x);
-			}
-
-			x = i128_shr(x, 1);
-			d = i128_shr(d, 1);
-		}
-
-		if (quo) *quo = r;
-		if (rem) *rem = n;
+#if defined(BIT128_NATIVE)
+	if (!i128_eq(b, I128_ZERO)) {
+		bit128__i128 n = i128_to_native(a);
+		bit128__i128 d = i128_to_native(b);
+		if (quo) *quo = i128_from_native(n / d);
+		if (rem) *rem = i128_from_native(n % d);
+		return;
 	}
 #endif
+	bool a_neg = a.hi < 0;
+	bool b_neg = b.hi < 0;
+	u128 n = {0};
+	u128 r = {0};
+	u128_divide(i128_to_u128(i128_abs(a)), i128_to_u128(i128_abs(b)), &n, &r);
+	i128 ni = u128_to_i128(n);
+	i128 ri = u128_to_i128(r);
+
+	if (quo) *quo = a_neg != b_neg ? i128_neg(ni) : ni;
+	if (rem) *rem = a_neg ? i128_neg(ri) : ri;
 }
 
 i128 i128_quo(i128 a, i128 b) {
@@ -7,8 +7,8 @@ struct irDebugInfo;
 
 struct irModule {
 	CheckerInfo * info;
-	gbArena       arena;
-	gbArena       tmp_arena;
+	DynamicArena  arena;
+	DynamicArena  tmp_arena;
 	gbAllocator   allocator;
 	gbAllocator   tmp_allocator;
 	// bool generate_debug_info;
@@ -34,6 +34,9 @@ struct irModule {
 	// Mainly used for file names
 	Map<irValue *>        const_strings; // Key: String
 
+	// NOTE: LLVM intrinsics used by the vector instructions, declared once when printing
+	Map<irValue *>        intrinsics; // Key: String (intrinsic name), Value: first instruction using it
+
 
 	Entity *              entry_point_entity;
 
@@ -41,6 +44,8 @@ struct irModule {
 	Array<irValue *>      procs_to_generate; // NOTE(bill): Procedures to generate
 
 	Array<String>         foreign_library_paths; // Only the ones that were used
+
+	Map<bool>             param_escapes; // Key: Entity * of a parameter and its irEscapeKind, see `ir_opt_param_escapes`
 };
 
 // NOTE(bill): For more info, see https://en.wikipedia.org/wiki/Dominator_(graph_theory)
@@ -132,6 +137,9 @@ struct irProcedure {
 
 	Array<irBranchBlocks> branch_blocks;
 
+	Array<irValue *>      variadic_any_arrays;  // `[N]any` backing each `..any` call, see `ir_opt_share_variadic_arrays`
+	bool                  contextless;          // Inferred, emitted and called without the context pointer
+
 	i32                   local_count;
 	i32                   instr_count;
 	i32                   block_count;
@@ -197,12 +205,58 @@ struct irProcedure {
 		irBlock *true_block;                                          \
 		irBlock *false_block;                                         \
 	})                                                                \
+	IR_INSTR_KIND(Switch, struct {                                    \
+		irValue * value;                                              \
+		irBlock * default_block;                                      \
+		irValue **case_values; /* constants of the type of `value` */ \
+		irBlock **case_blocks;                                        \
+		isize     case_count;                                         \
+	})                                                                \
 	IR_INSTR_KIND(Return, struct { irValue *value; })                 \
 	IR_INSTR_KIND(Select, struct {                                    \
 		irValue *cond;                                                \
 		irValue *true_value;                                          \
 		irValue *false_value;                                         \
 	})                                                                \
+	IR_INSTR_KIND(VectorExtractElement, struct {                      \
+		irValue *vector;                                              \
+		irValue *index;                                               \
+	})                                                                \
+	IR_INSTR_KIND(VectorInsertElement, struct {                       \
+		irValue *vector;                                              \
+		irValue *elem;                                                \
+		irValue *index;                                               \
+	})                                                                \
+	IR_INSTR_KIND(VectorShuffle, struct {                             \
+		irValue *vector;                                              \
+		irValue *other; /* NULL is undef */                           \
+		i32 *    indices;                                             \
+		i32      index_count;                                         \
+		Type *   type;                                                \
+	})                                                                \
+	IR_INSTR_KIND(VectorReduce, struct {                              \
+		TokenKind op; /* Token_Add, Token_Lt (min), Token_Gt (max) */ \
+		irValue * vector;                                             \
+	})                                                                \
+	IR_INSTR_KIND(VectorSelect, struct {                              \
+		irValue *mask; /* integer vector, non-zero lanes are true */  \
+		irValue *true_value;                                          \
+		irValue *false_value;                                         \
+	})                                                                \
+	IR_INSTR_KIND(VectorElementPtrs, struct {                         \
+		irValue *address;                                             \
+		irValue *indices;                                             \
+		Type *   type; /* vector of element pointers */               \
+	})                                                                \
+	IR_INSTR_KIND(VectorGather, struct {                              \
+		irValue *ptrs;                                                \
+		Type *   type;                                                \
+	})                                                                \
+	IR_INSTR_KIND(VectorScatter, struct {                             \
+		irValue *ptrs;                                                \
+		irValue *values;                                              \
+	})                                                                \
+	IR_INSTR_KIND(FusedMulAdd, struct { irValue *a, *b, *c; })        \
 	IR_INSTR_KIND(Phi, struct { Array<irValue *> edges; Type *type; })\
 	IR_INSTR_KIND(Unreachable, i32)                                   \
 	IR_INSTR_KIND(UnaryOp, struct {                                   \
@@ -614,6 +668,22 @@ Type *ir_instr_type(irInstr *instr) {
 		return instr->Conv.to;
 	case irInstr_Select:
 		return ir_type(instr->Select.true_value);
+	case irInstr_VectorExtractElement:
+		return base_vector_type(ir_type(instr->VectorExtractElement.vector));
+	case irInstr_VectorInsertElement:
+		return ir_type(instr->VectorInsertElement.vector);
+	case irInstr_VectorShuffle:
+		return instr->VectorShuffle.type;
+	case irInstr_VectorReduce:
+		return base_vector_type(ir_type(instr->VectorReduce.vector));
+	case irInstr_VectorSelect:
+		return ir_type(instr->VectorSelect.true_value);
+	case irInstr_VectorElementPtrs:
+		return instr->VectorElementPtrs.type;
+	case irInstr_VectorGather:
+		return instr->VectorGather.type;
+	case irInstr_FusedMulAdd:
+		return ir_type(instr->FusedMulAdd.a);
 	case irInstr_Call: {
 		Type *pt = base_type(instr->Call.type);
 		if (pt != NULL) {
@@ -980,6 +1050,18 @@ irValue *ir_instr_if(irProcedure *p, irValue *cond, irBlock *true_block, irBlock
 }
 
 
+irValue *ir_instr_switch(irProcedure *p, irValue *value, irBlock *default_block, irValue **case_values, irBlock **case_blocks, isize case_count) {
+	irValue *v = ir_alloc_instr(p, irInstr_Switch);
+	irInstr *i = &v->Instr;
+	i->Switch.value         = value;
+	i->Switch.default_block = default_block;
+	i->Switch.case_values   = case_values;
+	i->Switch.case_blocks   = case_blocks;
+	i->Switch.case_count    = case_count;
+	return v;
+}
+
+
 irValue *ir_instr_phi(irProcedure *p, Array<irValue *> edges, Type *type) {
 	irValue *v = ir_alloc_instr(p, irInstr_Phi);
 	irInstr *i = &v->Instr;
@@ -1007,6 +1089,79 @@ irValue *ir_instr_select(irProcedure *p, irValue *cond, irValue *t, irValue *f)
 	return v;
 }
 
+irValue *ir_instr_vector_extract_element(irProcedure *p, irValue *vector, irValue *index) {
+	irValue *v = ir_alloc_instr(p, irInstr_VectorExtractElement);
+	v->Instr.VectorExtractElement.vector = vector;
+	v->Instr.VectorExtractElement.index  = index;
+	return v;
+}
+
+irValue *ir_instr_vector_insert_element(irProcedure *p, irValue *vector, irValue *elem, irValue *index) {
+	irValue *v = ir_alloc_instr(p, irInstr_VectorInsertElement);
+	v->Instr.VectorInsertElement.vector = vector;
+	v->Instr.VectorInsertElement.elem   = elem;
+	v->Instr.VectorInsertElement.index  = index;
+	return v;
+}
+
+irValue *ir_instr_vector_shuffle(irProcedure *p, irValue *vector, irValue *other, i32 *indices, i32 index_count, Type *type) {
+	irValue *v = ir_alloc_instr(p, irInstr_VectorShuffle);
+	v->Instr.VectorShuffle.vector      = vector;
+	v->Instr.VectorShuffle.other       = other;
+	v->Instr.VectorShuffle.indices     = indices;
+	v->Instr.VectorShuffle.index_count = index_count;
+	v->Instr.VectorShuffle.type        = type;
+	return v;
+}
+
+irValue *ir_instr_vector_reduce(irProcedure *p, TokenKind op, irValue *vector) {
+	irValue *v = ir_alloc_instr(p, irInstr_VectorReduce);
+	v->Instr.VectorReduce.op     = op;
+	v->Instr.VectorReduce.vector = vector;
+	return v;
+}
+
+irValue *ir_instr_vector_select(irProcedure *p, irValue *mask, irValue *t, irValue *f) {
+	irValue *v = ir_alloc_instr(p, irInstr_VectorSelect);
+	v->Instr.VectorSelect.mask        = mask;
+	v->Instr.VectorSelect.true_value  = t;
+	v->Instr.VectorSelect.false_value = f;
+	return v;
+}
+
+irValue *ir_instr_vector_element_ptrs(irProcedure *p, irValue *address, irValue *indices) {
+	gbAllocator a = p->module->allocator;
+	Type *elem_ptr = ir_type(address);
+	GB_ASSERT(is_type_pointer(elem_ptr));
+	irValue *v = ir_alloc_instr(p, irInstr_VectorElementPtrs);
+	v->Instr.VectorElementPtrs.address = address;
+	v->Instr.VectorElementPtrs.indices = indices;
+	v->Instr.VectorElementPtrs.type    = make_type_vector(a, elem_ptr, base_type(ir_type(indices))->Vector.count);
+	return v;
+}
+
+irValue *ir_instr_vector_gather(irProcedure *p, irValue *ptrs, Type *type) {
+	irValue *v = ir_alloc_instr(p, irInstr_VectorGather);
+	v->Instr.VectorGather.ptrs = ptrs;
+	v->Instr.VectorGather.type = type;
+	return v;
+}
+
+irValue *ir_instr_vector_scatter(irProcedure *p, irValue *ptrs, irValue *values) {
+	irValue *v = ir_alloc_instr(p, irInstr_VectorScatter);
+	v->Instr.VectorScatter.ptrs   = ptrs;
+	v->Instr.VectorScatter.values = values;
+	return v;
+}
+
+irValue *ir_instr_fused_mul_add(irProcedure *p, irValue *a, irValue *b, irValue *c) {
+	irValue *v = ir_alloc_instr(p, irInstr_FusedMulAdd);
+	v->Instr.FusedMulAdd.a = a;
+	v->Instr.FusedMulAdd.b = b;
+	v->Instr.FusedMulAdd.c = c;
+	return v;
+}
+
 irValue *ir_instr_call(irProcedure *p, irValue *value, irValue *return_ptr, irValue **args, isize arg_count, Type *result_type, irValue *context_ptr) {
 	irValue *v = ir_alloc_instr(p, irInstr_Call);
 	v->Instr.Call.value       = value;
@@ -1216,9 +1371,13 @@ irValue *ir_add_module_constant(irModule *m, Type *type, ExactValue value) {
 	// gbAllocator a = gb_heap_allocator();
 
 	if (is_type_slice(type)) {
-		ast_node(cl, CompoundLit, value.value_compound);
-
-		isize count = cl->elems.count;
+		isize count = 0;
+		if (value.kind == ExactValue_Packed) {
+			count = cast(isize)value.value_packed->count;
+		} else {
+			ast_node(cl, CompoundLit, value.value_compound);
+			count = cl->elems.count;
+		}
 		if (count == 0) {
 			return ir_value_nil(a, type);
 		}
@@ -1469,6 +1628,26 @@ irValue *ir_emit_select(irProcedure *p, irValue *cond, irValue *t, irValue *f) {
 	return ir_emit(p, ir_instr_select(p, cond, t, f));
 }
 
+irValue *ir_emit_vector_extract(irProcedure *p, irValue *vector, i32 index) {
+	GB_ASSERT(is_type_simd_vector(ir_type(vector)));
+	irValue *i = ir_const_i32(p->module->allocator, index);
+	return ir_emit(p, ir_instr_vector_extract_element(p, vector, i));
+}
+
+// NOTE: Broadcasts `elem` to every element with an insertelement and a shufflevector of zeros
+irValue *ir_emit_vector_splat(irProcedure *p, irValue *elem, Type *vector_type) {
+	gbAllocator a = p->module->allocator;
+	GB_ASSERT(is_type_simd_vector(vector_type));
+	i32 count = cast(i32)base_type(vector_type)->Vector.count;
+	irValue *v = ir_value_undef(a, vector_type);
+	v = ir_emit(p, ir_instr_vector_insert_element(p, v, elem, ir_const_i32(a, 0)));
+	if (count == 1) {
+		return v;
+	}
+	i32 *indices = gb_alloc_array(a, i32, count);
+	return ir_emit(p, ir_instr_vector_shuffle(p, v, NULL, indices, count, vector_type));
+}
+
 irValue *ir_emit_zero_init(irProcedure *p, irValue *address)  {
 	return ir_emit(p, ir_instr_zero_init(p, address));
 }
@@ -1646,6 +1825,30 @@ void ir_emit_if(irProcedure *proc, irValue *cond, irBlock *true_block, irBlock *
 	ir_start_block(proc, NULL);
 }
 
+void ir_emit_switch(irProcedure *proc, irValue *value, irBlock *default_block, irValue **case_values, irBlock **case_blocks, isize case_count) {
+	irBlock *b = proc->curr_block;
+	if (b == NULL) {
+		return;
+	}
+	ir_emit(proc, ir_instr_switch(proc, value, default_block, case_values, case_blocks, case_count));
+	// NOTE: A block which several cases branch to is still a single edge, like a phi expects
+	ir_add_edge(b, default_block);
+	for (isize i = 0; i < case_count; i++) {
+		irBlock *target = case_blocks[i];
+		bool seen = false;
+		for_array(j, b->succs) {
+			if (b->succs[j] == target) {
+				seen = true;
+				break;
+			}
+		}
+		if (!seen) {
+			ir_add_edge(b, target);
+		}
+	}
+	ir_start_block(proc, NULL);
+}
+
 void ir_emit_startup_runtime(irProcedure *proc) {
 	GB_ASSERT(proc->parent == NULL && proc->name == "main");
 	ir_emit(proc, ir_alloc_instr(proc, irInstr_StartupRuntime));
@@ -1677,28 +1880,49 @@ irValue *ir_gen_map_header(irProcedure *proc, irValue *map_val, Type *map_type)
 
 	i64 entry_size   = type_size_of(a, map_type->Map.entry_type);
 	i64 entry_align  = type_align_of(a, map_type->Map.entry_type);
+	i64 key_offset   = type_offset_of(a, map_type->Map.entry_type, 1);
+	i64 key_size     = type_size_of(a, map_type->Map.key);
 	i64 value_offset = type_offset_of(a, map_type->Map.entry_type, 2);
 	i64 value_size   = type_size_of(a, map_type->Map.value);
 
 	ir_emit_store(proc, ir_emit_struct_ep(proc, h, 2), ir_const_int(a, entry_size));
 	ir_emit_store(proc, ir_emit_struct_ep(proc, h, 3), ir_const_int(a, entry_align));
-	ir_emit_store(proc, ir_emit_struct_ep(proc, h, 4), ir_const_int(a, value_offset));
-	ir_emit_store(proc, ir_emit_struct_ep(proc, h, 5), ir_const_int(a, value_size));
+	ir_emit_store(proc, ir_emit_struct_ep(proc, h, 4), ir_const_int(a, key_offset));
+	ir_emit_store(proc, ir_emit_struct_ep(proc, h, 5), ir_const_int(a, key_size));
+	ir_emit_store(proc, ir_emit_struct_ep(proc, h, 6), ir_const_int(a, value_offset));
+	ir_emit_store(proc, ir_emit_struct_ep(proc, h, 7), ir_const_int(a, value_size));
 
 
 	return ir_emit_load(proc, h);
 }
 
+// NOTE: Must produce the same hash as `__default_hash_string` in core/_preload.odin
+u64 ir_default_hash_string(String s) {
+	return MurmurHash64A(s.text, s.len, 0x9747b28c);
+}
+
+irValue *ir_address_from_load_or_generate_local(irProcedure *proc, irValue *val);
+irValue *ir_emit_arith(irProcedure *proc, TokenKind op, irValue *left, irValue *right, Type *type);
+
+// NOTE: A key of up to 64 bits is its own hash, the runtime mixes it before it picks a slot
 irValue *ir_gen_map_key(irProcedure *proc, irValue *key, Type *key_type) {
-	Type *hash_type = t_u128;
+	Type *hash_type = t_u64;
 	irValue *v = ir_add_local_generated(proc, t_map_key);
 	Type *t = base_type(ir_type(key));
 	key = ir_emit_conv(proc, key, key_type);
+	irValue *hash = NULL;
 	if (is_type_integer(t)) {
-		ir_emit_store(proc, ir_emit_struct_ep(proc, v, 0), ir_emit_conv(proc, key, hash_type));
+		i64 size = type_size_of(proc->module->allocator, t);
+		if (size > 8) {
+			irValue *lo = ir_emit_conv(proc, key, hash_type);
+			irValue *hi = ir_emit_arith(proc, Token_Shr, key, ir_const_int(proc->module->allocator, 64), key_type);
+			hash = ir_emit_arith(proc, Token_Xor, lo, ir_emit_conv(proc, hi, hash_type), hash_type);
+		} else {
+			hash = ir_emit_conv(proc, key, hash_type);
+		}
 	} else if (is_type_pointer(t)) {
 		irValue *p = ir_emit_conv(proc, key, t_uint);
-		ir_emit_store(proc, ir_emit_struct_ep(proc, v, 0), ir_emit_conv(proc, p, hash_type));
+		hash = ir_emit_conv(proc, p, hash_type);
 	} else if (is_type_float(t)) {
 		irValue *bits = NULL;
 		i64 size = type_size_of(proc->module->allocator, t);
@@ -1708,27 +1932,28 @@ irValue *ir_gen_map_key(irProcedure *proc, irValue *key, Type *key_type) {
 		default: GB_PANIC("Unhandled float size: %lld bits", size); break;
 		}
 
-		ir_emit_store(proc, ir_emit_struct_ep(proc, v, 0), ir_emit_conv(proc, bits, hash_type));
+		hash = ir_emit_conv(proc, bits, hash_type);
 	} else if (is_type_string(t)) {
 		irValue *str = ir_emit_conv(proc, key, t_string);
-		irValue *hashed_str = NULL;
 
 		if (str->kind == irValue_Constant) {
 			ExactValue ev = str->Constant.value;
 			GB_ASSERT(ev.kind == ExactValue_String);
-			u128 hs = fnv128a(ev.value_string.text, ev.value_string.len);
-			hashed_str = ir_value_constant(proc->module->allocator, t_u128, exact_value_u128(hs));
+			u64 hs = ir_default_hash_string(ev.value_string);
+			hash = ir_value_constant(proc->module->allocator, hash_type, exact_value_u64(hs));
 		} else {
 			irValue **args = gb_alloc_array(proc->module->allocator, irValue *, 1);
 			args[0] = str;
-			hashed_str = ir_emit_global_call(proc, "__default_hash_string", args, 1);
+			hash = ir_emit_global_call(proc, "__default_hash_string", args, 1);
 		}
-		ir_emit_store(proc, ir_emit_struct_ep(proc, v, 0), hashed_str);
-		ir_emit_store(proc, ir_emit_struct_ep(proc, v, 1), str);
 	} else {
 		GB_PANIC("Unhandled map key type");
 	}
 
+	irValue *ptr = ir_address_from_load_or_generate_local(proc, key);
+	ir_emit_store(proc, ir_emit_struct_ep(proc, v, 0), hash);
+	ir_emit_store(proc, ir_emit_struct_ep(proc, v, 1), ir_emit_conv(proc, ptr, t_rawptr));
+
 	return ir_emit_load(proc, v);
 }
 
@@ -1991,7 +2216,7 @@ irValue *ir_emit_unary_arith(irProcedure *proc, TokenKind op, irValue *x, Type *
 		GB_PANIC("This should be handled elsewhere");
 		break;
 	}
-	if (is_type_vector(ir_type(x))) {
+	if (is_type_vector(ir_type(x)) && !is_type_simd_vector(ir_type(x))) {
 		ir_emit_comment(proc, str_lit("vector.arith.begin"));
 		// IMPORTANT TODO(bill): This is very wasteful with regards to stack memory
 		Type *tl = base_type(ir_type(x));
@@ -2018,7 +2243,13 @@ irValue *ir_emit_arith(irProcedure *proc, TokenKind op, irValue *left, irValue *
 	Type *t_left = ir_type(left);
 	Type *t_right = ir_type(right);
 
-	if (is_type_vector(t_left) || is_type_vector(t_right)) {
+	if (is_type_simd_vector(type)) {
+		// NOTE: A single instruction on the whole `<N x T>`, the scalar operand is broadcast
+		left  = ir_emit_conv(proc, left, type);
+		right = ir_emit_conv(proc, right, type);
+		t_left  = type;
+		t_right = type;
+	} else if (is_type_vector(t_left) || is_type_vector(t_right)) {
 		ir_emit_comment(proc, str_lit("vector.arith.begin"));
 		// IMPORTANT TODO(bill): This is very wasteful with regards to stack memory
 		left  = ir_emit_conv(proc, left, type);
@@ -2160,7 +2391,7 @@ irValue *ir_emit_arith(irProcedure *proc, TokenKind op, irValue *left, irValue *
 	if (op == Token_ModMod) {
 		irValue *n = left;
 		irValue *m = right;
-		if (is_type_unsigned(type)) {
+		if (is_type_unsigned(base_vector_type(type))) {
 			return ir_emit_arith(proc, Token_Mod, n, m, type);
 		}
 		irValue *a = ir_emit_arith(proc, Token_Mod, n, m, type);
@@ -2264,6 +2495,45 @@ irValue *ir_emit_comp_against_nil(irProcedure *proc, TokenKind op_kind, irValue
 	return NULL;
 }
 
+irValue *ir_string_elem(irProcedure *proc, irValue *string);
+irValue *ir_string_len(irProcedure *proc, irValue *string);
+
+// NOTE: Comparing against a constant string checks the length first and then compares a known
+// number of bytes, which LLVM expands into a few word-wise loads rather than calling the runtime
+irValue *ir_emit_string_comp_const(irProcedure *proc, TokenKind op_kind, irValue *x, irValue *str) {
+	GB_ASSERT(op_kind == Token_CmpEq || op_kind == Token_NotEq);
+	GB_ASSERT(str->kind == irValue_Constant && str->Constant.value.kind == ExactValue_String);
+	gbAllocator a = proc->module->allocator;
+	isize len = str->Constant.value.value_string.len;
+
+	irValue *res = ir_emit_comp(proc, Token_CmpEq, ir_string_len(proc, x), ir_const_int(a, len));
+	if (len > 0) {
+		irBlock *bytes = ir_new_block(proc, NULL, "string.comp.bytes");
+		irBlock *done  = ir_new_block(proc, NULL, "string.comp.done");
+		ir_emit_if(proc, res, bytes, done);
+
+		ir_start_block(proc, bytes);
+		irValue **args = gb_alloc_array(a, irValue *, 3);
+		args[0] = ir_emit_conv(proc, ir_string_elem(proc, x),   t_rawptr);
+		args[1] = ir_emit_conv(proc, ir_string_elem(proc, str), t_rawptr);
+		args[2] = ir_const_int(a, len);
+		irValue *bytes_eq = ir_emit_global_call(proc, "__mem_equal", args, 3);
+		ir_emit_jump(proc, done);
+
+		ir_start_block(proc, done);
+		Array<irValue *> edges = {};
+		array_init(&edges, a, 2);
+		array_add(&edges, v_false);
+		array_add(&edges, bytes_eq);
+		res = ir_emit(proc, ir_instr_phi(proc, edges, t_bool));
+	}
+
+	if (op_kind == Token_NotEq) {
+		res = ir_emit_comp(proc, Token_CmpEq, res, v_false);
+	}
+	return res;
+}
+
 irValue *ir_emit_comp(irProcedure *proc, TokenKind op_kind, irValue *left, irValue *right) {
 	Type *a = base_type(ir_type(left));
 	Type *b = base_type(ir_type(right));
@@ -2304,6 +2574,20 @@ irValue *ir_emit_comp(irProcedure *proc, TokenKind op_kind, irValue *left, irVal
 		result = make_type_vector(proc->module->allocator, t_bool, a->Vector.count);
 	}
 
+	if (is_type_simd_vector(a)) {
+		// NOTE: A `[vector N]bool` is one byte per lane in memory, so all the lanes are compared at once
+		// into a byte vector which is stored over it
+		gbAllocator al = proc->module->allocator;
+		Type *byte_vector = make_type_vector(al, t_u8, a->Vector.count);
+		irValue *cmp = ir_emit(proc, ir_instr_binary_op(proc, op_kind, left, right, byte_vector));
+
+		Entity *e = make_entity_variable(al, NULL, empty_token, result, false);
+		irValue *res = ir_add_local(proc, e, NULL, false);
+		res->Instr.Local.alignment = gb_max(res->Instr.Local.alignment, type_align_of(al, byte_vector));
+		ir_emit_store(proc, ir_emit_bitcast(proc, res, make_type_pointer(al, byte_vector)), cmp);
+		return ir_emit_load(proc, res);
+	}
+
 	if (is_type_vector(a)) {
 		ir_emit_comment(proc, str_lit("vector.comp.begin"));
 		Type *tl = base_type(a);
@@ -2325,6 +2609,13 @@ irValue *ir_emit_comp(irProcedure *proc, TokenKind op_kind, irValue *left, irVal
 		return ir_emit_load(proc, res);
 	}
 
+	if (is_type_string(a) && (op_kind == Token_CmpEq || op_kind == Token_NotEq)) {
+		if (right->kind == irValue_Constant && right->Constant.value.kind == ExactValue_String) {
+			return ir_emit_string_comp_const(proc, op_kind, left, right);
+		} else if (left->kind == irValue_Constant && left->Constant.value.kind == ExactValue_String) {
+			return ir_emit_string_comp_const(proc, op_kind, right, left);
+		}
+	}
 
 	return ir_emit(proc, ir_instr_binary_op(proc, op_kind, left, right, result));
 }
@@ -2772,6 +3063,82 @@ String ir_lookup_polymorphic_field(CheckerInfo *info, Type *dst, Type *src) {
 
 
 
+// NOTE: Stores `value` boxed as an `any` through `address`
+void ir_emit_store_any(irProcedure *proc, irValue *address, irValue *value) {
+	Type *src_type = ir_type(value);
+	if (is_type_any(src_type)) {
+		ir_emit_store(proc, address, value);
+		return;
+	}
+	if (is_type_untyped_nil(src_type)) {
+		ir_emit_store(proc, address, ir_value_nil(proc->module->allocator, t_any));
+		return;
+	}
+
+	Type *st = default_type(src_type);
+	if (value->kind == irValue_Constant) {
+		value = ir_emit_conv(proc, value, st);
+	}
+
+	irValue *data = NULL;
+	if (value->kind == irValue_Instr &&
+	    value->Instr.kind == irInstr_Load) {
+		// NOTE(bill): Addreirble value
+		data = value->Instr.Load.address;
+	} else {
+		// NOTE(bill): Non-addreirble value
+		// NOTE: Stored straight after, so it does not need to be zeroed first
+		Entity *e = make_entity_variable(proc->module->allocator, NULL, empty_token, st, false);
+		data = ir_add_local(proc, e, NULL, false);
+		ir_emit_store(proc, data, value);
+	}
+	GB_ASSERT(is_type_pointer(ir_type(data)));
+	GB_ASSERT_MSG(is_type_typed(st), "%s", type_to_string(st));
+	data = ir_emit_conv(proc, data, t_rawptr);
+
+
+	irValue *ti = ir_type_info(proc, st);
+
+	ir_emit_store(proc, ir_emit_struct_ep(proc, address, 0), data);
+	ir_emit_store(proc, ir_emit_struct_ep(proc, address, 1), ti);
+}
+
+// NOTE: `values` must already be of the element type, unless it is `any`
+irValue *ir_emit_variadic_slice(irProcedure *proc, Type *slice_type, irValue **values, isize count) {
+	gbAllocator a = proc->module->allocator;
+	if (count == 0) {
+		return ir_value_nil(a, slice_type);
+	}
+
+	Type *elem_type = base_type(slice_type)->Slice.elem;
+	bool is_any = are_types_identical(elem_type, t_any);
+	irValue *base_array = NULL;
+	if (is_any) {
+		// NOTE: Every element is stored straight after, so it does not need to be zeroed first
+		Entity *e = make_entity_variable(a, NULL, empty_token, make_type_array(a, t_any, count), false);
+		base_array = ir_add_local(proc, e, NULL, false);
+		array_add(&proc->variadic_any_arrays, base_array);
+	} else {
+		base_array = ir_add_local_generated(proc, make_type_array(a, elem_type, count));
+	}
+
+	for (isize i = 0; i < count; i++) {
+		irValue *addr = ir_emit_array_epi(proc, base_array, i);
+		if (is_any) {
+			ir_emit_store_any(proc, addr, values[i]);
+		} else {
+			ir_emit_store(proc, addr, values[i]);
+		}
+	}
+
+	Entity *e = make_entity_variable(a, NULL, empty_token, slice_type, false);
+	irValue *slice = ir_add_local(proc, e, NULL, false);
+	irValue *base_elem = ir_emit_array_epi(proc, base_array, 0);
+	irValue *len = ir_const_int(a, count);
+	ir_fill_slice(proc, slice, base_elem, len, len);
+	return ir_emit_load(proc, slice);
+}
+
 irValue *ir_emit_conv(irProcedure *proc, irValue *value, Type *t) {
 	Type *src_type = ir_type(value);
 	if (are_types_identical(t, src_type)) {
@@ -3038,6 +3405,9 @@ irValue *ir_emit_conv(irProcedure *proc, irValue *value, Type *t) {
 	if (is_type_vector(dst)) {
 		Type *dst_elem = dst->Vector.elem;
 		value = ir_emit_conv(proc, value, dst_elem);
+		if (is_type_simd_vector(dst)) {
+			return ir_emit_vector_splat(proc, value, t);
+		}
 		irValue *v = ir_add_local_generated(proc, t);
 		isize index_count = dst->Vector.count;
 
@@ -3055,28 +3425,7 @@ irValue *ir_emit_conv(irProcedure *proc, irValue *value, Type *t) {
 			return ir_emit_load(proc, result);
 		}
 
-		Type *st = default_type(src_type);
-
-		irValue *data = NULL;
-		if (value->kind == irValue_Instr &&
-		    value->Instr.kind == irInstr_Load) {
-			// NOTE(bill): Addreirble value
-			data = value->Instr.Load.address;
-		} else {
-			// NOTE(bill): Non-addreirble value
-			data = ir_add_local_generated(proc, st);
-			ir_emit_store(proc, data, value);
-		}
-		GB_ASSERT(is_type_pointer(ir_type(data)));
-		GB_ASSERT_MSG(is_type_typed(st), "%s", type_to_string(st));
-		data = ir_emit_conv(proc, data, t_rawptr);
-
-
-		irValue *ti = ir_type_info(proc, st);
-
-		ir_emit_store(proc, ir_emit_struct_ep(proc, result, 0), data);
-		ir_emit_store(proc, ir_emit_struct_ep(proc, result, 1), ti);
-
+		ir_emit_store_any(proc, result, value);
 		return ir_emit_load(proc, result);
 	}
 
@@ -3696,6 +4045,161 @@ irValue *ir_emit_source_code_location(irProcedure *proc, String procedure, Token
 	return ir_emit_global_call(proc, "make_source_code_location", args, 4);
 }
 
+irValue *ir_emit_printf_helper_call(irProcedure *proc, Entity *e, irValue **args, isize arg_count) {
+	irValue **found = map_get(&proc->module->values, hash_entity(e));
+	GB_ASSERT_MSG(found != NULL, "Missing fmt procedure `%.*s`", LIT(e->token.string));
+	TypeTuple *params = &base_type(e->type)->Proc.params->Tuple;
+	GB_ASSERT(params->variable_count == arg_count);
+	for (isize i = 0; i < arg_count; i++) {
+		args[i] = ir_emit_conv(proc, args[i], params->variables[i]->type);
+	}
+	return ir_emit_call(proc, *found, args, arg_count);
+}
+
+void ir_emit_printf_text(irProcedure *proc, PrintfHelpers *h, irValue *buf, gbString *text) {
+	isize len = gb_string_length(*text);
+	if (len == 0) {
+		return;
+	}
+	gbAllocator a = proc->module->allocator;
+	u8 *data = gb_alloc_array(a, u8, len);
+	gb_memcopy(data, *text, len);
+	gb_string_clear(*text);
+
+	irValue **args = gb_alloc_array(a, irValue *, 2);
+	args[0] = buf;
+	args[1] = ir_const_string(a, make_string(data, len));
+	ir_emit_printf_helper_call(proc, h->write_string, args, 2);
+}
+
+void ir_emit_store_field(irProcedure *proc, irValue *ptr, char *name, irValue *value) {
+	Selection sel = lookup_field(proc->module->allocator, type_deref(ir_type(ptr)), make_string_c(name), false);
+	GB_ASSERT_MSG(sel.entity != NULL, "Missing field `%s`", name);
+	irValue *field = ir_emit_deep_field_gep(proc, ptr, sel);
+	ir_emit_store(proc, field, ir_emit_conv(proc, value, type_deref(ir_type(field))));
+}
+
+// NOTE: Lowers a `#printf` call recorded by `check_printf_call`. The format string is parsed here rather
+// than at run time and each directive becomes a direct call to the `fmt_*` procedure for the type of its
+// argument, so only the arguments without such a procedure are boxed into an `any`
+irValue *ir_build_printf_call(irProcedure *proc, AstNode *expr, Entity *flush) {
+	ast_node(ce, CallExpr, expr);
+	irModule *m = proc->module;
+	gbAllocator a = m->allocator;
+
+	Entity *e = entity_of_call_proc(m->info, ce->proc);
+	PrintfHelpers h = {};
+	bool found_helpers = find_printf_helpers(e, &h);
+	GB_ASSERT(found_helpers && h.flush == flush);
+
+	isize lead_count = base_type(e->type)->Proc.param_count-2;
+	irValue **flush_args = gb_alloc_array(a, irValue *, lead_count+1);
+	for (isize i = 0; i < lead_count; i++) {
+		flush_args[i] = ir_build_expr(proc, ce->args[i]);
+	}
+
+	TypeAndValue format = type_and_value_of_expr(m->info, ce->args[lead_count]);
+	GB_ASSERT(format.value.kind == ExactValue_String);
+	Array<FormatVerb> verbs = {};
+	array_init(&verbs, heap_allocator());
+	defer (array_free(&verbs));
+	FormatParseResult parsed = parse_format_string(format.value.value_string, &verbs);
+	GB_ASSERT(parsed == FormatParse_Ok);
+
+	isize value_count = ce->args.count-lead_count-1;
+	irValue **values = gb_alloc_array(a, irValue *, value_count);
+	for (isize i = 0; i < value_count; i++) {
+		AstNode *arg = ce->args[lead_count+1+i];
+		Type *t = default_type(type_of_expr(m->info, arg));
+		if (is_type_untyped_nil(t)) {
+			// NOTE: `nil` has no type of its own so it is boxed into an `any`, as a variadic argument would be
+			t = t_any;
+		}
+		values[i] = ir_emit_conv(proc, ir_build_expr(proc, arg), t);
+	}
+
+	// NOTE: The buffer is only read up to what has been written to it so it is not zeroed
+	i64 buffer_size = big_int_to_i64(exact_value_to_integer(h.buffer_size->Constant.value).value_integer);
+	Type *data_type = make_type_array(a, t_u8, buffer_size);
+	irValue *data = ir_add_local(proc, make_entity_variable(a, proc->curr_block->scope, empty_token, data_type, false), NULL, false);
+	irValue *slice = ir_add_local_generated(proc, make_type_slice(a, t_u8));
+	ir_fill_slice(proc, slice, ir_emit_array_epi(proc, data, 0), v_zero, ir_const_int(a, buffer_size));
+
+	irValue **make_args = gb_alloc_array(a, irValue *, 1);
+	make_args[0] = ir_emit_load(proc, slice);
+	irValue *buffer = ir_emit_printf_helper_call(proc, h.make_buffer, make_args, 1);
+	irValue *buf = ir_add_local_generated(proc, ir_type(buffer));
+	ir_emit_store(proc, buf, buffer);
+
+	irValue *fi = ir_add_local_generated(proc, h.fmt_info->type);
+
+	gbString text = gb_string_make(heap_allocator(), "");
+	defer (gb_string_free(text));
+
+	isize value_index = 0;
+	for_array(i, verbs) {
+		FormatVerb *v = &verbs[i];
+		if (v->verb == 0) {
+			text = gb_string_append_length(text, v->text.text, v->text.len);
+			continue;
+		}
+		ir_emit_printf_text(proc, &h, buf, &text);
+
+		ir_emit_zero_init(proc, fi);
+		ir_emit_store_field(proc, fi, "buf", buf);
+		ir_emit_store_field(proc, fi, "good_arg_index", v_true);
+		if (v->plus)  ir_emit_store_field(proc, fi, "plus",  v_true);
+		if (v->minus) ir_emit_store_field(proc, fi, "minus", v_true);
+		if (v->space) ir_emit_store_field(proc, fi, "space", v_true);
+		if (v->zero)  ir_emit_store_field(proc, fi, "zero",  v_true);
+		if (v->hash)  ir_emit_store_field(proc, fi, "hash",  v_true);
+		if (v->width_set) {
+			ir_emit_store_field(proc, fi, "width_set", v_true);
+			ir_emit_store_field(proc, fi, "width", ir_const_int(a, v->width));
+		}
+		if (v->prec_set) {
+			ir_emit_store_field(proc, fi, "prec_set", v_true);
+			ir_emit_store_field(proc, fi, "prec", ir_const_int(a, v->prec));
+		}
+
+		irValue *value = values[value_index++];
+		Type *t = base_type(ir_type(value));
+		i64 bits = 8*type_size_of(a, t);
+		irValue *verb = ir_value_constant(a, t_rune, exact_value_i64(v->verb));
+		irValue **args = gb_alloc_array(a, irValue *, 5);
+		args[0] = fi;
+		args[1] = value;
+		args[2] = verb;
+		isize arg_count = 3;
+		Entity *fmt_proc = h.fmt_arg;
+		if (v->verb != 'T' && t->kind == Type_Basic) {
+			if (is_type_boolean(t)) {
+				fmt_proc = h.fmt_bool;
+			} else if (is_type_rune(t)) {
+				fmt_proc = h.fmt_rune;
+			} else if (is_type_integer(t)) {
+				fmt_proc = h.fmt_int;
+				args[2] = ir_const_bool(a, !is_type_unsigned(t));
+				args[3] = ir_const_int(a, bits);
+				args[4] = verb;
+				arg_count = 5;
+			} else if (is_type_float(t)) {
+				fmt_proc = h.fmt_float;
+				args[2] = ir_const_int(a, bits);
+				args[3] = verb;
+				arg_count = 4;
+			} else if (is_type_string(t)) {
+				fmt_proc = h.fmt_string;
+			}
+		}
+		ir_emit_printf_helper_call(proc, fmt_proc, args, arg_count);
+	}
+	ir_emit_printf_text(proc, &h, buf, &text);
+
+	flush_args[lead_count] = buf;
+	return ir_emit_printf_helper_call(proc, h.flush, flush_args, lead_count+1);
+}
+
 irValue *ir_build_builtin_proc(irProcedure *proc, AstNode *expr, TypeAndValue tv, BuiltinProcId id) {
 	ast_node(ce, CallExpr, expr);
 
@@ -4103,7 +4607,7 @@ irValue *ir_build_builtin_proc(irProcedure *proc, AstNode *expr, TypeAndValue tv
 			}
 		}
 
-		if (!vari_expand) {
+		if (!vari_expand && !are_types_identical(elem_type, t_any)) {
 			for (isize i = 1; i < arg_count; i++) {
 				args[i] = ir_emit_conv(proc, args[i], elem_type);
 			}
@@ -4112,24 +4616,10 @@ irValue *ir_build_builtin_proc(irProcedure *proc, AstNode *expr, TypeAndValue tv
 		if (!vari_expand) {
 			ir_emit_comment(proc, str_lit("variadic call argument generation"));
 			Type *slice_type = make_type_slice(a, elem_type);
-			irValue *slice = ir_add_local_generated(proc, slice_type);
-			isize slice_len = arg_count-1;
-
-			if (slice_len > 0) {
-				irValue *base_array = ir_add_local_generated(proc, make_type_array(a, elem_type, slice_len));
-
-				for (isize i = 1; i < arg_count; i++) {
-					irValue *addr = ir_emit_array_epi(proc, base_array, i-1);
-					ir_emit_store(proc, addr, args[i]);
-				}
-
-				irValue *base_elem  = ir_emit_array_epi(proc, base_array, 0);
-				irValue *len = ir_const_int(a, slice_len);
-				ir_fill_slice(proc, slice, base_elem, len, len);
-			}
+			irValue *slice = ir_emit_variadic_slice(proc, slice_type, args+1, arg_count-1);
 
 			arg_count = 2;
-			args[arg_count-1] = ir_emit_load(proc, slice);
+			args[arg_count-1] = slice;
 		}
 
 		irValue *item_slice = args[1];
@@ -4201,8 +4691,22 @@ irValue *ir_build_builtin_proc(irProcedure *proc, AstNode *expr, TypeAndValue tv
 	} break;
 	case BuiltinProc_swizzle: {
 		ir_emit_comment(proc, str_lit("swizzle.begin"));
-		irAddr vector_addr = ir_build_addr(proc, ce->args[0]);
 		isize index_count = ce->args.count-1;
+		if (is_type_simd_vector(tv.type)) {
+			irValue *vector = ir_build_expr(proc, ce->args[0]);
+			if (index_count == 0) {
+				return vector;
+			}
+			i32 *indices = gb_alloc_array(proc->module->allocator, i32, index_count);
+			for (i32 i = 1; i < ce->args.count; i++) {
+				TypeAndValue tv = type_and_value_of_expr(proc->module->info, ce->args[i]);
+				GB_ASSERT(tv.value.kind == ExactValue_Integer);
+				indices[i-1] = cast(i32)big_int_to_i64(tv.value.value_integer);
+			}
+			return ir_emit(proc, ir_instr_vector_shuffle(proc, vector, NULL, indices, cast(i32)index_count, tv.type));
+		}
+
+		irAddr vector_addr = ir_build_addr(proc, ce->args[0]);
 		if (index_count == 0) {
 			return ir_addr_load(proc, vector_addr);
 		}
@@ -4214,7 +4718,7 @@ irValue *ir_build_builtin_proc(irProcedure *proc, AstNode *expr, TypeAndValue tv
 			GB_ASSERT(is_type_integer(tv.type));
 			GB_ASSERT(tv.value.kind == ExactValue_Integer);
 
-			i32 src_index = cast(i32)i128_to_i64(tv.value.value_integer);
+			i32 src_index = cast(i32)big_int_to_i64(tv.value.value_integer);
 			i32 dst_index = i-1;
 
 			irValue *src_elem = ir_emit_array_epi(proc, src, src_index);
@@ -4224,7 +4728,6 @@ irValue *ir_build_builtin_proc(irProcedure *proc, AstNode *expr, TypeAndValue tv
 		}
 		ir_emit_comment(proc, str_lit("swizzle.end"));
 		return ir_emit_load(proc, dst);
-		// return ir_emit(proc, ir_instr_vector_shuffle(proc, vector, indices, index_count));
 	} break;
 
 	case BuiltinProc_complex: {
@@ -4373,6 +4876,90 @@ irValue *ir_build_builtin_proc(irProcedure *proc, AstNode *expr, TypeAndValue tv
 		                     ir_build_expr(proc, ce->args[1]),
 		                     ir_build_expr(proc, ce->args[2]));
 	} break;
+
+	case BuiltinProc_shuffle: {
+		ir_emit_comment(proc, str_lit("shuffle"));
+		irValue *a = ir_build_expr(proc, ce->args[0]);
+		irValue *b = ir_build_expr(proc, ce->args[1]);
+		isize index_count = ce->args.count-2;
+		i32 *indices = gb_alloc_array(proc->module->allocator, i32, index_count);
+		for (isize i = 2; i < ce->args.count; i++) {
+			TypeAndValue tv = type_and_value_of_expr(proc->module->info, ce->args[i]);
+			GB_ASSERT(tv.value.kind == ExactValue_Integer);
+			indices[i-2] = cast(i32)big_int_to_i64(tv.value.value_integer);
+		}
+		return ir_emit(proc, ir_instr_vector_shuffle(proc, a, b, indices, cast(i32)index_count, tv.type));
+	} break;
+
+	case BuiltinProc_reduce_add:
+	case BuiltinProc_reduce_min:
+	case BuiltinProc_reduce_max: {
+		ir_emit_comment(proc, str_lit("reduce"));
+		TokenKind op = Token_Add;
+		switch (id) {
+		case BuiltinProc_reduce_min: op = Token_Lt; break;
+		case BuiltinProc_reduce_max: op = Token_Gt; break;
+		}
+		irValue *v = ir_build_expr(proc, ce->args[0]);
+		return ir_emit(proc, ir_instr_vector_reduce(proc, op, v));
+	} break;
+
+	case BuiltinProc_fma: {
+		ir_emit_comment(proc, str_lit("fma"));
+		Type *t = type_of_expr(proc->module->info, expr);
+		irValue *a = ir_emit_conv(proc, ir_build_expr(proc, ce->args[0]), t);
+		irValue *b = ir_emit_conv(proc, ir_build_expr(proc, ce->args[1]), t);
+		irValue *c = ir_emit_conv(proc, ir_build_expr(proc, ce->args[2]), t);
+		return ir_emit(proc, ir_instr_fused_mul_add(proc, a, b, c));
+	} break;
+
+	case BuiltinProc_select: {
+		ir_emit_comment(proc, str_lit("select"));
+		Type *t = type_of_expr(proc->module->info, expr);
+		irValue *mask = ir_build_expr(proc, ce->args[0]);
+		if (!is_type_simd_vector(ir_type(mask))) {
+			// NOTE: A boolean vector is one byte per lane in memory so reread it as a byte vector
+			gbAllocator a = proc->module->allocator;
+			i64 count = base_type(ir_type(mask))->Vector.count;
+			Type *byte_vector = make_type_vector(a, t_u8, count);
+			irValue *addr = ir_address_from_load_or_generate_local(proc, mask);
+			mask = ir_emit_load(proc, ir_emit_bitcast(proc, addr, make_type_pointer(a, byte_vector)));
+		}
+		irValue *x = ir_emit_conv(proc, ir_build_expr(proc, ce->args[1]), t);
+		irValue *y = ir_emit_conv(proc, ir_build_expr(proc, ce->args[2]), t);
+		return ir_emit(proc, ir_instr_vector_select(proc, mask, x, y));
+	} break;
+
+	case BuiltinProc_gather:
+	case BuiltinProc_scatter: {
+		if (id == BuiltinProc_gather) {
+			ir_emit_comment(proc, str_lit("gather"));
+		} else {
+			ir_emit_comment(proc, str_lit("scatter"));
+		}
+		irValue *slice = ir_build_expr(proc, ce->args[0]);
+		irValue *indices = ir_build_expr(proc, ce->args[1]);
+
+		if ((proc->module->stmt_state_flags & StmtStateFlag_no_bounds_check) == 0) {
+			Token token = ast_node_token(ce->args[1]);
+			irValue *len = ir_slice_count(proc, slice);
+			i64 count = base_type(ir_type(indices))->Vector.count;
+			for (i32 i = 0; i < count; i++) {
+				ir_emit_bounds_check(proc, token, ir_emit_vector_extract(proc, indices, i), len);
+			}
+		}
+
+		irValue *elem = ir_slice_elem(proc, slice);
+		irValue *ptrs = ir_emit(proc, ir_instr_vector_element_ptrs(proc, elem, indices));
+		if (id == BuiltinProc_gather) {
+			return ir_emit(proc, ir_instr_vector_gather(proc, ptrs, tv.type));
+		}
+
+		Type *vector_type = make_type_vector(proc->module->allocator, type_deref(ir_type(elem)), base_type(ir_type(indices))->Vector.count);
+		irValue *values = ir_emit_conv(proc, ir_build_expr(proc, ce->args[2]), vector_type);
+		ir_emit(proc, ir_instr_vector_scatter(proc, ptrs, values));
+		return NULL;
+	} break;
 	}
 
 	GB_PANIC("Unhandled built-in procedure");
@@ -4657,6 +5244,11 @@ irValue *ir_build_expr(irProcedure *proc, AstNode *expr) {
 			return ir_build_builtin_proc(proc, expr, tv, id);
 		}
 
+		Entity **printf_flush = map_get(&proc->module->info->printf_calls, hash_node(expr));
+		if (printf_flush != NULL) {
+			return ir_build_printf_call(proc, expr, *printf_flush);
+		}
+
 		// NOTE(bill): Regular call
 		irValue *value = ir_build_expr(proc, ce->proc);
 		GB_ASSERT(value != NULL);
@@ -4789,8 +5381,11 @@ irValue *ir_build_expr(irProcedure *proc, AstNode *expr) {
 				Type *variadic_type = pt->variables[i]->type;
 				GB_ASSERT(is_type_slice(variadic_type));
 				variadic_type = base_type(variadic_type)->Slice.elem;
-				for (; i < arg_count; i++) {
-					args[i] = ir_emit_conv(proc, args[i], variadic_type);
+				// NOTE: `any` arguments are boxed straight into the slice's backing array
+				if (!are_types_identical(variadic_type, t_any)) {
+					for (; i < arg_count; i++) {
+						args[i] = ir_emit_conv(proc, args[i], variadic_type);
+					}
 				}
 			}
 		} else {
@@ -4806,27 +5401,12 @@ irValue *ir_build_expr(irProcedure *proc, AstNode *expr) {
 
 		if (variadic && !vari_expand && !is_c_vararg) {
 			ir_emit_comment(proc, str_lit("variadic call argument generation"));
-			gbAllocator allocator = proc->module->allocator;
 			Type *slice_type = pt->variables[type->param_count-1]->type;
-			Type *elem_type  = base_type(slice_type)->Slice.elem;
-			irValue *slice = ir_add_local_generated(proc, slice_type);
 			isize slice_len = arg_count+1 - type->param_count;
-
-			if (slice_len > 0) {
-				irValue *base_array = ir_add_local_generated(proc, make_type_array(allocator, elem_type, slice_len));
-
-				for (isize i = type->param_count-1, j = 0; i < arg_count; i++, j++) {
-					irValue *addr = ir_emit_array_epi(proc, base_array, j);
-					ir_emit_store(proc, addr, args[i]);
-				}
-
-				irValue *base_elem = ir_emit_array_epi(proc, base_array, 0);
-				irValue *len = ir_const_int(allocator, slice_len);
-				ir_fill_slice(proc, slice, base_elem, len, len);
-			}
+			irValue *slice = ir_emit_variadic_slice(proc, slice_type, args+type->param_count-1, slice_len);
 
 			arg_count = type->param_count;
-			args[arg_count-1] = ir_emit_load(proc, slice);
+			args[arg_count-1] = slice;
 		}
 
 		return ir_emit_call(proc, value, args, final_count);
@@ -4995,7 +5575,7 @@ irAddr ir_build_addr(irProcedure *proc, AstNode *expr) {
 			Type *selector_type = base_type(type_of_expr(proc->module->info, se->selector));
 			GB_ASSERT_MSG(is_type_integer(selector_type), "%s", type_to_string(selector_type));
 			ExactValue val = type_and_value_of_expr(proc->module->info, sel).value;
-			i64 index = i128_to_i64(val.value_integer);
+			i64 index = big_int_to_i64(val.value_integer);
 
 			Selection sel = lookup_field_from_index(proc->module->allocator, type, index);
 			GB_ASSERT(sel.entity != NULL);
@@ -5715,17 +6295,7 @@ void ir_build_range_indexed(irProcedure *proc, irValue *expr, Type *val_type, ir
 
 			irValue *entry = ir_emit_ptr_offset(proc, elem, idx);
 			val = ir_emit_load(proc, ir_emit_struct_ep(proc, entry, 2));
-
-			irValue *hash = ir_emit_struct_ep(proc, entry, 0);
-			if (is_type_string(expr_type->Map.key)) {
-				irValue *str = ir_emit_struct_ep(proc, hash, 1);
-				ir_emit_store(proc, key, ir_emit_load(proc, str));
-			} else {
-				irValue *hash_ptr = ir_emit_struct_ep(proc, hash, 0);
-				hash_ptr = ir_emit_conv(proc, hash_ptr, ir_type(key));
-				ir_emit_store(proc, key, ir_emit_load(proc, hash_ptr));
-			}
-
+			ir_emit_store(proc, key, ir_emit_load(proc, ir_emit_struct_ep(proc, entry, 1)));
 
 		} break;
 		default:
@@ -5916,6 +6486,255 @@ void ir_build_poly_proc(irProcedure *proc, AstNodeProcDecl *pd, Entity *e) {
 }
 
 
+// NOTE: A `match` whose cases are all constants is dispatched with `switch` instructions, which
+// llc lowers to jump tables or binary searches, rather than with a compare per case.
+// Integer tags switch on the value, string tags switch on the length and, when a length has
+// enough cases, on the hash of the tag before the bytes are compared.
+gb_global i64   const ir_match_max_range_count = 256; // Values a constant case range may expand to
+gb_global isize const ir_match_string_hash_min = 4;   // Cases of one length needed to switch on the hash
+
+enum irMatchKind {
+	irMatch_Chain,
+	irMatch_Integer,
+	irMatch_String,
+};
+
+struct irMatchCase {
+	ExactValue value;
+	irBlock *  body;
+	isize      index; // Position in source order
+	u64        hash;  // Strings only
+};
+
+irMatchKind ir_match_stmt_kind(irProcedure *proc, AstNodeMatchStmt *ms) {
+	if (ms->tag == NULL) {
+		return irMatch_Chain;
+	}
+	CheckerInfo *info = proc->module->info;
+	Type *t = core_type(type_of_expr(info, ms->tag));
+	irMatchKind kind = irMatch_Chain;
+	if (is_type_integer(t) && type_size_of(proc->module->allocator, t) <= 8) {
+		kind = irMatch_Integer;
+	} else if (is_type_string(t)) {
+		kind = irMatch_String;
+	} else {
+		return irMatch_Chain;
+	}
+
+	ast_node(body, BlockStmt, ms->body);
+	for_array(i, body->stmts) {
+		ast_node(cc, CaseClause, body->stmts[i]);
+		for_array(j, cc->list) {
+			AstNode *expr = unparen_expr(cc->list[j]);
+			if (is_ast_node_a_range(expr)) {
+				if (kind != irMatch_Integer) {
+					return irMatch_Chain;
+				}
+				ast_node(ie, BinaryExpr, expr);
+				TypeAndValue lo = type_and_value_of_expr(info, ie->left);
+				TypeAndValue hi = type_and_value_of_expr(info, ie->right);
+				if (lo.mode != Addressing_Constant || lo.value.kind != ExactValue_Integer ||
+				    hi.mode != Addressing_Constant || hi.value.kind != ExactValue_Integer) {
+					return irMatch_Chain;
+				}
+				BigInt count = big_int_sub(hi.value.value_integer, lo.value.value_integer);
+				if (big_int_cmp_i64(count, ir_match_max_range_count) > 0) {
+					return irMatch_Chain;
+				}
+			} else {
+				TypeAndValue tav = type_and_value_of_expr(info, expr);
+				ExactValueKind value_kind = kind == irMatch_Integer ? ExactValue_Integer : ExactValue_String;
+				if (tav.mode != Addressing_Constant || tav.value.kind != value_kind) {
+					return irMatch_Chain;
+				}
+			}
+		}
+	}
+	return kind;
+}
+
+void ir_match_add_case(Map<bool> *seen, Array<irMatchCase> *cases, ExactValue value, irBlock *body) {
+	// NOTE: The first case with a value wins, as it would in a chain of compares
+	// Strings are keyed on their contents as `hash_exact_value` only sees their pointer
+	HashKey key = {};
+	if (value.kind == ExactValue_String) {
+		key = hash_string(value.value_string);
+	} else {
+		key = hash_exact_value(value);
+	}
+	if (map_get(seen, key) != NULL) {
+		return;
+	}
+	map_set(seen, key, true);
+	irMatchCase c = {value, body, cases->count};
+	array_add(cases, c);
+}
+
+// NOTE: Compares the bytes of the tag, whose length is already known to be `len`, with each case in
+// turn and jumps to `default_block` if none of them match
+void ir_build_match_string_compares(irProcedure *proc, irValue *tag, isize len, irMatchCase *cases, isize count, irBlock *default_block) {
+	gbAllocator a = proc->module->allocator;
+	if (len == 0) {
+		GB_ASSERT(count == 1);
+		ir_emit_jump(proc, cases[0].body);
+		return;
+	}
+	for (isize i = 0; i < count; i++) {
+		irValue *str = ir_value_constant(a, t_string, cases[i].value);
+		irValue **args = gb_alloc_array(a, irValue *, 3);
+		args[0] = ir_emit_conv(proc, ir_string_elem(proc, tag), t_rawptr);
+		args[1] = ir_emit_conv(proc, ir_string_elem(proc, str), t_rawptr);
+		args[2] = ir_const_int(a, len);
+		irValue *cond = ir_emit_global_call(proc, "__mem_equal", args, 3);
+
+		irBlock *next = default_block;
+		if (i+1 < count) {
+			next = ir_new_block(proc, NULL, "match.string.next");
+		}
+		ir_emit_if(proc, cond, cases[i].body, next);
+		if (next != default_block) {
+			ir_start_block(proc, next);
+		}
+	}
+}
+
+GB_COMPARE_PROC(ir_match_string_case_cmp) {
+	irMatchCase *x = cast(irMatchCase *)a;
+	irMatchCase *y = cast(irMatchCase *)b;
+	isize xl = x->value.value_string.len;
+	isize yl = y->value.value_string.len;
+	if (xl != yl) {
+		return xl < yl ? -1 : +1;
+	}
+	if (x->hash != y->hash) {
+		return x->hash < y->hash ? -1 : +1;
+	}
+	// NOTE: Cases that collide are compared in source order
+	if (x->index != y->index) {
+		return x->index < y->index ? -1 : +1;
+	}
+	return 0;
+}
+
+void ir_build_match_string_dispatch(irProcedure *proc, irValue *tag, Array<irMatchCase> cases, irBlock *default_block) {
+	gbAllocator a = proc->module->allocator;
+
+	// NOTE: The values are unique so their order only matters for the layout of the dispatch, the
+	// index keeps it deterministic as `gb_sort_array` is not stable
+	for_array(i, cases) {
+		cases[i].hash = ir_default_hash_string(cases[i].value.value_string);
+	}
+	gb_sort_array(cases.data, cases.count, ir_match_string_case_cmp);
+
+	isize len_count = 0;
+	irValue **len_values = gb_alloc_array(a, irValue *, cases.count);
+	irBlock **len_blocks = gb_alloc_array(a, irBlock *, cases.count);
+	for_array(i, cases) {
+		isize len = cases[i].value.value_string.len;
+		if (i == 0 || len != cases[i-1].value.value_string.len) {
+			len_values[len_count] = ir_const_int(a, len);
+			len_blocks[len_count] = ir_new_block(proc, NULL, "match.string.len");
+			len_count++;
+		}
+	}
+	ir_emit_switch(proc, ir_string_len(proc, tag), default_block, len_values, len_blocks, len_count);
+
+	for (isize i = 0, g = 0; i < cases.count; g++) {
+		isize len = cases[i].value.value_string.len;
+		isize end = i+1;
+		while (end < cases.count && cases[end].value.value_string.len == len) {
+			end++;
+		}
+		irMatchCase *group = cases.data+i;
+		isize group_count = end-i;
+		i = end;
+
+		ir_start_block(proc, len_blocks[g]);
+		if (group_count < ir_match_string_hash_min) {
+			ir_build_match_string_compares(proc, tag, len, group, group_count, default_block);
+			continue;
+		}
+
+		isize bucket_count = 0;
+		irValue **hash_values = gb_alloc_array(a, irValue *, group_count);
+		irBlock **hash_blocks = gb_alloc_array(a, irBlock *, group_count);
+		for (isize k = 0; k < group_count; k++) {
+			if (k == 0 || group[k].hash != group[k-1].hash) {
+				hash_values[bucket_count] = ir_value_constant(a, t_u64, exact_value_u64(group[k].hash));
+				hash_blocks[bucket_count] = ir_new_block(proc, NULL, "match.string.hash");
+				bucket_count++;
+			}
+		}
+
+		irValue **args = gb_alloc_array(a, irValue *, 1);
+		args[0] = tag;
+		irValue *hash = ir_emit_global_call(proc, "__default_hash_string", args, 1);
+		ir_emit_switch(proc, hash, default_block, hash_values, hash_blocks, bucket_count);
+
+		for (isize k = 0, bucket = 0; k < group_count; bucket++) {
+			isize bucket_end = k+1;
+			while (bucket_end < group_count && group[bucket_end].hash == group[k].hash) {
+				bucket_end++;
+			}
+			ir_start_block(proc, hash_blocks[bucket]);
+			ir_build_match_string_compares(proc, tag, len, group+k, bucket_end-k, default_block);
+			k = bucket_end;
+		}
+	}
+}
+
+void ir_build_match_dispatch(irProcedure *proc, AstNodeMatchStmt *ms, irMatchKind kind, irValue *tag, irBlock **bodies, irBlock *default_block) {
+	gbAllocator a = proc->module->allocator;
+	CheckerInfo *info = proc->module->info;
+	Type *tag_type = ir_type(tag);
+	bool is_unsigned = is_type_unsigned(tag_type);
+
+	Array<irMatchCase> cases = {};
+	Map<bool> seen = {};
+	array_init(&cases, heap_allocator());
+	map_init(&seen, heap_allocator());
+	defer (array_free(&cases));
+	defer (map_destroy(&seen));
+
+	ast_node(body, BlockStmt, ms->body);
+	for_array(i, body->stmts) {
+		ast_node(cc, CaseClause, body->stmts[i]);
+		for_array(j, cc->list) {
+			AstNode *expr = unparen_expr(cc->list[j]);
+			if (!is_ast_node_a_range(expr)) {
+				ExactValue value = type_and_value_of_expr(info, expr).value;
+				ir_match_add_case(&seen, &cases, value, bodies[i]);
+				continue;
+			}
+			ast_node(ie, BinaryExpr, expr);
+			BigInt lo = type_and_value_of_expr(info, ie->left).value.value_integer;
+			BigInt hi = type_and_value_of_expr(info, ie->right).value.value_integer;
+			i64 count = big_int_to_i64(big_int_sub(hi, lo));
+			if (ie->op.kind == Token_Ellipsis) {
+				count += 1;
+			}
+			for (i64 k = 0; k < count; k++) {
+				BigInt v = big_int_add(lo, big_int_from_i64(k));
+				ExactValue value = is_unsigned ? exact_value_u64(big_int_to_u64(v)) : exact_value_i64(big_int_to_i64(v));
+				ir_match_add_case(&seen, &cases, value, bodies[i]);
+			}
+		}
+	}
+
+	if (kind == irMatch_String) {
+		ir_build_match_string_dispatch(proc, tag, cases, default_block);
+		return;
+	}
+
+	irValue **case_values = gb_alloc_array(a, irValue *, cases.count);
+	irBlock **case_blocks = gb_alloc_array(a, irBlock *, cases.count);
+	for_array(i, cases) {
+		case_values[i] = ir_value_constant(a, tag_type, cases[i].value);
+		case_blocks[i] = cases[i].body;
+	}
+	ir_emit_switch(proc, tag, default_block, case_values, case_blocks, cases.count);
+}
+
 void ir_build_stmt_internal(irProcedure *proc, AstNode *node) {
 	switch (node->kind) {
 	case_ast_node(bs, EmptyStmt, node);
@@ -5957,7 +6776,7 @@ void ir_build_stmt_internal(irProcedure *proc, AstNode *node) {
 				ast_node(vd, ValueSpec, spec);
 
 				irModule *m = proc->module;
-				gbTempArenaMemory tmp = gb_temp_arena_memory_begin(&m->tmp_arena);
+				DynamicArenaTempMemory tmp = dynamic_arena_temp_memory_begin(&m->tmp_arena);
 
 				if (vd->values.count == 0) { // declared and zero-initialized
 					for_array(i, vd->names) {
@@ -6003,7 +6822,7 @@ void ir_build_stmt_internal(irProcedure *proc, AstNode *node) {
 					}
 				}
 
-				gb_temp_arena_memory_end(tmp);
+				dynamic_arena_temp_memory_end(tmp);
 			} break;
 
 			case Token_type: {
@@ -6084,7 +6903,7 @@ void ir_build_stmt_internal(irProcedure *proc, AstNode *node) {
 		ir_emit_comment(proc, str_lit("AssignStmt"));
 
 		irModule *m = proc->module;
-		gbTempArenaMemory tmp = gb_temp_arena_memory_begin(&m->tmp_arena);
+		DynamicArenaTempMemory tmp = dynamic_arena_temp_memory_begin(&m->tmp_arena);
 
 		switch (as->op.kind) {
 		case Token_Eq: {
@@ -6155,7 +6974,7 @@ void ir_build_stmt_internal(irProcedure *proc, AstNode *node) {
 		} break;
 		}
 
-		gb_temp_arena_memory_end(tmp);
+		dynamic_arena_temp_memory_end(tmp);
 	case_end;
 
 	case_ast_node(es, ExprStmt, node);
@@ -6187,8 +7006,8 @@ void ir_build_stmt_internal(irProcedure *proc, AstNode *node) {
 
 		if (res_count > 0 &&
 		    rs->results[0]->kind == AstNode_FieldValue) {
-			gbTempArenaMemory tmp = gb_temp_arena_memory_begin(&proc->module->tmp_arena);
-			defer (gb_temp_arena_memory_end(tmp));
+			DynamicArenaTempMemory tmp = dynamic_arena_temp_memory_begin(&proc->module->tmp_arena);
+			defer (dynamic_arena_temp_memory_end(tmp));
 
 			Array<irValue *> results;
 			array_init_count(&results, proc->module->tmp_allocator, return_count);
@@ -6247,8 +7066,8 @@ void ir_build_stmt_internal(irProcedure *proc, AstNode *node) {
 				v = ir_emit_conv(proc, v, e->type);
 			}
 		} else {
-			gbTempArenaMemory tmp = gb_temp_arena_memory_begin(&proc->module->tmp_arena);
-			defer (gb_temp_arena_memory_end(tmp));
+			DynamicArenaTempMemory tmp = dynamic_arena_temp_memory_begin(&proc->module->tmp_arena);
+			defer (dynamic_arena_temp_memory_end(tmp));
 
 			Array<irValue *> results;
 			array_init(&results, proc->module->tmp_allocator, return_count);
@@ -6575,6 +7394,45 @@ void ir_build_stmt_internal(irProcedure *proc, AstNode *node) {
 
 		ast_node(body, BlockStmt, ms->body);
 
+		irMatchKind match_kind = ir_match_stmt_kind(proc, ms);
+		if (match_kind != irMatch_Chain) {
+			isize case_count = body->stmts.count;
+			irBlock **bodies = gb_alloc_array(proc->module->allocator, irBlock *, case_count);
+			irBlock *default_block = done;
+			for_array(i, body->stmts) {
+				AstNode *clause = body->stmts[i];
+				ast_node(cc, CaseClause, clause);
+				if (cc->list.count == 0) {
+					bodies[i] = ir_new_block(proc, clause, "match.dflt.body");
+					default_block = bodies[i];
+				} else {
+					bodies[i] = ir_new_block(proc, clause, "match.case.body");
+				}
+			}
+
+			tag = ir_emit_conv(proc, tag, default_type(ir_type(tag)));
+			ir_build_match_dispatch(proc, ms, match_kind, tag, bodies, default_block);
+
+			for_array(i, body->stmts) {
+				ast_node(cc, CaseClause, body->stmts[i]);
+				irBlock *fall = done;
+				if (i+1 < case_count) {
+					fall = bodies[i+1];
+				}
+
+				ir_start_block(proc, bodies[i]);
+				ir_push_target_list(proc, ms->label, done, NULL, fall);
+				ir_open_scope(proc);
+				ir_build_stmt_list(proc, cc->stmts);
+				ir_close_scope(proc, irDeferExit_Default, bodies[i]);
+				ir_pop_target_list(proc);
+				ir_emit_jump(proc, done);
+			}
+
+			ir_start_block(proc, done);
+			break;
+		}
+
 		Array<AstNode *> default_stmts = {};
 		irBlock *default_fall = NULL;
 		irBlock *default_block = NULL;
@@ -6916,6 +7774,7 @@ void ir_begin_procedure_body(irProcedure *proc) {
 	array_init(&proc->children,         heap_allocator());
 	array_init(&proc->branch_blocks,    heap_allocator());
 	array_init(&proc->context_stack,    heap_allocator());
+	array_init(&proc->variadic_any_arrays, heap_allocator());
 
 	DeclInfo *decl = decl_info_of_entity(proc->module->info, proc->entity);
 	if (decl != NULL) {
@@ -7014,6 +7873,9 @@ void ir_insert_code_before_proc(irProcedure* proc, irProcedure *parent) {
 void ir_build_proc(irValue *value, irProcedure *parent) {
 	irProcedure *proc = &value->Proc;
 
+	isize trace = trace_begin(str_lit("ir_build_proc"), proc->name);
+	defer (trace_end(trace));
+
 	proc->parent = parent;
 
 	if (proc->entity != NULL) {
@@ -7080,13 +7942,11 @@ void ir_module_add_value(irModule *m, Entity *e, irValue *v) {
 }
 
 void ir_init_module(irModule *m, Checker *c) {
-	// TODO(bill): Determine a decent size for the arena
-	isize token_count = c->parser->total_token_count;
-	isize arena_size = 4 * token_count * gb_size_of(irValue);
-	gb_arena_init_from_allocator(&m->arena, heap_allocator(), arena_size);
-	gb_arena_init_from_allocator(&m->tmp_arena, heap_allocator(), arena_size);
-	m->allocator     = gb_arena_allocator(&m->arena);
-	m->tmp_allocator = gb_arena_allocator(&m->tmp_arena);
+	// NOTE: The arenas grow in blocks as needed so they no longer have to be sized up front
+	init_dynamic_arena(&m->arena,     gb_megabytes(4));
+	init_dynamic_arena(&m->tmp_arena, gb_megabytes(1));
+	m->allocator     = dynamic_arena_allocator(&m->arena);
+	m->tmp_allocator = dynamic_arena_allocator(&m->tmp_arena);
 	m->info = &c->info;
 
 	map_init(&m->values,  heap_allocator());
@@ -7097,6 +7957,8 @@ void ir_init_module(irModule *m, Checker *c) {
 	array_init(&m->procs_to_generate, heap_allocator());
 	array_init(&m->foreign_library_paths, heap_allocator());
 	map_init(&m->const_strings, heap_allocator());
+	map_init(&m->intrinsics, heap_allocator());
+	map_init(&m->param_escapes, heap_allocator());
 
 	// Default states
 	m->stmt_state_flags = 0;
@@ -7209,10 +8071,13 @@ void ir_destroy_module(irModule *m) {
 	map_destroy(&m->entity_names);
 	map_destroy(&m->debug_info);
 	map_destroy(&m->const_strings);
+	map_destroy(&m->intrinsics);
+	map_destroy(&m->param_escapes);
 	array_free(&m->procs);
 	array_free(&m->procs_to_generate);
 	array_free(&m->foreign_library_paths);
-	gb_arena_free(&m->arena);
+	destroy_dynamic_arena(&m->arena);
+	destroy_dynamic_arena(&m->tmp_arena);
 }
 
 
@@ -7368,7 +8233,11 @@ void ir_gen_tree(irGen *s) {
 	array_init(&global_variables, m->tmp_allocator, global_variable_max_count);
 
 	m->entry_point_entity = entry_point;
+	timings_begin_sub_section(&global_timings, str_lit("dependency map"));
 	m->min_dep_map = generate_minimum_dependency_map(info, entry_point);
+	timings_end_sub_section(&global_timings);
+
+	timings_begin_sub_section(&global_timings, str_lit("global entities"));
 
 	for_array(i, info->entities.entries) {
 		auto *entry = &info->entities.entries[i];
@@ -7612,6 +8481,9 @@ void ir_gen_tree(irGen *s) {
 		ir_end_procedure_body(proc);
 	}
 #endif
+	timings_end_sub_section(&global_timings);
+
+	timings_begin_sub_section(&global_timings, str_lit("startup runtime and type info"));
 	{ // Startup Runtime
 		// Cleanup(bill): probably better way of doing code insertion
 		String name = str_lit(IR_STARTUP_RUNTIME_PROC_NAME);
@@ -8184,9 +9056,13 @@ void ir_gen_tree(irGen *s) {
 
 
 
+	timings_end_sub_section(&global_timings);
+
+	timings_begin_sub_section(&global_timings, str_lit("procedure bodies"));
 	for_array(i, m->procs_to_generate) {
 		ir_build_proc(m->procs_to_generate[i], m->procs_to_generate[i]->Proc.parent);
 	}
+	timings_end_sub_section(&global_timings);
 
 	// Number debug info
 	for_array(i, m->debug_info.entries) {
@@ -38,6 +38,9 @@ void ir_opt_add_operands(Array<irValue *> *ops, irInstr *i) {
 	case irInstr_If:
 		array_add(ops, i->If.cond);
 		break;
+	case irInstr_Switch:
+		array_add(ops, i->Switch.value);
+		break;
 	case irInstr_Return:
 		if (i->Return.value != NULL) {
 			array_add(ops, i->Return.value);
@@ -45,6 +48,14 @@ void ir_opt_add_operands(Array<irValue *> *ops, irInstr *i) {
 		break;
 	case irInstr_Select:
 		array_add(ops, i->Select.cond);
+		array_add(ops, i->Select.true_value);
+		array_add(ops, i->Select.false_value);
+		break;
+	case irInstr_UnionTagPtr:
+		array_add(ops, i->UnionTagPtr.address);
+		break;
+	case irInstr_UnionTagValue:
+		array_add(ops, i->UnionTagValue.address);
 		break;
 	case irInstr_Phi:
 		for_array(j, i->Phi.edges) {
@@ -62,22 +73,55 @@ void ir_opt_add_operands(Array<irValue *> *ops, irInstr *i) {
 		break;
 	case irInstr_Call:
 		array_add(ops, i->Call.value);
+		if (i->Call.return_ptr != NULL) {
+			array_add(ops, i->Call.return_ptr);
+		}
+		if (i->Call.context_ptr != NULL) {
+			array_add(ops, i->Call.context_ptr);
+		}
 		for (isize j = 0; j < i->Call.arg_count; j++) {
 			array_add(ops, i->Call.args[j]);
 		}
 		break;
-	// case irInstr_VectorExtractElement:
-		// array_add(ops, i->VectorExtractElement.vector);
-		// array_add(ops, i->VectorExtractElement.index);
-		// break;
-	// case irInstr_VectorInsertElement:
-		// array_add(ops, i->VectorInsertElement.vector);
-		// array_add(ops, i->VectorInsertElement.elem);
-		// array_add(ops, i->VectorInsertElement.index);
-		// break;
-	// case irInstr_VectorShuffle:
-		// array_add(ops, i->VectorShuffle.vector);
-		// break;
+	case irInstr_VectorExtractElement:
+		array_add(ops, i->VectorExtractElement.vector);
+		array_add(ops, i->VectorExtractElement.index);
+		break;
+	case irInstr_VectorInsertElement:
+		array_add(ops, i->VectorInsertElement.vector);
+		array_add(ops, i->VectorInsertElement.elem);
+		array_add(ops, i->VectorInsertElement.index);
+		break;
+	case irInstr_VectorShuffle:
+		array_add(ops, i->VectorShuffle.vector);
+		if (i->VectorShuffle.other != NULL) {
+			array_add(ops, i->VectorShuffle.other);
+		}
+		break;
+	case irInstr_VectorReduce:
+		array_add(ops, i->VectorReduce.vector);
+		break;
+	case irInstr_VectorSelect:
+		array_add(ops, i->VectorSelect.mask);
+		array_add(ops, i->VectorSelect.true_value);
+		array_add(ops, i->VectorSelect.false_value);
+		break;
+	case irInstr_VectorElementPtrs:
+		array_add(ops, i->VectorElementPtrs.address);
+		array_add(ops, i->VectorElementPtrs.indices);
+		break;
+	case irInstr_VectorGather:
+		array_add(ops, i->VectorGather.ptrs);
+		break;
+	case irInstr_VectorScatter:
+		array_add(ops, i->VectorScatter.ptrs);
+		array_add(ops, i->VectorScatter.values);
+		break;
+	case irInstr_FusedMulAdd:
+		array_add(ops, i->FusedMulAdd.a);
+		array_add(ops, i->FusedMulAdd.b);
+		array_add(ops, i->FusedMulAdd.c);
+		break;
 	case irInstr_StartupRuntime:
 		break;
 
@@ -273,11 +317,1548 @@ void ir_opt_blocks(irProcedure *proc) {
 
 	ir_remove_dead_blocks(proc);
 }
+
+
+
+// NOTE: Size budgets, in instructions, for the procedures which are spliced into their callers
+gb_global isize const ir_inline_budget        = 256;   // `#inline` procedures
+gb_global isize const ir_inline_leaf_budget   = 24;    // Small procedures which do not call anything
+gb_global isize const ir_inline_caller_budget = 16384; // Stop growing a caller beyond this
+
+irValue *ir_opt_remap_value(Map<irValue *> *values, irValue *v) {
+	if (v == NULL) {
+		return NULL;
+	}
+	irValue **found = map_get(values, hash_pointer(v));
+	if (found != NULL) {
+		return *found;
+	}
+	return v;
+}
+
+irBlock *ir_opt_remap_block(Map<irBlock *> *blocks, irBlock *b) {
+	if (blocks == NULL || b == NULL) {
+		return b;
+	}
+	irBlock **found = map_get(blocks, hash_pointer(b));
+	if (found != NULL) {
+		return *found;
+	}
+	return b;
+}
+
+void ir_opt_remap_operands(irInstr *i, Map<irValue *> *values, Map<irBlock *> *blocks) {
+	#define IR_REMAP(v) (v) = ir_opt_remap_value(values, (v))
+	switch (i->kind) {
+	case irInstr_ZeroInit:           IR_REMAP(i->ZeroInit.address);           break;
+	case irInstr_Load:               IR_REMAP(i->Load.address);               break;
+	case irInstr_StructElementPtr:   IR_REMAP(i->StructElementPtr.address);   break;
+	case irInstr_StructExtractValue: IR_REMAP(i->StructExtractValue.address); break;
+	case irInstr_UnionTagPtr:        IR_REMAP(i->UnionTagPtr.address);        break;
+	case irInstr_UnionTagValue:      IR_REMAP(i->UnionTagValue.address);      break;
+	case irInstr_Conv:               IR_REMAP(i->Conv.value);                 break;
+	case irInstr_Return:             IR_REMAP(i->Return.value);               break;
+	case irInstr_UnaryOp:            IR_REMAP(i->UnaryOp.expr);               break;
+	case irInstr_DebugDeclare:       IR_REMAP(i->DebugDeclare.value);         break;
+	case irInstr_Store:
+		IR_REMAP(i->Store.address);
+		IR_REMAP(i->Store.value);
+		break;
+	case irInstr_PtrOffset:
+		IR_REMAP(i->PtrOffset.address);
+		IR_REMAP(i->PtrOffset.offset);
+		break;
+	case irInstr_ArrayElementPtr:
+		IR_REMAP(i->ArrayElementPtr.address);
+		IR_REMAP(i->ArrayElementPtr.elem_index);
+		break;
+	case irInstr_Select:
+		IR_REMAP(i->Select.cond);
+		IR_REMAP(i->Select.true_value);
+		IR_REMAP(i->Select.false_value);
+		break;
+	case irInstr_VectorExtractElement:
+		IR_REMAP(i->VectorExtractElement.vector);
+		IR_REMAP(i->VectorExtractElement.index);
+		break;
+	case irInstr_VectorInsertElement:
+		IR_REMAP(i->VectorInsertElement.vector);
+		IR_REMAP(i->VectorInsertElement.elem);
+		IR_REMAP(i->VectorInsertElement.index);
+		break;
+	case irInstr_VectorShuffle:
+		IR_REMAP(i->VectorShuffle.vector);
+		IR_REMAP(i->VectorShuffle.other);
+		break;
+	case irInstr_VectorReduce:       IR_REMAP(i->VectorReduce.vector);       break;
+	case irInstr_VectorSelect:
+		IR_REMAP(i->VectorSelect.mask);
+		IR_REMAP(i->VectorSelect.true_value);
+		IR_REMAP(i->VectorSelect.false_value);
+		break;
+	case irInstr_VectorElementPtrs:
+		IR_REMAP(i->VectorElementPtrs.address);
+		IR_REMAP(i->VectorElementPtrs.indices);
+		break;
+	case irInstr_VectorGather:       IR_REMAP(i->VectorGather.ptrs);         break;
+	case irInstr_VectorScatter:
+		IR_REMAP(i->VectorScatter.ptrs);
+		IR_REMAP(i->VectorScatter.values);
+		break;
+	case irInstr_FusedMulAdd:
+		IR_REMAP(i->FusedMulAdd.a);
+		IR_REMAP(i->FusedMulAdd.b);
+		IR_REMAP(i->FusedMulAdd.c);
+		break;
+	case irInstr_Phi:
+		for_array(j, i->Phi.edges) {
+			IR_REMAP(i->Phi.edges[j]);
+		}
+		break;
+	case irInstr_BinaryOp:
+		IR_REMAP(i->BinaryOp.left);
+		IR_REMAP(i->BinaryOp.right);
+		break;
+	case irInstr_Call:
+		IR_REMAP(i->Call.value);
+		IR_REMAP(i->Call.return_ptr);
+		IR_REMAP(i->Call.context_ptr);
+		for (isize j = 0; j < i->Call.arg_count; j++) {
+			IR_REMAP(i->Call.args[j]);
+		}
+		break;
+	case irInstr_Jump:
+		i->Jump.block = ir_opt_remap_block(blocks, i->Jump.block);
+		break;
+	case irInstr_If:
+		IR_REMAP(i->If.cond);
+		i->If.true_block  = ir_opt_remap_block(blocks, i->If.true_block);
+		i->If.false_block = ir_opt_remap_block(blocks, i->If.false_block);
+		break;
+	case irInstr_Switch:
+		IR_REMAP(i->Switch.value);
+		i->Switch.default_block = ir_opt_remap_block(blocks, i->Switch.default_block);
+		for (isize j = 0; j < i->Switch.case_count; j++) {
+			i->Switch.case_blocks[j] = ir_opt_remap_block(blocks, i->Switch.case_blocks[j]);
+		}
+		break;
+	}
+	#undef IR_REMAP
+}
+
+isize ir_opt_proc_instr_count(irProcedure *proc, bool *is_leaf) {
+	isize count = 0;
+	*is_leaf = true;
+	for_array(i, proc->blocks) {
+		irBlock *b = proc->blocks[i];
+		for_array(j, b->instrs) {
+			irInstr *instr = &b->instrs[j]->Instr;
+			switch (instr->kind) {
+			case irInstr_Comment:
+			case irInstr_Local:
+			case irInstr_DebugDeclare:
+				break;
+			case irInstr_Call:
+				*is_leaf = false;
+				count++;
+				break;
+			default:
+				count++;
+				break;
+			}
+		}
+	}
+	return count;
+}
+
+irProcedure *ir_opt_inline_candidate(irProcedure *caller, irInstr *call) {
+	GB_ASSERT(call->kind == irInstr_Call);
+	irValue *value = call->Call.value;
+	if (value->kind != irValue_Proc) {
+		return NULL;
+	}
+	irProcedure *callee = &value->Proc;
+	if (callee == caller || callee->blocks.count == 0 || callee->body == NULL) {
+		return NULL;
+	}
+	if ((callee->tags & ProcTag_no_inline) != 0) {
+		return NULL;
+	}
+	Type *pt = base_type(callee->type);
+	if (pt->kind != Type_Proc || pt->Proc.c_vararg || pt->Proc.param_count != call->Call.arg_count) {
+		return NULL;
+	}
+
+	bool is_leaf = false;
+	isize count = ir_opt_proc_instr_count(callee, &is_leaf);
+	if ((callee->tags & ProcTag_inline) != 0) {
+		if (count > ir_inline_budget) {
+			return NULL;
+		}
+	} else if (!is_leaf || count > ir_inline_leaf_budget) {
+		return NULL;
+	}
+
+	// NOTE: Recursion guard, a procedure which calls itself is never spliced
+	for_array(i, callee->blocks) {
+		irBlock *b = callee->blocks[i];
+		for_array(j, b->instrs) {
+			irInstr *instr = &b->instrs[j]->Instr;
+			if (instr->kind == irInstr_StartupRuntime) {
+				return NULL;
+			}
+			if (instr->kind == irInstr_Call &&
+			    instr->Call.value->kind == irValue_Proc &&
+			    &instr->Call.value->Proc == callee) {
+				return NULL;
+			}
+		}
+	}
+
+	return callee;
+}
+
+// NOTE: Splits `b` after the call at `index`, splices a copy of the callee's blocks in between and
+// returns the block which continues after the call. `result` is set to the value of the call
+irBlock *ir_opt_inline_call(irProcedure *proc, irBlock *b, isize index, irProcedure *callee, irValue **result) {
+	gbAllocator a = proc->module->allocator;
+	irValue *call_value = b->instrs[index];
+	irInstr *call = &call_value->Instr;
+	Type *pt = base_type(callee->type);
+
+	Map<irValue *> values = {}; // Key: irValue * of the callee
+	Map<irBlock *> blocks = {}; // Key: irBlock * of the callee
+	map_init(&values, heap_allocator());
+	map_init(&blocks, heap_allocator());
+	defer (map_destroy(&values));
+	defer (map_destroy(&blocks));
+
+	if (callee->return_ptr != NULL) {
+		map_set(&values, hash_pointer(callee->return_ptr), call->Call.return_ptr);
+	}
+	if (pt->Proc.calling_convention == ProcCC_Odin && callee->context_stack.count > 0) {
+		map_set(&values, hash_pointer(callee->context_stack[0]), call->Call.context_ptr);
+	}
+
+	// The block which continues after the call takes the rest of the instructions and the successors
+	irBlock *done = ir_new_block(proc, NULL, "inline.done");
+	done->scope       = b->scope;
+	done->scope_index = b->scope_index;
+	for (isize i = index+1; i < b->instrs.count; i++) {
+		array_add(&done->instrs, b->instrs[i]);
+		ir_set_instr_parent(b->instrs[i], done);
+	}
+	for_array(i, b->succs) {
+		array_add(&done->succs, b->succs[i]);
+		ir_opt_block_replace_pred(b->succs[i], b, done);
+	}
+	b->instrs.count = index;
+	array_clear(&b->succs);
+
+	irBlock *decl_block = proc->blocks[0];
+	irValue *decl_end = array_pop(&decl_block->instrs);
+
+	for_array(i, callee->blocks) {
+		irBlock *cb = callee->blocks[i];
+		irBlock *nb = ir_new_block(proc, NULL, "inline");
+		nb->label       = cb->label;
+		nb->scope       = b->scope;
+		nb->scope_index = b->scope_index;
+		map_set(&blocks, hash_pointer(cb), nb);
+		array_add(&proc->blocks, nb);
+	}
+
+	Array<irBlock *> return_blocks = {};
+	Array<irValue *> return_values = {};
+	array_init(&return_blocks, heap_allocator());
+	array_init(&return_values, heap_allocator());
+	defer (array_free(&return_blocks));
+	defer (array_free(&return_values));
+
+	for_array(i, callee->blocks) {
+		irBlock *cb = callee->blocks[i];
+		irBlock *nb = *map_get(&blocks, hash_pointer(cb));
+		for_array(j, cb->preds) {
+			array_add(&nb->preds, *map_get(&blocks, hash_pointer(cb->preds[j])));
+		}
+		for_array(j, cb->succs) {
+			array_add(&nb->succs, *map_get(&blocks, hash_pointer(cb->succs[j])));
+		}
+
+		for_array(j, cb->instrs) {
+			irValue *ov = cb->instrs[j];
+			if (ov->Instr.kind == irInstr_DebugDeclare) {
+				continue;
+			}
+			irValue *v = ir_alloc_value(a, irValue_Instr);
+			*v = *ov;
+			v->index = 0;
+			v->index_set = false;
+			proc->instr_count++;
+			map_set(&values, hash_pointer(ov), v);
+
+			irInstr *instr = &v->Instr;
+			switch (instr->kind) {
+			case irInstr_Local:
+				// NOTE: All variables must be in the first block, otherwise they would grow the stack within loops
+				array_init(&instr->Local.referrers, heap_allocator());
+				instr->parent = decl_block;
+				array_add(&decl_block->instrs, v);
+				array_add(&decl_block->locals, v);
+				proc->local_count++;
+				continue;
+			case irInstr_Phi: {
+				Array<irValue *> edges = {};
+				array_init_count(&edges, a, instr->Phi.edges.count);
+				for_array(k, instr->Phi.edges) {
+					edges[k] = instr->Phi.edges[k];
+				}
+				instr->Phi.edges = edges;
+			} break;
+			case irInstr_Switch: {
+				irBlock **case_blocks = gb_alloc_array(a, irBlock *, instr->Switch.case_count);
+				for (isize k = 0; k < instr->Switch.case_count; k++) {
+					case_blocks[k] = instr->Switch.case_blocks[k];
+				}
+				instr->Switch.case_blocks = case_blocks;
+			} break;
+			case irInstr_Call: {
+				irValue **args = gb_alloc_array(a, irValue *, instr->Call.arg_count);
+				for (isize k = 0; k < instr->Call.arg_count; k++) {
+					args[k] = instr->Call.args[k];
+				}
+				instr->Call.args = args;
+			} break;
+			case irInstr_Return:
+				array_add(&return_blocks, nb);
+				array_add(&return_values, instr->Return.value);
+				instr->kind = irInstr_Jump;
+				instr->Jump.block = done;
+				array_add(&nb->succs, done);
+				break;
+			}
+
+			instr->parent = nb;
+			array_add(&nb->instrs, v);
+		}
+	}
+
+	array_add(&decl_block->instrs, decl_end);
+
+	// NOTE: The parameters are replaced with the arguments, which are already in their ABI form
+	Array<irValue *> ops = {};
+	array_init(&ops, heap_allocator());
+	defer (array_free(&ops));
+	for_array(i, callee->blocks) {
+		irBlock *cb = callee->blocks[i];
+		for_array(j, cb->instrs) {
+			array_clear(&ops);
+			ir_opt_add_operands(&ops, &cb->instrs[j]->Instr);
+			for_array(k, ops) {
+				irValue *op = ops[k];
+				if (op == NULL || op->kind != irValue_Param || op->Param.parent != callee) {
+					continue;
+				}
+				if (pt->Proc.params == NULL) { // NOTE: The context pointer of a procedure without parameters
+					continue;
+				}
+				TypeTuple *params = &pt->Proc.params->Tuple;
+				for (isize p = 0; p < params->variable_count; p++) {
+					if (params->variables[p] == op->Param.entity) {
+						map_set(&values, hash_pointer(op), call->Call.args[p]);
+						break;
+					}
+				}
+			}
+		}
+	}
+
+	for_array(i, callee->blocks) {
+		irBlock *nb = *map_get(&blocks, hash_pointer(callee->blocks[i]));
+		for_array(j, nb->instrs) {
+			ir_opt_remap_operands(&nb->instrs[j]->Instr, &values, &blocks);
+		}
+	}
+	for_array(i, decl_block->locals) {
+		ir_opt_remap_operands(&decl_block->locals[i]->Instr, &values, &blocks);
+	}
+
+	irBlock *entry = *map_get(&blocks, hash_pointer(callee->blocks[0]));
+	irValue *jump = ir_instr_jump(proc, entry);
+	jump->Instr.parent = b;
+	array_add(&b->instrs, jump);
+	array_add(&b->succs, entry);
+	array_add(&entry->preds, b);
+
+	for_array(i, return_blocks) {
+		array_add(&done->preds, return_blocks[i]);
+	}
+
+	*result = NULL;
+	Type *type = ir_type(call_value);
+	if (type != NULL) {
+		if (return_values.count == 0) {
+			*result = ir_value_undef(a, type);
+		} else if (return_values.count == 1) {
+			*result = ir_opt_remap_value(&values, return_values[0]);
+		} else {
+			Array<irValue *> edges = {};
+			array_init_count(&edges, a, return_values.count);
+			for_array(i, return_values) {
+				edges[i] = ir_opt_remap_value(&values, return_values[i]);
+			}
+			irValue *phi = ir_instr_phi(proc, edges, type);
+			phi->Instr.parent = done;
+			// NOTE: Phi nodes must be first
+			array_add(&done->instrs, phi);
+			for (isize i = done->instrs.count-1; i > 0; i--) {
+				done->instrs[i] = done->instrs[i-1];
+			}
+			done->instrs[0] = phi;
+			*result = phi;
+		}
+	}
+
+	array_add(&proc->blocks, done);
+	return done;
+}
+
+void ir_opt_inline_calls(irProcedure *proc) {
+	bool is_leaf = false;
+	isize instr_count = ir_opt_proc_instr_count(proc, &is_leaf);
+	if (is_leaf) {
+		return;
+	}
+
+	Map<irValue *> results = {}; // Key: irValue * of the inlined call
+	map_init(&results, heap_allocator());
+	defer (map_destroy(&results));
+
+	// NOTE: Only the original blocks and their continuations are scanned so the inlined code is not inlined again
+	Array<irBlock *> worklist = {};
+	array_init(&worklist, heap_allocator());
+	defer (array_free(&worklist));
+	for_array(i, proc->blocks) {
+		array_add(&worklist, proc->blocks[i]);
+	}
+
+	for (isize i = 0; i < worklist.count; i++) {
+		irBlock *b = worklist[i];
+		for_array(j, b->instrs) {
+			irInstr *instr = &b->instrs[j]->Instr;
+			if (instr->kind != irInstr_Call) {
+				continue;
+			}
+			irProcedure *callee = ir_opt_inline_candidate(proc, instr);
+			if (callee == NULL) {
+				continue;
+			}
+			bool callee_is_leaf = false;
+			isize callee_count = ir_opt_proc_instr_count(callee, &callee_is_leaf);
+			if (instr_count + callee_count > ir_inline_caller_budget) {
+				continue;
+			}
+			instr_count += callee_count;
+
+			irValue *call = b->instrs[j];
+			irValue *result = NULL;
+			irBlock *done = ir_opt_inline_call(proc, b, j, callee, &result);
+			if (result != NULL) {
+				map_set(&results, hash_pointer(call), result);
+			}
+			array_add(&worklist, done);
+			break;
+		}
+	}
+
+	if (results.entries.count == 0) {
+		proc->block_count = cast(i32)proc->blocks.count;
+		return;
+	}
+
+	// NOTE: A result may itself be the result of another inlined call, e.g. `f(g(x))`
+	for_array(i, results.entries) {
+		irValue *v = results.entries[i].value;
+		for (irValue **found = map_get(&results, hash_pointer(v));
+		     found != NULL;
+		     found = map_get(&results, hash_pointer(v))) {
+			v = *found;
+		}
+		results.entries[i].value = v;
+	}
+	for_array(i, proc->blocks) {
+		irBlock *b = proc->blocks[i];
+		for_array(j, b->instrs) {
+			ir_opt_remap_operands(&b->instrs[j]->Instr, &results, NULL);
+		}
+	}
+	proc->block_count = cast(i32)proc->blocks.count;
+}
+
+
+// NOTE: Byte budget of the stack buffer which replaces the heap allocation of a `make` with a constant capacity
+gb_global i64 const ir_stack_array_max_size = 1024;
+
+// NOTE: Escape analysis state of the allocation of one `make`. The "family" of the allocation is every
+// local the array or slice is copied into, every pointer into its buffer and every value loaded from them
+struct irStackArray {
+	Map<irValue *>   users;       // Key: irValue * of an operand, multi-valued
+	Map<bool>        visited;     // Key: irValue * of the family
+	Array<irValue *> writes;      // Stores into the locals of a slice family
+	Array<irValue *> frees;       // Calls of `free_ptr` on the buffer of a slice
+	bool             is_slice;
+	irValue *        free_proc;   // `free_ptr` for slices, `free_ptr_with_allocator` for dynamic arrays
+	irValue *        procs[5];    // Runtime procedures which may be passed a pointer to the array
+	isize            proc_count;
+};
+
+bool ir_opt_stack_array_addr(irStackArray *s, irValue *addr);
+
+bool ir_opt_const_int(irValue *v, i64 *value) {
+	if (v->kind == irValue_Constant && v->Constant.value.kind == ExactValue_Integer) {
+		*value = big_int_to_i64(v->Constant.value.value_integer);
+		return true;
+	}
+	// NOTE: The size of a slice is `elem_size*cap` which is not folded when it is generated
+	if (v->kind == irValue_Instr && v->Instr.kind == irInstr_BinaryOp && v->Instr.BinaryOp.op == Token_Mul) {
+		i64 x = 0, y = 0;
+		if (ir_opt_const_int(v->Instr.BinaryOp.left, &x) && ir_opt_const_int(v->Instr.BinaryOp.right, &y) &&
+		    x >= 0 && y >= 0 && x <= U32_MAX && y <= U32_MAX) {
+			*value = x*y;
+			return true;
+		}
+	}
+	return false;
+}
+
+// NOTE: Whether `v` is only passed to `callee` and only as the argument at `index`
+bool ir_opt_is_call_arg(irInstr *instr, irValue *v, irValue *callee, isize index) {
+	if (callee == NULL || instr->kind != irInstr_Call || instr->Call.value != callee) {
+		return false;
+	}
+	if (index >= instr->Call.arg_count || instr->Call.args[index] != v) {
+		return false;
+	}
+	for (isize i = 0; i < instr->Call.arg_count; i++) {
+		if (i != index && instr->Call.args[i] == v) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// NOTE: Whether `b` can be reached from itself, a buffer of a `make` within a loop would be reused while
+// the array of the previous iteration could still be alive
+bool ir_opt_block_in_cycle(irBlock *b) {
+	Map<bool> seen = {}; // Key: irBlock *
+	Array<irBlock *> stack = {};
+	map_init(&seen, heap_allocator());
+	array_init(&stack, heap_allocator());
+	defer (map_destroy(&seen));
+	defer (array_free(&stack));
+
+	for_array(i, b->succs) {
+		array_add(&stack, b->succs[i]);
+	}
+	while (stack.count > 0) {
+		irBlock *next = array_pop(&stack);
+		if (next == b) {
+			return true;
+		}
+		if (map_get(&seen, hash_pointer(next)) != NULL) {
+			continue;
+		}
+		map_set(&seen, hash_pointer(next), true);
+		for_array(i, next->succs) {
+			array_add(&stack, next->succs[i]);
+		}
+	}
+	return false;
+}
+
+bool ir_opt_stack_array_visit(irStackArray *s, irValue *v) {
+	HashKey key = hash_pointer(v);
+	if (map_get(&s->visited, key) != NULL) {
+		return false;
+	}
+	map_set(&s->visited, key, true);
+	return true;
+}
+
+// NOTE: `data` points into the buffer. It may be read and written through and compared, but it must not be
+// stored, returned or passed on
+bool ir_opt_stack_array_data(irStackArray *s, irValue *data) {
+	if (!ir_opt_stack_array_visit(s, data)) {
+		return true;
+	}
+	for (MapEntry<irValue *> *e = multi_map_find_first(&s->users, hash_pointer(data));
+	     e != NULL;
+	     e = multi_map_find_next(&s->users, e)) {
+		irValue *user = e->value;
+		irInstr *u = &user->Instr;
+		switch (u->kind) {
+		case irInstr_Load:
+			break;
+		case irInstr_Store:
+			if (u->Store.value == data) {
+				// NOTE: `make` fills in the data pointer of the slice it returns
+				irValue *field = u->Store.address;
+				if (s->is_slice && field != data &&
+				    field->kind == irValue_Instr &&
+				    field->Instr.kind == irInstr_StructElementPtr &&
+				    field->Instr.StructElementPtr.elem_index == 0 &&
+				    ir_opt_stack_array_addr(s, field->Instr.StructElementPtr.address)) {
+					break;
+				}
+				return false;
+			}
+			break;
+		case irInstr_PtrOffset:
+		case irInstr_ArrayElementPtr:
+		case irInstr_StructElementPtr:
+			if (!ir_opt_stack_array_data(s, user)) {
+				return false;
+			}
+			break;
+		case irInstr_Conv:
+			if (u->Conv.kind != irConv_bitcast || !ir_opt_stack_array_data(s, user)) {
+				return false;
+			}
+			break;
+		case irInstr_BinaryOp:
+			switch (u->BinaryOp.op) {
+			case Token_CmpEq:
+			case Token_NotEq:
+			case Token_Lt:
+			case Token_Gt:
+			case Token_LtEq:
+			case Token_GtEq:
+				break;
+			default:
+				return false;
+			}
+			break;
+		case irInstr_Call:
+			if (s->is_slice && ir_opt_is_call_arg(u, data, s->free_proc, 0)) {
+				array_add(&s->frees, user);
+				break;
+			}
+			if (!s->is_slice && ir_opt_is_call_arg(u, data, s->free_proc, 1)) {
+				break;
+			}
+			return false;
+		default:
+			return false;
+		}
+	}
+	return true;
+}
+
+// NOTE: The allocator of a dynamic array refers to the buffer so it may only be used to free the array.
+// It is copied to a local when it is passed by pointer
+bool ir_opt_stack_array_allocator(irStackArray *s, irValue *allocator) {
+	if (!ir_opt_stack_array_visit(s, allocator)) {
+		return true;
+	}
+	bool is_local = allocator->kind == irValue_Instr && allocator->Instr.kind == irInstr_Local;
+	for (MapEntry<irValue *> *e = multi_map_find_first(&s->users, hash_pointer(allocator));
+	     e != NULL;
+	     e = multi_map_find_next(&s->users, e)) {
+		irValue *user = e->value;
+		irInstr *u = &user->Instr;
+		if (ir_opt_is_call_arg(u, allocator, s->free_proc, 0)) {
+			continue;
+		}
+		if (is_local) {
+			if (u->kind == irInstr_ZeroInit ||
+			    (u->kind == irInstr_Store && u->Store.value != allocator)) {
+				continue;
+			}
+			if (u->kind == irInstr_Load && ir_opt_stack_array_allocator(s, user)) {
+				continue;
+			}
+		} else if (u->kind == irInstr_Store && u->Store.value == allocator &&
+		           u->Store.address->kind == irValue_Instr &&
+		           u->Store.address->Instr.kind == irInstr_Local &&
+		           ir_opt_stack_array_allocator(s, u->Store.address)) {
+			continue;
+		}
+		return false;
+	}
+	return true;
+}
+
+// NOTE: `value` is a copy of the whole array or slice
+bool ir_opt_stack_array_value(irStackArray *s, irValue *value) {
+	if (!ir_opt_stack_array_visit(s, value)) {
+		return true;
+	}
+	for (MapEntry<irValue *> *e = multi_map_find_first(&s->users, hash_pointer(value));
+	     e != NULL;
+	     e = multi_map_find_next(&s->users, e)) {
+		irValue *user = e->value;
+		irInstr *u = &user->Instr;
+		switch (u->kind) {
+		case irInstr_StructExtractValue:
+			if (u->StructExtractValue.index == 0 && !ir_opt_stack_array_data(s, user)) {
+				return false;
+			}
+			if (u->StructExtractValue.index == 3 && !ir_opt_stack_array_allocator(s, user)) {
+				return false;
+			}
+			break;
+		case irInstr_Store: {
+			irValue *local = u->Store.address;
+			if (local->kind != irValue_Instr || local->Instr.kind != irInstr_Local ||
+			    !ir_opt_stack_array_addr(s, local)) {
+				return false;
+			}
+		} break;
+		default:
+			return false;
+		}
+	}
+	return true;
+}
+
+// NOTE: `field` points to the field at `index` of an array or slice of the family
+bool ir_opt_stack_array_field(irStackArray *s, irValue *field, i32 index) {
+	for (MapEntry<irValue *> *e = multi_map_find_first(&s->users, hash_pointer(field));
+	     e != NULL;
+	     e = multi_map_find_next(&s->users, e)) {
+		irValue *user = e->value;
+		irInstr *u = &user->Instr;
+		switch (u->kind) {
+		case irInstr_Load:
+			if (index == 0 && !ir_opt_stack_array_data(s, user)) {
+				return false;
+			}
+			if (index == 3 && !ir_opt_stack_array_allocator(s, user)) {
+				return false;
+			}
+			break;
+		case irInstr_Store:
+			if (u->Store.value == field || index == 3) {
+				return false;
+			}
+			if (index == 0 && s->is_slice) {
+				array_add(&s->writes, user);
+			}
+			break;
+		default:
+			return false;
+		}
+	}
+	return true;
+}
+
+// NOTE: `addr` points to a local which holds an array or slice of the family
+bool ir_opt_stack_array_addr(irStackArray *s, irValue *addr) {
+	if (!ir_opt_stack_array_visit(s, addr)) {
+		return true;
+	}
+	for (MapEntry<irValue *> *e = multi_map_find_first(&s->users, hash_pointer(addr));
+	     e != NULL;
+	     e = multi_map_find_next(&s->users, e)) {
+		irValue *user = e->value;
+		irInstr *u = &user->Instr;
+		switch (u->kind) {
+		case irInstr_ZeroInit:
+			break;
+		case irInstr_Store:
+			if (u->Store.value == addr) {
+				return false;
+			}
+			if (s->is_slice) {
+				array_add(&s->writes, user);
+			}
+			break;
+		case irInstr_Load:
+			if (!ir_opt_stack_array_value(s, user)) {
+				return false;
+			}
+			break;
+		case irInstr_PtrOffset:
+			if (!ir_opt_stack_array_addr(s, user)) {
+				return false;
+			}
+			break;
+		case irInstr_StructElementPtr:
+			if (!ir_opt_stack_array_field(s, user, u->StructElementPtr.elem_index)) {
+				return false;
+			}
+			break;
+		case irInstr_Conv: {
+			// NOTE: The runtime procedures only use the pointer to the array while they run
+			if (u->Conv.kind != irConv_bitcast) {
+				return false;
+			}
+			for (MapEntry<irValue *> *c = multi_map_find_first(&s->users, hash_pointer(user));
+			     c != NULL;
+			     c = multi_map_find_next(&s->users, c)) {
+				bool ok = false;
+				for (isize k = 0; k < s->proc_count && !ok; k++) {
+					ok = ir_opt_is_call_arg(&c->value->Instr, user, s->procs[k], 0);
+				}
+				if (!ok) {
+					return false;
+				}
+			}
+		} break;
+		default:
+			return false;
+		}
+	}
+	return true;
+}
+
+irValue *ir_opt_find_runtime_proc(irModule *m, char *name) {
+	irValue **found = map_get(&m->members, hash_string(make_string_c(name)));
+	if (found == NULL || (*found)->kind != irValue_Proc) {
+		return NULL;
+	}
+	return *found;
+}
+
+void ir_opt_insert_instr(irBlock *b, irValue *before, irValue *v) {
+	v->Instr.parent = b;
+	array_add(&b->instrs, v);
+	for (isize i = b->instrs.count-1; i > 0; i--) {
+		b->instrs[i] = b->instrs[i-1];
+		if (b->instrs[i] == before) {
+			b->instrs[i-1] = v;
+			return;
+		}
+	}
+	GB_PANIC("Instruction is not within its block");
+}
+
+void ir_opt_remove_instr(irBlock *b, irValue *v) {
+	for_array(i, b->instrs) {
+		if (b->instrs[i] == v) {
+			for (isize j = i+1; j < b->instrs.count; j++) {
+				b->instrs[j-1] = b->instrs[j];
+			}
+			b->instrs.count--;
+			return;
+		}
+	}
+}
+
+// NOTE: Adds a buffer of `size` bytes to the variables of the procedure
+irValue *ir_opt_add_stack_buffer(irProcedure *proc, Type *type, i64 alignment) {
+	gbAllocator a = proc->module->allocator;
+	irBlock *decl_block = proc->blocks[0];
+	Entity *e = make_entity_variable(a, decl_block->scope, empty_token, type, false);
+	irValue *local = ir_instr_local(proc, e, false);
+	local->Instr.Local.alignment = gb_max(alignment, local->Instr.Local.alignment);
+	local->Instr.parent = decl_block;
+
+	irValue *decl_end = array_pop(&decl_block->instrs);
+	array_add(&decl_block->instrs, local);
+	array_add(&decl_block->instrs, decl_end);
+	array_add(&decl_block->locals, local);
+	proc->local_count++;
+	return local;
+}
+
+// NOTE: Places the buffer of a `make([dynamic]T, len, cap)` or `make([]T, len, cap)` with a small constant
+// capacity on the stack when nothing of the array or slice outlives the procedure. A dynamic array gets an
+// allocator which moves it to the context allocator when it grows beyond the buffer. A slice cannot grow,
+// its `free` is removed instead
+void ir_opt_stack_arrays(irProcedure *proc) {
+	irModule *m = proc->module;
+	gbAllocator a = m->allocator;
+
+	irValue *make_proc       = ir_opt_find_runtime_proc(m, "__dynamic_array_make");
+	irValue *make_stack_proc = ir_opt_find_runtime_proc(m, "__dynamic_array_make_stack");
+	irValue *alloc_proc      = ir_opt_find_runtime_proc(m, "alloc");
+	if (make_stack_proc == NULL && alloc_proc == NULL) {
+		return;
+	}
+
+	Array<irValue *> candidates = {};
+	array_init(&candidates, heap_allocator());
+	defer (array_free(&candidates));
+	for_array(i, proc->blocks) {
+		irBlock *b = proc->blocks[i];
+		for_array(j, b->instrs) {
+			irValue *v = b->instrs[j];
+			if (v->Instr.kind != irInstr_Call) {
+				continue;
+			}
+			irValue *callee = v->Instr.Call.value;
+			if (callee != NULL && (callee == make_proc || callee == alloc_proc)) {
+				array_add(&candidates, v);
+			}
+		}
+	}
+	if (candidates.count == 0) {
+		return;
+	}
+
+	irStackArray s = {};
+	map_init(&s.users,   heap_allocator());
+	map_init(&s.visited, heap_allocator());
+	array_init(&s.writes, heap_allocator());
+	array_init(&s.frees,  heap_allocator());
+	defer (map_destroy(&s.users));
+	defer (map_destroy(&s.visited));
+	defer (array_free(&s.writes));
+	defer (array_free(&s.frees));
+
+	Array<irValue *> ops = {};
+	array_init(&ops, heap_allocator());
+	defer (array_free(&ops));
+	for_array(i, proc->blocks) {
+		irBlock *b = proc->blocks[i];
+		for_array(j, b->instrs) {
+			array_clear(&ops);
+			ir_opt_add_operands(&ops, &b->instrs[j]->Instr);
+			for_array(k, ops) {
+				if (ops[k] != NULL) {
+					multi_map_insert(&s.users, hash_pointer(ops[k]), b->instrs[j]);
+				}
+			}
+		}
+	}
+
+	for_array(i, candidates) {
+		irValue *call = candidates[i];
+		irInstr *instr = &call->Instr;
+		irBlock *b = instr->parent;
+
+		map_clear(&s.visited);
+		array_clear(&s.writes);
+		array_clear(&s.frees);
+		s.is_slice = instr->Call.value == alloc_proc;
+		s.proc_count = 0;
+
+		if (s.is_slice) {
+			i64 size = 0, align = 0;
+			if (instr->Call.arg_count != 2 ||
+			    !ir_opt_const_int(instr->Call.args[0], &size) ||
+			    !ir_opt_const_int(instr->Call.args[1], &align) ||
+			    size <= 0 || size > ir_stack_array_max_size || ir_opt_block_in_cycle(b)) {
+				continue;
+			}
+			s.free_proc = ir_opt_find_runtime_proc(m, "free_ptr");
+			s.procs[s.proc_count++] = ir_opt_find_runtime_proc(m, "__slice_append");
+			if (!ir_opt_stack_array_data(&s, call)) {
+				continue;
+			}
+			// NOTE: Every pointer which reaches a removed `free` must be the buffer
+			bool only_buffer = true;
+			for_array(k, s.writes) {
+				irValue *value = s.writes[k]->Instr.Store.value;
+				if (map_get(&s.visited, hash_pointer(value)) == NULL) {
+					only_buffer = false;
+					break;
+				}
+			}
+			if (!only_buffer) {
+				continue;
+			}
+
+			Type *buffer_type = make_type_array(a, t_u8, size);
+			irValue *buffer = ir_opt_add_stack_buffer(proc, buffer_type, align);
+			ir_opt_insert_instr(b, call, ir_instr_zero_init(proc, buffer));
+
+			// NOTE: The call is turned into the pointer to the buffer so that its users stay the same
+			instr->kind = irInstr_Conv;
+			instr->Conv.kind  = irConv_bitcast;
+			instr->Conv.value = buffer;
+			instr->Conv.from  = ir_type(buffer);
+			instr->Conv.to    = t_rawptr;
+
+			for_array(k, s.frees) {
+				irValue *free_call = s.frees[k];
+				ir_opt_remove_instr(free_call->Instr.parent, free_call);
+			}
+		} else {
+			i64 elem_size = 0, elem_align = 0, cap = 0;
+			if (make_stack_proc == NULL || instr->Call.arg_count != 5 ||
+			    !ir_opt_const_int(instr->Call.args[1], &elem_size) ||
+			    !ir_opt_const_int(instr->Call.args[2], &elem_align) ||
+			    !ir_opt_const_int(instr->Call.args[4], &cap) ||
+			    elem_size <= 0 || cap <= 0 || cap > ir_stack_array_max_size/elem_size ||
+			    ir_opt_block_in_cycle(b)) {
+				continue;
+			}
+			irValue *array = instr->Call.args[0];
+			if (array->kind != irValue_Instr || array->Instr.kind != irInstr_Conv ||
+			    array->Instr.Conv.value->kind != irValue_Instr ||
+			    array->Instr.Conv.value->Instr.kind != irInstr_Local) {
+				continue;
+			}
+			s.free_proc = ir_opt_find_runtime_proc(m, "free_ptr_with_allocator");
+			s.procs[s.proc_count++] = make_proc;
+			s.procs[s.proc_count++] = ir_opt_find_runtime_proc(m, "__dynamic_array_append");
+			s.procs[s.proc_count++] = ir_opt_find_runtime_proc(m, "__dynamic_array_append_nothing");
+			s.procs[s.proc_count++] = ir_opt_find_runtime_proc(m, "__dynamic_array_reserve");
+			s.procs[s.proc_count++] = ir_opt_find_runtime_proc(m, "__dynamic_array_resize");
+			if (!ir_opt_stack_array_addr(&s, array->Instr.Conv.value)) {
+				continue;
+			}
+
+			Type *pt = base_type(ir_type(make_stack_proc));
+			Type *header_type = type_deref(pt->Proc.params->Tuple.variables[5]->type);
+			irValue *header = ir_opt_add_stack_buffer(proc, header_type, 0);
+			irValue *buffer = ir_opt_add_stack_buffer(proc, make_type_array(a, t_u8, elem_size*cap), elem_align);
+			irValue *data = ir_instr_conv(proc, irConv_bitcast, buffer, ir_type(buffer), t_rawptr);
+			ir_opt_insert_instr(b, call, data);
+
+			irValue **args = gb_alloc_array(a, irValue *, 7);
+			for (isize k = 0; k < 5; k++) {
+				args[k] = instr->Call.args[k];
+			}
+			args[5] = header;
+			args[6] = data;
+			instr->Call.value     = make_stack_proc;
+			instr->Call.args      = args;
+			instr->Call.arg_count = 7;
+		}
+	}
+}
+
+
+// NOTE: Escape analysis of the backing array of a `..any` slice. Its "family" is every pointer into the
+// array, every local which holds a slice of it and every such slice value
+enum irEscapeKind {
+	irEscape_Data,  // Pointer into the array
+	irEscape_Slot,  // Pointer to a slice of the array, e.g. a local or a parameter passed by pointer
+	irEscape_Value, // Slice of the array
+
+	irEscape_Count,
+};
+
+struct irEscape {
+	irModule *     module;
+	Map<irValue *> users;   // Key: irValue * of an operand, multi-valued
+	Map<bool>      visited; // Key: irValue * of the family
+};
+
+bool ir_opt_escape_data (irEscape *s, irValue *data);
+bool ir_opt_escape_slot (irEscape *s, irValue *slot);
+bool ir_opt_escape_value(irEscape *s, irValue *value);
+bool ir_opt_param_escapes(irModule *m, irProcedure *proc, isize index, irEscapeKind kind);
+
+void ir_opt_escape_init(irEscape *s, irProcedure *proc) {
+	s->module = proc->module;
+	map_init(&s->users,   heap_allocator());
+	map_init(&s->visited, heap_allocator());
+
+	Array<irValue *> ops = {};
+	array_init(&ops, heap_allocator());
+	defer (array_free(&ops));
+	for_array(i, proc->blocks) {
+		irBlock *b = proc->blocks[i];
+		for_array(j, b->instrs) {
+			array_clear(&ops);
+			ir_opt_add_operands(&ops, &b->instrs[j]->Instr);
+			for_array(k, ops) {
+				if (ops[k] != NULL) {
+					multi_map_insert(&s->users, hash_pointer(ops[k]), b->instrs[j]);
+				}
+			}
+		}
+	}
+}
+
+void ir_opt_escape_destroy(irEscape *s) {
+	map_destroy(&s->users);
+	map_destroy(&s->visited);
+}
+
+bool ir_opt_escape_visit(irEscape *s, irValue *v) {
+	HashKey key = hash_pointer(v);
+	if (map_get(&s->visited, key) != NULL) {
+		return false;
+	}
+	map_set(&s->visited, key, true);
+	return true;
+}
+
+// NOTE: `v` may be passed to a procedure whose parameter does not escape, in any position
+bool ir_opt_escape_call(irEscape *s, irInstr *call, irValue *v, irEscapeKind kind) {
+	irValue *callee = call->Call.value;
+	if (callee == v || call->Call.return_ptr == v || call->Call.context_ptr == v ||
+	    callee->kind != irValue_Proc) {
+		return false;
+	}
+	for (isize i = 0; i < call->Call.arg_count; i++) {
+		if (call->Call.args[i] == v && ir_opt_param_escapes(s->module, &callee->Proc, i, kind)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool ir_opt_escape_data(irEscape *s, irValue *data) {
+	if (!ir_opt_escape_visit(s, data)) {
+		return true;
+	}
+	for (MapEntry<irValue *> *e = multi_map_find_first(&s->users, hash_pointer(data));
+	     e != NULL;
+	     e = multi_map_find_next(&s->users, e)) {
+		irValue *user = e->value;
+		irInstr *u = &user->Instr;
+		switch (u->kind) {
+		case irInstr_Load:
+			break;
+		case irInstr_Store:
+			if (u->Store.value == data) {
+				// NOTE: Filling in the data pointer of a local slice
+				irValue *field = u->Store.address;
+				if (field->kind == irValue_Instr &&
+				    field->Instr.kind == irInstr_StructElementPtr &&
+				    field->Instr.StructElementPtr.elem_index == 0 &&
+				    field->Instr.StructElementPtr.address->kind == irValue_Instr &&
+				    field->Instr.StructElementPtr.address->Instr.kind == irInstr_Local &&
+				    ir_opt_escape_slot(s, field->Instr.StructElementPtr.address)) {
+					break;
+				}
+				return false;
+			}
+			break;
+		case irInstr_PtrOffset:
+			if (u->PtrOffset.address != data || !ir_opt_escape_data(s, user)) {
+				return false;
+			}
+			break;
+		case irInstr_ArrayElementPtr:
+			if (u->ArrayElementPtr.address != data || !ir_opt_escape_data(s, user)) {
+				return false;
+			}
+			break;
+		case irInstr_StructElementPtr:
+			if (!ir_opt_escape_data(s, user)) {
+				return false;
+			}
+			break;
+		case irInstr_Conv:
+			if (u->Conv.kind != irConv_bitcast || !ir_opt_escape_data(s, user)) {
+				return false;
+			}
+			break;
+		case irInstr_BinaryOp:
+			switch (u->BinaryOp.op) {
+			case Token_CmpEq:
+			case Token_NotEq:
+			case Token_Lt:
+			case Token_Gt:
+			case Token_LtEq:
+			case Token_GtEq:
+				break;
+			default:
+				return false;
+			}
+			break;
+		case irInstr_Call:
+			if (!ir_opt_escape_call(s, u, data, irEscape_Data)) {
+				return false;
+			}
+			break;
+		default:
+			return false;
+		}
+	}
+	return true;
+}
+
+// NOTE: `field` points to the field at `index` of a slice of the family, only its data pointer is tracked
+bool ir_opt_escape_field(irEscape *s, irValue *field, i32 index) {
+	for (MapEntry<irValue *> *e = multi_map_find_first(&s->users, hash_pointer(field));
+	     e != NULL;
+	     e = multi_map_find_next(&s->users, e)) {
+		irValue *user = e->value;
+		irInstr *u = &user->Instr;
+		switch (u->kind) {
+		case irInstr_Load:
+			if (index == 0 && !ir_opt_escape_data(s, user)) {
+				return false;
+			}
+			break;
+		case irInstr_Store:
+			if (u->Store.value == field) {
+				return false;
+			}
+			break;
+		default:
+			return false;
+		}
+	}
+	return true;
+}
+
+bool ir_opt_escape_slot(irEscape *s, irValue *slot) {
+	if (!ir_opt_escape_visit(s, slot)) {
+		return true;
+	}
+	for (MapEntry<irValue *> *e = multi_map_find_first(&s->users, hash_pointer(slot));
+	     e != NULL;
+	     e = multi_map_find_next(&s->users, e)) {
+		irValue *user = e->value;
+		irInstr *u = &user->Instr;
+		switch (u->kind) {
+		case irInstr_ZeroInit:
+			break;
+		case irInstr_Store:
+			if (u->Store.value == slot) {
+				return false;
+			}
+			break;
+		case irInstr_Load:
+			if (!ir_opt_escape_value(s, user)) {
+				return false;
+			}
+			break;
+		case irInstr_StructElementPtr:
+			if (!ir_opt_escape_field(s, user, u->StructElementPtr.elem_index)) {
+				return false;
+			}
+			break;
+		case irInstr_Call:
+			if (!ir_opt_escape_call(s, u, slot, irEscape_Slot)) {
+				return false;
+			}
+			break;
+		default:
+			return false;
+		}
+	}
+	return true;
+}
+
+bool ir_opt_escape_value(irEscape *s, irValue *value) {
+	if (!ir_opt_escape_visit(s, value)) {
+		return true;
+	}
+	for (MapEntry<irValue *> *e = multi_map_find_first(&s->users, hash_pointer(value));
+	     e != NULL;
+	     e = multi_map_find_next(&s->users, e)) {
+		irValue *user = e->value;
+		irInstr *u = &user->Instr;
+		switch (u->kind) {
+		case irInstr_StructExtractValue:
+			if (u->StructExtractValue.index == 0 && !ir_opt_escape_data(s, user)) {
+				return false;
+			}
+			break;
+		case irInstr_Store: {
+			irValue *local = u->Store.address;
+			if (local->kind != irValue_Instr || local->Instr.kind != irInstr_Local ||
+			    !ir_opt_escape_slot(s, local)) {
+				return false;
+			}
+		} break;
+		case irInstr_Call:
+			if (!ir_opt_escape_call(s, u, value, irEscape_Value)) {
+				return false;
+			}
+			break;
+		default:
+			return false;
+		}
+	}
+	return true;
+}
+
+// NOTE: Whether the parameter at `index` of `proc` can outlive the call, when it is a member of the family of
+// the given kind. Procedures without a body, and recursive ones while they are analysed, are assumed to keep it
+bool ir_opt_param_escapes(irModule *m, irProcedure *proc, isize index, irEscapeKind kind) {
+	Type *pt = base_type(proc->type);
+	if (proc->blocks.count == 0 || pt->Proc.params == NULL || index >= pt->Proc.params->Tuple.variable_count) {
+		return true;
+	}
+	Entity *param = pt->Proc.params->Tuple.variables[index];
+	HashKey key = hash_ptr_and_id(param, cast(u32)kind);
+	bool *found = map_get(&m->param_escapes, key);
+	if (found != NULL) {
+		return *found;
+	}
+	map_set(&m->param_escapes, key, true);
+
+	irEscape s = {};
+	ir_opt_escape_init(&s, proc);
+	defer (ir_opt_escape_destroy(&s));
+
+	bool escapes = false;
+	for_array(i, s.users.entries) {
+		irValue *v = cast(irValue *)s.users.entries[i].key.ptr;
+		if (v->kind != irValue_Param || v->Param.parent != proc || v->Param.entity != param ||
+		    map_get(&s.visited, hash_pointer(v)) != NULL) {
+			continue;
+		}
+		irEscapeKind param_kind = kind;
+		if (v->Param.kind == irParamPass_Pointer && kind == irEscape_Value) {
+			param_kind = irEscape_Slot;
+		} else if (v->Param.kind != irParamPass_Value) {
+			escapes = true;
+			break;
+		}
+		switch (param_kind) {
+		case irEscape_Data:  escapes = !ir_opt_escape_data (&s, v); break;
+		case irEscape_Slot:  escapes = !ir_opt_escape_slot (&s, v); break;
+		case irEscape_Value: escapes = !ir_opt_escape_value(&s, v); break;
+		}
+		if (escapes) {
+			break;
+		}
+	}
+
+	map_set(&m->param_escapes, key, escapes);
+	return escapes;
+}
+
+// NOTE: Every `..any` call gets its own backing array. The arrays which only reach callees that do not keep
+// the slice are merged into one, which is grown to the largest of them
+void ir_opt_share_variadic_arrays(irProcedure *proc) {
+	if (proc->variadic_any_arrays.count < 2) {
+		return;
+	}
+	gbAllocator a = proc->module->allocator;
+
+	irEscape s = {};
+	ir_opt_escape_init(&s, proc);
+	defer (ir_opt_escape_destroy(&s));
+
+	Map<irValue *> shared = {}; // Key: irValue * of a merged array
+	map_init(&shared, heap_allocator());
+	defer (map_destroy(&shared));
+
+	irValue *array = NULL;
+	for_array(i, proc->variadic_any_arrays) {
+		irValue *local = proc->variadic_any_arrays[i];
+		map_clear(&s.visited);
+		if (!ir_opt_escape_data(&s, local)) {
+			continue;
+		}
+		if (array == NULL) {
+			array = local;
+			continue;
+		}
+		map_set(&shared, hash_pointer(local), array);
+
+		irInstr *instr = &array->Instr;
+		i64 count = type_deref(local->Instr.Local.type)->Array.count;
+		if (instr->Local.entity->type->Array.count < count) {
+			Type *type = make_type_array(a, t_any, count);
+			instr->Local.entity->type = type;
+			instr->Local.type = make_type_pointer(a, type);
+		}
+	}
+	if (shared.entries.count == 0) {
+		return;
+	}
+
+	for_array(i, proc->blocks) {
+		irBlock *b = proc->blocks[i];
+		for_array(j, b->instrs) {
+			ir_opt_remap_operands(&b->instrs[j]->Instr, &shared, NULL);
+		}
+	}
+	irBlock *decl_block = proc->blocks[0];
+	for_array(i, shared.entries) {
+		irValue *local = cast(irValue *)shared.entries[i].key.ptr;
+		ir_opt_remove_instr(decl_block, local);
+		isize count = 0;
+		for_array(j, decl_block->locals) {
+			if (decl_block->locals[j] != local) {
+				decl_block->locals[count++] = decl_block->locals[j];
+			}
+		}
+		decl_block->locals.count = count;
+		proc->local_count--;
+	}
+}
+
+bool ir_opt_is_contextless_candidate(irProcedure *proc) {
+	if (proc->blocks.count == 0 || proc->body == NULL || proc->context_stack.count == 0) {
+		return false;
+	}
+	if ((proc->tags & ProcTag_export) != 0) {
+		return false;
+	}
+	Type *pt = base_type(proc->type);
+	return pt->Proc.calling_convention == ProcCC_Odin && !pt->Proc.c_vararg;
+}
+
+// NOTE: Passing the context pointer on to a contextless procedure does not count as reading it
+bool ir_opt_proc_reads_context(irProcedure *proc, Array<irValue *> *ops) {
+	irValue *context_ptr = proc->context_stack[0];
+	for_array(i, proc->blocks) {
+		irBlock *b = proc->blocks[i];
+		for_array(j, b->instrs) {
+			irInstr *instr = &b->instrs[j]->Instr;
+			array_clear(ops);
+			if (instr->kind == irInstr_Call &&
+			    instr->Call.value->kind == irValue_Proc &&
+			    instr->Call.value->Proc.contextless) {
+				for (isize k = 0; k < instr->Call.arg_count; k++) {
+					array_add(ops, instr->Call.args[k]);
+				}
+			} else {
+				ir_opt_add_operands(ops, instr);
+			}
+			for_array(k, *ops) {
+				if ((*ops)[k] == context_ptr) {
+					return true;
+				}
+			}
+		}
+	}
+	return false;
+}
+
+// NOTE: Removes the copy of the default context made by a non-Odin procedure when nothing uses it
+void ir_opt_remove_unused_default_context(irProcedure *proc, Array<irValue *> *ops) {
+	if (proc->context_stack.count == 0) {
+		return;
+	}
+	irValue *local = proc->context_stack[0];
+	if (local->kind != irValue_Instr || local->Instr.kind != irInstr_Local) {
+		return;
+	}
+
+	for_array(i, proc->blocks) {
+		irBlock *b = proc->blocks[i];
+		for_array(j, b->instrs) {
+			irValue *v = b->instrs[j];
+			irInstr *instr = &v->Instr;
+			if (v == local || instr->kind == irInstr_ZeroInit) {
+				continue;
+			}
+			if (instr->kind == irInstr_Store && instr->Store.value != local) {
+				continue;
+			}
+			array_clear(ops);
+			ir_opt_add_operands(ops, instr);
+			for_array(k, *ops) {
+				if ((*ops)[k] == local) {
+					return;
+				}
+			}
+		}
+	}
+
+	irValue *global_default_context = proc->module->global_default_context;
+	for_array(i, proc->blocks) {
+		irBlock *b = proc->blocks[i];
+		isize count = 0;
+		for_array(j, b->instrs) {
+			irValue *v = b->instrs[j];
+			irInstr *instr = &v->Instr;
+			bool remove = v == local;
+			if (instr->kind == irInstr_ZeroInit) {
+				remove = instr->ZeroInit.address == local;
+			} else if (instr->kind == irInstr_Store && instr->Store.address == local) {
+				remove = true;
+				irValue *init = instr->Store.value;
+				if (init->kind == irValue_Instr &&
+				    init->Instr.kind == irInstr_Load &&
+				    init->Instr.Load.address == global_default_context) {
+					// NOTE: The load is emitted right before the store and only feeds it
+					GB_ASSERT(count > 0 && b->instrs[count-1] == init);
+					count--;
+				}
+			}
+			if (!remove) {
+				b->instrs[count++] = v;
+			}
+		}
+		b->instrs.count = count;
+
+		count = 0;
+		for_array(j, b->locals) {
+			if (b->locals[j] != local) {
+				b->locals[count++] = b->locals[j];
+			}
+		}
+		b->locals.count = count;
+	}
+	proc->local_count--;
+}
+
+// NOTE: A procedure which is only ever called directly, never reads `context` and only calls
+// procedures which do not either, is emitted without the implicit context pointer parameter
+void ir_opt_infer_contextless(irModule *m) {
+	Array<irValue *> ops = {};
+	array_init(&ops, heap_allocator());
+	defer (array_free(&ops));
+
+	for_array(i, m->procs) {
+		irProcedure *proc = m->procs[i];
+		proc->contextless = ir_opt_is_contextless_candidate(proc);
+	}
+
+	// NOTE: A procedure used as a value may be called through a procedure pointer, which passes the context
+	for_array(i, m->procs) {
+		irProcedure *proc = m->procs[i];
+		for_array(j, proc->blocks) {
+			irBlock *b = proc->blocks[j];
+			for_array(k, b->instrs) {
+				irInstr *instr = &b->instrs[k]->Instr;
+				array_clear(&ops);
+				if (instr->kind == irInstr_Call) {
+					for (isize l = 0; l < instr->Call.arg_count; l++) {
+						array_add(&ops, instr->Call.args[l]);
+					}
+				} else {
+					ir_opt_add_operands(&ops, instr);
+				}
+				for_array(l, ops) {
+					irValue *op = ops[l];
+					if (op != NULL && op->kind == irValue_Proc) {
+						op->Proc.contextless = false;
+					}
+				}
+			}
+		}
+	}
+	for_array(i, m->members.entries) {
+		irValue *v = m->members.entries[i].value;
+		if (v->kind == irValue_Global &&
+		    v->Global.value != NULL &&
+		    v->Global.value->kind == irValue_Proc) {
+			v->Global.value->Proc.contextless = false;
+		}
+	}
+
+	for (bool changed = true; changed; ) {
+		changed = false;
+		for_array(i, m->procs) {
+			irProcedure *proc = m->procs[i];
+			if (proc->contextless && ir_opt_proc_reads_context(proc, &ops)) {
+				proc->contextless = false;
+				changed = true;
+			}
+		}
+	}
+
+	for_array(i, m->procs) {
+		irProcedure *proc = m->procs[i];
+		for_array(j, proc->blocks) {
+			irBlock *b = proc->blocks[j];
+			for_array(k, b->instrs) {
+				irInstr *instr = &b->instrs[k]->Instr;
+				if (instr->kind == irInstr_Call &&
+				    instr->Call.value->kind == irValue_Proc &&
+				    instr->Call.value->Proc.contextless) {
+					instr->Call.context_ptr = NULL;
+				}
+			}
+		}
+		ir_opt_remove_unused_default_context(proc, &ops);
+	}
+}
+
+
 void ir_opt_build_referrers(irProcedure *proc) {
-	gbTempArenaMemory tmp = gb_temp_arena_memory_begin(&proc->module->tmp_arena);
+	DynamicArenaTempMemory tmp = dynamic_arena_temp_memory_begin(&proc->module->tmp_arena);
 
 	Array<irValue *> ops = {0}; // NOTE(bill): Act as a buffer
-	array_init(&ops, proc->module->tmp_allocator, 64); // HACK(bill): This _could_ overflow the temp arena
+	array_init(&ops, proc->module->tmp_allocator, 64);
 	for_array(i, proc->blocks) {
 		irBlock *b = proc->blocks[i];
 		for_array(j, b->instrs) {
@@ -297,7 +1878,7 @@ void ir_opt_build_referrers(irProcedure *proc) {
 		}
 	}
 
-	gb_temp_arena_memory_end(tmp);
+	dynamic_arena_temp_memory_end(tmp);
 }
 
 
@@ -371,7 +1952,7 @@ irDomPrePost ir_opt_number_dom_tree(irBlock *v, i32 pre, i32 post) {
 void ir_opt_build_dom_tree(irProcedure *proc) {
 	// Based on this paper: http://jgaa.info/accepted/2006/GeorgiadisTarjanWerneck2006.10.1.pdf
 
-	gbTempArenaMemory tmp = gb_temp_arena_memory_begin(&proc->module->tmp_arena);
+	DynamicArenaTempMemory tmp = dynamic_arena_temp_memory_begin(&proc->module->tmp_arena);
 
 	isize n = proc->blocks.count;
 	irBlock **buf = gb_alloc_array(proc->module->tmp_allocator, irBlock *, 5*n);
@@ -451,7 +2032,7 @@ void ir_opt_build_dom_tree(irProcedure *proc) {
 
 	ir_opt_number_dom_tree(root, 0, 0);
 
-	gb_temp_arena_memory_end(tmp);
+	dynamic_arena_temp_memory_end(tmp);
 }
 
 void ir_opt_mem2reg(irProcedure *proc) {
@@ -460,16 +2041,52 @@ void ir_opt_mem2reg(irProcedure *proc) {
 
 
 
+// NOTE: Procedures are optimized callees first, so a procedure is spliced into its callers with the
+// calls it can inline already inlined. Inlining therefore cascades down a chain of calls as far as the
+// budgets allow, whatever the order of `module.procs`. Each procedure of a cycle of calls is visited
+// once, from the first procedure of the cycle in `module.procs`, which is optimized last
+void ir_opt_proc_callees_first(Map<bool> *visited, irProcedure *proc) {
+	if (map_get(visited, hash_pointer(proc)) != NULL) {
+		return;
+	}
+	map_set(visited, hash_pointer(proc), true);
+	if (proc->blocks.count == 0) { // Prototype/external procedure
+		return;
+	}
+
+	for_array(i, proc->blocks) {
+		irBlock *b = proc->blocks[i];
+		for_array(j, b->instrs) {
+			irInstr *instr = &b->instrs[j]->Instr;
+			if (instr->kind == irInstr_Call && instr->Call.value->kind == irValue_Proc) {
+				ir_opt_proc_callees_first(visited, &instr->Call.value->Proc);
+			}
+		}
+	}
+
+	ir_opt_share_variadic_arrays(proc);
+	ir_opt_stack_arrays(proc);
+	ir_opt_inline_calls(proc);
+	ir_opt_blocks(proc);
+}
+
 void ir_opt_tree(irGen *s) {
 	s->opt_called = true;
 
+	Map<bool> visited = {}; // Key: irProcedure *
+	map_init(&visited, heap_allocator());
+	defer (map_destroy(&visited));
+	for_array(member_index, s->module.procs) {
+		ir_opt_proc_callees_first(&visited, s->module.procs[member_index]);
+	}
+
+	ir_opt_infer_contextless(&s->module);
+
 	for_array(member_index, s->module.procs) {
 		irProcedure *proc = s->module.procs[member_index];
 		if (proc->blocks.count == 0) { // Prototype/external procedure
 			continue;
 		}
-
-		ir_opt_blocks(proc);
 	#if 0
 		ir_opt_build_referrers(proc);
 		ir_opt_build_dom_tree(proc);
@@ -47,10 +47,10 @@ void ir_fprintf(irFileBuffer *f, char *fmt, ...) {
 void ir_fprint_string(irFileBuffer *f, String s) {
 	ir_file_buffer_write(f, s.text, s.len);
 }
-void ir_fprint_i128(irFileBuffer *f, i128 i) {
-	char buf[200] = {};
-	String str = i128_to_string(i, buf, gb_size_of(buf)-1);
+void ir_fprint_big_int(irFileBuffer *f, BigInt i) {
+	String str = big_int_to_string(heap_allocator(), i);
 	ir_fprint_string(f, str);
+	gb_free(heap_allocator(), str.text);
 }
 
 void ir_file_write(irFileBuffer *f, void *data, isize len) {
@@ -261,6 +261,13 @@ void ir_print_type(irFileBuffer *f, irModule *m, Type *t) {
 		ir_fprintf(f, "]");
 		return;
 	case Type_Vector: {
+		// NOTE: Vectors of pointers only arise internally, as the addresses of `gather` and `scatter`
+		if (is_type_simd_vector(t) || is_type_pointer(t->Vector.elem)) {
+			ir_fprintf(f, "<%lld x ", t->Vector.count);
+			ir_print_type(f, m, t->Vector.elem);
+			ir_fprintf(f, ">");
+			return;
+		}
 		i64 align = type_align_of(heap_allocator(), t);
 		i64 count = t->Vector.count;
 		ir_fprintf(f, "{[0 x <%lld x i8>], [%lld x ", align, count);
@@ -268,10 +275,6 @@ void ir_print_type(irFileBuffer *f, irModule *m, Type *t) {
 		ir_fprintf(f, "]}");
 		return;
 	}
-/* 		ir_fprintf(f, "<%lld x ", t->Vector.count);
-		ir_print_type(f, m, t->Vector.elem);
-		ir_fprintf(f, ">");
-		return; */
 	case Type_Slice:
 		ir_fprintf(f, "{");
 		ir_print_type(f, m, t->Slice.elem);
@@ -390,6 +393,165 @@ void ir_print_type(irFileBuffer *f, irModule *m, Type *t) {
 
 void ir_print_exact_value(irFileBuffer *f, irModule *m, ExactValue value, Type *type);
 
+// NOTE: Prints a byte array as a single `c"..."` constant, written in chunks so large tables
+// do not need a temporary buffer the size of the whole array
+void ir_print_packed_bytes(irFileBuffer *f, u8 *data, i64 len) {
+	char hex_table[] = "0123456789ABCDEF";
+	u8 buf[1024];
+	isize j = 0;
+	ir_fprintf(f, "c\"");
+	for (i64 i = 0; i < len; i++) {
+		if (j+3 > gb_size_of(buf)) {
+			ir_file_write(f, buf, j);
+			j = 0;
+		}
+		u8 c = data[i];
+		if (ir_valid_char(c) || c == ' ') {
+			buf[j++] = c;
+		} else {
+			buf[j++] = '\\';
+			buf[j++] = hex_table[c >> 4];
+			buf[j++] = hex_table[c & 0x0f];
+		}
+	}
+	ir_file_write(f, buf, j);
+	ir_fprintf(f, "\"");
+}
+
+// NOTE: Allocators only guarantee `max_align`, which is less than the natural alignment of the wider
+// vectors and of the records that contain them, so every load and store states at most `max_align`
+// rather than letting LLVM assume the ABI alignment of the type
+i64 ir_memory_align_of(irModule *m, Type *t) {
+	i64 align = type_align_of(m->allocator, t);
+	return gb_min(align, build_context.max_align);
+}
+
+// NOTE: The overload suffix LLVM mangles into intrinsic names, e.g. `v4f32`, `i64` or `v4p0f32`
+gbString ir_append_intrinsic_suffix(gbString s, Type *t) {
+	t = base_type(t);
+	switch (t->kind) {
+	case Type_Vector:
+		s = gb_string_appendc(s, gb_bprintf("v%lld", cast(long long)t->Vector.count));
+		return ir_append_intrinsic_suffix(s, t->Vector.elem);
+	case Type_Pointer:
+		s = gb_string_appendc(s, "p0");
+		return ir_append_intrinsic_suffix(s, t->Pointer.elem);
+	}
+	i64 bits = 8*type_size_of(heap_allocator(), t);
+	return gb_string_appendc(s, gb_bprintf("%c%lld", is_type_float(t) ? 'f' : 'i', cast(long long)bits));
+}
+
+String ir_intrinsic_name(irModule *m, irInstr *instr) {
+	gbString s = gb_string_make(heap_allocator(), "llvm.");
+	switch (instr->kind) {
+	case irInstr_VectorReduce: {
+		Type *vt = ir_type(instr->VectorReduce.vector);
+		Type *elem = base_vector_type(vt);
+		char const *op = "";
+		switch (instr->VectorReduce.op) {
+		case Token_Add: op = is_type_float(elem) ? "fadd" : "add"; break;
+		case Token_Lt:  op = is_type_float(elem) ? "fmin" : is_type_unsigned(elem) ? "umin" : "smin"; break;
+		case Token_Gt:  op = is_type_float(elem) ? "fmax" : is_type_unsigned(elem) ? "umax" : "smax"; break;
+		default: GB_PANIC("Unknown vector reduction"); break;
+		}
+		s = gb_string_appendc(s, gb_bprintf("vector.reduce.%s.", op));
+		s = ir_append_intrinsic_suffix(s, vt);
+	} break;
+	case irInstr_VectorGather:
+		s = gb_string_appendc(s, "masked.gather.");
+		s = ir_append_intrinsic_suffix(s, instr->VectorGather.type);
+		s = gb_string_appendc(s, ".");
+		s = ir_append_intrinsic_suffix(s, ir_type(instr->VectorGather.ptrs));
+		break;
+	case irInstr_VectorScatter:
+		s = gb_string_appendc(s, "masked.scatter.");
+		s = ir_append_intrinsic_suffix(s, ir_type(instr->VectorScatter.values));
+		s = gb_string_appendc(s, ".");
+		s = ir_append_intrinsic_suffix(s, ir_type(instr->VectorScatter.ptrs));
+		break;
+	case irInstr_FusedMulAdd:
+		s = gb_string_appendc(s, "fma.");
+		s = ir_append_intrinsic_suffix(s, ir_type(instr->FusedMulAdd.a));
+		break;
+	default:
+		GB_PANIC("Instruction does not lower to an intrinsic");
+		break;
+	}
+
+	isize len = gb_string_length(s);
+	u8 *text = gb_alloc_array(m->allocator, u8, len);
+	gb_memcopy(text, s, len);
+	gb_string_free(s);
+	return make_string(text, len);
+}
+
+// NOTE: Returns the name of the intrinsic `value` calls and records it so that it is declared once
+String ir_use_intrinsic(irModule *m, irValue *value) {
+	String name = ir_intrinsic_name(m, &value->Instr);
+	HashKey key = hash_string(name);
+	if (map_get(&m->intrinsics, key) == NULL) {
+		map_set(&m->intrinsics, key, value);
+	}
+	return name;
+}
+
+void ir_print_vector_all_true_mask(irFileBuffer *f, i64 count) {
+	ir_fprintf(f, "<%lld x i1> <", count);
+	for (i64 i = 0; i < count; i++) {
+		if (i > 0) {
+			ir_fprintf(f, ", ");
+		}
+		ir_fprintf(f, "i1 true");
+	}
+	ir_fprintf(f, ">");
+}
+
+void ir_print_intrinsic_declaration(irFileBuffer *f, irModule *m, irValue *value) {
+	irInstr *instr = &value->Instr;
+	String name = ir_intrinsic_name(m, instr);
+	ir_fprintf(f, "declare ");
+	switch (instr->kind) {
+	case irInstr_VectorReduce: {
+		Type *vt = ir_type(instr->VectorReduce.vector);
+		Type *elem = base_vector_type(vt);
+		ir_print_type(f, m, elem);
+		ir_fprintf(f, " @%.*s(", LIT(name));
+		if (instr->VectorReduce.op == Token_Add && is_type_float(elem)) {
+			ir_print_type(f, m, elem);
+			ir_fprintf(f, ", ");
+		}
+		ir_print_type(f, m, vt);
+	} break;
+	case irInstr_VectorGather: {
+		Type *vt = instr->VectorGather.type;
+		ir_print_type(f, m, vt);
+		ir_fprintf(f, " @%.*s(", LIT(name));
+		ir_print_type(f, m, ir_type(instr->VectorGather.ptrs));
+		ir_fprintf(f, ", i32, <%lld x i1>, ", base_type(vt)->Vector.count);
+		ir_print_type(f, m, vt);
+	} break;
+	case irInstr_VectorScatter: {
+		Type *vt = ir_type(instr->VectorScatter.values);
+		ir_fprintf(f, "void @%.*s(", LIT(name));
+		ir_print_type(f, m, vt);
+		ir_fprintf(f, ", ");
+		ir_print_type(f, m, ir_type(instr->VectorScatter.ptrs));
+		ir_fprintf(f, ", i32, <%lld x i1>", base_type(vt)->Vector.count);
+	} break;
+	case irInstr_FusedMulAdd: {
+		Type *t = ir_type(instr->FusedMulAdd.a);
+		ir_print_type(f, m, t);
+		ir_fprintf(f, " @%.*s(", LIT(name));
+		ir_print_type(f, m, t);
+		ir_fprintf(f, ", ");
+		ir_print_type(f, m, t);
+		ir_fprintf(f, ", ");
+		ir_print_type(f, m, t);
+	} break;
+	}
+	ir_fprintf(f, ")\n");
+}
+
 void ir_print_compound_element(irFileBuffer *f, irModule *m, ExactValue v, Type *elem_type) {
 	ir_print_type(f, m, elem_type);
 	ir_fprintf(f, " ");
@@ -403,6 +565,19 @@ void ir_print_compound_element(irFileBuffer *f, irModule *m, ExactValue v, Type
 
 void ir_print_exact_value(irFileBuffer *f, irModule *m, ExactValue value, Type *type) {
 	type = core_type(type);
+	if (is_type_simd_vector(type) && value.kind != ExactValue_Compound) {
+		// NOTE: A scalar constant of a vector type is broadcast to every element
+		Type *elem_type = type->Vector.elem;
+		ir_fprintf(f, "<");
+		for (i64 i = 0; i < type->Vector.count; i++) {
+			if (i > 0) {
+				ir_fprintf(f, ", ");
+			}
+			ir_print_compound_element(f, m, value, elem_type);
+		}
+		ir_fprintf(f, ">");
+		return;
+	}
 	value = convert_exact_value_for_type(value, type);
 
 	switch (value.kind) {
@@ -439,19 +614,19 @@ void ir_print_exact_value(irFileBuffer *f, irModule *m, ExactValue value, Type *
 	} break;
 	case ExactValue_Integer: {
 		if (is_type_pointer(type)) {
-			if (i128_eq(value.value_integer, I128_ZERO)) {
+			if (big_int_is_zero(value.value_integer)) {
 				ir_fprintf(f, "null");
 			} else {
 				ir_fprintf(f, "inttoptr (");
 				ir_print_type(f, m, t_int);
 				ir_fprintf(f, " ");
-				ir_fprint_i128(f, value.value_integer);
+				ir_fprint_big_int(f, value.value_integer);
 				ir_fprintf(f, " to ");
 				ir_print_type(f, m, t_rawptr);
 				ir_fprintf(f, ")");
 			}
 		} else {
-			ir_fprint_i128(f, value.value_integer);
+			ir_fprint_big_int(f, value.value_integer);
 		}
 	} break;
 	case ExactValue_Float: {
@@ -507,6 +682,24 @@ void ir_print_exact_value(irFileBuffer *f, irModule *m, ExactValue value, Type *
 		}
 		break;
 
+	case ExactValue_Packed: {
+		PackedArray *packed = value.value_packed;
+		Type *elem_type = packed->elem_type;
+		if (packed->elem_size == 1 && packed->elem_kind != PackedElem_Bool) {
+			ir_print_packed_bytes(f, packed->data, packed->count);
+			break;
+		}
+
+		ir_fprintf(f, "[");
+		for (i64 i = 0; i < packed->count; i++) {
+			if (i > 0) {
+				ir_fprintf(f, ", ");
+			}
+			ir_print_compound_element(f, m, packed_array_get(packed, i), elem_type);
+		}
+		ir_fprintf(f, "]");
+	} break;
+
 	case ExactValue_Compound: {
 		type = base_type(type);
 		if (is_type_array(type)) {
@@ -548,10 +741,15 @@ void ir_print_exact_value(irFileBuffer *f, irModule *m, ExactValue value, Type *
 			i64 align = type_align_of(m->allocator, type);
 			i64 count = type->Vector.count;
 			Type *elem_type = type->Vector.elem;
+			bool is_simd = is_type_simd_vector(type);
 
-			ir_fprintf(f, "{[0 x <%lld x i8>] zeroinitializer, [%lld x ", align, count);
-			ir_print_type(f, m, elem_type);
-			ir_fprintf(f, "][");
+			if (is_simd) {
+				ir_fprintf(f, "<");
+			} else {
+				ir_fprintf(f, "{[0 x <%lld x i8>] zeroinitializer, [%lld x ", align, count);
+				ir_print_type(f, m, elem_type);
+				ir_fprintf(f, "][");
+			}
 
 			if (elem_count == 1 && type->Vector.count > 1) {
 				TypeAndValue tav = type_and_value_of_expr(m->info, cl->elems[0]);
@@ -574,9 +772,13 @@ void ir_print_exact_value(irFileBuffer *f, irModule *m, ExactValue value, Type *
 				}
 			}
 
-			ir_fprintf(f, "]}");
+			if (is_simd) {
+				ir_fprintf(f, ">");
+			} else {
+				ir_fprintf(f, "]}");
+			}
 		} else if (is_type_struct(type)) {
-			gbTempArenaMemory tmp = gb_temp_arena_memory_begin(&m->tmp_arena);
+			DynamicArenaTempMemory tmp = dynamic_arena_temp_memory_begin(&m->tmp_arena);
 
 			ast_node(cl, CompoundLit, value.value_compound);
 
@@ -645,7 +847,7 @@ void ir_print_exact_value(irFileBuffer *f, irModule *m, ExactValue value, Type *
 				ir_fprintf(f, ">");
 			}
 
-			gb_temp_arena_memory_end(tmp);
+			dynamic_arena_temp_memory_end(tmp);
 		} else {
 			ir_fprintf(f, "zeroinitializer");
 		}
@@ -802,7 +1004,8 @@ void ir_print_instr(irFileBuffer *f, irModule *m, irValue *value) {
 		ir_print_type(f, m, type);
 		ir_fprintf(f, " zeroinitializer, ");
 		ir_print_type(f, m, type);
-		ir_fprintf(f, "* %%%d\n", instr->ZeroInit.address->index);
+		ir_fprintf(f, "* %%%d", instr->ZeroInit.address->index);
+		ir_fprintf(f, ", align %lld\n", ir_memory_align_of(m, type));
 	} break;
 
 	case irInstr_Store: {
@@ -822,8 +1025,9 @@ void ir_print_instr(irFileBuffer *f, irModule *m, irValue *value) {
 			// TODO(bill): Do ordering
 			ir_fprintf(f, " unordered");
 			ir_fprintf(f, ", align %lld\n", type_align_of(m->allocator, type));
+		} else {
+			ir_fprintf(f, ", align %lld\n", ir_memory_align_of(m, type));
 		}
-		ir_fprintf(f, "\n");
 	} break;
 
 	case irInstr_Load: {
@@ -841,7 +1045,7 @@ void ir_print_instr(irFileBuffer *f, irModule *m, irValue *value) {
 			// TODO(bill): Do ordering
 			ir_fprintf(f, " unordered");
 		}
-		ir_fprintf(f, ", align %lld\n", type_align_of(m->allocator, type));
+		ir_fprintf(f, ", align %lld\n", ir_memory_align_of(m, type));
 	} break;
 
 	case irInstr_ArrayElementPtr: {
@@ -856,7 +1060,7 @@ void ir_print_instr(irFileBuffer *f, irModule *m, irValue *value) {
 		ir_fprintf(f, ", ");
 		ir_print_type(f, m, t_int);
 		ir_fprintf(f, " 0, ");
-		if (is_type_vector(type_deref(et))) {
+		if (is_type_vector(type_deref(et)) && !is_type_simd_vector(type_deref(et))) {
 			ir_print_type(f, m, t_i32);
 			ir_fprintf(f, " 1, ");
 		}
@@ -1020,6 +1224,27 @@ void ir_print_instr(irFileBuffer *f, irModule *m, irValue *value) {
 		ir_fprintf(f, "\n");
 	} break;
 
+	case irInstr_Switch: {
+		Type *type = ir_type(instr->Switch.value);
+		ir_fprintf(f, "switch ");
+		ir_print_type(f, m, type);
+		ir_fprintf(f, " ");
+		ir_print_value(f, m, instr->Switch.value, type);
+		ir_fprintf(f, ", label %%");
+		ir_print_block_name(f, instr->Switch.default_block);
+		ir_fprintf(f, " [\n");
+		for (isize i = 0; i < instr->Switch.case_count; i++) {
+			ir_fprintf(f, "\t\t");
+			ir_print_type(f, m, type);
+			ir_fprintf(f, " ");
+			ir_print_value(f, m, instr->Switch.case_values[i], type);
+			ir_fprintf(f, ", label %%");
+			ir_print_block_name(f, instr->Switch.case_blocks[i]);
+			ir_fprintf(f, "\n");
+		}
+		ir_fprintf(f, "\t]\n");
+	} break;
+
 	case irInstr_Return: {
 		irInstrReturn *ret = &instr->Return;
 		ir_fprintf(f, "ret ");
@@ -1071,7 +1296,7 @@ void ir_print_instr(irFileBuffer *f, irModule *m, irValue *value) {
 			break;
 		case Token_Xor:
 		case Token_Not:
-			GB_ASSERT(is_type_integer(type) || is_type_boolean(type));
+			GB_ASSERT(is_type_integer(elem_type) || is_type_boolean(elem_type));
 			ir_fprintf(f, "xor");
 			break;
 		default:
@@ -1084,7 +1309,9 @@ void ir_print_instr(irFileBuffer *f, irModule *m, irValue *value) {
 		ir_fprintf(f, " ");
 		switch (uo->op) {
 		case Token_Sub:
-			if (is_type_float(elem_type)) {
+			if (is_type_simd_vector(type)) {
+				ir_fprintf(f, "zeroinitializer");
+			} else if (is_type_float(elem_type)) {
 				ir_print_exact_value(f, m, exact_value_float(0), elem_type);
 			} else {
 				ir_fprintf(f, "0");
@@ -1092,8 +1319,12 @@ void ir_print_instr(irFileBuffer *f, irModule *m, irValue *value) {
 			break;
 		case Token_Xor:
 		case Token_Not:
-			GB_ASSERT(is_type_integer(type) || is_type_boolean(type));
-			ir_fprintf(f, "-1");
+			GB_ASSERT(is_type_integer(elem_type) || is_type_boolean(elem_type));
+			if (is_type_simd_vector(type)) {
+				ir_print_exact_value(f, m, exact_value_i64(-1), type);
+			} else {
+				ir_fprintf(f, "-1");
+			}
 			break;
 		}
 		ir_fprintf(f, ", ");
@@ -1105,11 +1336,20 @@ void ir_print_instr(irFileBuffer *f, irModule *m, irValue *value) {
 		irInstrBinaryOp *bo = &value->Instr.BinaryOp;
 		Type *type = base_type(ir_type(bo->left));
 		Type *elem_type = type;
+		if (is_type_simd_vector(type)) {
+			elem_type = base_type(type->Vector.elem);
+		}
 		GB_ASSERT_MSG(!is_type_vector(elem_type), type_to_string(elem_type));
 
-		ir_fprintf(f, "%%%d = ", value->index);
+		bool is_comparison = gb_is_between(bo->op, Token__ComparisonBegin+1, Token__ComparisonEnd-1);
+		if (is_comparison && is_type_simd_vector(type)) {
+			// NOTE: The `<N x i1>` of a vector comparison is widened to the byte vector of its result
+			ir_fprintf(f, "%%vcmp.%d = ", value->index);
+		} else {
+			ir_fprintf(f, "%%%d = ", value->index);
+		}
 
-		if (gb_is_between(bo->op, Token__ComparisonBegin+1, Token__ComparisonEnd-1)) {
+		if (is_comparison) {
 			if (is_type_string(elem_type)) {
 				ir_fprintf(f, "call ");
 				ir_print_calling_convention(f, m, ProcCC_Odin);
@@ -1121,7 +1361,7 @@ void ir_print_instr(irFileBuffer *f, irModule *m, irValue *value) {
 				case Token_Lt:    runtime_proc = "__string_lt"; break;
 				case Token_Gt:    runtime_proc = "__string_gt"; break;
 				case Token_LtEq:  runtime_proc = "__string_le"; break;
-				case Token_GtEq:  runtime_proc = "__string_gt"; break;
+				case Token_GtEq:  runtime_proc = "__string_ge"; break;
 				}
 
 				ir_fprintf(f, " ");
@@ -1241,6 +1481,10 @@ void ir_print_instr(irFileBuffer *f, irModule *m, irValue *value) {
 		ir_print_value(f, m, bo->left, type);
 		ir_fprintf(f, ", ");
 		ir_print_value(f, m, bo->right, type);
+		if (is_comparison && is_type_simd_vector(type)) {
+			ir_fprintf(f, "\n\t%%%d = zext <%lld x i1> %%vcmp.%d to ", value->index, type->Vector.count, value->index);
+			ir_print_type(f, m, ir_type(value));
+		}
 		ir_fprintf(f, "\n");
 	} break;
 
@@ -1333,7 +1577,7 @@ void ir_print_instr(irFileBuffer *f, irModule *m, irValue *value) {
 				}
 			}
 		}
-		if (proc_type->Proc.calling_convention == ProcCC_Odin) {
+		if (call->context_ptr != NULL) {
 			if (param_index > 0) ir_fprintf(f, ", ");
 
 			ir_print_type(f, m, t_context_ptr);
@@ -1358,68 +1602,188 @@ void ir_print_instr(irFileBuffer *f, irModule *m, irValue *value) {
 		ir_fprintf(f, "\n");
 	} break;
 
-	// case irInstr_VectorExtractElement: {
-		// Type *vt = ir_type(instr->VectorExtractElement.vector);
-		// Type *it = ir_type(instr->VectorExtractElement.index);
-		// ir_fprintf(f, "%%%d = extractelement ", value->index);
-
-		// ir_print_type(f, m, vt);
-		// ir_fprintf(f, " ");
-		// ir_print_value(f, m, instr->VectorExtractElement.vector, vt);
-		// ir_fprintf(f, ", ");
-		// ir_print_type(f, m, it);
-		// ir_fprintf(f, " ");
-		// ir_print_value(f, m, instr->VectorExtractElement.index, it);
-		// ir_fprintf(f, "\n");
-	// } break;
-
-	// case irInstr_VectorInsertElement: {
-	// 	irInstrVectorInsertElement *ie = &instr->VectorInsertElement;
-	// 	Type *vt = ir_type(ie->vector);
-	// 	ir_fprintf(f, "%%%d = insertelement ", value->index);
-
-	// 	ir_print_type(f, m, vt);
-	// 	ir_fprintf(f, " ");
-	// 	ir_print_value(f, m, ie->vector, vt);
-	// 	ir_fprintf(f, ", ");
-
-	// 	ir_print_type(f, m, ir_type(ie->elem));
-	// 	ir_fprintf(f, " ");
-	// 	ir_print_value(f, m, ie->elem, ir_type(ie->elem));
-	// 	ir_fprintf(f, ", ");
-
-	// 	ir_print_type(f, m, ir_type(ie->index));
-	// 	ir_fprintf(f, " ");
-	// 	ir_print_value(f, m, ie->index, ir_type(ie->index));
-
-	// 	ir_fprintf(f, "\n");
-	// } break;
-
-	// case irInstr_VectorShuffle: {
-	// 	irInstrVectorShuffle *sv = &instr->VectorShuffle;
-	// 	Type *vt = ir_type(sv->vector);
-	// 	ir_fprintf(f, "%%%d = shufflevector ", value->index);
-
-	// 	ir_print_type(f, m, vt);
-	// 	ir_fprintf(f, " ");
-	// 	ir_print_value(f, m, sv->vector, vt);
-	// 	ir_fprintf(f, ", ");
-
-	// 	ir_print_type(f, m, vt);
-	// 	ir_fprintf(f, " ");
-	// 	ir_print_value(f, m, sv->vector, vt);
-	// 	ir_fprintf(f, ", ");
-
-	// 	ir_fprintf(f, "<%td x i32> <", sv->index_count);
-	// 	for (isize i = 0; i < sv->index_count; i++) {
-	// 		if (i > 0) {
-	// 			ir_fprintf(f, ", ");
-	// 		}
-	// 		ir_fprintf(f, "i32 %d", sv->indices[i]);
-	// 	}
-	// 	ir_fprintf(f, ">");
-	// 	ir_fprintf(f, "\n");
-	// } break;
+	case irInstr_VectorExtractElement: {
+		Type *vt = ir_type(instr->VectorExtractElement.vector);
+		Type *it = ir_type(instr->VectorExtractElement.index);
+		ir_fprintf(f, "%%%d = extractelement ", value->index);
+
+		ir_print_type(f, m, vt);
+		ir_fprintf(f, " ");
+		ir_print_value(f, m, instr->VectorExtractElement.vector, vt);
+		ir_fprintf(f, ", ");
+		ir_print_type(f, m, it);
+		ir_fprintf(f, " ");
+		ir_print_value(f, m, instr->VectorExtractElement.index, it);
+		ir_fprintf(f, "\n");
+	} break;
+
+	case irInstr_VectorInsertElement: {
+		irInstrVectorInsertElement *ie = &instr->VectorInsertElement;
+		Type *vt = ir_type(ie->vector);
+		ir_fprintf(f, "%%%d = insertelement ", value->index);
+
+		ir_print_type(f, m, vt);
+		ir_fprintf(f, " ");
+		ir_print_value(f, m, ie->vector, vt);
+		ir_fprintf(f, ", ");
+
+		ir_print_type(f, m, ir_type(ie->elem));
+		ir_fprintf(f, " ");
+		ir_print_value(f, m, ie->elem, ir_type(ie->elem));
+		ir_fprintf(f, ", ");
+
+		ir_print_type(f, m, ir_type(ie->index));
+		ir_fprintf(f, " ");
+		ir_print_value(f, m, ie->index, ir_type(ie->index));
+
+		ir_fprintf(f, "\n");
+	} break;
+
+	case irInstr_VectorShuffle: {
+		irInstrVectorShuffle *sv = &instr->VectorShuffle;
+		Type *vt = ir_type(sv->vector);
+		ir_fprintf(f, "%%%d = shufflevector ", value->index);
+
+		ir_print_type(f, m, vt);
+		ir_fprintf(f, " ");
+		ir_print_value(f, m, sv->vector, vt);
+		ir_fprintf(f, ", ");
+
+		ir_print_type(f, m, vt);
+		if (sv->other != NULL) {
+			ir_fprintf(f, " ");
+			ir_print_value(f, m, sv->other, vt);
+			ir_fprintf(f, ", ");
+		} else {
+			ir_fprintf(f, " undef, ");
+		}
+
+		ir_fprintf(f, "<%d x i32> <", sv->index_count);
+		for (isize i = 0; i < sv->index_count; i++) {
+			if (i > 0) {
+				ir_fprintf(f, ", ");
+			}
+			ir_fprintf(f, "i32 %d", sv->indices[i]);
+		}
+		ir_fprintf(f, ">");
+		ir_fprintf(f, "\n");
+	} break;
+
+	case irInstr_VectorReduce: {
+		irInstrVectorReduce *vr = &instr->VectorReduce;
+		Type *vt = ir_type(vr->vector);
+		Type *elem = base_vector_type(vt);
+		String name = ir_use_intrinsic(m, value);
+		bool is_fadd = vr->op == Token_Add && is_type_float(elem);
+		// NOTE: `reassoc` lets the float sum be done pairwise rather than strictly in lane order
+		ir_fprintf(f, "%%%d = call %s", value->index, is_fadd ? "reassoc " : "");
+		ir_print_type(f, m, elem);
+		ir_fprintf(f, " @%.*s(", LIT(name));
+		if (is_fadd) {
+			ir_print_type(f, m, elem);
+			ir_fprintf(f, " -0.0, ");
+		}
+		ir_print_type(f, m, vt);
+		ir_fprintf(f, " ");
+		ir_print_value(f, m, vr->vector, vt);
+		ir_fprintf(f, ")\n");
+	} break;
+
+	case irInstr_VectorSelect: {
+		irInstrVectorSelect *vs = &instr->VectorSelect;
+		Type *mt = ir_type(vs->mask);
+		Type *vt = ir_type(vs->true_value);
+		i64 count = base_type(vt)->Vector.count;
+		ir_fprintf(f, "%%vsel.%d = icmp ne ", value->index);
+		ir_print_type(f, m, mt);
+		ir_fprintf(f, " ");
+		ir_print_value(f, m, vs->mask, mt);
+		ir_fprintf(f, ", zeroinitializer\n\t");
+
+		ir_fprintf(f, "%%%d = select <%lld x i1> %%vsel.%d, ", value->index, count, value->index);
+		ir_print_type(f, m, vt);
+		ir_fprintf(f, " ");
+		ir_print_value(f, m, vs->true_value, vt);
+		ir_fprintf(f, ", ");
+		ir_print_type(f, m, vt);
+		ir_fprintf(f, " ");
+		ir_print_value(f, m, vs->false_value, vt);
+		ir_fprintf(f, "\n");
+	} break;
+
+	case irInstr_VectorElementPtrs: {
+		irInstrVectorElementPtrs *ep = &instr->VectorElementPtrs;
+		Type *pt = ir_type(ep->address);
+		Type *it = ir_type(ep->indices);
+		ir_fprintf(f, "%%%d = getelementptr ", value->index);
+		ir_print_type(f, m, type_deref(pt));
+		ir_fprintf(f, ", ");
+		ir_print_type(f, m, pt);
+		ir_fprintf(f, " ");
+		ir_print_value(f, m, ep->address, pt);
+		ir_fprintf(f, ", ");
+		ir_print_type(f, m, it);
+		ir_fprintf(f, " ");
+		ir_print_value(f, m, ep->indices, it);
+		ir_fprintf(f, "\n");
+	} break;
+
+	case irInstr_VectorGather: {
+		irInstrVectorGather *vg = &instr->VectorGather;
+		Type *vt = vg->type;
+		Type *pt = ir_type(vg->ptrs);
+		String name = ir_use_intrinsic(m, value);
+		ir_fprintf(f, "%%%d = call ", value->index);
+		ir_print_type(f, m, vt);
+		ir_fprintf(f, " @%.*s(", LIT(name));
+		ir_print_type(f, m, pt);
+		ir_fprintf(f, " ");
+		ir_print_value(f, m, vg->ptrs, pt);
+		ir_fprintf(f, ", i32 %lld, ", type_align_of(m->allocator, base_vector_type(vt)));
+		ir_print_vector_all_true_mask(f, base_type(vt)->Vector.count);
+		ir_fprintf(f, ", ");
+		ir_print_type(f, m, vt);
+		ir_fprintf(f, " undef)\n");
+	} break;
+
+	case irInstr_VectorScatter: {
+		irInstrVectorScatter *vs = &instr->VectorScatter;
+		Type *vt = ir_type(vs->values);
+		Type *pt = ir_type(vs->ptrs);
+		String name = ir_use_intrinsic(m, value);
+		ir_fprintf(f, "call void @%.*s(", LIT(name));
+		ir_print_type(f, m, vt);
+		ir_fprintf(f, " ");
+		ir_print_value(f, m, vs->values, vt);
+		ir_fprintf(f, ", ");
+		ir_print_type(f, m, pt);
+		ir_fprintf(f, " ");
+		ir_print_value(f, m, vs->ptrs, pt);
+		ir_fprintf(f, ", i32 %lld, ", type_align_of(m->allocator, base_vector_type(vt)));
+		ir_print_vector_all_true_mask(f, base_type(vt)->Vector.count);
+		ir_fprintf(f, ")\n");
+	} break;
+
+	case irInstr_FusedMulAdd: {
+		irInstrFusedMulAdd *fma = &instr->FusedMulAdd;
+		Type *t = ir_type(fma->a);
+		String name = ir_use_intrinsic(m, value);
+		ir_fprintf(f, "%%%d = call ", value->index);
+		ir_print_type(f, m, t);
+		ir_fprintf(f, " @%.*s(", LIT(name));
+		ir_print_type(f, m, t);
+		ir_fprintf(f, " ");
+		ir_print_value(f, m, fma->a, t);
+		ir_fprintf(f, ", ");
+		ir_print_type(f, m, t);
+		ir_fprintf(f, " ");
+		ir_print_value(f, m, fma->b, t);
+		ir_fprintf(f, ", ");
+		ir_print_type(f, m, t);
+		ir_fprintf(f, " ");
+		ir_print_value(f, m, fma->c, t);
+		ir_fprintf(f, ")\n");
+	} break;
 
 	#if 0
 	case irInstr_BoundsCheck: {
@@ -1522,6 +1886,9 @@ void ir_print_instr(irFileBuffer *f, irModule *m, irValue *value) {
 
 
 void ir_print_proc(irFileBuffer *f, irModule *m, irProcedure *proc) {
+	isize trace = trace_begin(str_lit("ir_print_proc"), proc->name);
+	defer (trace_end(trace));
+
 	if (proc->body == NULL) {
 		ir_fprintf(f, "declare ");
 		// if (proc->tags & ProcTag_dll_import) {
@@ -1597,7 +1964,7 @@ void ir_print_proc(irFileBuffer *f, irModule *m, irProcedure *proc) {
 			param_index++;
 		}
 	}
-	if (proc_type->calling_convention == ProcCC_Odin) {
+	if (proc_type->calling_convention == ProcCC_Odin && !proc->contextless) {
 		if (param_index > 0) ir_fprintf(f, ", ");
 
 		ir_print_type(f, m, t_context_ptr);
@@ -1732,6 +2099,10 @@ void print_llvm_ir(irGen *ir) {
 		}
 	}
 
+	for_array(i, m->intrinsics.entries) {
+		ir_print_intrinsic_declaration(f, m, m->intrinsics.entries[i].value);
+	}
+
 	for_array(member_index, m->members.entries) {
 		auto *entry = &m->members.entries[member_index];
 		irValue *v = entry->value;
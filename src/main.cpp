@@ -1,8 +1,6 @@
-#define USE_CUSTOM_BACKEND 0
-// #define PRINT_TIMINGS
-
 #include "common.cpp"
 #include "timings.cpp"
+#include "trace.cpp"
 #include "build_settings.cpp"
 #include "tokenizer.cpp"
 #include "parser.cpp"
@@ -73,6 +71,10 @@ i32 system_exec_command_line_app(char *name, bool is_silent, char *fmt, ...) {
 	cmd = make_string(cast(u8 *)&cmd_line, cmd_len-1);
 
 	exit_code = system(&cmd_line[0]);
+	if (exit_code != -1 && WIFEXITED(exit_code)) {
+		// NOTE: `system` returns the wait status, whose low byte is zero for a normal exit
+		exit_code = WEXITSTATUS(exit_code);
+	}
 
 	// pid_t pid = fork();
 	// int status = 0;
@@ -163,6 +165,275 @@ void usage(String argv0) {
 	print_usage_line(1, "run          compile and run .odin file");
 	print_usage_line(1, "docs         generate documentation for a .odin file");
 	print_usage_line(1, "version      print version");
+	print_usage_line(0, "Flags:");
+	print_usage_line(1, "-opt=N         optimization level (0-3), or `size` to optimize for code size");
+	print_usage_line(1, "-mcpu=<cpu>    target cpu for code generation, e.g. `native`");
+	print_usage_line(1, "-show-memory   print the memory used by each phase and arena");
+	print_usage_line(1, "-show-timings  print the wall-clock and CPU time of each phase and sub-phase");
+	print_usage_line(1, "-export-timings=<file>  write the timings and counters as JSON to <file>");
+	print_usage_line(1, "-trace=<file>  write a Chrome trace of the compiler phases and procedures to <file>");
+	print_usage_line(1, "-llvm-ir-only  stop after writing the .ll file (used by misc/benchmark.sh)");
+	print_usage_line(1, "-backend=ssa   use the experimental custom SSA backend (linux/amd64) instead of LLVM,");
+	print_usage_line(1, "               which reports an error for what it cannot compile yet");
+}
+
+
+
+// NOTE: Called once the build has finished and, through a `defer`, on every exit after parsing,
+// so that the trace of a failed build is written too
+void export_trace(Timings *t) {
+	gb_local_persist bool exported = false;
+	if (build_context.trace_file.len > 0 && !exported) {
+		exported = true;
+		trace_export_json(&global_trace, t, build_context.trace_file);
+	}
+}
+
+void show_timings(Timings *t) {
+	if (build_context.show_timings) {
+		timings_print_all(t);
+	}
+	if (build_context.export_timings_file.len > 0) {
+		timings_export_json(t, build_context.export_timings_file);
+	}
+	export_trace(t);
+}
+
+#if !defined(GB_SYSTEM_WINDOWS)
+// NOTE: Links `output_base`.o into the executable or shared library, used by both backends
+i32 link_object_unix(String output_base, Array<String> foreign_library_paths) {
+	gbString lib_str = gb_string_make(heap_allocator(), "");
+	defer (gb_string_free(lib_str));
+	char lib_str_buf[1024] = {0};
+	for_array(i, foreign_library_paths) {
+		String lib = foreign_library_paths[i];
+
+		// NOTE(zangent): Sometimes, you have to use -framework on MacOS.
+		//   This allows you to specify '-f' in a #foreign_system_library,
+		//   without having to implement any new syntax specifically for MacOS.
+		#if defined(GB_SYSTEM_OSX)
+			isize len;
+			if(lib.len > 2 && lib[0] == '-' && lib[1] == 'f') {
+				len = gb_snprintf(lib_str_buf, gb_size_of(lib_str_buf),
+				                        " -framework %.*s ", (int)(lib.len) - 2, lib.text + 2);
+			} else {
+				len = gb_snprintf(lib_str_buf, gb_size_of(lib_str_buf),
+				                        " -l%.*s ", LIT(lib));
+			}
+		#else
+			isize len = gb_snprintf(lib_str_buf, gb_size_of(lib_str_buf),
+			                        " -l%.*s ", LIT(lib));
+		#endif
+		lib_str = gb_string_appendc(lib_str, lib_str_buf);
+	}
+
+	// Unlike the Win32 linker code, the output_ext includes the dot, because
+	// typically executable files on *NIX systems don't have extensions.
+	char *output_ext = "";
+	char *link_settings = "";
+	char *linker;
+	if (build_context.is_dll) {
+		// Shared libraries are .dylib on MacOS and .so on Linux.
+		// TODO(zangent): Is that statement entirely truthful?
+		#if defined(GB_SYSTEM_OSX)
+			output_ext = ".dylib";
+		#else
+			output_ext = ".so";
+		#endif
+
+		link_settings = "-shared";
+	} else {
+		// TODO: Do I need anything here?
+		link_settings = "";
+	}
+
+	#if defined(GB_SYSTEM_OSX)
+		linker = "ld";
+	#else
+		// TODO(zangent): Figure out how to make ld work on Linux.
+		//   It probably has to do with including the entire CRT, but
+		//   that's quite a complicated issue to solve while remaining distro-agnostic.
+		//   Clang can figure out linker flags for us, and that's good enough _for now_.
+		linker = "clang -Wno-unused-command-line-argument";
+	#endif
+
+	return system_exec_command_line_app("ld-link", true,
+		"%s \"%.*s\".o -o \"%.*s%s\" %s "
+		"-lc -lm "
+		" %.*s "
+		" %s "
+		#if defined(GB_SYSTEM_OSX)
+			// This sets a requirement of Mountain Lion and up, but the compiler doesn't work without this limit.
+			// NOTE: If you change this (although this minimum is as low as you can go with Odin working)
+			//       make sure to also change the `mtriple` param passed to `opt`
+			" -macosx_version_min 10.8.0 "
+			// This points the linker to where the entry point is
+			" -e _main "
+		#endif
+		, linker, LIT(output_base), LIT(output_base), output_ext,
+		lib_str, LIT(build_context.link_flags),
+		link_settings
+		);
+}
+#endif
+
+void add_parser_counters(Timings *t, Parser *p) {
+	isize node_count = 0;
+	for_array(i, p->files) {
+		node_count += p->files[i].node_count;
+	}
+	timings_add_counter(t, str_lit("files"),     p->files.count);
+	timings_add_counter(t, str_lit("lines"),     p->total_line_count);
+	timings_add_counter(t, str_lit("tokens"),    p->total_token_count);
+	timings_add_counter(t, str_lit("ast nodes"), node_count);
+}
+
+void add_checker_counters(Timings *t, Checker *c) {
+	timings_add_counter(t, str_lit("entities"),      global_entity_id);
+	timings_add_counter(t, str_lit("types"),         global_type_count);
+	timings_add_counter(t, str_lit("declarations"),  c->info.entities.entries.count);
+	timings_add_counter(t, str_lit("type info"),     c->info.type_info_count);
+}
+
+void add_ir_counters(Timings *t, irGen *ir_gen) {
+	isize instr_count = 0;
+	for_array(i, ir_gen->module.procs) {
+		instr_count += ir_gen->module.procs[i]->instr_count;
+	}
+	timings_add_counter(t, str_lit("ir procedures"),   ir_gen->module.procs.count);
+	timings_add_counter(t, str_lit("ir instructions"), instr_count);
+	timings_add_counter(t, str_lit("ll bytes"),        gb_file_size(&ir_gen->output_file));
+}
+
+
+struct MemoryReportEntry {
+	String phase;
+	String label;
+	isize  used;
+	isize  peak;
+	isize  reserved;
+	isize  blocks;
+};
+
+struct MemoryReport {
+	Array<MemoryReportEntry> entries;
+	Array<String>            phases;
+	Array<isize>             phase_peaks; // NOTE: Peak memory of the process at the end of each phase
+};
+
+#if defined(GB_SYSTEM_WINDOWS)
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+
+isize peak_memory_usage(void) {
+	PROCESS_MEMORY_COUNTERS pmc = {};
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, gb_size_of(pmc))) {
+		return cast(isize)pmc.PeakWorkingSetSize;
+	}
+	return 0;
+}
+#elif defined(GB_SYSTEM_OSX) || defined(GB_SYSTEM_UNIX)
+#include <sys/resource.h>
+
+isize peak_memory_usage(void) {
+	struct rusage usage = {};
+	if (getrusage(RUSAGE_SELF, &usage) != 0) {
+		return 0;
+	}
+#if defined(GB_SYSTEM_OSX)
+	return cast(isize)usage.ru_maxrss; // NOTE: Already in bytes
+#else
+	return cast(isize)usage.ru_maxrss * 1024;
+#endif
+}
+#else
+#error Implement system
+#endif
+
+void memory_report_init(MemoryReport *r) {
+	array_init(&r->entries,     heap_allocator());
+	array_init(&r->phases,      heap_allocator());
+	array_init(&r->phase_peaks, heap_allocator());
+}
+
+void memory_report_destroy(MemoryReport *r) {
+	array_free(&r->entries);
+	array_free(&r->phases);
+	array_free(&r->phase_peaks);
+}
+
+// NOTE: Arenas with the same phase and label are summed together (e.g. one per file)
+void memory_report_add_arena(MemoryReport *r, String phase, String label, DynamicArena *a) {
+	MemoryReportEntry *e = NULL;
+	if (r->entries.count > 0) {
+		e = &r->entries[r->entries.count-1];
+		if (e->phase != phase || e->label != label) {
+			e = NULL;
+		}
+	}
+	if (e == NULL) {
+		MemoryReportEntry entry = {phase, label};
+		array_add(&r->entries, entry);
+		e = &r->entries[r->entries.count-1];
+	}
+	e->used     += dynamic_arena_used(a);
+	e->peak     += a->peak_used;
+	e->reserved += dynamic_arena_reserved(a);
+	e->blocks   += dynamic_arena_block_count(a);
+}
+
+void memory_report_end_phase(MemoryReport *r, String phase) {
+	array_add(&r->phases, phase);
+	array_add(&r->phase_peaks, peak_memory_usage());
+}
+
+f64 memory_report_kilobytes(isize bytes) {
+	return cast(f64)bytes / 1024.0;
+}
+
+void memory_report_print(MemoryReport *r) {
+	char const SPACES[] = "                                                                ";
+	isize max_len = 0;
+	for_array(i, r->entries) {
+		MemoryReportEntry e = r->entries[i];
+		max_len = gb_max(max_len, e.phase.len + 3 + e.label.len);
+	}
+	for_array(i, r->phases) {
+		max_len = gb_max(max_len, r->phases[i].len);
+	}
+	GB_ASSERT(max_len <= gb_size_of(SPACES)-1);
+
+	isize total_used = 0;
+	isize total_reserved = 0;
+	gb_printf("Arena Memory\n");
+	for_array(i, r->entries) {
+		MemoryReportEntry e = r->entries[i];
+		gb_printf("%.*s - %.*s%.*s - %.1f KiB used, %.1f KiB peak, %.1f KiB reserved in %td block%s\n",
+		          LIT(e.phase), LIT(e.label),
+		          cast(int)(max_len-(e.phase.len + 3 + e.label.len)), SPACES,
+		          memory_report_kilobytes(e.used),
+		          memory_report_kilobytes(e.peak),
+		          memory_report_kilobytes(e.reserved),
+		          e.blocks, e.blocks == 1 ? "" : "s");
+		total_used     += e.used;
+		total_reserved += e.reserved;
+	}
+	gb_printf("Total%.*s - %.1f KiB used, %.1f KiB reserved\n",
+	          cast(int)(max_len-5), SPACES,
+	          memory_report_kilobytes(total_used),
+	          memory_report_kilobytes(total_reserved));
+
+	gb_printf("Peak Process Memory\n");
+	isize prev = 0;
+	for_array(i, r->phases) {
+		String phase = r->phases[i];
+		isize peak = r->phase_peaks[i];
+		gb_printf("%.*s%.*s - %.1f KiB (+%.1f KiB)\n",
+		          LIT(phase), cast(int)(max_len-phase.len), SPACES,
+		          memory_report_kilobytes(peak),
+		          memory_report_kilobytes(peak-prev));
+		prev = peak;
+	}
 }
 
 
@@ -171,6 +442,13 @@ enum BuildFlagKind {
 	BuildFlag_Invalid,
 
 	BuildFlag_OptimizationLevel,
+	BuildFlag_ShowMemory,
+	BuildFlag_ShowTimings,
+	BuildFlag_ExportTimings,
+	BuildFlag_Trace,
+	BuildFlag_LLVMIROnly,
+	BuildFlag_Backend,
+	BuildFlag_TargetCpu,
 
 	BuildFlag_COUNT,
 };
@@ -201,7 +479,14 @@ void add_flag(Array<BuildFlag> *build_flags, BuildFlagKind kind, String name, Bu
 bool parse_build_flags(Array<String> args) {
 	Array<BuildFlag> build_flags = {};
 	array_init(&build_flags, heap_allocator(), BuildFlag_COUNT);
-	add_flag(&build_flags, BuildFlag_OptimizationLevel, str_lit("opt"), BuildFlagParam_Integer);
+	add_flag(&build_flags, BuildFlag_OptimizationLevel, str_lit("opt"), BuildFlagParam_String);
+	add_flag(&build_flags, BuildFlag_ShowMemory,        str_lit("show-memory"), BuildFlagParam_None);
+	add_flag(&build_flags, BuildFlag_ShowTimings,       str_lit("show-timings"), BuildFlagParam_None);
+	add_flag(&build_flags, BuildFlag_ExportTimings,     str_lit("export-timings"), BuildFlagParam_String);
+	add_flag(&build_flags, BuildFlag_Trace,             str_lit("trace"), BuildFlagParam_String);
+	add_flag(&build_flags, BuildFlag_LLVMIROnly,        str_lit("llvm-ir-only"), BuildFlagParam_None);
+	add_flag(&build_flags, BuildFlag_Backend,           str_lit("backend"), BuildFlagParam_String);
+	add_flag(&build_flags, BuildFlag_TargetCpu,         str_lit("mcpu"), BuildFlagParam_String);
 
 	Array<String> flag_args = args;
 	flag_args.data  += 3;
@@ -223,7 +508,10 @@ bool parse_build_flags(Array<String> args) {
 				}
 			}
 			name.len = end;
-			String param = substring(flag, 2+end, flag.len);
+			String param = {};
+			if (2+end <= flag.len) {
+				param = substring(flag, 2+end, flag.len);
+			}
 
 			bool found = false;
 			for_array(build_flag_index, build_flags) {
@@ -291,15 +579,60 @@ bool parse_build_flags(Array<String> args) {
 						}
 						if (ok) {
 							switch (bf.kind) {
-							case BuildFlag_OptimizationLevel:
-								if (value.kind == ExactValue_Integer) {
-									build_context.optimization_level = cast(i32)i128_to_i64(value.value_integer);
+							case BuildFlag_OptimizationLevel: {
+								GB_ASSERT(value.kind == ExactValue_String);
+								String level = value.value_string;
+								bool is_integer = true;
+								for (isize j = 0; j < level.len; j++) {
+									if (!gb_char_is_digit(level[j])) {
+										is_integer = false;
+										break;
+									}
+								}
+								if (level == "size") {
+									build_context.optimize_for_size = true;
+								} else if (is_integer) {
+									ExactValue v = exact_value_integer_from_string(level);
+									build_context.optimization_level = cast(i32)big_int_to_i64(v.value_integer);
+								} else {
+									gb_printf_err("%.*s expected an integer or `size`, got %.*s\n", LIT(name), LIT(param));
+									bad_flags = true;
+									ok = false;
+								}
+							} break;
+							case BuildFlag_ShowMemory:
+								build_context.show_memory = true;
+								break;
+							case BuildFlag_ShowTimings:
+								build_context.show_timings = true;
+								break;
+							case BuildFlag_ExportTimings:
+								GB_ASSERT(value.kind == ExactValue_String);
+								build_context.export_timings_file = value.value_string;
+								break;
+							case BuildFlag_Trace:
+								GB_ASSERT(value.kind == ExactValue_String);
+								build_context.trace_file = value.value_string;
+								break;
+							case BuildFlag_LLVMIROnly:
+								build_context.llvm_ir_only = true;
+								break;
+							case BuildFlag_Backend:
+								GB_ASSERT(value.kind == ExactValue_String);
+								if (value.value_string == "ssa") {
+									build_context.use_ssa_backend = true;
+								} else if (value.value_string == "llvm") {
+									build_context.use_ssa_backend = false;
 								} else {
-									gb_printf_err("%.*s expected an integer, got %.*s", LIT(name), LIT(param));
+									gb_printf_err("%.*s expected `ssa` or `llvm`, got %.*s\n", LIT(name), LIT(param));
 									bad_flags = true;
 									ok = false;
 								}
 								break;
+							case BuildFlag_TargetCpu:
+								GB_ASSERT(value.kind == ExactValue_String);
+								build_context.target_cpu = value.value_string;
+								break;
 							}
 						}
 
@@ -328,13 +661,16 @@ int main(int arg_count, char **arg_ptr) {
 		return 1;
 	}
 
-	Timings timings = {0};
-	timings_init(&timings, str_lit("Total Time"), 128);
-	defer (timings_destroy(&timings));
+	timings_init(&global_timings, str_lit("Total Time"), 128);
+	defer (timings_destroy(&global_timings));
 	init_string_buffer_memory();
 	init_scratch_memory(gb_megabytes(10));
 	init_global_error_collector();
 
+	MemoryReport memory_report = {};
+	memory_report_init(&memory_report);
+	defer (memory_report_destroy(&memory_report));
+
 	Array<String> args = setup_args(arg_count, arg_ptr);
 
 
@@ -386,6 +722,11 @@ int main(int arg_count, char **arg_ptr) {
 		return 1;
 	}
 
+	if (build_context.trace_file.len > 0) {
+		trace_init(&global_trace);
+	}
+	defer (trace_destroy(&global_trace));
+
 
 	init_build_context();
 	if (build_context.word_size == 4) {
@@ -396,25 +737,36 @@ int main(int arg_count, char **arg_ptr) {
 
 	// TODO(bill): prevent compiling without a linker
 
-	timings_start_section(&timings, str_lit("parse files"));
+	timings_start_section(&global_timings, str_lit("parse files"));
 
 	Parser parser = {0};
 	if (!init_parser(&parser)) {
 		return 1;
 	}
 	defer (destroy_parser(&parser));
+	defer (export_trace(&global_timings));
 
 	if (parse_files(&parser, init_filename) != ParseFile_None) {
 		return 1;
 	}
 
+	add_parser_counters(&global_timings, &parser);
+
+	if (build_context.show_memory) {
+		String phase = str_lit("parse files");
+		for_array(i, parser.files) {
+			memory_report_add_arena(&memory_report, phase, str_lit("ast"), &parser.files[i].arena);
+		}
+		memory_report_end_phase(&memory_report, phase);
+	}
+
 	if (build_context.generate_docs) {
 		generate_documentation(&parser);
 		return 0;
 	}
 
 #if 1
-	timings_start_section(&timings, str_lit("type check"));
+	timings_start_section(&global_timings, str_lit("type check"));
 
 	Checker checker = {0};
 
@@ -422,41 +774,92 @@ int main(int arg_count, char **arg_ptr) {
 	defer (destroy_checker(&checker));
 
 	check_parsed_files(&checker);
+	add_checker_counters(&global_timings, &checker);
 
+	if (build_context.show_memory) {
+		String phase = str_lit("type check");
+		memory_report_add_arena(&memory_report, phase, str_lit("checker"),     &checker.arena);
+		memory_report_add_arena(&memory_report, phase, str_lit("checker temp"), &checker.tmp_arena);
+		memory_report_end_phase(&memory_report, phase);
+	}
 
 #endif
-#if defined(USE_CUSTOM_BACKEND) && USE_CUSTOM_BACKEND
-	if (global_error_collector.count != 0) {
-		return 1;
+	if (checker.info.run_exprs.count > 0 && global_error_collector.count == 0) {
+		timings_start_section(&global_timings, str_lit("compile time execution"));
+		if (!ssa_execute_run_exprs(&checker.info, parser.total_token_count)) {
+			return 1;
+		}
 	}
 
-	if (checker.parser->total_token_count < 2) {
-		return 1;
-	}
+	if (build_context.use_ssa_backend) {
+		if (global_error_collector.count != 0) {
+			return 1;
+		}
 
-	if (!ssa_generate(&parser, &checker.info)) {
-		return 1;
+		if (checker.parser->total_token_count < 2) {
+			return 1;
+		}
+
+		timings_start_section(&global_timings, str_lit("ssa gen"));
+		Array<String> foreign_library_paths = {};
+		array_init(&foreign_library_paths, heap_allocator());
+		defer (array_free(&foreign_library_paths));
+		if (!ssa_generate(&parser, &checker.info, &foreign_library_paths)) {
+			return 1;
+		}
+
+	#if !defined(GB_SYSTEM_WINDOWS)
+		String init_fullpath = parser.init_fullpath;
+		String output_base = make_string(init_fullpath.text, string_extension_position(init_fullpath));
+
+		timings_start_section(&global_timings, str_lit("ld-link"));
+		i32 exit_code = link_object_unix(output_base, foreign_library_paths);
+		if (exit_code != 0) {
+			return exit_code;
+		}
+
+		show_timings(&global_timings);
+
+		if (run_output) {
+			system_exec_command_line_app("odin run", false, "%.*s", LIT(output_base));
+		}
+	#endif
+		return 0;
 	}
-#else
+
 	irGen ir_gen = {0};
 	if (!ir_gen_init(&ir_gen, &checker)) {
 		return 1;
 	}
 	defer (ir_gen_destroy(&ir_gen));
 
-	timings_start_section(&timings, str_lit("llvm ir gen"));
+	timings_start_section(&global_timings, str_lit("llvm ir gen"));
 	ir_gen_tree(&ir_gen);
 
-	timings_start_section(&timings, str_lit("llvm ir opt tree"));
+	timings_start_section(&global_timings, str_lit("llvm ir opt tree"));
 	ir_opt_tree(&ir_gen);
 
-	timings_start_section(&timings, str_lit("llvm ir print"));
+	timings_start_section(&global_timings, str_lit("llvm ir print"));
 	print_llvm_ir(&ir_gen);
+	add_ir_counters(&global_timings, &ir_gen);
+
+	if (build_context.show_memory) {
+		String phase = str_lit("llvm ir");
+		memory_report_add_arena(&memory_report, phase, str_lit("ir"),      &ir_gen.module.arena);
+		memory_report_add_arena(&memory_report, phase, str_lit("ir temp"), &ir_gen.module.tmp_arena);
+		memory_report_end_phase(&memory_report, phase);
+		memory_report_print(&memory_report);
+	}
 
 	// prof_print_all();
 
+	if (build_context.llvm_ir_only) {
+		show_timings(&global_timings);
+		return 0;
+	}
+
 	#if 1
-	timings_start_section(&timings, str_lit("llvm-opt"));
+	timings_start_section(&global_timings, str_lit("llvm-opt"));
 
 	String output_name = ir_gen.output_name;
 	String output_base = ir_gen.output_base;
@@ -470,9 +873,6 @@ int main(int arg_count, char **arg_ptr) {
 		// For more passes arguments: http://llvm.org/docs/Passes.html
 		exit_code = system_exec_command_line_app("llvm-opt", false,
 			"\"%.*sbin/opt\" \"%.*s\".ll -o \"%.*s\".bc %.*s "
-			"-mem2reg "
-			"-memcpyopt "
-			"-die "
 			"",
 			LIT(build_context.ODIN_ROOT),
 			LIT(output_base), LIT(output_base),
@@ -485,9 +885,6 @@ int main(int arg_count, char **arg_ptr) {
 		//   with the Windows version, while they will be system-provided on MacOS and GNU/Linux
 		exit_code = system_exec_command_line_app("llvm-opt", false,
 			"opt \"%.*s\".ll -o \"%.*s\".bc %.*s "
-			"-mem2reg "
-			"-memcpyopt "
-			"-die "
 			#if defined(GB_SYSTEM_OSX)
 				// This sets a requirement of Mountain Lion and up, but the compiler doesn't work without this limit.
 				// NOTE: If you change this (although this minimum is as low as you can go with Odin working)
@@ -503,7 +900,7 @@ int main(int arg_count, char **arg_ptr) {
 	#endif
 
 	#if defined(GB_SYSTEM_WINDOWS)
-		timings_start_section(&timings, str_lit("llvm-llc"));
+		timings_start_section(&global_timings, str_lit("llvm-llc"));
 		// For more arguments: http://llvm.org/docs/CommandGuide/llc.html
 		exit_code = system_exec_command_line_app("llvm-llc", false,
 			"\"%.*sbin/llc\" \"%.*s.bc\" -filetype=obj -O%d "
@@ -518,7 +915,7 @@ int main(int arg_count, char **arg_ptr) {
 			return exit_code;
 		}
 
-		timings_start_section(&timings, str_lit("msvc-link"));
+		timings_start_section(&global_timings, str_lit("msvc-link"));
 
 		gbString lib_str = gb_string_make(heap_allocator(), "");
 		defer (gb_string_free(lib_str));
@@ -556,9 +953,7 @@ int main(int arg_count, char **arg_ptr) {
 			return exit_code;
 		}
 
-	#if defined(PRINT_TIMINGS)
-		timings_print_all(&timings);
-	#endif
+		show_timings(&global_timings);
 
 
 		if (run_output) {
@@ -570,7 +965,7 @@ int main(int arg_count, char **arg_ptr) {
 		// NOTE(zangent): Linux / Unix is unfinished and not tested very well.
 
 
-		timings_start_section(&timings, str_lit("llvm-llc"));
+		timings_start_section(&global_timings, str_lit("llvm-llc"));
 		// For more arguments: http://llvm.org/docs/CommandGuide/llc.html
 		exit_code = system_exec_command_line_app("llc", false,
 			"llc \"%.*s.bc\" -filetype=obj -relocation-model=pic -O%d "
@@ -584,87 +979,14 @@ int main(int arg_count, char **arg_ptr) {
 			return exit_code;
 		}
 
-		timings_start_section(&timings, str_lit("ld-link"));
-
-		gbString lib_str = gb_string_make(heap_allocator(), "");
-		defer (gb_string_free(lib_str));
-		char lib_str_buf[1024] = {0};
-		for_array(i, ir_gen.module.foreign_library_paths) {
-			String lib = ir_gen.module.foreign_library_paths[i];
-
-			// NOTE(zangent): Sometimes, you have to use -framework on MacOS.
-			//   This allows you to specify '-f' in a #foreign_system_library,
-			//   without having to implement any new syntax specifically for MacOS.
-			#if defined(GB_SYSTEM_OSX)
-				isize len;
-				if(lib.len > 2 && lib[0] == '-' && lib[1] == 'f') {
-					len = gb_snprintf(lib_str_buf, gb_size_of(lib_str_buf),
-					                        " -framework %.*s ", (int)(lib.len) - 2, lib.text + 2);
-				} else {
-					len = gb_snprintf(lib_str_buf, gb_size_of(lib_str_buf),
-					                        " -l%.*s ", LIT(lib));
-				}
-			#else
-				isize len = gb_snprintf(lib_str_buf, gb_size_of(lib_str_buf),
-				                        " -l%.*s ", LIT(lib));
-			#endif
-			lib_str = gb_string_appendc(lib_str, lib_str_buf);
-		}
-
-		// Unlike the Win32 linker code, the output_ext includes the dot, because
-		// typically executable files on *NIX systems don't have extensions.
-		char *output_ext = "";
-		char *link_settings = "";
-		char *linker;
-		if (build_context.is_dll) {
-			// Shared libraries are .dylib on MacOS and .so on Linux.
-			// TODO(zangent): Is that statement entirely truthful?
-			#if defined(GB_SYSTEM_OSX)
-				output_ext = ".dylib";
-			#else
-				output_ext = ".so";
-			#endif
-
-			link_settings = "-shared";
-		} else {
-			// TODO: Do I need anything here?
-			link_settings = "";
-		}
-
-		#if defined(GB_SYSTEM_OSX)
-			linker = "ld";
-		#else
-			// TODO(zangent): Figure out how to make ld work on Linux.
-			//   It probably has to do with including the entire CRT, but
-			//   that's quite a complicated issue to solve while remaining distro-agnostic.
-			//   Clang can figure out linker flags for us, and that's good enough _for now_.
-			linker = "clang -Wno-unused-command-line-argument";
-		#endif
+		timings_start_section(&global_timings, str_lit("ld-link"));
 
-		exit_code = system_exec_command_line_app("ld-link", true,
-			"%s \"%.*s\".o -o \"%.*s%s\" %s "
-			"-lc -lm "
-			" %.*s "
-			" %s "
-			#if defined(GB_SYSTEM_OSX)
-				// This sets a requirement of Mountain Lion and up, but the compiler doesn't work without this limit.
-				// NOTE: If you change this (although this minimum is as low as you can go with Odin working)
-				//       make sure to also change the `mtriple` param passed to `opt`
-				" -macosx_version_min 10.8.0 "
-				// This points the linker to where the entry point is
-				" -e _main "
-			#endif
-			, linker, LIT(output_base), LIT(output_base), output_ext,
-			lib_str, LIT(build_context.link_flags),
-			link_settings
-			);
+		exit_code = link_object_unix(output_base, ir_gen.module.foreign_library_paths);
 		if (exit_code != 0) {
 			return exit_code;
 		}
 
-	#if defined(PRINT_TIMINGS)
-		timings_print_all(&timings);
-	#endif
+		show_timings(&global_timings);
 
 		if (run_output) {
 			system_exec_command_line_app("odin run", false, "%.*s", LIT(output_base));
@@ -672,7 +994,6 @@ int main(int arg_count, char **arg_ptr) {
 
 	#endif
 #endif
-#endif
 #endif
 
 	return 0;
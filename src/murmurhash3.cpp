@@ -223,3 +223,43 @@ gb_inline u128 MurmurHash3_128(void const *key, isize len, u32 seed) {
 }
 
 
+
+// NOTE: MurmurHash64A, this must stay in sync with `__default_hash` in core/_preload.odin as it
+// is used to hash constant map keys at compile time
+u64 MurmurHash64A(void const *key, isize len, u64 seed) {
+	u64 const m = 0xc6a4a7935bd1e995ULL;
+	i32 const r = 47;
+
+	u8 const *data = cast(u8 const *)key;
+	u64 h = seed ^ (cast(u64)len * m);
+
+	while (len >= 8) {
+		u64 k;
+		gb_memmove(&k, data, 8);
+
+		k *= m;
+		k ^= k >> r;
+		k *= m;
+
+		h ^= k;
+		h *= m;
+
+		data += 8;
+		len  -= 8;
+	}
+
+	if (len > 0) {
+		u64 k = 0;
+		for (isize i = 0; i < len; i++) {
+			k |= cast(u64)data[i] << (8*i);
+		}
+		h ^= k;
+		h *= m;
+	}
+
+	h ^= h >> r;
+	h *= m;
+	h ^= h >> r;
+
+	return h;
+}
@@ -22,7 +22,8 @@ struct CommentGroup {
 
 struct AstFile {
 	i32            id;
-	gbArena        arena;
+	DynamicArena   arena;
+	isize          node_count;
 	Tokenizer      tokenizer;
 	Array<Token>   tokens;
 	isize          curr_token_index;
@@ -80,6 +81,7 @@ enum ProcTag {
 
 
 	ProcTag_require_results = 1<<4,
+	ProcTag_printf          = 1<<5,
 
 	ProcTag_foreign         = 1<<10,
 	ProcTag_export          = 1<<11,
@@ -927,12 +929,8 @@ bool ast_node_expect(AstNode *node, AstNodeKind kind) {
 
 // NOTE(bill): And this below is why is I/we need a new language! Discriminated unions are a pain in C/C++
 AstNode *make_ast_node(AstFile *f, AstNodeKind kind) {
-	gbArena *arena = &f->arena;
-	if (gb_arena_size_remaining(arena, GB_DEFAULT_MEMORY_ALIGNMENT) <= gb_size_of(AstNode)) {
-		// NOTE(bill): If a syntax error is so bad, just quit!
-		gb_exit(1);
-	}
-	AstNode *node = gb_alloc_item(gb_arena_allocator(arena), AstNode);
+	AstNode *node = gb_alloc_item(dynamic_arena_allocator(&f->arena), AstNode);
+	f->node_count++;
 	node->kind = kind;
 	return node;
 }
@@ -2108,6 +2106,7 @@ void parse_proc_tags(AstFile *f, u64 *tags, String *link_name, ProcCallingConven
 		ELSE_IF_ADD_TAG(no_bounds_check)
 		ELSE_IF_ADD_TAG(inline)
 		ELSE_IF_ADD_TAG(no_inline)
+		ELSE_IF_ADD_TAG(printf)
 		else if (tag_name == "cc_odin") {
 			if (cc == ProcCC_Invalid) {
 				cc = ProcCC_Odin;
@@ -2269,12 +2268,12 @@ AstNode *parse_operand(AstFile *f, bool lhs) {
 				error(expr, "#run can only be applied to procedure calls");
 				operand = ast_bad_expr(f, token, f->curr_token);
 			}
-			warning(token, "#run is not yet implemented");
 		} else if (name.string == "file") { return ast_basic_directive(f, token, name.string);
 		} else if (name.string == "line") { return ast_basic_directive(f, token, name.string);
 		} else if (name.string == "procedure") { return ast_basic_directive(f, token, name.string);
 		} else if (name.string == "caller_location") { return ast_basic_directive(f, token, name.string);
-		} else if (name.string == "location") {
+		} else if (name.string == "location" ||
+		           name.string == "load") {
 			AstNode *tag = ast_basic_directive(f, token, name.string);
 			return parse_call_expr(f, tag);
 		} else {
@@ -4484,10 +4483,10 @@ ParseFileError init_ast_file(AstFile *f, String fullpath) {
 		f->prev_token = f->tokens[f->curr_token_index];
 		f->curr_token = f->tokens[f->curr_token_index];
 
-		// NOTE(bill): Is this big enough or too small?
-		isize arena_size = gb_size_of(AstNode);
-		arena_size *= 2*f->tokens.count;
-		gb_arena_init_from_allocator(&f->arena, heap_allocator(), arena_size);
+		// NOTE: Start with roughly one node per two tokens and grow from there
+		isize block_size = gb_size_of(AstNode) * (f->tokens.count/2 + 1);
+		block_size = gb_clamp(block_size, gb_kilobytes(64), gb_megabytes(4));
+		init_dynamic_arena(&f->arena, block_size);
 		array_init(&f->comments, heap_allocator());
 
 		f->curr_proc = NULL;
@@ -4508,7 +4507,7 @@ ParseFileError init_ast_file(AstFile *f, String fullpath) {
 }
 
 void destroy_ast_file(AstFile *f) {
-	gb_arena_free(&f->arena);
+	destroy_dynamic_arena(&f->arena);
 	array_free(&f->tokens);
 	gb_free(heap_allocator(), f->tokenizer.fullpath.text);
 	destroy_tokenizer(&f->tokenizer);
@@ -4678,6 +4677,9 @@ void parse_setup_file_decls(Parser *p, AstFile *f, String base_dir, Array<AstNod
 }
 
 void parse_file(Parser *p, AstFile *f) {
+	isize trace = trace_begin(str_lit("parse_file"), f->tokenizer.fullpath);
+	defer (trace_end(trace));
+
 	String filepath = f->tokenizer.fullpath;
 	String base_dir = filepath;
 	for (isize i = filepath.len-1; i >= 0; i--) {
@@ -4727,6 +4729,9 @@ ParseFileError parse_files(Parser *p, String init_filename) {
 		TokenPos pos = imported_file.pos;
 		AstFile file = {};
 
+		timings_begin_sub_section(&global_timings, filename_from_path(import_path));
+		defer (timings_end_sub_section(&global_timings));
+
 		ParseFileError err = init_ast_file(&file, import_path);
 
 		if (err != ParseFile_None) {
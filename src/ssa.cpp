@@ -10,9 +10,11 @@ struct ssaTargetList;
 
 
 String ssa_mangle_name(ssaModule *m, String path, Entity *e);
+ssaValue *ssa_emit_conv(ssaProc *p, ssaValue *v, Type *t);
 
 
 #include "ssa_op.cpp"
+#include "ssa_elf.cpp"
 
 #define SSA_DEFAULT_VALUE_ARG_CAPACITY 8
 struct ssaValueArgs {
@@ -41,6 +43,7 @@ struct ssaValue {
 	i32           uses;
 	ssaValueArgs  args;
 	ExactValue    exact_value; // Used for constants
+	Entity *      entity;      // Used by Proc
 
 	String        comment_string;
 };
@@ -145,6 +148,12 @@ struct ssaProc {
 
 	Array<ssaDefer>   defer_stmts;
 	i32               scope_level;
+
+	AstNode *         curr_node;  // Statement or expression being built, for error positions
+
+	// NOTE: The first construct the builder cannot handle yet, which is reported as an error
+	String            unsupported;
+	AstNode *         unsupported_node;
 };
 
 struct ssaRegister {
@@ -159,19 +168,32 @@ struct ssaModule {
 	gbAllocator        tmp_allocator;
 	gbArena            tmp_arena;
 
-	Map<Entity *>      min_dep_map; // Key: Entity *
-	Map<ssaValue *>    values;      // Key: Entity *
+	Map<Entity *>      min_dep_map;  // Key: Entity *
+	Map<ssaValue *>    values;       // Key: Entity *
+	Map<String>        entity_names; // Key: Entity *, Value: symbol name
 	// List of registers for the specific architecture
 	Array<ssaRegister> registers;
 
 	ssaProc *proc; // current procedure
 
 	Entity *entry_point_entity;
+	Entity *startup_runtime; // Called at the start of the entry point, NULL when there is none
 
 	u32 stmt_state_flags;
 
 	Array<ssaProc *>  procs;
-	Array<ssaValue *>     procs_to_generate;
+	Array<ssaProc *>  procs_to_generate; // Nested procedures, named once their parent is built
+
+	// NOTE: Only what the generated code refers to is built, see `ssa_request_references`
+	Map<ssaProc *>    unbuilt_procs;   // Key: Entity *
+	Array<ssaProc *>  proc_queue;
+	Map<bool>         defined_globals; // Key: Entity *
+	Array<ssaProc *>  init_procs;      // Called from `__$startup_runtime`
+
+	ssaObject object;
+	String    output_base;
+
+	Array<String> *foreign_library_paths; // Only the ones that are referred to, linked with the object
 };
 
 enum ssaAddrKind {
@@ -247,7 +269,7 @@ void ssa_add_edge_to(ssaBlock *b, ssaBlock *c) {
 	}
 	GB_ASSERT(c != NULL);
 	isize i = b->succs.count;
-	isize j = b->preds.count;
+	isize j = c->preds.count;
 	ssaEdge s = {c, j};
 	ssaEdge p = {b, i};
 	array_add(&b->succs, s);
@@ -399,6 +421,8 @@ ssaValue *ssa_build_expr     (ssaProc *p, AstNode *expr);
 void      ssa_build_stmt     (ssaProc *p, AstNode *node);
 void      ssa_build_stmt_list(ssaProc *p, Array<AstNode *> nodes);
 ssaValue *ssa_emit_deep_field_ptr_index(ssaProc *p, ssaValue *e, Selection sel);
+ssaAddr   ssa_build_compound_lit(ssaProc *p, AstNode *expr, Type *type);
+ssaAddr   ssa_build_packed_array(ssaProc *p, Type *type, PackedArray *packed);
 
 
 
@@ -451,7 +475,6 @@ void ssa_emit_defer_stmts(ssaProc *p, ssaDeferExitKind kind, ssaBlock *b) {
 	for (isize i = count-1; i >= 0; i--) {
 		ssaDefer d = p->defer_stmts[i];
 		if (kind == ssaDeferExit_Default) {
-			gb_printf_err("scope_level %d %d\n", p->scope_level, d.scope_level);
 			if (p->scope_level == d.scope_level &&
 			    d.scope_level > 1) {
 				ssa_build_defer_stmt(p, d);
@@ -505,7 +528,7 @@ ssaValue *ssa_emit_store(ssaProc *p, ssaValue *dst, ssaValue *v) {
 	// NOTE(bill): Sanity check
 	Type *a = core_type(type_deref(dst->type));
 	Type *b = core_type(v->type);
-	if (!is_type_untyped(b)) {
+	if (!is_type_untyped(b) && p->unsupported.len == 0) {
 		GB_ASSERT_MSG(are_types_identical(a, b), "%s %s", type_to_string(a), type_to_string(b));
 	}
 #endif
@@ -582,6 +605,30 @@ ssaProc *ssa_new_proc(ssaModule *m, String name, Entity *entity, DeclInfo *decl_
 	return p;
 }
 
+// NOTE: Records that `p` uses a construct which cannot be built yet and returns a placeholder of
+// type `t`, so that the builder can unwind normally. `ssa_generate` then reports it as an error
+ssaValue *ssa_unsupported(ssaProc *p, AstNode *node, char *what, Type *t) {
+	if (p->unsupported.len == 0) {
+		p->unsupported      = make_string_c(what);
+		p->unsupported_node = node != NULL ? node : p->curr_node;
+	}
+	if (p->curr_block == NULL) {
+		ssaBlock *dead_block = ssa_new_block(p, ssaBlock_Plain, "");
+		ssa_start_block(p, dead_block);
+	}
+	return ssa_new_value0(p, ssaOp_Unknown, t);
+}
+
+ssaAddr ssa_unsupported_addr(ssaProc *p, AstNode *node, char *what, Type *elem) {
+	Type *t = t_rawptr;
+	if (elem != NULL) {
+		t = make_type_pointer(p->allocator, elem);
+	}
+	ssaAddr addr = {0};
+	addr.addr = ssa_unsupported(p, node, what, t);
+	return addr;
+}
+
 ssaAddr ssa_add_local(ssaProc *p, Entity *e, AstNode *expr) {
 	Type *t = make_type_pointer(p->allocator, e->type);
 
@@ -675,6 +722,7 @@ void ssa_addr_store(ssaProc *p, ssaAddr addr, ssaValue *value) {
 		return;
 	}
 
+	value = ssa_emit_conv(p, value, ssa_addr_type(addr));
 	ssa_emit_store(p, addr.addr, value);
 }
 
@@ -725,28 +773,134 @@ ssaAddr ssa_build_addr_from_entity(ssaProc *p, Entity *e, AstNode *expr) {
 	} else if (e->kind == Entity_Variable && e->flags & EntityFlag_Using) {
 		// NOTE(bill): Calculate the using variable every time
 		v = ssa_get_using_variable(p, e);
+	} else if (e->kind == Entity_Variable && e->scope != NULL && e->scope->is_file) {
+		v = ssa_new_value0(p, ssaOp_Global, make_type_pointer(p->allocator, e->type));
+		v->entity = e;
+		v->comment_string = e->token.string;
 	}
 
 	if (v == NULL) {
-		GB_PANIC("Unknown value: %.*s, entity: %p %.*s\n", LIT(e->token.string), e, LIT(entity_strings[e->kind]));
+		return ssa_unsupported_addr(p, expr, "implicit value", e->type);
 	}
 
 	return ssa_addr(v);
 }
 
 
+ssaOp ssa_int_conv_op(i64 src_size, i64 dst_size, bool is_signed) {
+	if (src_size > dst_size) {
+		switch (src_size*10 + dst_size) {
+		case 21: return ssaOp_Trunc16to8;
+		case 41: return ssaOp_Trunc32to8;
+		case 42: return ssaOp_Trunc32to16;
+		case 81: return ssaOp_Trunc64to8;
+		case 82: return ssaOp_Trunc64to16;
+		case 84: return ssaOp_Trunc64to32;
+		}
+	} else if (is_signed) {
+		switch (src_size*10 + dst_size) {
+		case 12: return ssaOp_SignExt8to16;
+		case 14: return ssaOp_SignExt8to32;
+		case 18: return ssaOp_SignExt8to64;
+		case 24: return ssaOp_SignExt16to32;
+		case 28: return ssaOp_SignExt16to64;
+		case 48: return ssaOp_SignExt32to64;
+		}
+	} else {
+		switch (src_size*10 + dst_size) {
+		case 12: return ssaOp_ZeroExt8to16;
+		case 14: return ssaOp_ZeroExt8to32;
+		case 18: return ssaOp_ZeroExt8to64;
+		case 24: return ssaOp_ZeroExt16to32;
+		case 28: return ssaOp_ZeroExt16to64;
+		case 48: return ssaOp_ZeroExt32to64;
+		}
+	}
+	return ssaOp_Invalid;
+}
+
+// NOTE: Integers must be 32 or 64 bits wide, smaller integers are extended first
+ssaOp ssa_float_conv_op(i64 int_size, bool is_unsigned, i64 float_size, bool to_float) {
+	i64 key = int_size*10 + float_size;
+	if (to_float) {
+		switch (key) {
+		case 44: return is_unsigned ? ssaOp_Cvt32Uto32F : ssaOp_Cvt32to32F;
+		case 48: return is_unsigned ? ssaOp_Cvt32Uto64F : ssaOp_Cvt32to64F;
+		case 84: return is_unsigned ? ssaOp_Cvt64Uto32F : ssaOp_Cvt64to32F;
+		case 88: return is_unsigned ? ssaOp_Cvt64Uto64F : ssaOp_Cvt64to64F;
+		}
+	} else {
+		switch (key) {
+		case 44: return is_unsigned ? ssaOp_Cvt32Fto32U : ssaOp_Cvt32Fto32;
+		case 48: return is_unsigned ? ssaOp_Cvt64Fto32U : ssaOp_Cvt64Fto32;
+		case 84: return is_unsigned ? ssaOp_Cvt32Fto64U : ssaOp_Cvt32Fto64;
+		case 88: return is_unsigned ? ssaOp_Cvt64Fto64U : ssaOp_Cvt64Fto64;
+		}
+	}
+	return ssaOp_Invalid;
+}
+
 ssaValue *ssa_emit_conv(ssaProc *p, ssaValue *v, Type *t) {
 	Type *src_type = v->type;
 	if (are_types_identical(t, src_type)) {
 		return v;
 	}
 
-	Type *src = core_type(src_type);
+	Type *src = core_type(default_type(src_type)); // NOTE: Untyped constants are converted from their default type
 	Type *dst = core_type(t);
 
 	if (is_type_untyped_nil(src)) {
 		return ssa_const_nil(p, t);
 	}
+	if (v->op == ssaOp_ConstString && is_type_string(dst)) {
+		return ssa_const_string(p, t, v->exact_value.value_string);
+	}
+
+	// Integer <-> Integer
+	if (is_type_integer(src) && is_type_integer(dst)) {
+		i64 sz = type_size_of(p->allocator, src);
+		i64 dz = type_size_of(p->allocator, dst);
+		if (sz == dz) {
+			return ssa_new_value1(p, ssaOp_Copy, t, v);
+		}
+		ssaOp op = ssa_int_conv_op(sz, dz, !is_type_unsigned(src));
+		if (op != ssaOp_Invalid) {
+			return ssa_new_value1(p, op, t, v);
+		}
+	}
+	// Float <-> Float
+	if (is_type_float(src) && is_type_float(dst)) {
+		i64 sz = type_size_of(p->allocator, src);
+		i64 dz = type_size_of(p->allocator, dst);
+		if (sz == dz) {
+			return ssa_new_value1(p, ssaOp_Copy, t, v);
+		}
+		return ssa_new_value1(p, sz == 4 ? ssaOp_Cvt32Fto64F : ssaOp_Cvt64Fto32F, t, v);
+	}
+	// Integer -> Float
+	if (is_type_integer(src) && is_type_float(dst)) {
+		i64 sz = type_size_of(p->allocator, src);
+		if (sz < 4) {
+			v = ssa_emit_conv(p, v, is_type_unsigned(src) ? t_u32 : t_i32);
+			sz = 4;
+		}
+		ssaOp op = ssa_float_conv_op(sz, is_type_unsigned(src), type_size_of(p->allocator, dst), true);
+		if (op != ssaOp_Invalid) {
+			return ssa_new_value1(p, op, t, v);
+		}
+	}
+	// Float -> Integer
+	if (is_type_float(src) && is_type_integer(dst)) {
+		i64 dz = type_size_of(p->allocator, dst);
+		if (dz < 4) {
+			ssaValue *i = ssa_emit_conv(p, v, is_type_unsigned(dst) ? t_u32 : t_i32);
+			return ssa_emit_conv(p, i, t);
+		}
+		ssaOp op = ssa_float_conv_op(dz, is_type_unsigned(dst), type_size_of(p->allocator, src), false);
+		if (op != ssaOp_Invalid) {
+			return ssa_new_value1(p, op, t, v);
+		}
+	}
 
 	// Pointer <-> Pointer
 	if (is_type_pointer(src) && is_type_pointer(dst)) {
@@ -764,16 +918,16 @@ ssaValue *ssa_emit_conv(ssaProc *p, ssaValue *v, Type *t) {
 	if (is_type_proc(src) && is_type_pointer(dst)) {
 		return ssa_new_value1(p, ssaOp_Copy, dst, v);
 	}
+	// Integer <-> Pointer
+	if (is_type_integer(src) && is_type_pointer(dst)) {
+		return ssa_new_value1(p, ssaOp_Copy, t, v);
+	}
+	if (is_type_pointer(src) && is_type_integer(dst)) {
+		return ssa_new_value1(p, ssaOp_Copy, t, v);
+	}
 
-
-	gb_printf_err("ssa_emit_conv: src -> dst\n");
-	gb_printf_err("Not Identical %s != %s\n", type_to_string(src_type), type_to_string(t));
-	gb_printf_err("Not Identical %s != %s\n", type_to_string(src), type_to_string(dst));
-
-
-	GB_PANIC("Invalid type conversion: `%s` to `%s`", type_to_string(src_type), type_to_string(t));
-
-	return NULL;
+	// TODO: `any`, unions, slices from arrays, etc.
+	return ssa_unsupported(p, NULL, "type conversion", t);
 }
 
 
@@ -803,6 +957,20 @@ ssaValue *ssa_emit_array_index(ssaProc *p, ssaValue *v, ssaValue *index) {
 	return ssa_new_value2(p, ssaOp_ArrayIndex, elem_ptr, v, index);
 }
 
+void ssa_emit_bounds_check(ssaProc *p, ssaValue *index, i64 count) {
+	if ((p->module->stmt_state_flags & StmtStateFlag_no_bounds_check) != 0) {
+		return;
+	}
+	if (ssa_is_op_const(index->op)) {
+		i64 i = big_int_to_i64(index->exact_value.value_integer);
+		if (0 <= i && i < count) {
+			return;
+		}
+	}
+	ssaValue *len = ssa_const_int(p, t_int, count);
+	ssa_new_value2(p, ssaOp_BoundsCheck, t_int, index, len);
+}
+
 ssaValue *ssa_emit_ptr_index(ssaProc *p, ssaValue *s, i64 index) {
 	gbAllocator a = p->allocator;
 	Type *t = base_type(type_deref(s->type));
@@ -850,11 +1018,11 @@ ssaValue *ssa_emit_ptr_index(ssaProc *p, ssaValue *s, i64 index) {
 		case 0: result_type = make_type_pointer(a, gst->Record.fields[0]->type); break;
 		case 1: result_type = make_type_pointer(a, gst->Record.fields[1]->type); break;
 		}
-	}else {
-		GB_PANIC("TODO(bill): ssa_emit_ptr_index type: %s, %d", type_to_string(s->type), index);
 	}
 
-	GB_ASSERT(result_type != NULL);
+	if (result_type == NULL) {
+		return ssa_unsupported(p, NULL, "field pointer", t_rawptr);
+	}
 
 	return ssa_new_value1i(p, ssaOp_PtrIndex, result_type, index, s);
 }
@@ -865,7 +1033,9 @@ ssaValue *ssa_emit_value_index(ssaProc *p, ssaValue *s, i64 index) {
 			return ssa_emit_load(p, e);
 		}
 	}
-	GB_ASSERT(can_ssa_type(s->type));
+	if (!can_ssa_type(s->type)) {
+		return ssa_emit_load(p, ssa_emit_ptr_index(p, ssa_address_from_load_or_generate_local(p, s), index));
+	}
 
 	gbAllocator a = p->allocator;
 	Type *t = base_type(s->type);
@@ -913,11 +1083,11 @@ ssaValue *ssa_emit_value_index(ssaProc *p, ssaValue *s, i64 index) {
 		case 0: result_type = gst->Record.fields[0]->type; break;
 		case 1: result_type = gst->Record.fields[1]->type; break;
 		}
-	} else {
-		GB_PANIC("TODO(bill): struct_ev type: %s, %d", type_to_string(s->type), index);
 	}
 
-	GB_ASSERT(result_type != NULL);
+	if (result_type == NULL) {
+		return ssa_unsupported(p, NULL, "field value", t_int);
+	}
 
 	return ssa_new_value1i(p, ssaOp_ValueIndex, result_type, index, s);
 }
@@ -961,8 +1131,7 @@ ssaValue *ssa_emit_deep_field_ptr_index(ssaProc *p, ssaValue *e, Selection sel)
 				break;
 
 			default:
-				GB_PANIC("un-gep-able type");
-				break;
+				return ssa_unsupported(p, NULL, "field pointer", t_rawptr);
 			}
 		} else if (type->kind == Type_Slice) {
 			e = ssa_emit_ptr_index(p, e, index);
@@ -980,7 +1149,7 @@ ssaValue *ssa_emit_deep_field_ptr_index(ssaProc *p, ssaValue *e, Selection sel)
 			case 2: e = ssa_emit_ptr_index(p, e, 3); break; // allocator
 			}
 		} else {
-			GB_PANIC("un-gep-able type");
+			return ssa_unsupported(p, NULL, "field pointer", t_rawptr);
 		}
 	}
 
@@ -996,7 +1165,10 @@ ssaValue *ssa_emit_deep_field_value_index(ssaProc *p, ssaValue *e, Selection sel
 			return ssa_emit_load(p, ptr);
 		}
 	}
-	GB_ASSERT(can_ssa_type(e->type));
+	if (!can_ssa_type(e->type)) {
+		ssaValue *ptr = ssa_emit_deep_field_ptr_index(p, ssa_address_from_load_or_generate_local(p, e), sel);
+		return ssa_emit_load(p, ptr);
+	}
 
 	for_array(i, sel.index) {
 		i32 index = cast(i32)sel.index[i];
@@ -1007,9 +1179,7 @@ ssaValue *ssa_emit_deep_field_value_index(ssaProc *p, ssaValue *e, Selection sel
 
 
 		if (is_type_raw_union(type)) {
-			GB_PANIC("TODO(bill): IS THIS EVEN CORRECT?");
-			type = type->Record.fields[index]->type;
-			e = ssa_emit_conv(p, e, type);
+			return ssa_unsupported(p, NULL, "raw union field", type->Record.fields[index]->type);
 		} else if (type->kind == Type_Map) {
 			e = ssa_emit_value_index(p, e, 1);
 			switch (index) {
@@ -1029,7 +1199,176 @@ ssaValue *ssa_emit_deep_field_value_index(ssaProc *p, ssaValue *e, Selection sel
 
 
 
+ssaValue *ssa_const_value(ssaProc *p, AstNode *expr, Type *type, ExactValue value) {
+	Type *t = core_type(default_type(type));
+	if (value.kind == ExactValue_Compound) {
+		return ssa_addr_load(p, ssa_build_compound_lit(p, value.value_compound, type));
+	} else if (value.kind == ExactValue_Packed) {
+		return ssa_addr_load(p, ssa_build_packed_array(p, type, value.value_packed));
+	}
+
+	if (is_type_boolean(t)) {
+		return ssa_const_bool(p, type, value.value_bool);
+	} else if (is_type_string(t)) {
+		GB_ASSERT(value.kind == ExactValue_String);
+		return ssa_const_string(p, type, value.value_string);
+	} else if(is_type_slice(t)) {
+		return ssa_const_slice(p, type, value);
+	} else if (is_type_integer(t)) {
+		GB_ASSERT(value.kind == ExactValue_Integer);
+
+		i64 s = 8*type_size_of(p->allocator, t);
+		switch (s) {
+		case 8:  return ssa_const_i8 (p, type, big_int_to_i64(value.value_integer));
+		case 16: return ssa_const_i16(p, type, big_int_to_i64(value.value_integer));
+		case 32: return ssa_const_i32(p, type, big_int_to_i64(value.value_integer));
+		case 64: return ssa_const_i64(p, type, big_int_to_i64(value.value_integer));
+		default: return ssa_unsupported(p, expr, "128-bit constant", type);
+		}
+	} else if (is_type_float(t)) {
+		GB_ASSERT(value.kind == ExactValue_Float);
+		i64 s = 8*type_size_of(p->allocator, t);
+		switch (s) {
+		case 32: return ssa_const_f32(p, type, value.value_float);
+		case 64: return ssa_const_f64(p, type, value.value_float);
+		default: GB_PANIC("Unknown float size");
+		}
+	}
+	return ssa_const_nil(p, type);
+}
+
+// NOTE: Slice literals point into a backing array in .bss, as the IR backend's do, so that the
+// slice stays valid after the procedure returns
+ssaValue *ssa_add_global_generated(ssaProc *p, Type *t, char *kind) {
+	ssaModule *m = p->module;
+	isize name_len = p->name.len + 1 + gb_strlen(kind) + 1 + 10 + 1;
+	u8 *name_text = gb_alloc_array(m->allocator, u8, name_len);
+	name_len = gb_snprintf(cast(char *)name_text, name_len, "%.*s.%s-%d", LIT(p->name), kind, p->value_id);
+	String name = make_string(name_text, name_len-1);
+
+	Token token = {Token_Ident};
+	token.string = name;
+	Entity *e = make_entity_variable(m->allocator, NULL, token, t, false);
+	map_set(&m->entity_names, hash_pointer(e), name);
+
+	gbAllocator a = heap_allocator();
+	i64 size = type_size_of(a, t);
+	i64 offset = ssa_object_reserve_bss(&m->object, size, type_align_of(a, t));
+	ssa_object_define_symbol(&m->object, name, ssaObjectSection_Bss, offset, size, false, false);
+
+	ssaValue *v = ssa_new_value0(p, ssaOp_Global, make_type_pointer(p->allocator, t));
+	v->entity = e;
+	v->comment_string = name;
+	return v;
+}
+
+// NOTE: Builds `cl` into a new local of `type`, or `type` itself for a slice, which starts zeroed
+// and has each element stored into it. `type` is passed as constants made by `#run` have none
+ssaAddr ssa_build_compound_lit(ssaProc *p, AstNode *expr, Type *type) {
+	ast_node(cl, CompoundLit, expr);
+	gbAllocator a = p->allocator;
+	Type *bt = base_type(type);
+	ssaAddr v = ssa_add_local_generated(p, type);
+
+	switch (bt->kind) {
+	case Type_Record: {
+		if (!is_type_struct(bt) && !is_type_union(bt)) {
+			return ssa_unsupported_addr(p, expr, "raw union literal", type);
+		}
+		TypeRecord *st = &bt->Record;
+		for_array(field_index, cl->elems) {
+			AstNode *elem = cl->elems[field_index];
+			isize index = field_index;
+			if (elem->kind == AstNode_FieldValue) {
+				ast_node(fv, FieldValue, elem);
+				Selection sel = lookup_field(a, bt, fv->field->Ident.string, false);
+				index = sel.index[0];
+				elem = fv->value;
+			} else {
+				Selection sel = lookup_field_from_index(a, bt, st->fields_in_src_order[field_index]->Variable.field_src_index);
+				index = sel.index[0];
+			}
+			Type *ft = st->fields[index]->type;
+			ssaValue *fv = ssa_emit_conv(p, ssa_build_expr(p, elem), ft);
+			ssa_emit_store(p, ssa_emit_ptr_index(p, v.addr, index), fv);
+		}
+	} break;
+
+	case Type_Array:
+	case Type_Vector: {
+		Type *et = bt->kind == Type_Array ? bt->Array.elem : bt->Vector.elem;
+		if (bt->kind == Type_Vector && cl->elems.count == 1 && bt->Vector.count > 1) {
+			// NOTE: Broadcast
+			ssaValue *ev = ssa_emit_conv(p, ssa_build_expr(p, cl->elems[0]), et);
+			for (i64 i = 0; i < bt->Vector.count; i++) {
+				ssa_emit_store(p, ssa_emit_array_index(p, v.addr, ssa_const_int(p, t_int, i)), ev);
+			}
+			break;
+		}
+		for_array(i, cl->elems) {
+			ssaValue *ev = ssa_emit_conv(p, ssa_build_expr(p, cl->elems[i]), et);
+			ssa_emit_store(p, ssa_emit_array_index(p, v.addr, ssa_const_int(p, t_int, i)), ev);
+		}
+	} break;
+
+	case Type_Slice: {
+		if (cl->elems.count == 0) {
+			break;
+		}
+		Type *et = bt->Slice.elem;
+		ssaValue *backing = ssa_add_global_generated(p, make_type_array(a, et, cl->elems.count), "$slice");
+		for_array(i, cl->elems) {
+			ssaValue *ev = ssa_emit_conv(p, ssa_build_expr(p, cl->elems[i]), et);
+			ssa_emit_store(p, ssa_emit_array_index(p, backing, ssa_const_int(p, t_int, i)), ev);
+		}
+		ssaValue *data = ssa_emit_array_index(p, backing, ssa_const_int(p, t_int, 0));
+		ssaValue *count = ssa_const_int(p, t_int, cl->elems.count);
+		ssa_emit_store(p, ssa_emit_ptr_index(p, v.addr, 0), data);
+		ssa_emit_store(p, ssa_emit_ptr_index(p, v.addr, 1), count);
+		ssa_emit_store(p, ssa_emit_ptr_index(p, v.addr, 2), count);
+	} break;
+
+	case Type_DynamicArray:
+		if (cl->elems.count > 0) {
+			return ssa_unsupported_addr(p, expr, "dynamic array literal", type);
+		}
+		break;
+
+	case Type_Map:
+		if (cl->elems.count > 0) {
+			return ssa_unsupported_addr(p, expr, "map literal", type);
+		}
+		break;
+
+	default:
+		if (cl->elems.count > 0) {
+			return ssa_unsupported_addr(p, expr, "compound literal", type);
+		}
+		break;
+	}
+
+	return v;
+}
+
+// NOTE: Constant arrays of scalars no longer have their elements as expressions
+ssaAddr ssa_build_packed_array(ssaProc *p, Type *type, PackedArray *packed) {
+	ssaAddr v = ssa_add_local_generated(p, type);
+	for (i64 i = 0; i < packed->count; i++) {
+		ExactValue value = packed_array_get(packed, i);
+		if (value.kind == ExactValue_Integer && big_int_is_zero(value.value_integer)) {
+			continue;
+		}
+		ssaValue *ev = ssa_const_value(p, NULL, packed->elem_type, value);
+		ssa_emit_store(p, ssa_emit_array_index(p, v.addr, ssa_const_int(p, t_int, i)), ev);
+	}
+	return v;
+}
+
 ssaAddr ssa_build_addr(ssaProc *p, AstNode *expr) {
+	if (p->unsupported.len > 0) {
+		return ssa_unsupported_addr(p, expr, "", type_of_expr(p->module->info, expr));
+	}
+
 	switch (expr->kind) {
 	case_ast_node(i, Ident, expr);
 		if (ssa_is_blank_ident(expr)) {
@@ -1063,7 +1402,7 @@ ssaAddr ssa_build_addr(ssaProc *p, AstNode *expr) {
 
 			Type *type = base_type(tav.type);
 			if (tav.mode == Addressing_Type) { // Addressing_Type
-				GB_PANIC("TODO: SelectorExpr Addressing_Type");
+				return ssa_unsupported_addr(p, expr, "type field", type_of_expr(p->module->info, expr));
 				// Selection sel = lookup_field(p->allocator, type, selector, true);
 				// Entity *e = sel.entity;
 				// GB_ASSERT(e->kind == Entity_Variable);
@@ -1098,7 +1437,7 @@ ssaAddr ssa_build_addr(ssaProc *p, AstNode *expr) {
 			Type *type = base_type(type_of_expr(p->module->info, se->expr));
 			GB_ASSERT(is_type_integer(type));
 			ExactValue val = type_and_value_of_expr(p->module->info, sel).value;
-			i64 index = i128_to_i64(val.value_integer);
+			i64 index = big_int_to_i64(val.value_integer);
 
 			Selection sel = lookup_field_from_index(p->allocator, type, index);
 			GB_ASSERT(sel.entity != NULL);
@@ -1111,7 +1450,7 @@ ssaAddr ssa_build_addr(ssaProc *p, AstNode *expr) {
 
 	case_ast_node(ue, UnaryExpr, expr);
 		switch (ue->op.kind) {
-		case Token_Pointer: {
+		case Token_And: {
 			return ssa_build_addr(p, ue->expr);
 		}
 		default:
@@ -1124,11 +1463,52 @@ ssaAddr ssa_build_addr(ssaProc *p, AstNode *expr) {
 	case_end;
 
 	case_ast_node(ie, IndexExpr, expr);
-		GB_PANIC("TODO(bill): ssa_build_addr IndexExpr");
+		Type *t = base_type(type_of_expr(p->module->info, ie->expr));
+		bool deref = is_type_pointer(t);
+		t = base_type(type_deref(t));
+
+		if (is_type_array(t)) {
+			ssaValue *array = NULL;
+			if (deref) {
+				array = ssa_build_expr(p, ie->expr);
+			} else {
+				array = ssa_build_addr(p, ie->expr).addr;
+			}
+			ssaValue *index = ssa_emit_conv(p, ssa_build_expr(p, ie->index), t_int);
+			ssa_emit_bounds_check(p, index, t->Array.count);
+			return ssa_addr(ssa_emit_array_index(p, array, index));
+		}
+
+		Type *elem = NULL;
+		if (is_type_slice(t)) {
+			elem = t->Slice.elem;
+		} else if (is_type_dynamic_array(t)) {
+			elem = t->DynamicArray.elem;
+		} else if (is_type_string(t)) {
+			elem = t_u8;
+		} else {
+			return ssa_unsupported_addr(p, expr, "index expression", type_of_expr(p->module->info, expr));
+		}
+
+		// NOTE: Slices, dynamic arrays and strings all start with the data pointer and the length
+		ssaValue *s = NULL;
+		if (deref) {
+			s = ssa_build_expr(p, ie->expr);
+		} else {
+			s = ssa_build_addr(p, ie->expr).addr;
+		}
+		ssaValue *data = ssa_emit_load(p, ssa_emit_ptr_index(p, s, 0));
+		Type *elem_ptr = make_type_pointer(p->allocator, elem);
+		ssaValue *len = ssa_emit_load(p, ssa_emit_ptr_index(p, s, 1));
+		ssaValue *index = ssa_emit_conv(p, ssa_build_expr(p, ie->index), t_int);
+		if ((p->module->stmt_state_flags & StmtStateFlag_no_bounds_check) == 0) {
+			ssa_new_value2(p, ssaOp_BoundsCheck, t_int, index, len);
+		}
+		return ssa_addr(ssa_new_value2(p, ssaOp_PtrOffset, elem_ptr, data, index));
 	case_end;
 
 	case_ast_node(se, SliceExpr, expr);
-		GB_PANIC("TODO(bill): ssa_build_addr SliceExpr");
+		return ssa_unsupported_addr(p, expr, "slice expression", type_of_expr(p->module->info, expr));
 	case_end;
 
 	case_ast_node(de, DerefExpr, expr);
@@ -1143,20 +1523,12 @@ ssaAddr ssa_build_addr(ssaProc *p, AstNode *expr) {
 	case_end;
 
 	case_ast_node(cl, CompoundLit, expr);
-		GB_PANIC("TODO(bill): ssa_build_addr CompoundLit");
+		return ssa_build_compound_lit(p, expr, type_of_expr(p->module->info, expr));
 	case_end;
 
 	}
 
-	TokenPos token_pos = ast_node_token(expr).pos;
-	GB_PANIC("Unexpected address expression\n"
-	         "\tAstNode: %.*s @ "
-	         "%.*s(%td:%td)\n",
-	         LIT(ast_node_strings[expr->kind]),
-	         LIT(token_pos.file), token_pos.line, token_pos.column);
-
-
-	return ssa_addr(NULL);
+	return ssa_unsupported_addr(p, expr, "address expression", type_of_expr(p->module->info, expr));
 }
 
 
@@ -1175,6 +1547,8 @@ Type *ssa_proper_type(Type *t) {
 				return t_u64;
 			}
 			return t_u32;
+		case Basic_rune:
+			return t_i32;
 		}
 	}
 
@@ -1191,6 +1565,8 @@ ssaOp ssa_determine_op(TokenKind op, Type *t) {
 			case Token_Or:     return ssaOp_Or8;
 			case Token_Xor:    return ssaOp_Xor8;
 			case Token_AndNot: return ssaOp_AndNot8;
+			case Token_CmpEq:  return ssaOp_EqB;
+			case Token_NotEq:  return ssaOp_NeB;
 			}
 			break;
 		case Basic_i8:
@@ -1376,11 +1752,46 @@ ssaOp ssa_determine_op(TokenKind op, Type *t) {
 		}
 	}
 
-	GB_PANIC("Invalid Op for type");
+	if (is_type_pointer(t) || is_type_rawptr(t) || is_type_proc(t)) {
+		switch (op) {
+		case Token_Lt:     return ssaOp_LtPtr;
+		case Token_LtEq:   return ssaOp_LePtr;
+		case Token_Gt:     return ssaOp_GtPtr;
+		case Token_GtEq:   return ssaOp_GePtr;
+		case Token_CmpEq:  return ssaOp_EqPtr;
+		case Token_NotEq:  return ssaOp_NePtr;
+		}
+	}
+
+	// NOTE: The caller reports the operation as unsupported
 	return ssaOp_Invalid;
 }
 
 
+isize ssa_shift_size_index(Type *t) {
+	switch (type_size_of(heap_allocator(), ssa_proper_type(t))) {
+	case 1: return 0;
+	case 2: return 1;
+	case 4: return 2;
+	case 8: return 3;
+	}
+	return -1; // NOTE: 128-bit shifts have no operation yet
+}
+
+// NOTE: Shift operations are ordered by the size of `x` and then the size of the shift amount
+ssaOp ssa_determine_shift_op(TokenKind op, Type *x, Type *y) {
+	isize x_index = ssa_shift_size_index(x);
+	isize y_index = ssa_shift_size_index(y);
+	if (x_index < 0 || y_index < 0) {
+		return ssaOp_Invalid;
+	}
+	ssaOp base = ssaOp_Lsh8x8;
+	if (op == Token_Shr) {
+		base = is_type_unsigned(ssa_proper_type(x)) ? ssaOp_Rsh8Ux8 : ssaOp_Rsh8x8;
+	}
+	return cast(ssaOp)(base + 4*x_index + y_index);
+}
+
 ssaValue *ssa_emit_comp(ssaProc *p, TokenKind op, ssaValue *x, ssaValue *y) {
 	GB_ASSERT(x != NULL && y != NULL);
 	Type *a = core_type(x->type);
@@ -1420,7 +1831,11 @@ ssaValue *ssa_emit_comp(ssaProc *p, TokenKind op, ssaValue *x, ssaValue *y) {
 		return ssa_addr_load(p, addr);
 	}
 
-	return ssa_new_value2(p, ssa_determine_op(op, x->type), x->type, x, y);
+	ssaOp comp_op = ssa_determine_op(op, x->type);
+	if (comp_op == ssaOp_Invalid) {
+		return ssa_unsupported(p, NULL, "comparison", result);
+	}
+	return ssa_new_value2(p, comp_op, result, x, y);
 }
 
 
@@ -1448,8 +1863,8 @@ ssaValue *ssa_emit_unary_arith(ssaProc *p, TokenKind op, ssaValue *x, Type *type
 
 
 	switch (op) {
-	case Token_Pointer: {
-		GB_PANIC("Token_Pointer should be handled elsewhere");
+	case Token_And: {
+		GB_PANIC("Token_And should be handled elsewhere");
 	} break;
 
 	case Token_Add:
@@ -1465,7 +1880,7 @@ ssaValue *ssa_emit_unary_arith(ssaProc *p, TokenKind op, ssaValue *x, Type *type
 		case 32: return ssa_new_value1(p, ssaOp_Not32, type, x);
 		case 64: return ssa_new_value1(p, ssaOp_Not64, type, x);
 		}
-		GB_PANIC("unknown integer size");
+		return ssa_unsupported(p, NULL, "bitwise not", type);
 	} break;
 
 	case Token_Sub: { // 0-x
@@ -1483,38 +1898,35 @@ ssaValue *ssa_emit_unary_arith(ssaProc *p, TokenKind op, ssaValue *x, Type *type
 			case 64: return ssa_new_value1(p, ssaOp_Neg64F, type, x);
 			}
 		}
-		GB_PANIC("unknown type for -x");
+		return ssa_unsupported(p, NULL, "negation", type);
 	} break;
 	}
 	return NULL;
 }
 ssaValue *ssa_emit_arith(ssaProc *p, TokenKind op, ssaValue *x, ssaValue *y, Type *type) {
 	if (is_type_vector(x->type)) {
-		GB_PANIC("TODO(bill): ssa_emit_arith vector");
+		return ssa_unsupported(p, NULL, "vector arithmetic", type);
 	} else if (is_type_complex(x->type)) {
-		GB_PANIC("TODO(bill): ssa_emit_arith complex");
+		return ssa_unsupported(p, NULL, "complex arithmetic", type);
 	}
 
 	if (op == Token_Add) {
 		if (is_type_pointer(x->type)) {
-			GB_PANIC("TODO(bill): Ptr arith");
 			ssaValue *ptr = ssa_emit_conv(p, x, type);
-			ssaValue *offset = y;
-			// return ssa_emit_ptr_offset(p, ptr, offset);
+			ssaValue *offset = ssa_emit_conv(p, y, t_int);
+			return ssa_new_value2(p, ssaOp_PtrOffset, type, ptr, offset);
 		} else if (is_type_pointer(y->type)) {
-			GB_PANIC("TODO(bill): Ptr arith");
-
 			ssaValue *ptr = ssa_emit_conv(p, y, type);
-			ssaValue *offset = x;
-			// return ssa_emit_ptr_offset(p, ptr, offset);
+			ssaValue *offset = ssa_emit_conv(p, x, t_int);
+			return ssa_new_value2(p, ssaOp_PtrOffset, type, ptr, offset);
 		}
 	} else if (op == Token_Sub) {
 		if (is_type_pointer(x->type) && is_type_integer(y->type)) {
-			GB_PANIC("TODO(bill): Ptr arith");
 			// ptr - int
 			ssaValue *ptr = ssa_emit_conv(p, x, type);
-			ssaValue *offset = y;
-			// return ssa_emit_ptr_offset(p, ptr, offset);
+			ssaValue *offset = ssa_emit_conv(p, y, t_int);
+			offset = ssa_emit_unary_arith(p, Token_Sub, offset, t_int);
+			return ssa_new_value2(p, ssaOp_PtrOffset, type, ptr, offset);
 		} else if (is_type_pointer(x->type) && is_type_pointer(y->type)) {
 			GB_ASSERT(is_type_integer(type));
 			Type *ptr_type = base_type(x->type);
@@ -1538,7 +1950,25 @@ ssaValue *ssa_emit_arith(ssaProc *p, TokenKind op, ssaValue *x, ssaValue *y, Typ
 	case Token_Xor:
 	case Token_AndNot:
 		GB_ASSERT(x != NULL && y != NULL);
-		return ssa_new_value2(p, ssa_determine_op(op, x->type), type, x, y);
+		{
+			ssaOp arith_op = ssa_determine_op(op, x->type);
+			if (arith_op == ssaOp_Invalid) {
+				return ssa_unsupported(p, NULL, "arithmetic", type);
+			}
+			return ssa_new_value2(p, arith_op, type, x, y);
+		}
+
+	case Token_Shl:
+	case Token_Shr:
+		GB_ASSERT(x != NULL && y != NULL);
+		x = ssa_emit_conv(p, x, type);
+		{
+			ssaOp shift_op = ssa_determine_shift_op(op, x->type, y->type);
+			if (shift_op == ssaOp_Invalid) {
+				return ssa_unsupported(p, NULL, "shift", type);
+			}
+			return ssa_new_value2(p, shift_op, type, x, y);
+		}
 	}
 
 	return NULL;
@@ -1547,6 +1977,14 @@ ssaValue *ssa_emit_arith(ssaProc *p, TokenKind op, ssaValue *x, ssaValue *y, Typ
 
 
 
+void ssa_emit_if(ssaProc *p, ssaValue *cond, ssaBlock *yes, ssaBlock *no) {
+	ssaBlock *b = ssa_end_block(p);
+	b->kind = ssaBlock_If;
+	ssa_set_control(b, cond);
+	ssa_add_edge_to(b, yes);
+	ssa_add_edge_to(b, no);
+}
+
 ssaValue *ssa_build_cond(ssaProc *p, AstNode *cond, ssaBlock *yes, ssaBlock *no) {
 	switch (cond->kind) {
 	case_ast_node(pe, ParenExpr, cond);
@@ -1575,11 +2013,7 @@ ssaValue *ssa_build_cond(ssaProc *p, AstNode *cond, ssaBlock *yes, ssaBlock *no)
 	}
 
 	ssaValue *c = ssa_build_expr(p, cond);
-	ssaBlock *b = ssa_end_block(p);
-	b->kind = ssaBlock_If;
-	ssa_set_control(b, c);
-	ssa_add_edge_to(b, yes);
-	ssa_add_edge_to(b, no);
+	ssa_emit_if(p, c, yes, no);
 	return c;
 }
 
@@ -1593,17 +2027,17 @@ ssaValue *ssa_emit_logical_binary_expr(ssaProc *p, AstNode *expr) {
 
 	Type *type = default_type(type_of_expr(p->module->info, expr));
 
-	bool short_circuit_value = false;
+	// NOTE: The short circuit value is created before branching so that it dominates every edge into `done`
+	bool short_circuit_value = be->op.kind == Token_CmpOr;
+	ssaValue *short_circuit = ssa_const_bool(p, type, short_circuit_value);
 	if (be->op.kind == Token_CmpAnd) {
 		ssa_build_cond(p, be->left, rhs, done);
-		short_circuit_value = false;
 	} else if (be->op.kind == Token_CmpOr) {
 		ssa_build_cond(p, be->left, done, rhs);
-		short_circuit_value = true;
 	}
 	if (rhs->preds.count == 0) {
 		ssa_start_block(p, done);
-		return ssa_const_bool(p, type, short_circuit_value);
+		return short_circuit;
 	}
 
 	if (done->preds.count == 0) {
@@ -1612,59 +2046,123 @@ ssaValue *ssa_emit_logical_binary_expr(ssaProc *p, AstNode *expr) {
 	}
 
 	ssa_start_block(p, rhs);
-	ssaValue *short_circuit = ssa_const_bool(p, type, short_circuit_value);
-	ssaValueArgs edges = {0};
-	ssa_init_value_args(&edges, p->allocator);
-	for_array(i, done->preds) {
-		ssa_add_arg(&edges, short_circuit);
-	}
+	isize short_circuit_count = done->preds.count;
 
-	ssa_add_arg(&edges, ssa_build_expr(p, be->right));
+	ssaValue *right = ssa_build_expr(p, be->right);
 	ssa_emit_jump(p, done);
 	ssa_start_block(p, done);
 
+	// NOTE: The arguments are added in place as `ssaValueArgs` may point into its own backing
 	ssaValue *phi = ssa_new_value0(p, ssaOp_Phi, type);
-	phi->args = edges;
+	for (isize i = 0; i < short_circuit_count; i++) {
+		ssa_add_arg(&phi->args, short_circuit);
+	}
+	ssa_add_arg(&phi->args, right);
 	return phi;
 }
 
+// NOTE: Returns NULL for indirect calls
+Entity *ssa_call_entity(CheckerInfo *info, AstNode *call) {
+	AstNode *proc = unparen_expr(call->CallExpr.proc);
+	if (proc->kind == AstNode_SelectorExpr) {
+		proc = proc->SelectorExpr.selector;
+	}
+	Entity *e = entity_of_ident(info, proc);
+	if (e != NULL && e->kind == Entity_Procedure) {
+		return e;
+	}
+	return NULL;
+}
+
+ssaOp ssa_call_op(ProcCallingConvention cc) {
+	switch (cc) {
+	case ProcCC_C:    return ssaOp_CallC;
+	case ProcCC_Std:  return ssaOp_CallStd;
+	case ProcCC_Fast: return ssaOp_CallFast;
+	}
+	return ssaOp_CallOdin;
+}
+
+ssaValue *ssa_build_builtin_proc(ssaProc *p, AstNode *expr, TypeAndValue tv, BuiltinProcId id) {
+	ast_node(ce, CallExpr, expr);
+
+	switch (id) {
+	case BuiltinProc_len:
+	case BuiltinProc_cap: {
+		ssaValue *v = ssa_build_expr(p, ce->args[0]);
+		Type *t = base_type(v->type);
+		if (is_type_pointer(t)) {
+			v = ssa_emit_load(p, v);
+			t = base_type(type_deref(t));
+		}
+		i64 index = id == BuiltinProc_len ? 1 : 2;
+		if (is_type_string(t) && id == BuiltinProc_len) {
+			return ssa_emit_value_index(p, v, index);
+		} else if (is_type_slice(t) || is_type_dynamic_array(t)) {
+			return ssa_emit_value_index(p, v, index);
+		}
+	} break;
+	}
+
+	return ssa_unsupported(p, expr, "builtin procedure", tv.type);
+}
+
+ssaValue *ssa_build_call_expr(ssaProc *p, AstNode *expr) {
+	ast_node(ce, CallExpr, expr);
+	Entity *e = ssa_call_entity(p->module->info, expr);
+	if (e == NULL) {
+		return ssa_unsupported(p, expr, "indirect call", type_of_expr(p->module->info, expr));
+	}
+
+	TypeProc *pt = &base_type(e->type)->Proc;
+	if (pt->is_generic || pt->variadic || ce->ellipsis.pos.line != 0 || ce->args.count != pt->param_count) {
+		return ssa_unsupported(p, expr, "call with generic, variadic or default arguments", type_of_expr(p->module->info, expr));
+	}
+	if (pt->result_count > 1) {
+		return ssa_unsupported(p, expr, "call with multiple return values", type_of_expr(p->module->info, expr));
+	}
+
+	gbTempArenaMemory tmp = gb_temp_arena_memory_begin(&p->module->tmp_arena);
+	defer (gb_temp_arena_memory_end(tmp));
+
+	ssaValue **args = gb_alloc_array(p->module->tmp_allocator, ssaValue *, ce->args.count);
+	for_array(i, ce->args) {
+		if (ce->args[i]->kind == AstNode_FieldValue) {
+			return ssa_unsupported(p, expr, "call with named arguments", type_of_expr(p->module->info, expr));
+		}
+		Type *param_type = pt->params->Tuple.variables[i]->type;
+		args[i] = ssa_emit_conv(p, ssa_build_expr(p, ce->args[i]), param_type);
+	}
+
+	Type *result_type = NULL;
+	if (pt->result_count == 1) {
+		result_type = pt->results->Tuple.variables[0]->type;
+	}
+
+	ssaValue *proc = ssa_new_value0(p, ssaOp_Proc, e->type);
+	proc->entity = e;
+	proc->comment_string = e->token.string;
+
+	ssaValue *call = ssa_new_value1(p, ssa_call_op(pt->calling_convention), result_type, proc);
+	for_array(i, ce->args) {
+		ssa_add_arg(&call->args, args[i]);
+	}
+	return call;
+}
+
 ssaValue *ssa_build_expr(ssaProc *p, AstNode *expr) {
 	expr = unparen_expr(expr);
 
 	TypeAndValue tv = type_and_value_of_expr(p->module->info, expr);
 	GB_ASSERT(tv.mode != Addressing_Invalid);
 
+	if (p->unsupported.len > 0) {
+		return ssa_unsupported(p, expr, "", tv.type);
+	}
+	p->curr_node = expr;
+
 	if (tv.value.kind != ExactValue_Invalid) {
-		Type *t = core_type(tv.type);
-		if (is_type_boolean(t)) {
-			return ssa_const_bool(p, tv.type, tv.value.value_bool);
-		} else if (is_type_string(t)) {
-			GB_ASSERT(tv.value.kind == ExactValue_String);
-			return ssa_const_string(p, tv.type, tv.value.value_string);
-		} else if(is_type_slice(t)) {
-			return ssa_const_slice(p, tv.type, tv.value);
-		} else if (is_type_integer(t)) {
-			GB_ASSERT(tv.value.kind == ExactValue_Integer);
-
-			i64 s = 8*type_size_of(p->allocator, t);
-			switch (s) {
-			case 8:  return ssa_const_i8 (p, tv.type, i128_to_i64(tv.value.value_integer));
-			case 16: return ssa_const_i16(p, tv.type, i128_to_i64(tv.value.value_integer));
-			case 32: return ssa_const_i32(p, tv.type, i128_to_i64(tv.value.value_integer));
-			case 64: return ssa_const_i64(p, tv.type, i128_to_i64(tv.value.value_integer));
-			default: GB_PANIC("Unknown integer size");
-			}
-		} else if (is_type_float(t)) {
-			GB_ASSERT(tv.value.kind == ExactValue_Float);
-			i64 s = 8*type_size_of(p->allocator, t);
-			switch (s) {
-			case 32: return ssa_const_f32(p, tv.type, tv.value.value_float);
-			case 64: return ssa_const_f64(p, tv.type, tv.value.value_float);
-			default: GB_PANIC("Unknown float size");
-			}
-		}
-		// IMPORTANT TODO(bill): Do constant record/array literals correctly
-		return ssa_const_nil(p, tv.type);
+		return ssa_const_value(p, expr, tv.type, tv.value);
 	}
 
 	if (tv.mode == Addressing_Variable) {
@@ -1673,26 +2171,18 @@ ssaValue *ssa_build_expr(ssaProc *p, AstNode *expr) {
 
 
 	switch (expr->kind) {
-	case_ast_node(bl, BasicLit, expr);
-		GB_PANIC("Non-constant basic literal");
-	case_end;
+	case AstNode_BasicLit:
+		return ssa_unsupported(p, expr, "non-constant basic literal", tv.type);
 
-	case_ast_node(bd, BasicDirective, expr);
-		TokenPos pos = bd->token.pos;
-		GB_PANIC("Non-constant basic literal %.*s(%td:%td) - %.*s", LIT(pos.file), pos.line, pos.column, LIT(bd->name));
-	case_end;
+	case AstNode_BasicDirective:
+		return ssa_unsupported(p, expr, "non-constant directive", tv.type);
 
 	case_ast_node(i, Ident, expr);
 		Entity *e = *map_get(&p->module->info->uses, hash_pointer(expr));
 		if (e->kind == Entity_Builtin) {
-			Token token = ast_node_token(expr);
-			GB_PANIC("TODO(bill): ssa_build_expr Entity_Builtin `%.*s`\n"
-			         "\t at %.*s(%td:%td)", LIT(builtin_procs[e->Builtin.id].name),
-			         LIT(token.pos.file), token.pos.line, token.pos.column);
-			return NULL;
+			return ssa_unsupported(p, expr, "builtin procedure value", tv.type);
 		} else if (e->kind == Entity_Nil) {
-			GB_PANIC("TODO(bill): nil");
-			return NULL;
+			return ssa_unsupported(p, expr, "untyped nil", tv.type);
 		}
 
 		ssaValue **found = map_get(&p->module->values, hash_pointer(e));
@@ -1705,10 +2195,16 @@ ssaValue *ssa_build_expr(ssaProc *p, AstNode *expr) {
 			ssaAddr addr = ssa_build_addr(p, expr);
 			return ssa_addr_load(p, addr);
 		}
+		if (e->kind == Entity_Procedure) {
+			ssaValue *v = ssa_new_value0(p, ssaOp_Proc, e->type);
+			v->entity = e;
+			v->comment_string = e->token.string;
+			return v;
+		}
 	case_end;
 
 	case_ast_node(ue, UnaryExpr, expr);
-		if (ue->op.kind == Token_Pointer) {
+		if (ue->op.kind == Token_And) {
 			return ssa_build_addr(p, ue->expr).addr;
 		}
 		ssaValue *x = ssa_build_expr(p, ue->expr);
@@ -1736,8 +2232,9 @@ ssaValue *ssa_build_expr(ssaProc *p, AstNode *expr) {
 
 		case Token_Shl:
 		case Token_Shr: {
-			GB_PANIC("TODO: shifts");
-			return NULL;
+			ssaValue *x = ssa_build_expr(p, be->left);
+			ssaValue *y = ssa_build_expr(p, be->right);
+			return ssa_emit_arith(p, be->op.kind, x, y, type);
 		}
 
 		case Token_CmpEq:
@@ -1756,8 +2253,7 @@ ssaValue *ssa_build_expr(ssaProc *p, AstNode *expr) {
 			return ssa_emit_logical_binary_expr(p, expr);
 
 		default:
-			GB_PANIC("Invalid binary expression");
-			break;
+			return ssa_unsupported(p, expr, "binary expression", tv.type);
 		}
 	case_end;
 
@@ -1804,27 +2300,7 @@ ssaValue *ssa_build_expr(ssaProc *p, AstNode *expr) {
 
 
 	case_ast_node(pl, ProcLit, expr);
-		GB_PANIC("TODO(bill): ssa_build_expr ProcLit");
-	#if 0
-		// NOTE(bill): Generate a new name
-		// parent$count
-		isize name_len = proc->name.len + 1 + 8 + 1;
-		u8 *name_text = gb_alloc_array(proc->module->allocator, u8, name_len);
-		name_len = gb_snprintf(cast(char *)name_text, name_len, "%.*s$%d", LIT(proc->name), cast(i32)proc->children.count);
-		String name = make_string(name_text, name_len-1);
-
-		Type *type = type_of_expr(proc->module->info, expr);
-		irValue *value = ir_value_procedure(proc->module->allocator,
-		                                    proc->module, NULL, type, pl->type, pl->body, name);
-
-		value->Proc.tags = pl->tags;
-		value->Proc.parent = proc;
-
-		array_add(&proc->children, &value->Proc);
-		array_add(&proc->module->procs_to_generate, value);
-
-		return value;
-	#endif
+		return ssa_unsupported(p, expr, "procedure literal", tv.type);
 	case_end;
 
 	case_ast_node(cl, CompoundLit, expr);
@@ -1833,14 +2309,19 @@ ssaValue *ssa_build_expr(ssaProc *p, AstNode *expr) {
 
 
 	case_ast_node(ce, CallExpr, expr);
-		if (map_get(&p->module->info->types, hash_pointer(ce->proc))->mode == Addressing_Type) {
+		AddressingMode proc_mode = map_get(&p->module->info->types, hash_pointer(ce->proc))->mode;
+		if (proc_mode == Addressing_Type) {
 			GB_ASSERT(ce->args.count == 1);
 			ssaValue *x = ssa_build_expr(p, ce->args[0]);
 			return ssa_emit_conv(p, x, tv.type);
 		}
+		if (proc_mode == Addressing_Builtin) {
+			Entity *e = entity_of_ident(p->module->info, unparen_expr(ce->proc));
+			BuiltinProcId id = cast(BuiltinProcId)(e != NULL ? e->Builtin.id : BuiltinProc_DIRECTIVE);
+			return ssa_build_builtin_proc(p, expr, tv, id);
+		}
 
-		AstNode *p = unparen_expr(ce->proc);
-		GB_PANIC("TODO(bill): ssa_build_expr CallExpr");
+		return ssa_build_call_expr(p, expr);
 	case_end;
 
 	case_ast_node(se, SliceExpr, expr);
@@ -1852,9 +2333,7 @@ ssaValue *ssa_build_expr(ssaProc *p, AstNode *expr) {
 	case_end;
 	}
 
-	GB_PANIC("Unexpected expression: %.*s", LIT(ast_node_strings[expr->kind]));
-
-	return NULL;
+	return ssa_unsupported(p, expr, "expression", tv.type);
 }
 
 
@@ -1903,6 +2382,236 @@ void ssa_build_assign_op(ssaProc *p, ssaAddr lhs, ssaValue *value, TokenKind op)
 	ssa_addr_store(p, lhs, new_value);
 }
 
+// NOTE: Nested procedures are named `parent.name-index` and built once something refers to them
+void ssa_build_nested_proc(ssaProc *p, AstNodeProcDecl *pd, Entity *e, DeclInfo *decl) {
+	ssaModule *m = p->module;
+	if (!is_entity_in_dependency_map(&m->min_dep_map, e)) {
+		// NOTE: Nothing depends upon it so doesn't need to be built
+		return;
+	}
+
+	String pd_name = e->token.string;
+	if (pd->link_name.len > 0) {
+		pd_name = pd->link_name;
+	}
+
+	isize name_len = p->name.len + 1 + pd_name.len + 1 + 10 + 1;
+	u8 *name_text = gb_alloc_array(m->allocator, u8, name_len);
+	name_len = gb_snprintf(cast(char *)name_text, name_len, "%.*s.%.*s-%d",
+	                       LIT(p->name), LIT(pd_name), cast(i32)m->procs_to_generate.count);
+	String name = make_string(name_text, name_len-1);
+
+	ssaProc *child = ssa_new_proc(m, name, e, decl);
+	map_set(&m->entity_names, hash_pointer(e), name);
+	map_set(&m->unbuilt_procs, hash_pointer(e), child);
+	array_add(&m->procs_to_generate, child);
+}
+
+// NOTE: The address of the value of `expr`, which is copied into a local when it is not addressable
+ssaValue *ssa_build_addr_or_copy(ssaProc *p, AstNode *expr) {
+	if (type_and_value_of_expr(p->module->info, expr).mode == Addressing_Variable) {
+		return ssa_build_addr(p, expr).addr;
+	}
+	ssaValue *v = ssa_build_expr(p, expr);
+	ssaAddr addr = ssa_add_local_generated(p, v->type);
+	ssa_addr_store(p, addr, v);
+	return addr.addr;
+}
+
+// NOTE: Ranges over intervals, arrays, slices and dynamic arrays. The loop block advances the
+// index so that `continue` jumps straight to it, as in the IR backend
+void ssa_build_range_stmt(ssaProc *p, AstNode *node) {
+	ast_node(rs, RangeStmt, node);
+	CheckerInfo *info = p->module->info;
+
+	Type *val_type = NULL;
+	Type *idx_type = NULL;
+	if (rs->value != NULL && !ssa_is_blank_ident(rs->value)) {
+		val_type = type_of_expr(info, rs->value);
+	}
+	if (rs->index != NULL && !ssa_is_blank_ident(rs->index)) {
+		idx_type = type_of_expr(info, rs->index);
+	}
+
+	ssaValue *val = NULL;
+	ssaValue *idx = NULL;
+	ssaBlock *loop = ssa_new_block(p, ssaBlock_Plain, "for.range.loop");
+	ssaBlock *body = ssa_new_block(p, ssaBlock_Plain, "for.range.body");
+	ssaBlock *done = ssa_new_block(p, ssaBlock_Plain, "for.range.done");
+	AstNode *expr = unparen_expr(rs->expr);
+	TypeAndValue tv = type_and_value_of_expr(info, expr);
+
+	if (is_ast_node_a_range(expr)) {
+		ast_node(ie, BinaryExpr, expr);
+		ssaValue *lower = ssa_build_expr(p, ie->left);
+		Type *t = val_type != NULL ? val_type : default_type(lower->type);
+		ssaAddr value = ssa_add_local_generated(p, t);
+		ssaAddr index = ssa_add_local_generated(p, t_int);
+		ssa_addr_store(p, value, lower);
+
+		ssa_emit_jump(p, loop);
+		ssa_start_block(p, loop);
+		ssaValue *upper = ssa_emit_conv(p, ssa_build_expr(p, ie->right), t);
+		TokenKind op = ie->op.kind == Token_Ellipsis ? Token_LtEq : Token_Lt;
+		val = ssa_addr_load(p, value);
+		ssa_emit_if(p, ssa_emit_comp(p, op, val, upper), body, done);
+
+		ssa_start_block(p, body);
+		idx = ssa_addr_load(p, index);
+		ssa_addr_store(p, value, ssa_emit_arith(p, Token_Add, val, ssa_emit_conv(p, ssa_const_int(p, t_int, 1), t), t));
+		ssa_addr_store(p, index, ssa_emit_arith(p, Token_Add, idx, ssa_const_int(p, t_int, 1), t_int));
+	} else if (tv.mode == Addressing_Type) {
+		ssa_unsupported(p, node, "range over an enum type", NULL);
+		return;
+	} else {
+		Type *et = base_type(type_deref(tv.type));
+		ssaValue *ptr = NULL;
+		if (is_type_pointer(tv.type)) {
+			ptr = ssa_build_expr(p, expr);
+		} else {
+			ptr = ssa_build_addr_or_copy(p, expr);
+		}
+
+		ssaValue *data  = NULL;
+		ssaValue *count = NULL;
+		switch (et->kind) {
+		case Type_Array:
+			count = ssa_const_int(p, t_int, et->Array.count);
+			break;
+		case Type_Vector:
+			count = ssa_const_int(p, t_int, et->Vector.count);
+			break;
+		case Type_Slice:
+			data  = ssa_emit_load(p, ssa_emit_ptr_index(p, ptr, 0));
+			count = ssa_emit_load(p, ssa_emit_ptr_index(p, ptr, 1));
+			break;
+		case Type_DynamicArray:
+			break; // NOTE: Loaded on each iteration as the body may append to the array
+		case Type_Map:
+			ssa_unsupported(p, node, "range over a map", NULL);
+			return;
+		default:
+			ssa_unsupported(p, node, "range over a string", NULL);
+			return;
+		}
+
+		ssaAddr index = ssa_add_local_generated(p, t_int);
+		ssa_addr_store(p, index, ssa_const_int(p, t_int, -1));
+
+		ssa_emit_jump(p, loop);
+		ssa_start_block(p, loop);
+		idx = ssa_emit_arith(p, Token_Add, ssa_addr_load(p, index), ssa_const_int(p, t_int, 1), t_int);
+		ssa_addr_store(p, index, idx);
+		if (et->kind == Type_DynamicArray) {
+			count = ssa_emit_load(p, ssa_emit_ptr_index(p, ptr, 1));
+		}
+		ssa_emit_if(p, ssa_emit_comp(p, Token_Lt, idx, count), body, done);
+
+		ssa_start_block(p, body);
+		if (val_type != NULL) {
+			ssaValue *elem = NULL;
+			if (et->kind == Type_Array || et->kind == Type_Vector) {
+				elem = ssa_emit_array_index(p, ptr, idx);
+			} else {
+				if (et->kind == Type_DynamicArray) {
+					data = ssa_emit_load(p, ssa_emit_ptr_index(p, ptr, 0));
+				}
+				elem = ssa_new_value2(p, ssaOp_PtrOffset, data->type, data, idx);
+			}
+			val = ssa_emit_load(p, elem);
+		}
+	}
+
+	ssa_open_scope(p);
+	if (val_type != NULL) {
+		ssa_addr_store(p, ssa_add_local_for_ident(p, rs->value), val);
+	}
+	if (idx_type != NULL) {
+		ssa_addr_store(p, ssa_add_local_for_ident(p, rs->index), idx);
+	}
+
+	ssa_push_target_list(p, done, loop, NULL);
+	ssa_build_stmt(p, rs->body);
+	ssa_pop_target_list(p);
+	ssa_close_scope(p, ssaDeferExit_Default, NULL);
+
+	ssa_emit_jump(p, loop);
+	ssa_start_block(p, done);
+}
+
+// NOTE: Compares the tag against each case in source order, a range `lo..hi` or `lo..<hi` with
+// two branches. The default clause is only reached once every other case has failed
+void ssa_build_match_stmt(ssaProc *p, AstNode *node) {
+	ast_node(ms, MatchStmt, node);
+	ssa_open_scope(p);
+	if (ms->init != NULL) {
+		ssa_build_stmt(p, ms->init);
+	}
+	ssaValue *tag = NULL;
+	if (ms->tag != NULL) {
+		tag = ssa_build_expr(p, ms->tag);
+		tag = ssa_emit_conv(p, tag, default_type(tag->type));
+	}
+
+	ast_node(body, BlockStmt, ms->body);
+	isize case_count = body->stmts.count;
+	ssaBlock *done = ssa_new_block(p, ssaBlock_Plain, "match.done");
+	ssaBlock **bodies = gb_alloc_array(p->allocator, ssaBlock *, case_count);
+	ssaBlock *default_block = done;
+	for_array(i, body->stmts) {
+		ast_node(cc, CaseClause, body->stmts[i]);
+		if (cc->list.count == 0) {
+			bodies[i] = ssa_new_block(p, ssaBlock_Plain, "match.dflt.body");
+			default_block = bodies[i];
+		} else {
+			bodies[i] = ssa_new_block(p, ssaBlock_Plain, "match.case.body");
+		}
+	}
+
+	for_array(i, body->stmts) {
+		ast_node(cc, CaseClause, body->stmts[i]);
+		for_array(j, cc->list) {
+			AstNode *expr = unparen_expr(cc->list[j]);
+			ssaBlock *next = ssa_new_block(p, ssaBlock_Plain, "match.case.next");
+			if (is_ast_node_a_range(expr)) {
+				ast_node(ie, BinaryExpr, expr);
+				ssaBlock *upper = ssa_new_block(p, ssaBlock_Plain, "match.case.upper");
+				ssaValue *lo = ssa_build_expr(p, ie->left);
+				ssa_emit_if(p, ssa_emit_comp(p, Token_LtEq, lo, tag), upper, next);
+				ssa_start_block(p, upper);
+				TokenKind op = ie->op.kind == Token_Ellipsis ? Token_LtEq : Token_Lt;
+				ssaValue *hi = ssa_build_expr(p, ie->right);
+				ssa_emit_if(p, ssa_emit_comp(p, op, tag, hi), bodies[i], next);
+			} else if (tag == NULL) {
+				ssa_build_cond(p, expr, bodies[i], next);
+			} else {
+				ssaValue *value = ssa_build_expr(p, expr);
+				ssa_emit_if(p, ssa_emit_comp(p, Token_CmpEq, tag, value), bodies[i], next);
+			}
+			ssa_start_block(p, next);
+		}
+	}
+	ssa_emit_jump(p, default_block);
+
+	for_array(i, body->stmts) {
+		ast_node(cc, CaseClause, body->stmts[i]);
+		ssaBlock *fall = done;
+		if (i+1 < case_count) {
+			fall = bodies[i+1];
+		}
+		ssa_start_block(p, bodies[i]);
+		ssa_push_target_list(p, done, NULL, fall);
+		ssa_open_scope(p);
+		ssa_build_stmt_list(p, cc->stmts);
+		ssa_close_scope(p, ssaDeferExit_Default, NULL);
+		ssa_pop_target_list(p);
+		ssa_emit_jump(p, done);
+	}
+
+	ssa_start_block(p, done);
+	ssa_close_scope(p, ssaDeferExit_Default, NULL);
+}
+
 void ssa_build_stmt_internal(ssaProc *p, AstNode *node);
 void ssa_build_stmt(ssaProc *p, AstNode *node) {
 	u32 prev_stmt_state_flags = p->module->stmt_state_flags;
@@ -1927,6 +2636,7 @@ void ssa_build_stmt(ssaProc *p, AstNode *node) {
 	p->module->stmt_state_flags = prev_stmt_state_flags;
 }
 void ssa_build_stmt_internal(ssaProc *p, AstNode *node) {
+	p->curr_node = node;
 	if (p->curr_block == NULL) {
 		ssaBlock *dead_block = ssa_new_block(p, ssaBlock_Plain, "");
 		ssa_start_block(p, dead_block);
@@ -1955,6 +2665,51 @@ void ssa_build_stmt_internal(ssaProc *p, AstNode *node) {
 		ssa_build_when_stmt(p, ws);
 	case_end;
 
+	case_ast_node(gd, GenDecl, node);
+		if (gd->token.kind != Token_var) {
+			// NOTE: Constants and types need no code
+			break;
+		}
+		for_array(i, gd->specs) {
+			ast_node(vd, ValueSpec, gd->specs[i]);
+
+			ssaModule *m = p->module;
+			gbTempArenaMemory tmp = gb_temp_arena_memory_begin(&m->tmp_arena);
+
+			Array<ssaAddr> lvals = {0};
+			array_init(&lvals, m->tmp_allocator, vd->names.count);
+			for_array(j, vd->names) {
+				AstNode *name = vd->names[j];
+				ssaAddr lval = {0};
+				if (!ssa_is_blank_ident(name)) {
+					lval = ssa_add_local_for_ident(p, name);
+				}
+				array_add(&lvals, lval);
+			}
+
+			if (vd->values.count > 0) {
+				Array<ssaValue *> inits = {0};
+				array_init(&inits, m->tmp_allocator, lvals.count);
+				for_array(j, vd->values) {
+					ssaValue *init = ssa_build_expr(p, vd->values[j]);
+					Type *t = base_type(init->type);
+					if (t->kind == Type_Tuple) {
+						for (isize k = 0; k < t->Tuple.variable_count; k++) {
+							array_add(&inits, ssa_emit_value_index(p, init, k));
+						}
+					} else {
+						array_add(&inits, init);
+					}
+				}
+				for_array(j, inits) {
+					ssa_addr_store(p, lvals[j], inits[j]);
+				}
+			}
+
+			gb_temp_arena_memory_end(tmp);
+		}
+	case_end;
+
 	case_ast_node(s, IncDecStmt, node);
 		TokenKind op = Token_Add;
 		if (s->op.kind == Token_Dec) {
@@ -2059,7 +2814,21 @@ void ssa_build_stmt_internal(ssaProc *p, AstNode *node) {
 	case_end;
 
 	case_ast_node(rs, ReturnStmt, node);
-		GB_PANIC("TODO: ReturnStmt");
+		ssa_emit_comment(p, str_lit("ReturnStmt"));
+		ssaValue *v = NULL;
+		isize result_count = p->entity->type->Proc.result_count;
+		if (result_count == 1) {
+			GB_ASSERT(rs->results.count == 1);
+			v = ssa_emit_conv(p, ssa_build_expr(p, rs->results[0]), base_type(p->entity->type)->Proc.results->Tuple.variables[0]->type);
+		} else if (result_count > 1) {
+			ssa_unsupported(p, node, "multiple return values", NULL);
+		}
+
+		ssa_emit_defer_stmts(p, ssaDeferExit_Return, NULL);
+
+		ssaBlock *b = ssa_end_block(p);
+		b->kind = ssaBlock_Ret;
+		ssa_set_control(b, v);
 	case_end;
 
 	case_ast_node(is, IfStmt, node);
@@ -2140,22 +2909,24 @@ void ssa_build_stmt_internal(ssaProc *p, AstNode *node) {
 		if (fs->post != NULL) {
 			ssa_start_block(p, post);
 			ssa_build_stmt(p, fs->post);
-			ssa_emit_jump(p, post);
+			ssa_emit_jump(p, loop);
 		}
 
 		ssa_start_block(p, done);
 	case_end;
 
 	case_ast_node(rs, RangeStmt, node);
-		GB_PANIC("TODO: RangeStmt");
+		ssa_emit_comment(p, str_lit("RangeStmt"));
+		ssa_build_range_stmt(p, node);
 	case_end;
 
-	case_ast_node(rs, MatchStmt, node);
-		GB_PANIC("TODO: MatchStmt");
+	case_ast_node(ms, MatchStmt, node);
+		ssa_emit_comment(p, str_lit("MatchStmt"));
+		ssa_build_match_stmt(p, node);
 	case_end;
 
 	case_ast_node(rs, TypeMatchStmt, node);
-		GB_PANIC("TODO: TypeMatchStmt");
+		ssa_unsupported(p, node, "type match statement", NULL);
 	case_end;
 
 	case_ast_node(bs, BranchStmt, node);
@@ -2189,10 +2960,40 @@ void ssa_build_stmt_internal(ssaProc *p, AstNode *node) {
 	case_end;
 
 	case_ast_node(pa, PushAllocator, node);
-		GB_PANIC("TODO: PushAllocator");
+		ssa_unsupported(p, node, "push_allocator statement", NULL);
 	case_end;
 	case_ast_node(pc, PushContext, node);
-		GB_PANIC("TODO: PushContext");
+		ssa_unsupported(p, node, "push_context statement", NULL);
+	case_end;
+
+	case_ast_node(fb, ForeignBlockDecl, node);
+		for_array(i, fb->decls) {
+			ssa_build_stmt(p, fb->decls[i]);
+		}
+	case_end;
+
+	case_ast_node(pd, ProcDecl, node);
+		CheckerInfo *info = p->module->info;
+		Entity *e = entity_of_ident(info, pd->name);
+		if (pd->body == NULL) {
+			// NOTE: Foreign procedures are referred to by their unmangled name
+			String name = e->token.string;
+			if (pd->link_name.len > 0) {
+				name = pd->link_name;
+			}
+			map_set(&p->module->entity_names, hash_pointer(e), name);
+		} else if (is_type_gen_proc(e->type)) {
+			auto *found = map_get(&info->gen_procs, hash_pointer(pd->name));
+			if (found != NULL) {
+				for_array(i, *found) {
+					Entity *spec = (*found)[i];
+					DeclInfo *d = decl_info_of_entity(info, spec);
+					ssa_build_nested_proc(p, &d->proc_decl->ProcDecl, spec, d);
+				}
+			}
+		} else {
+			ssa_build_nested_proc(p, pd, e, decl_info_of_entity(info, e));
+		}
 	case_end;
 	}
 }
@@ -2217,9 +3018,9 @@ void ssa_print_exact_value(gbFile *f, ssaValue *v) {
 		break;
 	case ExactValue_Integer:
 		if (is_type_unsigned(t)) {
-			gb_fprintf(f, " [%llu]", cast(unsigned long long)i128_to_u64(ev.value_integer));
+			gb_fprintf(f, " [%llu]", cast(unsigned long long)big_int_to_u64(ev.value_integer));
 		} else {
-			gb_fprintf(f, " [%lld]", cast(long long)i128_to_i64(ev.value_integer));
+			gb_fprintf(f, " [%lld]", cast(long long)big_int_to_i64(ev.value_integer));
 		}
 		break;
 	case ExactValue_Float:
@@ -2342,7 +3143,7 @@ void ssa_print_proc(gbFile *f, ssaProc *p) {
 			}
 		}
 
-		if (b->kind == ssaBlock_Plain) {
+		if (b->kind == ssaBlock_Plain || b->kind == ssaBlock_Entry) {
 			GB_ASSERT(b->succs.count == 1);
 			ssaBlock *next = b->succs[0].block;
 			gb_fprintf(f, "    ");
@@ -2361,7 +3162,11 @@ void ssa_print_proc(gbFile *f, ssaProc *p) {
 			gb_fprintf(f, "\n");
 		} else if (b->kind == ssaBlock_Ret) {
 			gb_fprintf(f, "    ");
-			gb_fprintf(f, "ret");
+			if (b->control != NULL) {
+				gb_fprintf(f, "ret v%d", b->control->id);
+			} else {
+				gb_fprintf(f, "ret");
+			}
 			gb_fprintf(f, "\n");
 		}
 	}
@@ -2370,7 +3175,15 @@ void ssa_print_proc(gbFile *f, ssaProc *p) {
 }
 
 
-void ssa_opt_proc(ssaProc *p) {
+#include "ssa_opt.cpp"
+
+// NOTE: Reports a construct which the backend cannot build or lower yet, naming the procedure
+void ssa_error_unsupported(ssaProc *p, AstNode *node, String what) {
+	Token token = p->entity->token;
+	if (node != NULL) {
+		token = ast_node_token(node);
+	}
+	error(token, "`%.*s` uses %.*s, which the custom backend does not support yet", LIT(p->name), LIT(what));
 }
 
 void ssa_build_proc(ssaModule *m, ssaProc *p) {
@@ -2382,14 +3195,40 @@ void ssa_build_proc(ssaModule *m, ssaProc *p) {
 		return;
 	}
 
-	ast_node(pl, ProcLit, p->decl_info->proc_decl);
-	if (pl->body == NULL) {
+	ast_node(pd, ProcDecl, p->decl_info->proc_decl);
+	if (pd->body == NULL) {
 		return;
 	}
 	p->entry = ssa_new_block(p, ssaBlock_Entry, "entry");
 
 	ssa_start_block(p, p->entry);
-	ssa_build_stmt(p, pl->body);
+
+	if (m->startup_runtime != NULL && p->entity == m->entry_point_entity) {
+		ssaValue *startup = ssa_new_value0(p, ssaOp_Proc, m->startup_runtime->type);
+		startup->entity = m->startup_runtime;
+		startup->comment_string = m->startup_runtime->token.string;
+		ssa_new_value1(p, ssaOp_CallOdin, NULL, startup);
+	}
+
+	Type *pt = base_type(p->entity->type);
+	if (pt->Proc.params != NULL) {
+		TypeTuple *params = &pt->Proc.params->Tuple;
+		for (isize i = 0; i < params->variable_count; i++) {
+			Entity *e = params->variables[i];
+			if (e->kind != Entity_Variable) {
+				continue;
+			}
+			ssaValue *arg = ssa_new_value0v(p, ssaOp_Arg, e->type, exact_value_i64(i));
+			arg->comment_string = e->token.string;
+			if (e->token.string != "" &&
+			    e->token.string != "_") {
+				ssaAddr local = ssa_add_local(p, e, NULL);
+				ssa_addr_store(p, local, arg);
+			}
+		}
+	}
+
+	ssa_build_stmt(p, pd->body);
 
 	if (p->entity->type->Proc.result_count == 0) {
 		ssa_emit_defer_stmts(p, ssaDeferExit_Return, NULL);
@@ -2397,67 +3236,264 @@ void ssa_build_proc(ssaModule *m, ssaProc *p) {
 
 	p->exit = ssa_new_block(p, ssaBlock_Exit, "exit");
 	ssa_emit_jump(p, p->exit);
+}
+
+
+void ssa_module_init(ssaModule *m, CheckerInfo *info, isize token_count) {
+	m->info = info;
+
+	isize arena_size = 4 * token_count * gb_max3(gb_size_of(ssaValue), gb_size_of(ssaBlock), gb_size_of(ssaProc));
+
+	gb_arena_init_from_allocator(&m->arena,     heap_allocator(), arena_size);
+	gb_arena_init_from_allocator(&m->tmp_arena, heap_allocator(), arena_size);
+	m->tmp_allocator = gb_arena_allocator(&m->tmp_arena);
+	m->allocator     = gb_arena_allocator(&m->arena);
+
+	map_init(&m->values,       heap_allocator());
+	map_init(&m->entity_names, heap_allocator());
+	array_init(&m->registers,         heap_allocator());
+	array_init(&m->procs,             heap_allocator());
+	array_init(&m->procs_to_generate, heap_allocator());
+	map_init(&m->unbuilt_procs,   heap_allocator());
+	array_init(&m->proc_queue,    heap_allocator());
+	map_init(&m->defined_globals, heap_allocator());
+	array_init(&m->init_procs,    heap_allocator());
+	ssa_object_init(&m->object);
+}
+
+void ssa_module_destroy(ssaModule *m) {
+	ssa_object_destroy(&m->object);
+	map_destroy(&m->values);
+	map_destroy(&m->entity_names);
+	array_free(&m->registers);
+	array_free(&m->procs);
+	array_free(&m->procs_to_generate);
+	map_destroy(&m->unbuilt_procs);
+	array_free(&m->proc_queue);
+	map_destroy(&m->defined_globals);
+	array_free(&m->init_procs);
+	gb_arena_free(&m->tmp_arena);
+	gb_arena_free(&m->arena);
+}
+
+
+#include "ssa_amd64.cpp"
+#include "ssa_vm.cpp"
+
+// NOTE: Defines a global variable in .data when its initial value is a constant, or in .bss
+// when it has none. Returns false when the value needs code to initialise it
+bool ssa_define_global_data(ssaModule *m, Entity *e, String name, ExactValue value) {
+	ssaObject *o = &m->object;
+	gbAllocator a = heap_allocator();
+	Type *t = core_type(e->type);
+	i64 size  = type_size_of(a, e->type);
+	i64 align = type_align_of(a, e->type);
+
+	if (value.kind == ExactValue_Invalid) {
+		i64 offset = ssa_object_reserve_bss(o, size, align);
+		ssa_object_define_symbol(o, name, ssaObjectSection_Bss, offset, size, false, true);
+		return true;
+	}
+
+	u64 bits = 0;
+	if (is_type_string(t) && value.kind == ExactValue_String) {
+		i64 str = ssa_object_add_string(o, value.value_string);
+		i64 offset = ssa_object_align_section(o, ssaObjectSection_Data, align);
+		ssa_object_add_relocation(o, ssaObjectSection_Data, offset,
+		                          ssa_object_section_symbol(o, ssaObjectSection_Rodata), ssaRelocation_Abs64, str);
+		Array<u8> *data = &o->sections[ssaObjectSection_Data];
+		u64 len = cast(u64)value.value_string.len;
+		for (isize i = 0; i < 8; i++) array_add(data, cast(u8)0);
+		for (isize i = 0; i < 8; i++) array_add(data, cast(u8)(len >> (8*i)));
+		ssa_object_define_symbol(o, name, ssaObjectSection_Data, offset, size, false, true);
+		return true;
+	} else if (is_type_array(t) && value.kind == ExactValue_Packed) {
+		// NOTE: Packed element data is already in the little-endian layout of the array
+		PackedArray *packed = value.value_packed;
+		GB_ASSERT(packed->count*packed->elem_size == size);
+		i64 offset = ssa_object_align_section(o, ssaObjectSection_Data, align);
+		Array<u8> *data = &o->sections[ssaObjectSection_Data];
+		for (i64 i = 0; i < size; i++) {
+			array_add(data, packed->data[i]);
+		}
+		ssa_object_define_symbol(o, name, ssaObjectSection_Data, offset, size, false, true);
+		return true;
+	} else if (is_type_boolean(t) && value.kind == ExactValue_Bool) {
+		bits = value.value_bool ? 1 : 0;
+	} else if (is_type_float(t) && (value.kind == ExactValue_Integer || value.kind == ExactValue_Float)) {
+		f64 f = exact_value_to_float(value).value_float;
+		if (size == 4) {
+			f32 f32_value = cast(f32)f;
+			bits = *cast(u32 *)&f32_value;
+		} else {
+			bits = *cast(u64 *)&f;
+		}
+	} else if ((is_type_integer(t) || is_type_pointer(t)) && value.kind == ExactValue_Integer) {
+		bits = big_int_to_u64(value.value_integer);
+	} else if (is_type_pointer(t) && value.kind == ExactValue_Pointer) {
+		bits = cast(u64)value.value_pointer;
+	} else {
+		return false;
+	}
+	if (size > 8) {
+		return false;
+	}
+
+	i64 offset = ssa_object_align_section(o, ssaObjectSection_Data, align);
+	Array<u8> *data = &o->sections[ssaObjectSection_Data];
+	for (i64 i = 0; i < size; i++) {
+		array_add(data, cast(u8)(bits >> (8*i)));
+	}
+	ssa_object_define_symbol(o, name, ssaObjectSection_Data, offset, size, false, true);
+	return true;
+}
+
+// NOTE: Procedures made by the backend itself, which have no declaration
+ssaProc *ssa_begin_synthetic_proc(ssaModule *m, String name) {
+	Token token = {Token_Ident};
+	token.string = name;
+	Type *type = make_type_proc(m->allocator, NULL, NULL, 0, NULL, 0, false, ProcCC_Odin);
+	Entity *e = make_entity_procedure(m->allocator, NULL, token, type, 0);
+	map_set(&m->entity_names, hash_pointer(e), name);
+
+	ssaProc *p = ssa_new_proc(m, name, e, NULL);
+	m->proc = p;
+	p->entry = ssa_new_block(p, ssaBlock_Entry, "entry");
+	ssa_start_block(p, p->entry);
+	return p;
+}
+
+void ssa_end_synthetic_proc(ssaProc *p) {
+	p->exit = ssa_new_block(p, ssaBlock_Exit, "exit");
+	ssa_emit_jump(p, p->exit);
+}
+
+String ssa_make_init_proc_name(ssaModule *m, String symbol) {
+	String prefix = str_lit("__$init.");
+	isize len = prefix.len + symbol.len;
+	u8 *text = gb_alloc_array(m->allocator, u8, len+1);
+	gb_memmove(text, prefix.text, prefix.len);
+	gb_memmove(text+prefix.len, symbol.text, symbol.len);
+	return make_string(text, len);
+}
 
-	ssa_opt_proc(p);
+void ssa_request_references(ssaModule *m, ssaProc *p);
 
-	ssa_print_proc(gb_file_get_standard(gbFileStandard_Error), p);
+void ssa_request_foreign_library(ssaModule *m, Entity *e) {
+	String library_path = e->LibraryName.path;
+	if (library_path.len == 0) {
+		return;
+	}
+	for_array(i, *m->foreign_library_paths) {
+		if ((*m->foreign_library_paths)[i] == library_path) {
+			return;
+		}
+	}
+	array_add(m->foreign_library_paths, library_path);
 }
 
+void ssa_request_proc(ssaModule *m, Entity *e) {
+	HashKey key = hash_pointer(e);
+	ssaProc **found = map_get(&m->unbuilt_procs, key);
+	if (found != NULL) {
+		array_add(&m->proc_queue, *found);
+		map_remove(&m->unbuilt_procs, key);
+		if (e->kind == Entity_Procedure && e->Procedure.foreign_library != NULL) {
+			ssa_request_foreign_library(m, e->Procedure.foreign_library);
+		}
+	}
+}
+
+// NOTE: Defines a global variable the first time it is referred to. Non-constant initial values are
+// stored by their own procedure, called from `__$startup_runtime`
+void ssa_request_global(ssaModule *m, Entity *e) {
+	HashKey key = hash_pointer(e);
+	String *name = map_get(&m->entity_names, key);
+	if (name == NULL || e->scope == NULL || !e->scope->is_file || map_get(&m->defined_globals, key) != NULL) {
+		return;
+	}
+	map_set(&m->defined_globals, key, true);
+
+	DeclInfo *decl = decl_info_of_entity(m->info, e);
+	ExactValue value = {};
+	if (decl != NULL && decl->init_expr != NULL) {
+		value = type_and_value_of_expr(m->info, decl->init_expr).value;
+	}
+	if (ssa_define_global_data(m, e, *name, value)) {
+		return;
+	}
+
+	ssa_define_global_data(m, e, *name, ExactValue{});
+	ssaProc *p = ssa_begin_synthetic_proc(m, ssa_make_init_proc_name(m, *name));
+	ssaValue *g = ssa_new_value0(p, ssaOp_Global, make_type_pointer(p->allocator, e->type));
+	g->entity = e;
+	g->comment_string = e->token.string;
+	ssa_emit_store(p, g, ssa_emit_conv(p, ssa_build_expr(p, decl->init_expr), e->type));
+	ssa_end_synthetic_proc(p);
+	array_add(&m->init_procs, p);
+	ssa_request_references(m, p);
+}
 
+// NOTE: Queues the procedures and defines the global variables which `p` refers to. The dependency
+// map also has the runtime procedures which the IR backend calls implicitly, e.g. for bounds checks,
+// whereas this backend lowers those checks inline
+void ssa_request_references(ssaModule *m, ssaProc *p) {
+	for_array(i, p->blocks) {
+		ssaBlock *b = p->blocks[i];
+		for_array(j, b->values) {
+			ssaValue *v = b->values[j];
+			if (v->entity == NULL) {
+				continue;
+			}
+			if (v->op == ssaOp_Proc) {
+				ssa_request_proc(m, v->entity);
+			} else if (v->op == ssaOp_Global) {
+				ssa_request_global(m, v->entity);
+			}
+		}
+	}
+}
 
-bool ssa_generate(Parser *parser, CheckerInfo *info) {
+// NOTE: Writes `output_base`.o and adds the foreign libraries it needs to `foreign_library_paths`
+bool ssa_generate(Parser *parser, CheckerInfo *info, Array<String> *foreign_library_paths) {
 	if (global_error_collector.count != 0) {
 		return false;
 	}
 
 	ssaModule m = {0};
-	{ // Init ssaModule
-		m.info = info;
+	ssa_module_init(&m, info, parser->total_token_count);
+	defer (ssa_module_destroy(&m));
+	m.foreign_library_paths = foreign_library_paths;
 
-		isize token_count = parser->total_token_count;
-		isize arena_size = 4 * token_count * gb_max3(gb_size_of(ssaValue), gb_size_of(ssaBlock), gb_size_of(ssaProc));
+	String init_fullpath = parser->init_fullpath;
+	m.output_base = make_string(init_fullpath.text, string_extension_position(init_fullpath));
 
-		gb_arena_init_from_allocator(&m.arena,     heap_allocator(), arena_size);
-		gb_arena_init_from_allocator(&m.tmp_arena, heap_allocator(), arena_size);
-		m.tmp_allocator = gb_arena_allocator(&m.tmp_arena);
-		m.allocator     = gb_arena_allocator(&m.arena);
-
-		map_init(&m.values,    heap_allocator());
-		array_init(&m.registers,         heap_allocator());
-		array_init(&m.procs,             heap_allocator());
-		array_init(&m.procs_to_generate, heap_allocator());
+	if (build_context.ODIN_OS != "linux" || build_context.ODIN_ARCH != "amd64") {
+		gb_printf_err("The custom backend only supports linux/amd64, got %.*s/%.*s\n",
+		              LIT(build_context.ODIN_OS), LIT(build_context.ODIN_ARCH));
+		return false;
 	}
 
-	isize global_variable_max_count = 0;
 	Entity *entry_point = NULL;
-	bool has_dll_main = false;
-	bool has_win_main = false;
-
 	for_array(i, info->entities.entries) {
 		auto *entry = &info->entities.entries[i];
 		Entity *e = cast(Entity *)entry->key.ptr;
-		String name = e->token.string;
-		if (e->kind == Entity_Variable) {
-			global_variable_max_count++;
-		} else if (e->kind == Entity_Procedure && !e->scope->is_global) {
-			if (e->scope->is_init && name == "main") {
-				entry_point = e;
-			}
-			if ((e->Procedure.tags & ProcTag_export) != 0 ||
-			    (e->Procedure.link_name.len > 0) ||
-			    (e->scope->is_file && e->Procedure.link_name.len > 0)) {
-				if (!has_dll_main && name == "DllMain") {
-					has_dll_main = true;
-				} else if (!has_win_main && name == "WinMain") {
-					has_win_main = true;
-				}
-			}
+		if (e->kind == Entity_Procedure && !e->scope->is_global &&
+		    e->scope->is_init && e->token.string == "main") {
+			entry_point = e;
 		}
 	}
 
-
+	timings_begin_sub_section(&global_timings, str_lit("dependency map"));
 	m.entry_point_entity = entry_point;
-	m.min_dep_map = generate_minimum_dependency_map(info, entry_point);
+	m.min_dep_map = generate_minimum_dependency_map(info, entry_point, false);
+	timings_end_sub_section(&global_timings);
+
+	// NOTE: Every symbol is named before anything is built, as procedures may refer to
+	// each other in any order
+	Array<ssaProc *> roots = {0};
+	array_init(&roots, heap_allocator());
+	defer (array_free(&roots));
 
 	for_array(i, info->entities.entries) {
 		auto *entry = &info->entities.entries[i];
@@ -2475,7 +3511,7 @@ bool ssa_generate(Parser *parser, CheckerInfo *info) {
 			continue;
 		}
 
-		if (!scope->is_global) {
+		if (!scope->is_global || is_type_gen_proc(e->type)) {
 			if (e->kind == Entity_Procedure && (e->Procedure.tags & ProcTag_export) != 0) {
 			} else if (e->kind == Entity_Procedure && e->Procedure.link_name.len > 0) {
 				// Handle later
@@ -2485,44 +3521,109 @@ bool ssa_generate(Parser *parser, CheckerInfo *info) {
 			}
 		}
 
-
 		switch (e->kind) {
-		case Entity_TypeName:
+		case Entity_Variable:
+			map_set(&m.entity_names, hash_pointer(e), name);
 			break;
 
-		case Entity_Variable: {
-
-		} break;
-
 		case Entity_Procedure: {
 			ast_node(pd, ProcDecl, decl->proc_decl);
-			String original_name = name;
-			AstNode *body = pd->body;
 			if (e->Procedure.is_foreign) {
 				name = e->token.string; // NOTE(bill): Don't use the mangled name
 			}
 			if (pd->link_name.len > 0) {
 				name = pd->link_name;
 			}
+			map_set(&m.entity_names, hash_pointer(e), name);
 
-			if (e == entry_point) {
-				ssaProc *p = ssa_new_proc(&m, name, e, decl);
-				ssa_build_proc(&m, p);
+			TypeProc *pt = &base_type(e->type)->Proc;
+			if (pd->body == NULL || (pt->is_generic && !pt->is_generic_specialized)) {
+				break;
+			}
+			ssaProc *p = ssa_new_proc(&m, name, e, decl);
+			map_set(&m.unbuilt_procs, hash_pointer(e), p);
+			if (e == entry_point || (e->Procedure.tags & ProcTag_export) != 0) {
+				array_add(&roots, p);
 			}
+		} break;
+		}
+	}
+
+	timings_begin_sub_section(&global_timings, str_lit("build procedures"));
+	// NOTE: The initialisers are only known once everything has been built
+	ssaProc *startup = NULL;
+	if (entry_point != NULL) {
+		startup = ssa_begin_synthetic_proc(&m, str_lit("__$startup_runtime"));
+		m.startup_runtime = startup->entity;
+	}
+	for_array(i, roots) {
+		ssa_request_proc(&m, roots[i]->entity);
+	}
+	for (isize i = 0; i < m.proc_queue.count; i++) {
+		ssaProc *p = m.proc_queue[i];
+		ssa_build_proc(&m, p);
+		ssa_request_references(&m, p);
+		array_add(&m.procs, p);
+	}
+	for_array(i, m.init_procs) {
+		array_add(&m.procs, m.init_procs[i]);
+	}
+	if (startup != NULL) {
+		for_array(i, m.init_procs) {
+			ssaValue *init = ssa_new_value0(startup, ssaOp_Proc, m.init_procs[i]->entity->type);
+			init->entity = m.init_procs[i]->entity;
+			init->comment_string = m.init_procs[i]->name;
+			ssa_new_value1(startup, ssaOp_CallOdin, NULL, init);
+		}
+		ssa_end_synthetic_proc(startup);
+		array_add(&m.procs, startup);
+	}
+	timings_end_sub_section(&global_timings);
 
-			// ssaValue *p = ssa_make_value_procedure(a, m, e, e->type, decl->type_expr, body, name);
-			// p->Proc.tags = pd->tags;
+	// NOTE: A construct the backend cannot build is an error, rather than a body which traps at run time
+	isize value_count = 0;
+	for_array(i, m.procs) {
+		ssaProc *p = m.procs[i];
+		value_count += p->value_id;
+		if (p->unsupported.len > 0) {
+			ssa_error_unsupported(p, p->unsupported_node, p->unsupported);
+		}
+	}
+	if (global_error_collector.count != 0) {
+		return false;
+	}
 
-			// ssa_module_add_value(m, e, p);
-			// HashKey hash_name = hash_string(name);
-			// if (map_get(&m.members, hash_name) == NULL) {
-				// map_set(&m.members, hash_name, p);
-			// }
-		} break;
+	timings_begin_sub_section(&global_timings, str_lit("optimise"));
+	ssa_opt_procs(m.procs);
+	timings_end_sub_section(&global_timings);
+
+	timings_begin_sub_section(&global_timings, str_lit("amd64"));
+	ssa_amd64_init_registers(&m);
+	for_array(i, m.procs) {
+		ssaProc *p = m.procs[i];
+		String what = ssa_amd64_lower_proc(&m, &m.object, p);
+		if (what.len > 0) {
+			ssa_error_unsupported(p, NULL, what);
 		}
 	}
+	timings_end_sub_section(&global_timings);
+	if (global_error_collector.count != 0) {
+		return false;
+	}
 
-	return true;
+	timings_add_counter(&global_timings, str_lit("ssa procedures"), m.procs.count);
+	timings_add_counter(&global_timings, str_lit("ssa values"),     value_count);
+	timings_add_counter(&global_timings, str_lit("ssa globals"),    m.defined_globals.entries.count);
+	timings_add_counter(&global_timings, str_lit("text bytes"),     m.object.sections[ssaObjectSection_Text].count);
+
+	timings_begin_sub_section(&global_timings, str_lit("write object"));
+	isize object_path_len = m.output_base.len + 2;
+	u8 *object_path_text = gb_alloc_array(heap_allocator(), u8, object_path_len+1);
+	defer (gb_free(heap_allocator(), object_path_text));
+	gb_snprintf(cast(char *)object_path_text, object_path_len+1, "%.*s.o", LIT(m.output_base));
+	bool ok = ssa_object_write_elf(&m.object, make_string(object_path_text, object_path_len));
+	timings_end_sub_section(&global_timings);
+	return ok;
 }
 
 
@@ -2552,7 +3653,7 @@ String ssa_mangle_name(ssaModule *m, String path, Entity *e) {
 	isize base_len = ext-1-base;
 
 	isize max_len = base_len + 1 + 10 + 1 + name.len;
-	bool is_overloaded = check_is_entity_overloaded(e);
+	bool is_overloaded = check_is_entity_overloaded(e) || is_type_gen_proc(e->type);
 	if (is_overloaded) {
 		max_len += 21;
 	}
@@ -0,0 +1,1935 @@
+// NOTE: Non-optimising x86-64 (System V) code generation for the custom backend
+//
+// Each procedure is linearised in block order, the register sized values are given
+// registers by a linear scan allocator (Poletto & Sarkar) over conservative live intervals,
+// and then every ssaValue is lowered on its own: its arguments are moved into scratch
+// registers, the operation is performed and the result is moved to its allocated location.
+// Aggregates (strings, slices, records, etc.) always live in a stack slot.
+
+enum ssaAmd64Reg {
+	ssaAmd64_RAX, ssaAmd64_RCX, ssaAmd64_RDX, ssaAmd64_RBX,
+	ssaAmd64_RSP, ssaAmd64_RBP, ssaAmd64_RSI, ssaAmd64_RDI,
+	ssaAmd64_R8,  ssaAmd64_R9,  ssaAmd64_R10, ssaAmd64_R11,
+	ssaAmd64_R12, ssaAmd64_R13, ssaAmd64_R14, ssaAmd64_R15,
+
+	ssaAmd64_XMM0,  ssaAmd64_XMM1,  ssaAmd64_XMM2,  ssaAmd64_XMM3,
+	ssaAmd64_XMM4,  ssaAmd64_XMM5,  ssaAmd64_XMM6,  ssaAmd64_XMM7,
+	ssaAmd64_XMM8,  ssaAmd64_XMM9,  ssaAmd64_XMM10, ssaAmd64_XMM11,
+	ssaAmd64_XMM12, ssaAmd64_XMM13, ssaAmd64_XMM14, ssaAmd64_XMM15,
+
+	ssaAmd64_RegCount,
+};
+
+// NOTE: Scratch registers are never allocated, every lowered value may clobber them
+// R11 is reserved for materialising constants within `ssa_amd64_get`
+#define SSA_AMD64_TMP0  ssaAmd64_RAX
+#define SSA_AMD64_TMP1  ssaAmd64_RCX
+#define SSA_AMD64_TMP2  ssaAmd64_RDX
+#define SSA_AMD64_FTMP0 ssaAmd64_XMM14
+#define SSA_AMD64_FTMP1 ssaAmd64_XMM15
+
+i32 const ssa_amd64_int_arg_regs[6] = {
+	ssaAmd64_RDI, ssaAmd64_RSI, ssaAmd64_RDX, ssaAmd64_RCX, ssaAmd64_R8, ssaAmd64_R9,
+};
+i32 const ssa_amd64_float_arg_reg_count = 8;
+
+enum ssaAmd64Cond {
+	ssaAmd64Cond_B  = 0x2,
+	ssaAmd64Cond_AE = 0x3,
+	ssaAmd64Cond_E  = 0x4,
+	ssaAmd64Cond_NE = 0x5,
+	ssaAmd64Cond_BE = 0x6,
+	ssaAmd64Cond_A  = 0x7,
+	ssaAmd64Cond_S  = 0x8,
+	ssaAmd64Cond_P  = 0xA,
+	ssaAmd64Cond_NP = 0xB,
+	ssaAmd64Cond_L  = 0xC,
+	ssaAmd64Cond_GE = 0xD,
+	ssaAmd64Cond_LE = 0xE,
+	ssaAmd64Cond_G  = 0xF,
+};
+
+bool ssa_amd64_is_float_reg(i32 reg) {
+	return reg >= ssaAmd64_XMM0;
+}
+
+bool ssa_amd64_is_callee_saved(i32 reg) {
+	switch (reg) {
+	case ssaAmd64_RBX:
+	case ssaAmd64_R12:
+	case ssaAmd64_R13:
+	case ssaAmd64_R14:
+	case ssaAmd64_R15:
+		return true;
+	}
+	return false;
+}
+
+// NOTE: Fills in the allocatable registers in order of preference
+void ssa_amd64_init_registers(ssaModule *m) {
+	i32 const regs[] = {
+		ssaAmd64_RSI, ssaAmd64_RDI, ssaAmd64_R8,  ssaAmd64_R9,  ssaAmd64_R10,
+		ssaAmd64_RBX, ssaAmd64_R12, ssaAmd64_R13, ssaAmd64_R14, ssaAmd64_R15,
+	};
+	array_clear(&m->registers);
+	for (isize i = 0; i < gb_count_of(regs); i++) {
+		ssaRegister r = {regs[i], 8};
+		array_add(&m->registers, r);
+	}
+	for (i32 i = ssaAmd64_XMM0; i < SSA_AMD64_FTMP0; i++) {
+		ssaRegister r = {i, 16};
+		array_add(&m->registers, r);
+	}
+}
+
+
+enum ssaAmd64Class {
+	ssaAmd64Class_None,
+	ssaAmd64Class_Int,    // General purpose register
+	ssaAmd64Class_Float,  // SSE register
+	ssaAmd64Class_Memory, // Stack slot
+};
+
+ssaAmd64Class ssa_amd64_type_class(Type *t) {
+	if (t == NULL) {
+		return ssaAmd64Class_None;
+	}
+	t = core_type(default_type(t));
+	switch (t->kind) {
+	case Type_Basic:
+		switch (t->Basic.kind) {
+		case Basic_f32:
+		case Basic_f64:
+			return ssaAmd64Class_Float;
+		case Basic_string:
+		case Basic_any:
+		case Basic_complex64:
+		case Basic_complex128:
+			return ssaAmd64Class_Memory;
+		case Basic_UntypedNil:
+			return ssaAmd64Class_Int;
+		}
+		break;
+	case Type_Pointer:
+	case Type_Proc:
+		return ssaAmd64Class_Int;
+	case Type_Tuple:
+		if (t->Tuple.variable_count == 0) {
+			return ssaAmd64Class_None;
+		}
+		return ssaAmd64Class_Memory;
+	default:
+		return ssaAmd64Class_Memory;
+	}
+
+	i64 size = type_size_of(heap_allocator(), t);
+	switch (size) {
+	case 0:
+		return ssaAmd64Class_None;
+	case 1: case 2: case 4: case 8:
+		return ssaAmd64Class_Int;
+	}
+	return ssaAmd64Class_Memory;
+}
+
+ssaAmd64Class ssa_amd64_value_class(ssaValue *v) {
+	switch (v->op) {
+	case ssaOp_Comment:
+	case ssaOp_Store:
+	case ssaOp_Zero:
+	case ssaOp_Assume:
+	case ssaOp_Trap:
+	case ssaOp_DebugTrap:
+	case ssaOp_BoundsCheck:
+	case ssaOp_SliceBoundsCheck:
+		return ssaAmd64Class_None;
+
+	case ssaOp_Eq8: case ssaOp_Eq16: case ssaOp_Eq32: case ssaOp_Eq64: case ssaOp_EqPtr: case ssaOp_Eq32F: case ssaOp_Eq64F:
+	case ssaOp_Ne8: case ssaOp_Ne16: case ssaOp_Ne32: case ssaOp_Ne64: case ssaOp_NePtr: case ssaOp_Ne32F: case ssaOp_Ne64F:
+	case ssaOp_Lt8: case ssaOp_Lt16: case ssaOp_Lt32: case ssaOp_Lt64: case ssaOp_LtPtr: case ssaOp_Lt32F: case ssaOp_Lt64F:
+	case ssaOp_Gt8: case ssaOp_Gt16: case ssaOp_Gt32: case ssaOp_Gt64: case ssaOp_GtPtr: case ssaOp_Gt32F: case ssaOp_Gt64F:
+	case ssaOp_Le8: case ssaOp_Le16: case ssaOp_Le32: case ssaOp_Le64: case ssaOp_LePtr: case ssaOp_Le32F: case ssaOp_Le64F:
+	case ssaOp_Ge8: case ssaOp_Ge16: case ssaOp_Ge32: case ssaOp_Ge64: case ssaOp_GePtr: case ssaOp_Ge32F: case ssaOp_Ge64F:
+	case ssaOp_NotB: case ssaOp_EqB: case ssaOp_NeB:
+		return ssaAmd64Class_Int;
+	}
+	return ssa_amd64_type_class(v->type);
+}
+
+bool ssa_amd64_is_rematerialized(ssaValue *v) {
+	switch (v->op) {
+	case ssaOp_Local:
+	case ssaOp_Global:
+	case ssaOp_Proc:
+		return true;
+	case ssaOp_ConstBool:
+	case ssaOp_ConstNil:
+	case ssaOp_Const8:
+	case ssaOp_Const16:
+	case ssaOp_Const32:
+	case ssaOp_Const64:
+	case ssaOp_Const32F:
+	case ssaOp_Const64F:
+		return ssa_amd64_value_class(v) != ssaAmd64Class_Memory;
+	}
+	return false;
+}
+
+bool ssa_amd64_is_call(ssaValue *v) {
+	switch (v->op) {
+	case ssaOp_CallOdin:
+	case ssaOp_CallC:
+	case ssaOp_CallStd:
+	case ssaOp_CallFast:
+		return true;
+	}
+	return false;
+}
+
+// NOTE: Aggregate results are written through a hidden pointer passed as the first integer argument
+bool ssa_amd64_returns_memory(Type *proc_type) {
+	TypeProc *pt = &base_type(proc_type)->Proc;
+	if (pt->result_count != 1) {
+		return false;
+	}
+	return ssa_amd64_type_class(pt->results->Tuple.variables[0]->type) == ssaAmd64Class_Memory;
+}
+
+
+enum ssaLocationKind {
+	ssaLocation_None,
+	ssaLocation_Register,
+	ssaLocation_Spill, // 8 bytes at [rbp+offset]
+	ssaLocation_Frame, // The value is the address rbp+offset (locals and aggregates)
+};
+
+struct ssaLocation {
+	ssaLocationKind kind;
+	i32             reg;
+	i32             offset;
+};
+
+struct ssaLiveInterval {
+	ssaValue *value;
+	i32       start;
+	i32       end;
+	bool      is_float;
+	bool      crosses_call;
+};
+
+struct ssaAmd64Fixup {
+	isize     offset; // Position of the rel32
+	ssaBlock *target;
+};
+
+struct ssaAmd64Gen {
+	ssaModule *          module;
+	ssaObject *          object;
+	ssaProc *            proc;
+	Array<u8> *          code;
+
+	Array<ssaBlock *>    order;            // Linearised blocks
+	ssaLocation *        locations;        // Indexed by ssaValue.id
+	i32 *                arg_save_offsets; // Indexed by ssaValue.id, incoming argument slots
+	i32 *                value_pos;        // Indexed by ssaValue.id
+	i32 *                block_start;      // Indexed by ssaBlock.id
+	i32 *                block_end;        // Indexed by ssaBlock.id
+	isize *              block_offsets;    // Indexed by ssaBlock.id
+	Array<ssaAmd64Fixup> fixups;
+	Array<i32>           call_positions;
+
+	i32                  frame_size;
+	bool                 used_regs[ssaAmd64_RegCount];
+	i32                  callee_saved_offsets[ssaAmd64_RegCount];
+	i32                  result_ptr_offset; // Saved hidden result pointer, 0 when there is none
+
+	String               unsupported; // The first value which could not be lowered
+};
+
+
+////////////////////////////////////////////////////////////////
+//
+// Instruction encoding
+//
+////////////////////////////////////////////////////////////////
+
+void ssa_amd64_u8(ssaAmd64Gen *g, u8 x) {
+	array_add(g->code, x);
+}
+void ssa_amd64_u32(ssaAmd64Gen *g, u32 x) {
+	for (isize i = 0; i < 4; i++) {
+		array_add(g->code, cast(u8)(x >> (8*i)));
+	}
+}
+void ssa_amd64_u64(ssaAmd64Gen *g, u64 x) {
+	for (isize i = 0; i < 8; i++) {
+		array_add(g->code, cast(u8)(x >> (8*i)));
+	}
+}
+void ssa_amd64_patch32(ssaAmd64Gen *g, isize at, i32 x) {
+	for (isize i = 0; i < 4; i++) {
+		(*g->code)[at+i] = cast(u8)(cast(u32)x >> (8*i));
+	}
+}
+
+// NOTE: `opcode` holds `opcode_len` bytes, most significant byte first
+void ssa_amd64_opcode(ssaAmd64Gen *g, u32 opcode, isize opcode_len) {
+	for (isize i = opcode_len-1; i >= 0; i--) {
+		ssa_amd64_u8(g, cast(u8)(opcode >> (8*i)));
+	}
+}
+
+// NOTE: `byte_regs` forces a REX prefix so that SPL/BPL/SIL/DIL are used rather than AH/CH/DH/BH
+void ssa_amd64_prefixes(ssaAmd64Gen *g, u8 prefix, bool w, i32 reg, i32 base, bool byte_regs) {
+	if (prefix != 0) {
+		ssa_amd64_u8(g, prefix);
+	}
+	reg &= 15; base &= 15;
+	u8 rex = 0x40;
+	if (w)        rex |= 0x8;
+	if (reg & 8)  rex |= 0x4;
+	if (base & 8) rex |= 0x1;
+	if (rex != 0x40 || (byte_regs && (reg >= 4 || base >= 4))) {
+		ssa_amd64_u8(g, rex);
+	}
+}
+
+// op reg, rm (register direct)
+void ssa_amd64_rr(ssaAmd64Gen *g, u8 prefix, bool w, u32 opcode, isize opcode_len, i32 reg, i32 rm, bool byte_regs = false) {
+	ssa_amd64_prefixes(g, prefix, w, reg, rm, byte_regs);
+	ssa_amd64_opcode(g, opcode, opcode_len);
+	ssa_amd64_u8(g, cast(u8)(0xC0 | ((reg&7)<<3) | (rm&7)));
+}
+
+// op reg, [base+disp]
+void ssa_amd64_rm(ssaAmd64Gen *g, u8 prefix, bool w, u32 opcode, isize opcode_len, i32 reg, i32 base, i32 disp, bool byte_regs = false) {
+	ssa_amd64_prefixes(g, prefix, w, reg, base, byte_regs);
+	ssa_amd64_opcode(g, opcode, opcode_len);
+	bool disp8 = -128 <= disp && disp <= 127;
+	u8 mod = disp8 ? 0x40 : 0x80;
+	if ((base&7) == 4) { // RSP and R12 require a SIB byte
+		ssa_amd64_u8(g, cast(u8)(mod | ((reg&7)<<3) | 4));
+		ssa_amd64_u8(g, 0x24);
+	} else {
+		ssa_amd64_u8(g, cast(u8)(mod | ((reg&7)<<3) | (base&7)));
+	}
+	if (disp8) {
+		ssa_amd64_u8(g, cast(u8)cast(i8)disp);
+	} else {
+		ssa_amd64_u32(g, cast(u32)disp);
+	}
+}
+
+// op reg, [rip+disp32] relocated against `symbol`
+void ssa_amd64_rip(ssaAmd64Gen *g, u8 prefix, bool w, u32 opcode, isize opcode_len, i32 reg, isize symbol, i64 addend) {
+	ssa_amd64_prefixes(g, prefix, w, reg, 0, false);
+	ssa_amd64_opcode(g, opcode, opcode_len);
+	ssa_amd64_u8(g, cast(u8)(((reg&7)<<3) | 5));
+	// NOTE: The displacement is relative to the end of the instruction
+	ssa_object_add_relocation(g->object, ssaObjectSection_Text, g->code->count, symbol, ssaRelocation_PC32, addend-4);
+	ssa_amd64_u32(g, 0);
+}
+
+void ssa_amd64_mov(ssaAmd64Gen *g, i32 dst, i32 src) {
+	if (dst == src) {
+		return;
+	}
+	bool df = ssa_amd64_is_float_reg(dst);
+	bool sf = ssa_amd64_is_float_reg(src);
+	if (!df && !sf) {
+		ssa_amd64_rr(g, 0, true, 0x8B, 1, dst, src);
+	} else if (df && sf) {
+		ssa_amd64_rr(g, 0, false, 0x0F28, 2, dst, src); // movaps
+	} else if (df) {
+		ssa_amd64_rr(g, 0x66, true, 0x0F6E, 2, dst, src); // movq xmm, r64
+	} else {
+		ssa_amd64_rr(g, 0x66, true, 0x0F7E, 2, src, dst); // movq r64, xmm
+	}
+}
+
+void ssa_amd64_mov_imm(ssaAmd64Gen *g, i32 reg, u64 imm) {
+	GB_ASSERT(!ssa_amd64_is_float_reg(reg));
+	if (imm == 0) {
+		ssa_amd64_rr(g, 0, false, 0x33, 1, reg, reg); // xor r32, r32
+	} else if (imm <= 0xffffffffull) {
+		ssa_amd64_prefixes(g, 0, false, 0, reg, false);
+		ssa_amd64_u8(g, cast(u8)(0xB8 + (reg&7)));
+		ssa_amd64_u32(g, cast(u32)imm);
+	} else if (cast(i64)imm >= -0x80000000ll && cast(i64)imm < 0) {
+		ssa_amd64_prefixes(g, 0, true, 0, reg, false);
+		ssa_amd64_u8(g, 0xC7);
+		ssa_amd64_u8(g, cast(u8)(0xC0 | (reg&7)));
+		ssa_amd64_u32(g, cast(u32)imm);
+	} else {
+		ssa_amd64_prefixes(g, 0, true, 0, reg, false);
+		ssa_amd64_u8(g, cast(u8)(0xB8 + (reg&7)));
+		ssa_amd64_u64(g, imm);
+	}
+}
+
+void ssa_amd64_lea(ssaAmd64Gen *g, i32 reg, i32 base, i32 disp) {
+	ssa_amd64_rm(g, 0, true, 0x8D, 1, reg, base, disp);
+}
+
+// NOTE: Loads are zero extended to the full register
+void ssa_amd64_load(ssaAmd64Gen *g, i64 size, i32 reg, i32 base, i32 disp) {
+	if (ssa_amd64_is_float_reg(reg)) {
+		ssa_amd64_rm(g, size == 4 ? 0xF3 : 0xF2, false, 0x0F10, 2, reg, base, disp); // movss/movsd
+		return;
+	}
+	switch (size) {
+	case 1: ssa_amd64_rm(g, 0, false, 0x0FB6, 2, reg, base, disp); break; // movzx r32, m8
+	case 2: ssa_amd64_rm(g, 0, false, 0x0FB7, 2, reg, base, disp); break; // movzx r32, m16
+	case 4: ssa_amd64_rm(g, 0, false, 0x8B,   1, reg, base, disp); break;
+	case 8: ssa_amd64_rm(g, 0, true,  0x8B,   1, reg, base, disp); break;
+	default: GB_PANIC("Invalid load size %lld", cast(long long)size); break;
+	}
+}
+
+void ssa_amd64_store(ssaAmd64Gen *g, i64 size, i32 base, i32 disp, i32 reg) {
+	if (ssa_amd64_is_float_reg(reg)) {
+		ssa_amd64_rm(g, size == 4 ? 0xF3 : 0xF2, false, 0x0F11, 2, reg, base, disp); // movss/movsd
+		return;
+	}
+	switch (size) {
+	case 1: ssa_amd64_rm(g, 0,    false, 0x88, 1, reg, base, disp, true); break;
+	case 2: ssa_amd64_rm(g, 0x66, false, 0x89, 1, reg, base, disp); break;
+	case 4: ssa_amd64_rm(g, 0,    false, 0x89, 1, reg, base, disp); break;
+	case 8: ssa_amd64_rm(g, 0,    true,  0x89, 1, reg, base, disp); break;
+	default: GB_PANIC("Invalid store size %lld", cast(long long)size); break;
+	}
+}
+
+// NOTE: Extends the low `size` bytes of `reg` to 64 bits
+void ssa_amd64_extend(ssaAmd64Gen *g, i32 reg, i64 size, bool is_signed) {
+	if (is_signed) {
+		switch (size) {
+		case 1: ssa_amd64_rr(g, 0, true, 0x0FBE, 2, reg, reg, true); break; // movsx r64, r8
+		case 2: ssa_amd64_rr(g, 0, true, 0x0FBF, 2, reg, reg);       break; // movsx r64, r16
+		case 4: ssa_amd64_rr(g, 0, true, 0x63,   1, reg, reg);       break; // movsxd r64, r32
+		}
+	} else {
+		switch (size) {
+		case 1: ssa_amd64_rr(g, 0, false, 0x0FB6, 2, reg, reg, true); break; // movzx r32, r8
+		case 2: ssa_amd64_rr(g, 0, false, 0x0FB7, 2, reg, reg);       break; // movzx r32, r16
+		case 4: ssa_amd64_rr(g, 0, false, 0x8B,   1, reg, reg);       break; // mov r32, r32
+		}
+	}
+}
+
+// NOTE: `opcode` is the `op r, r/m` form: 0x03 add, 0x0B or, 0x23 and, 0x2B sub, 0x33 xor, 0x3B cmp
+void ssa_amd64_alu(ssaAmd64Gen *g, u8 opcode, i64 size, i32 dst, i32 src) {
+	switch (size) {
+	case 1: ssa_amd64_rr(g, 0,    false, opcode-1, 1, dst, src, true); break;
+	case 2: ssa_amd64_rr(g, 0x66, false, opcode,   1, dst, src); break;
+	case 4: ssa_amd64_rr(g, 0,    false, opcode,   1, dst, src); break;
+	default: ssa_amd64_rr(g, 0,   true,  opcode,   1, dst, src); break;
+	}
+}
+
+// NOTE: `ext` is the /digit of the 0x81 group: 0 add, 1 or, 4 and, 5 sub, 6 xor, 7 cmp
+void ssa_amd64_alu_imm(ssaAmd64Gen *g, i32 ext, i32 reg, i32 imm) {
+	ssa_amd64_rr(g, 0, true, 0x81, 1, ext, reg);
+	ssa_amd64_u32(g, cast(u32)imm);
+}
+
+// NOTE: `ext` is the /digit of the 0xF7 group: 2 not, 3 neg, 6 div, 7 idiv
+void ssa_amd64_unary(ssaAmd64Gen *g, i32 ext, i32 reg) {
+	ssa_amd64_rr(g, 0, true, 0xF7, 1, ext, reg);
+}
+
+void ssa_amd64_setcc(ssaAmd64Gen *g, ssaAmd64Cond cc, i32 reg) {
+	ssa_amd64_rr(g, 0, false, 0x0F90 | cc, 2, 0, reg, true);
+}
+
+// NOTE: Returns the position of the rel8 to patch
+isize ssa_amd64_jcc8(ssaAmd64Gen *g, ssaAmd64Cond cc) {
+	ssa_amd64_u8(g, cast(u8)(0x70 | cc));
+	ssa_amd64_u8(g, 0);
+	return g->code->count-1;
+}
+isize ssa_amd64_jmp8(ssaAmd64Gen *g) {
+	ssa_amd64_u8(g, 0xEB);
+	ssa_amd64_u8(g, 0);
+	return g->code->count-1;
+}
+void ssa_amd64_patch8(ssaAmd64Gen *g, isize at) {
+	isize rel = g->code->count - (at+1);
+	GB_ASSERT(rel >= -128 && rel <= 127);
+	(*g->code)[at] = cast(u8)cast(i8)rel;
+}
+
+void ssa_amd64_jump(ssaAmd64Gen *g, ssaBlock *target) {
+	ssa_amd64_u8(g, 0xE9);
+	ssaAmd64Fixup f = {g->code->count, target};
+	array_add(&g->fixups, f);
+	ssa_amd64_u32(g, 0);
+}
+
+void ssa_amd64_jcc(ssaAmd64Gen *g, ssaAmd64Cond cc, ssaBlock *target) {
+	ssa_amd64_u8(g, 0x0F);
+	ssa_amd64_u8(g, cast(u8)(0x80 | cc));
+	ssaAmd64Fixup f = {g->code->count, target};
+	array_add(&g->fixups, f);
+	ssa_amd64_u32(g, 0);
+}
+
+void ssa_amd64_push(ssaAmd64Gen *g, i32 reg) {
+	ssa_amd64_prefixes(g, 0, false, 0, reg, false);
+	ssa_amd64_u8(g, cast(u8)(0x50 + (reg&7)));
+}
+void ssa_amd64_pop(ssaAmd64Gen *g, i32 reg) {
+	ssa_amd64_prefixes(g, 0, false, 0, reg, false);
+	ssa_amd64_u8(g, cast(u8)(0x58 + (reg&7)));
+}
+
+// NOTE: `opcode` is the 0x0F?? SSE opcode, `size` selects the ss (4) or sd (8) form
+void ssa_amd64_sse(ssaAmd64Gen *g, u32 opcode, i64 size, i32 dst, i32 src, bool w = false) {
+	ssa_amd64_rr(g, size == 4 ? 0xF3 : 0xF2, w, opcode, 2, dst, src);
+}
+
+void ssa_amd64_ucomis(ssaAmd64Gen *g, i64 size, i32 a, i32 b) {
+	ssa_amd64_rr(g, size == 4 ? 0 : 0x66, false, 0x0F2E, 2, a, b);
+}
+
+void ssa_amd64_float_const(ssaAmd64Gen *g, i32 reg, i64 size, f64 value) {
+	u64 bits = 0;
+	if (size == 4) {
+		f32 f = cast(f32)value;
+		bits = *cast(u32 *)&f;
+	} else {
+		bits = *cast(u64 *)&value;
+	}
+	ssa_amd64_mov_imm(g, ssaAmd64_R11, bits);
+	ssa_amd64_mov(g, reg, ssaAmd64_R11);
+}
+
+// NOTE: Copies `size` bytes from [src] to [dst], clobbering RAX and R11
+void ssa_amd64_copy(ssaAmd64Gen *g, i32 dst, i32 src, i64 size) {
+	i64 offset = 0;
+	if (size >= 128) {
+		// NOTE: A loop is used for large copies so the code does not explode
+		ssa_amd64_mov_imm(g, ssaAmd64_R11, size/8);
+		isize loop = g->code->count;
+		ssa_amd64_load(g, 8, ssaAmd64_RAX, src, 0);
+		ssa_amd64_store(g, 8, dst, 0, ssaAmd64_RAX);
+		ssa_amd64_alu_imm(g, 0, src, 8);
+		ssa_amd64_alu_imm(g, 0, dst, 8);
+		ssa_amd64_alu_imm(g, 5, ssaAmd64_R11, 1);
+		ssa_amd64_u8(g, 0x0F);
+		ssa_amd64_u8(g, 0x80 | ssaAmd64Cond_NE);
+		ssa_amd64_u32(g, cast(u32)cast(i32)(loop - (g->code->count+4)));
+		size = size%8; // NOTE: `src` and `dst` now point to the remainder
+	}
+	for (i64 chunk = 8; chunk > 0; chunk /= 2) {
+		while (size >= chunk) {
+			ssa_amd64_load(g, chunk, ssaAmd64_RAX, src, cast(i32)offset);
+			ssa_amd64_store(g, chunk, dst, cast(i32)offset, ssaAmd64_RAX);
+			offset += chunk;
+			size -= chunk;
+		}
+	}
+}
+
+// NOTE: Zeroes `size` bytes at [dst], clobbering RAX and R11
+void ssa_amd64_zero(ssaAmd64Gen *g, i32 dst, i64 size) {
+	i64 offset = 0;
+	ssa_amd64_mov_imm(g, ssaAmd64_RAX, 0);
+	if (size >= 128) {
+		ssa_amd64_mov_imm(g, ssaAmd64_R11, size/8);
+		isize loop = g->code->count;
+		ssa_amd64_store(g, 8, dst, 0, ssaAmd64_RAX);
+		ssa_amd64_alu_imm(g, 0, dst, 8);
+		ssa_amd64_alu_imm(g, 5, ssaAmd64_R11, 1);
+		ssa_amd64_u8(g, 0x0F);
+		ssa_amd64_u8(g, 0x80 | ssaAmd64Cond_NE);
+		ssa_amd64_u32(g, cast(u32)cast(i32)(loop - (g->code->count+4)));
+		size = size%8;
+	}
+	for (i64 chunk = 8; chunk > 0; chunk /= 2) {
+		while (size >= chunk) {
+			ssa_amd64_store(g, chunk, dst, cast(i32)offset, ssaAmd64_RAX);
+			offset += chunk;
+			size -= chunk;
+		}
+	}
+}
+
+
+////////////////////////////////////////////////////////////////
+//
+// Register allocation
+//
+////////////////////////////////////////////////////////////////
+
+i32 ssa_amd64_alloc_frame(ssaAmd64Gen *g, i64 size, i64 align) {
+	align = gb_clamp(align, 1, 16);
+	g->frame_size = cast(i32)align_formula(g->frame_size + size, align);
+	return -g->frame_size;
+}
+
+void ssa_amd64_linearise(ssaAmd64Gen *g) {
+	ssaProc *p = g->proc;
+	i32 pos = 0;
+	for_array(i, p->blocks) {
+		ssaBlock *b = p->blocks[i];
+		if (b->proc == NULL) {
+			continue; // NOTE: Cleared block
+		}
+		array_add(&g->order, b);
+
+		g->block_start[b->id] = pos;
+		pos += 2;
+		for_array(j, b->values) {
+			ssaValue *v = b->values[j];
+			if (v->op == ssaOp_Phi) {
+				g->value_pos[v->id] = g->block_start[b->id];
+				continue;
+			}
+			g->value_pos[v->id] = pos;
+			if (ssa_amd64_is_call(v)) {
+				array_add(&g->call_positions, pos);
+			}
+			pos += 2;
+		}
+		g->block_end[b->id] = pos;
+		pos += 2;
+	}
+}
+
+void ssa_amd64_bitset_set(u64 *set, isize i) {
+	set[i/64] |= 1ull << (i%64);
+}
+bool ssa_amd64_bitset_get(u64 *set, isize i) {
+	return (set[i/64] & (1ull << (i%64))) != 0;
+}
+
+// NOTE: Live intervals are the conservative hull [first def, last use] extended over every
+// block the value is live in or out of, so loops are covered without interval holes
+void ssa_amd64_build_intervals(ssaAmd64Gen *g, Array<ssaLiveInterval> *intervals) {
+	ssaProc *p = g->proc;
+	gbAllocator a = heap_allocator();
+	isize value_count = p->value_id;
+	isize block_count = p->block_id;
+	isize words = (value_count+63)/64;
+
+	u64 *live_in  = gb_alloc_array(a, u64, words*block_count);
+	u64 *live_out = gb_alloc_array(a, u64, words*block_count);
+	u64 *gen      = gb_alloc_array(a, u64, words*block_count);
+	u64 *kill     = gb_alloc_array(a, u64, words*block_count);
+	defer (gb_free(a, live_in));
+	defer (gb_free(a, live_out));
+	defer (gb_free(a, gen));
+	defer (gb_free(a, kill));
+	gb_zero_size(live_in,  gb_size_of(u64)*words*block_count);
+	gb_zero_size(live_out, gb_size_of(u64)*words*block_count);
+	gb_zero_size(gen,      gb_size_of(u64)*words*block_count);
+	gb_zero_size(kill,     gb_size_of(u64)*words*block_count);
+
+	for_array(i, g->order) {
+		ssaBlock *b = g->order[i];
+		u64 *bgen  = gen  + words*b->id;
+		u64 *bkill = kill + words*b->id;
+		for_array(j, b->values) {
+			ssaValue *v = b->values[j];
+			if (v->op != ssaOp_Phi) {
+				for_array(k, v->args) {
+					ssaValue *arg = v->args[k];
+					if (!ssa_amd64_bitset_get(bkill, arg->id)) {
+						ssa_amd64_bitset_set(bgen, arg->id);
+					}
+				}
+			}
+			ssa_amd64_bitset_set(bkill, v->id);
+		}
+		if (b->control != NULL && !ssa_amd64_bitset_get(bkill, b->control->id)) {
+			ssa_amd64_bitset_set(bgen, b->control->id);
+		}
+	}
+
+	for (bool changed = true; changed; ) {
+		changed = false;
+		for (isize i = g->order.count-1; i >= 0; i--) {
+			ssaBlock *b = g->order[i];
+			u64 *out = live_out + words*b->id;
+			u64 *in  = live_in  + words*b->id;
+			for_array(j, b->succs) {
+				ssaBlock *s = b->succs[j].block;
+				isize edge = b->succs[j].index;
+				u64 *sin = live_in + words*s->id;
+				for (isize w = 0; w < words; w++) {
+					out[w] |= sin[w];
+				}
+				for_array(k, s->values) {
+					ssaValue *phi = s->values[k];
+					if (phi->op == ssaOp_Phi && edge < phi->args.count) {
+						ssa_amd64_bitset_set(out, phi->args[edge]->id);
+					}
+				}
+			}
+			u64 *bgen  = gen  + words*b->id;
+			u64 *bkill = kill + words*b->id;
+			for (isize w = 0; w < words; w++) {
+				u64 x = bgen[w] | (out[w] & ~bkill[w]);
+				if (x != in[w]) {
+					in[w] = x;
+					changed = true;
+				}
+			}
+		}
+	}
+
+	i32 *start = gb_alloc_array(a, i32, value_count);
+	i32 *end   = gb_alloc_array(a, i32, value_count);
+	defer (gb_free(a, start));
+	defer (gb_free(a, end));
+	for (isize i = 0; i < value_count; i++) {
+		start[i] = I32_MAX;
+		end[i]   = -1;
+	}
+
+	for_array(i, g->order) {
+		ssaBlock *b = g->order[i];
+		for_array(j, b->values) {
+			ssaValue *v = b->values[j];
+			i32 pos = g->value_pos[v->id];
+			start[v->id] = gb_min(start[v->id], pos);
+			end[v->id]   = gb_max(end[v->id], pos);
+			if (v->op == ssaOp_Phi) {
+				for_array(k, v->args) {
+					ssaBlock *pred = b->preds[k].block;
+					ssaValue *arg = v->args[k];
+					end[arg->id] = gb_max(end[arg->id], g->block_end[pred->id]);
+				}
+			} else {
+				for_array(k, v->args) {
+					ssaValue *arg = v->args[k];
+					end[arg->id] = gb_max(end[arg->id], pos);
+				}
+			}
+		}
+		if (b->control != NULL) {
+			end[b->control->id] = gb_max(end[b->control->id], g->block_end[b->id]);
+		}
+
+		u64 *in  = live_in  + words*b->id;
+		u64 *out = live_out + words*b->id;
+		for (isize id = 0; id < value_count; id++) {
+			if (ssa_amd64_bitset_get(in, id)) {
+				start[id] = gb_min(start[id], g->block_start[b->id]);
+				end[id]   = gb_max(end[id], g->block_start[b->id]);
+			}
+			if (ssa_amd64_bitset_get(out, id)) {
+				end[id] = gb_max(end[id], g->block_end[b->id]);
+			}
+		}
+	}
+
+	for_array(i, g->order) {
+		ssaBlock *b = g->order[i];
+		for_array(j, b->values) {
+			ssaValue *v = b->values[j];
+			ssaAmd64Class c = ssa_amd64_value_class(v);
+			if (c != ssaAmd64Class_Int && c != ssaAmd64Class_Float) {
+				continue;
+			}
+			if (ssa_amd64_is_rematerialized(v) || v->op == ssaOp_Arg) {
+				continue;
+			}
+			ssaLiveInterval interval = {};
+			interval.value    = v;
+			interval.start    = start[v->id];
+			interval.end      = end[v->id];
+			interval.is_float = c == ssaAmd64Class_Float;
+			for_array(k, g->call_positions) {
+				i32 call = g->call_positions[k];
+				if (interval.start < call && call < interval.end) {
+					interval.crosses_call = true;
+					break;
+				}
+			}
+			array_add(intervals, interval);
+		}
+	}
+}
+
+GB_COMPARE_PROC(ssa_amd64_interval_cmp) {
+	ssaLiveInterval *x = cast(ssaLiveInterval *)a;
+	ssaLiveInterval *y = cast(ssaLiveInterval *)b;
+	if (x->start != y->start) {
+		return x->start < y->start ? -1 : +1;
+	}
+	return x->value->id < y->value->id ? -1 : +1;
+}
+
+void ssa_amd64_spill(ssaAmd64Gen *g, ssaValue *v) {
+	ssaLocation l = {ssaLocation_Spill};
+	l.offset = ssa_amd64_alloc_frame(g, 8, 8);
+	g->locations[v->id] = l;
+}
+
+bool ssa_amd64_reg_allowed(ssaLiveInterval *it, ssaRegister r) {
+	if (it->is_float != ssa_amd64_is_float_reg(r.id)) {
+		return false;
+	}
+	if (it->crosses_call && !ssa_amd64_is_callee_saved(r.id)) {
+		return false;
+	}
+	return true;
+}
+
+void ssa_amd64_linear_scan(ssaAmd64Gen *g, Array<ssaLiveInterval> *intervals) {
+	Array<ssaRegister> *registers = &g->module->registers;
+	gb_sort_array(intervals->data, intervals->count, ssa_amd64_interval_cmp);
+
+	ssaLiveInterval *reg_owner[ssaAmd64_RegCount] = {};
+	Array<ssaLiveInterval *> active = {};
+	array_init(&active, heap_allocator());
+	defer (array_free(&active));
+
+	for_array(i, *intervals) {
+		ssaLiveInterval *it = &(*intervals)[i];
+
+		// Expire the old intervals
+		for (isize j = 0; j < active.count; /**/) {
+			ssaLiveInterval *old = active[j];
+			if (old->end <= it->start) {
+				reg_owner[g->locations[old->value->id].reg] = NULL;
+				active[j] = active[active.count-1];
+				array_pop(&active);
+			} else {
+				j++;
+			}
+		}
+
+		i32 reg = -1;
+		for_array(j, *registers) {
+			ssaRegister r = (*registers)[j];
+			if (reg_owner[r.id] == NULL && ssa_amd64_reg_allowed(it, r)) {
+				reg = r.id;
+				break;
+			}
+		}
+
+		if (reg < 0) {
+			// NOTE: Spill whichever of the conflicting intervals ends last
+			ssaLiveInterval *victim = NULL;
+			for_array(j, active) {
+				ssaLiveInterval *other = active[j];
+				ssaRegister r = {g->locations[other->value->id].reg};
+				if (!ssa_amd64_reg_allowed(it, r)) {
+					continue;
+				}
+				if (victim == NULL || other->end > victim->end) {
+					victim = other;
+				}
+			}
+			if (victim == NULL || victim->end <= it->end) {
+				ssa_amd64_spill(g, it->value);
+				continue;
+			}
+			reg = g->locations[victim->value->id].reg;
+			ssa_amd64_spill(g, victim->value);
+			for_array(j, active) {
+				if (active[j] == victim) {
+					active[j] = active[active.count-1];
+					array_pop(&active);
+					break;
+				}
+			}
+		}
+
+		ssaLocation l = {ssaLocation_Register};
+		l.reg = reg;
+		g->locations[it->value->id] = l;
+		g->used_regs[reg] = true;
+		reg_owner[reg] = it;
+		array_add(&active, it);
+	}
+}
+
+void ssa_amd64_assign_locations(ssaAmd64Gen *g) {
+	ssaProc *p = g->proc;
+	gbAllocator a = heap_allocator();
+
+	// NOTE: Incoming arguments are saved to the frame in the prologue, so that the argument
+	// registers are free for allocation
+	isize int_index = 0;
+	isize float_index = 0;
+	isize stack_index = 0;
+	if (ssa_amd64_returns_memory(p->entity->type)) {
+		g->result_ptr_offset = ssa_amd64_alloc_frame(g, 8, 8);
+		int_index++;
+	}
+	for_array(i, g->order) {
+		ssaBlock *b = g->order[i];
+		for_array(j, b->values) {
+			ssaValue *v = b->values[j];
+			ssaAmd64Class c = ssa_amd64_value_class(v);
+			if (v->op == ssaOp_Arg) {
+				bool in_reg = false;
+				if (c == ssaAmd64Class_Float) {
+					in_reg = float_index < ssa_amd64_float_arg_reg_count;
+					float_index += in_reg;
+				} else {
+					in_reg = int_index < gb_count_of(ssa_amd64_int_arg_regs);
+					int_index += in_reg;
+				}
+				if (in_reg) {
+					g->arg_save_offsets[v->id] = ssa_amd64_alloc_frame(g, 8, 8);
+				} else {
+					g->arg_save_offsets[v->id] = cast(i32)(16 + 8*stack_index++);
+				}
+				if (c != ssaAmd64Class_Memory) {
+					ssaLocation l = {ssaLocation_Spill};
+					l.offset = g->arg_save_offsets[v->id];
+					g->locations[v->id] = l;
+					continue;
+				}
+			}
+
+			if (v->op == ssaOp_Local) {
+				Type *t = type_deref(v->type);
+				ssaLocation l = {ssaLocation_Frame};
+				l.offset = ssa_amd64_alloc_frame(g, type_size_of(a, t), type_align_of(a, t));
+				g->locations[v->id] = l;
+			} else if (c == ssaAmd64Class_Memory) {
+				Type *t = default_type(v->type);
+				ssaLocation l = {ssaLocation_Frame};
+				l.offset = ssa_amd64_alloc_frame(g, type_size_of(a, t), type_align_of(a, t));
+				g->locations[v->id] = l;
+			}
+		}
+	}
+
+	Array<ssaLiveInterval> intervals = {};
+	array_init(&intervals, a);
+	defer (array_free(&intervals));
+	ssa_amd64_build_intervals(g, &intervals);
+	ssa_amd64_linear_scan(g, &intervals);
+
+	for (i32 reg = 0; reg < ssaAmd64_RegCount; reg++) {
+		if (g->used_regs[reg] && ssa_amd64_is_callee_saved(reg)) {
+			g->callee_saved_offsets[reg] = ssa_amd64_alloc_frame(g, 8, 8);
+		}
+	}
+	g->frame_size = cast(i32)align_formula(g->frame_size, 16);
+}
+
+
+////////////////////////////////////////////////////////////////
+//
+// Lowering
+//
+////////////////////////////////////////////////////////////////
+
+String ssa_amd64_symbol_name(ssaModule *m, Entity *e) {
+	String *found = map_get(&m->entity_names, hash_pointer(e));
+	if (found != NULL) {
+		return *found;
+	}
+	return e->token.string;
+}
+
+// NOTE: Moves the value of `v` into `reg`, aggregates produce their address
+void ssa_amd64_get(ssaAmd64Gen *g, ssaValue *v, i32 reg) {
+	if (ssa_amd64_is_rematerialized(v)) {
+		ExactValue ev = v->exact_value;
+		switch (v->op) {
+		case ssaOp_Local:
+			ssa_amd64_lea(g, reg, ssaAmd64_RBP, g->locations[v->id].offset);
+			return;
+		case ssaOp_ConstBool:
+			ssa_amd64_mov_imm(g, reg, ev.value_bool ? 1 : 0);
+			return;
+		case ssaOp_ConstNil:
+			if (ssa_amd64_is_float_reg(reg)) {
+				ssa_amd64_rr(g, 0, false, 0x0F57, 2, reg, reg); // xorps
+			} else {
+				ssa_amd64_mov_imm(g, reg, 0);
+			}
+			return;
+		case ssaOp_Const8:
+		case ssaOp_Const16:
+		case ssaOp_Const32:
+		case ssaOp_Const64:
+			ssa_amd64_mov_imm(g, reg, cast(u64)big_int_to_i64(ev.value_integer));
+			return;
+		case ssaOp_Const32F:
+			ssa_amd64_float_const(g, reg, 4, ev.value_float);
+			return;
+		case ssaOp_Const64F:
+			ssa_amd64_float_const(g, reg, 8, ev.value_float);
+			return;
+		case ssaOp_Global:
+		case ssaOp_Proc: {
+			isize symbol = ssa_object_get_symbol(g->object, ssa_amd64_symbol_name(g->module, v->entity));
+			ssa_amd64_rip(g, 0, true, 0x8D, 1, reg, symbol, 0); // lea reg, [rip+symbol]
+		} return;
+		}
+	}
+
+	ssaLocation l = g->locations[v->id];
+	switch (l.kind) {
+	case ssaLocation_Register:
+		ssa_amd64_mov(g, reg, l.reg);
+		break;
+	case ssaLocation_Spill:
+		ssa_amd64_load(g, 8, reg, ssaAmd64_RBP, l.offset);
+		break;
+	case ssaLocation_Frame:
+		ssa_amd64_lea(g, reg, ssaAmd64_RBP, l.offset);
+		break;
+	default:
+		GB_PANIC("ssa_amd64_get: v%d (%.*s) has no location", v->id, LIT(ssa_op_strings[v->op]));
+		break;
+	}
+}
+
+// NOTE: Moves `reg` into the location of `v`, aggregates must be copied with `ssa_amd64_copy`
+void ssa_amd64_set(ssaAmd64Gen *g, ssaValue *v, i32 reg) {
+	ssaLocation l = g->locations[v->id];
+	switch (l.kind) {
+	case ssaLocation_Register:
+		ssa_amd64_mov(g, l.reg, reg);
+		break;
+	case ssaLocation_Spill:
+		ssa_amd64_store(g, 8, ssaAmd64_RBP, l.offset, reg);
+		break;
+	case ssaLocation_None:
+		break;
+	default:
+		GB_PANIC("ssa_amd64_set: v%d (%.*s) is not register sized", v->id, LIT(ssa_op_strings[v->op]));
+		break;
+	}
+}
+
+i64 ssa_amd64_size_of(Type *t) {
+	return type_size_of(heap_allocator(), default_type(t));
+}
+
+bool ssa_amd64_is_signed(Type *t) {
+	t = core_type(default_type(t));
+	return is_type_integer(t) && !is_type_unsigned(t);
+}
+
+i64 ssa_amd64_field_offset(Type *t, i64 index) {
+	t = base_type(t);
+	if (t->kind == Type_Map) {
+		t = t->Map.generated_struct_type;
+	}
+	return type_offset_of(heap_allocator(), t, cast(i32)index);
+}
+
+void ssa_amd64_int_binary(ssaAmd64Gen *g, ssaValue *v, u8 opcode) {
+	ssa_amd64_get(g, v->args[0], SSA_AMD64_TMP0);
+	ssa_amd64_get(g, v->args[1], SSA_AMD64_TMP1);
+	// NOTE: The low bits of add, sub, and, or and xor do not depend on the upper bits
+	ssa_amd64_alu(g, opcode, 8, SSA_AMD64_TMP0, SSA_AMD64_TMP1);
+	ssa_amd64_set(g, v, SSA_AMD64_TMP0);
+}
+
+void ssa_amd64_div(ssaAmd64Gen *g, ssaValue *v, bool is_signed, bool is_mod) {
+	i64 size = ssa_amd64_size_of(v->type);
+	ssa_amd64_get(g, v->args[0], SSA_AMD64_TMP0);
+	ssa_amd64_get(g, v->args[1], SSA_AMD64_TMP1);
+	// NOTE: Smaller sizes are widened to 64 bits, the quotient and remainder still fit
+	ssa_amd64_extend(g, SSA_AMD64_TMP0, size, is_signed);
+	ssa_amd64_extend(g, SSA_AMD64_TMP1, size, is_signed);
+	if (is_signed) {
+		ssa_amd64_u8(g, 0x48); ssa_amd64_u8(g, 0x99); // cqo
+		ssa_amd64_unary(g, 7, SSA_AMD64_TMP1);
+	} else {
+		ssa_amd64_mov_imm(g, ssaAmd64_RDX, 0);
+		ssa_amd64_unary(g, 6, SSA_AMD64_TMP1);
+	}
+	ssa_amd64_set(g, v, is_mod ? ssaAmd64_RDX : ssaAmd64_RAX);
+}
+
+void ssa_amd64_shift(ssaAmd64Gen *g, ssaValue *v, i32 ext, i64 size, bool is_signed) {
+	ssa_amd64_get(g, v->args[0], SSA_AMD64_TMP0);
+	ssa_amd64_get(g, v->args[1], ssaAmd64_RCX);
+	if (ext != 4) { // NOTE: Right shifts need the full width value
+		ssa_amd64_extend(g, SSA_AMD64_TMP0, size, is_signed);
+	}
+	ssa_amd64_rr(g, 0, true, 0xD3, 1, ext, SSA_AMD64_TMP0); // shl/shr/sar r64, cl
+	ssa_amd64_set(g, v, SSA_AMD64_TMP0);
+}
+
+void ssa_amd64_int_compare(ssaAmd64Gen *g, ssaValue *v, ssaAmd64Cond signed_cc, ssaAmd64Cond unsigned_cc) {
+	Type *t = v->args[0]->type;
+	i64 size = ssa_amd64_size_of(t);
+	if (size > 8) {
+		size = 8;
+	}
+	ssa_amd64_get(g, v->args[0], SSA_AMD64_TMP0);
+	ssa_amd64_get(g, v->args[1], SSA_AMD64_TMP1);
+	ssa_amd64_alu(g, 0x3B, size, SSA_AMD64_TMP0, SSA_AMD64_TMP1);
+	ssa_amd64_setcc(g, ssa_amd64_is_signed(t) ? signed_cc : unsigned_cc, SSA_AMD64_TMP0);
+	ssa_amd64_extend(g, SSA_AMD64_TMP0, 1, false);
+	ssa_amd64_set(g, v, SSA_AMD64_TMP0);
+}
+
+void ssa_amd64_float_compare(ssaAmd64Gen *g, ssaValue *v, TokenKind op, i64 size) {
+	ssa_amd64_get(g, v->args[0], SSA_AMD64_FTMP0);
+	ssa_amd64_get(g, v->args[1], SSA_AMD64_FTMP1);
+	switch (op) {
+	case Token_CmpEq:
+		ssa_amd64_ucomis(g, size, SSA_AMD64_FTMP0, SSA_AMD64_FTMP1);
+		ssa_amd64_setcc(g, ssaAmd64Cond_E,  SSA_AMD64_TMP0);
+		ssa_amd64_setcc(g, ssaAmd64Cond_NP, SSA_AMD64_TMP1);
+		ssa_amd64_alu(g, 0x23, 1, SSA_AMD64_TMP0, SSA_AMD64_TMP1);
+		break;
+	case Token_NotEq:
+		ssa_amd64_ucomis(g, size, SSA_AMD64_FTMP0, SSA_AMD64_FTMP1);
+		ssa_amd64_setcc(g, ssaAmd64Cond_NE, SSA_AMD64_TMP0);
+		ssa_amd64_setcc(g, ssaAmd64Cond_P,  SSA_AMD64_TMP1);
+		ssa_amd64_alu(g, 0x0B, 1, SSA_AMD64_TMP0, SSA_AMD64_TMP1);
+		break;
+	// NOTE: Only the "above" conditions are false for unordered operands
+	case Token_Gt:
+		ssa_amd64_ucomis(g, size, SSA_AMD64_FTMP0, SSA_AMD64_FTMP1);
+		ssa_amd64_setcc(g, ssaAmd64Cond_A, SSA_AMD64_TMP0);
+		break;
+	case Token_GtEq:
+		ssa_amd64_ucomis(g, size, SSA_AMD64_FTMP0, SSA_AMD64_FTMP1);
+		ssa_amd64_setcc(g, ssaAmd64Cond_AE, SSA_AMD64_TMP0);
+		break;
+	case Token_Lt:
+		ssa_amd64_ucomis(g, size, SSA_AMD64_FTMP1, SSA_AMD64_FTMP0);
+		ssa_amd64_setcc(g, ssaAmd64Cond_A, SSA_AMD64_TMP0);
+		break;
+	case Token_LtEq:
+		ssa_amd64_ucomis(g, size, SSA_AMD64_FTMP1, SSA_AMD64_FTMP0);
+		ssa_amd64_setcc(g, ssaAmd64Cond_AE, SSA_AMD64_TMP0);
+		break;
+	}
+	ssa_amd64_extend(g, SSA_AMD64_TMP0, 1, false);
+	ssa_amd64_set(g, v, SSA_AMD64_TMP0);
+}
+
+void ssa_amd64_float_binary(ssaAmd64Gen *g, ssaValue *v, u32 opcode, i64 size) {
+	ssa_amd64_get(g, v->args[0], SSA_AMD64_FTMP0);
+	ssa_amd64_get(g, v->args[1], SSA_AMD64_FTMP1);
+	ssa_amd64_sse(g, opcode, size, SSA_AMD64_FTMP0, SSA_AMD64_FTMP1);
+	ssa_amd64_set(g, v, SSA_AMD64_FTMP0);
+}
+
+void ssa_amd64_int_to_float(ssaAmd64Gen *g, ssaValue *v, i64 src_size, i64 dst_size, bool is_unsigned) {
+	ssa_amd64_get(g, v->args[0], SSA_AMD64_TMP0);
+	if (!is_unsigned || src_size < 8) {
+		ssa_amd64_extend(g, SSA_AMD64_TMP0, src_size, !is_unsigned);
+		ssa_amd64_sse(g, 0x0F2A, dst_size, SSA_AMD64_FTMP0, SSA_AMD64_TMP0, true); // cvtsi2ss/sd
+	} else {
+		// NOTE: Values with the top bit set are halved (keeping the rounding bit) and doubled afterwards
+		ssa_amd64_rr(g, 0, true, 0x85, 1, SSA_AMD64_TMP0, SSA_AMD64_TMP0); // test rax, rax
+		isize neg = ssa_amd64_jcc8(g, ssaAmd64Cond_S);
+		ssa_amd64_sse(g, 0x0F2A, dst_size, SSA_AMD64_FTMP0, SSA_AMD64_TMP0, true);
+		isize done = ssa_amd64_jmp8(g);
+		ssa_amd64_patch8(g, neg);
+		ssa_amd64_mov(g, SSA_AMD64_TMP1, SSA_AMD64_TMP0);
+		ssa_amd64_rr(g, 0, true, 0xD1, 1, 5, SSA_AMD64_TMP1); // shr rcx, 1
+		ssa_amd64_rr(g, 0, false, 0x83, 1, 4, SSA_AMD64_TMP0); // and eax, 1
+		ssa_amd64_u8(g, 1);
+		ssa_amd64_alu(g, 0x0B, 8, SSA_AMD64_TMP1, SSA_AMD64_TMP0);
+		ssa_amd64_sse(g, 0x0F2A, dst_size, SSA_AMD64_FTMP0, SSA_AMD64_TMP1, true);
+		ssa_amd64_sse(g, 0x0F58, dst_size, SSA_AMD64_FTMP0, SSA_AMD64_FTMP0);
+		ssa_amd64_patch8(g, done);
+	}
+	ssa_amd64_set(g, v, SSA_AMD64_FTMP0);
+}
+
+void ssa_amd64_float_to_int(ssaAmd64Gen *g, ssaValue *v, i64 src_size, i64 dst_size, bool is_unsigned) {
+	ssa_amd64_get(g, v->args[0], SSA_AMD64_FTMP0);
+	if (!is_unsigned || dst_size < 8) {
+		ssa_amd64_sse(g, 0x0F2C, src_size, SSA_AMD64_TMP0, SSA_AMD64_FTMP0, true); // cvttss2si/cvttsd2si r64
+	} else {
+		// NOTE: Values >= 2^63 are offset by 2^63 and the top bit is flipped back
+		ssa_amd64_float_const(g, SSA_AMD64_FTMP1, src_size, 9223372036854775808.0);
+		ssa_amd64_ucomis(g, src_size, SSA_AMD64_FTMP0, SSA_AMD64_FTMP1);
+		isize big = ssa_amd64_jcc8(g, ssaAmd64Cond_AE);
+		ssa_amd64_sse(g, 0x0F2C, src_size, SSA_AMD64_TMP0, SSA_AMD64_FTMP0, true);
+		isize done = ssa_amd64_jmp8(g);
+		ssa_amd64_patch8(g, big);
+		ssa_amd64_sse(g, 0x0F5C, src_size, SSA_AMD64_FTMP0, SSA_AMD64_FTMP1);
+		ssa_amd64_sse(g, 0x0F2C, src_size, SSA_AMD64_TMP0, SSA_AMD64_FTMP0, true);
+		ssa_amd64_rr(g, 0, true, 0x0FBA, 2, 7, SSA_AMD64_TMP0); // btc rax, 63
+		ssa_amd64_u8(g, 63);
+		ssa_amd64_patch8(g, done);
+	}
+	ssa_amd64_set(g, v, SSA_AMD64_TMP0);
+}
+
+// NOTE: Loads the value at [base+offset] into `v`
+void ssa_amd64_load_value(ssaAmd64Gen *g, ssaValue *v, i32 base, i32 offset) {
+	Type *t = default_type(v->type);
+	i64 size = ssa_amd64_size_of(t);
+	switch (ssa_amd64_value_class(v)) {
+	case ssaAmd64Class_Int:
+		ssa_amd64_load(g, size, SSA_AMD64_TMP0, base, offset);
+		ssa_amd64_set(g, v, SSA_AMD64_TMP0);
+		break;
+	case ssaAmd64Class_Float:
+		ssa_amd64_load(g, size, SSA_AMD64_FTMP0, base, offset);
+		ssa_amd64_set(g, v, SSA_AMD64_FTMP0);
+		break;
+	case ssaAmd64Class_Memory:
+		if (offset != 0) {
+			ssa_amd64_lea(g, base, base, offset);
+		}
+		ssa_amd64_get(g, v, SSA_AMD64_TMP2);
+		ssa_amd64_copy(g, SSA_AMD64_TMP2, base, size);
+		break;
+	}
+}
+
+// NOTE: Moves an outgoing argument into the integer register `reg`, extended to 64 bits
+void ssa_amd64_call_arg(ssaAmd64Gen *g, ssaValue *arg, i32 reg) {
+	switch (ssa_amd64_value_class(arg)) {
+	case ssaAmd64Class_Float:
+		ssa_amd64_get(g, arg, SSA_AMD64_FTMP0);
+		ssa_amd64_mov(g, reg, SSA_AMD64_FTMP0);
+		break;
+	case ssaAmd64Class_Int:
+		ssa_amd64_get(g, arg, reg);
+		ssa_amd64_extend(g, reg, ssa_amd64_size_of(arg->type), ssa_amd64_is_signed(arg->type));
+		break;
+	case ssaAmd64Class_Memory:
+		ssa_amd64_get(g, arg, reg);
+		break;
+	default:
+		ssa_amd64_mov_imm(g, reg, 0);
+		break;
+	}
+}
+
+// NOTE: System V call sequence. Aggregates are passed by pointer and aggregate results through
+// a hidden pointer, which only matches C for procedures built by this backend
+void ssa_amd64_call(ssaAmd64Gen *g, ssaValue *v) {
+	ssaValue *proc = v->args[0];
+	GB_ASSERT(proc->op == ssaOp_Proc && proc->entity != NULL);
+	Entity *e = proc->entity;
+	bool is_foreign = e->kind == Entity_Procedure && e->Procedure.is_foreign;
+	bool returns_memory = ssa_amd64_value_class(v) == ssaAmd64Class_Memory;
+	if (is_foreign && returns_memory) {
+		g->unsupported = str_lit("foreign call returning an aggregate");
+		return;
+	}
+
+	gbTempArenaMemory tmp = gb_temp_arena_memory_begin(&g->module->tmp_arena);
+	defer (gb_temp_arena_memory_end(tmp));
+	gbAllocator a = g->module->tmp_allocator;
+
+	isize arg_count = v->args.count-1;
+	i32 *targets = gb_alloc_array(a, i32, arg_count); // Register or -1 for the stack
+	isize int_index = returns_memory ? 1 : 0;
+	isize float_index = 0;
+	isize stack_count = 0;
+	for (isize i = 0; i < arg_count; i++) {
+		ssaValue *arg = v->args[i+1];
+		ssaAmd64Class c = ssa_amd64_value_class(arg);
+		if (is_foreign && c == ssaAmd64Class_Memory) {
+			g->unsupported = str_lit("foreign call with an aggregate argument");
+			return;
+		}
+		targets[i] = -1;
+		if (c == ssaAmd64Class_Float) {
+			if (float_index < ssa_amd64_float_arg_reg_count) {
+				targets[i] = ssaAmd64_XMM0 + cast(i32)float_index++;
+			}
+		} else if (int_index < gb_count_of(ssa_amd64_int_arg_regs)) {
+			targets[i] = ssa_amd64_int_arg_regs[int_index++];
+		}
+		if (targets[i] < 0) {
+			stack_count++;
+		}
+	}
+
+	// NOTE: The stack arguments are pushed in reverse, padded to keep rsp 16 byte aligned at the call
+	i32 stack_size = cast(i32)(8*stack_count);
+	if (stack_count%2 != 0) {
+		ssa_amd64_alu_imm(g, 5, ssaAmd64_RSP, 8);
+		stack_size += 8;
+	}
+	for (isize i = arg_count-1; i >= 0; i--) {
+		if (targets[i] < 0) {
+			ssa_amd64_call_arg(g, v->args[i+1], SSA_AMD64_TMP0);
+			ssa_amd64_push(g, SSA_AMD64_TMP0);
+		}
+	}
+
+	// NOTE: The register arguments go through the stack as the argument registers may be allocated
+	for (isize i = 0; i < arg_count; i++) {
+		if (targets[i] >= 0) {
+			ssa_amd64_call_arg(g, v->args[i+1], SSA_AMD64_TMP0);
+			ssa_amd64_push(g, SSA_AMD64_TMP0);
+		}
+	}
+	for (isize i = arg_count-1; i >= 0; i--) {
+		if (targets[i] < 0) {
+			continue;
+		}
+		if (ssa_amd64_is_float_reg(targets[i])) {
+			ssa_amd64_pop(g, SSA_AMD64_TMP0);
+			ssa_amd64_mov(g, targets[i], SSA_AMD64_TMP0);
+		} else {
+			ssa_amd64_pop(g, targets[i]);
+		}
+	}
+	if (returns_memory) {
+		ssa_amd64_get(g, v, ssaAmd64_RDI);
+	}
+
+	ssa_amd64_mov_imm(g, SSA_AMD64_TMP0, cast(u64)float_index); // NOTE: Vector register count for variadic C procedures
+	isize symbol = ssa_object_get_symbol(g->object, ssa_amd64_symbol_name(g->module, e));
+	ssa_amd64_u8(g, 0xE8); // call rel32
+	ssa_object_add_relocation(g->object, ssaObjectSection_Text, g->code->count, symbol, ssaRelocation_PLT32, -4);
+	ssa_amd64_u32(g, 0);
+	if (stack_size > 0) {
+		ssa_amd64_alu_imm(g, 0, ssaAmd64_RSP, stack_size);
+	}
+
+	switch (ssa_amd64_value_class(v)) {
+	case ssaAmd64Class_Int:
+		ssa_amd64_set(g, v, ssaAmd64_RAX);
+		break;
+	case ssaAmd64Class_Float:
+		ssa_amd64_set(g, v, ssaAmd64_XMM0);
+		break;
+	}
+}
+
+void ssa_amd64_lower_value(ssaAmd64Gen *g, ssaValue *v) {
+	gbAllocator a = heap_allocator();
+
+	switch (v->op) {
+	case ssaOp_Comment:
+	case ssaOp_Assume:
+	case ssaOp_Phi:    // NOTE: Phis are resolved at the end of the predecessors
+	case ssaOp_Local:  // NOTE: Frame address
+	case ssaOp_Global: // NOTE: Rematerialized at each use
+	case ssaOp_Proc:
+		break;
+
+	case ssaOp_CallOdin:
+	case ssaOp_CallC:
+	case ssaOp_CallStd:
+	case ssaOp_CallFast:
+		ssa_amd64_call(g, v);
+		break;
+
+	case ssaOp_Arg:
+		if (ssa_amd64_value_class(v) == ssaAmd64Class_Memory) {
+			// NOTE: Aggregates are passed by pointer and copied so they can be modified
+			ssa_amd64_load(g, 8, SSA_AMD64_TMP1, ssaAmd64_RBP, g->arg_save_offsets[v->id]);
+			ssa_amd64_get(g, v, SSA_AMD64_TMP2);
+			ssa_amd64_copy(g, SSA_AMD64_TMP2, SSA_AMD64_TMP1, ssa_amd64_size_of(v->type));
+		}
+		break;
+
+	case ssaOp_SP:
+		ssa_amd64_mov(g, SSA_AMD64_TMP0, ssaAmd64_RSP);
+		ssa_amd64_set(g, v, SSA_AMD64_TMP0);
+		break;
+	case ssaOp_SB:
+		ssa_amd64_mov(g, SSA_AMD64_TMP0, ssaAmd64_RBP);
+		ssa_amd64_set(g, v, SSA_AMD64_TMP0);
+		break;
+
+	case ssaOp_ConstBool:
+	case ssaOp_Const8:
+	case ssaOp_Const16:
+	case ssaOp_Const32:
+	case ssaOp_Const64:
+	case ssaOp_Const32F:
+	case ssaOp_Const64F:
+		break; // NOTE: Rematerialized at each use
+
+	case ssaOp_ConstNil:
+		if (ssa_amd64_value_class(v) == ssaAmd64Class_Memory) {
+			ssa_amd64_get(g, v, SSA_AMD64_TMP2);
+			ssa_amd64_zero(g, SSA_AMD64_TMP2, ssa_amd64_size_of(v->type));
+		}
+		break;
+
+	case ssaOp_ConstString: {
+		String str = v->exact_value.value_string;
+		i64 offset = ssa_object_add_string(g->object, str);
+		isize rodata = ssa_object_section_symbol(g->object, ssaObjectSection_Rodata);
+		ssa_amd64_get(g, v, SSA_AMD64_TMP2);
+		ssa_amd64_rip(g, 0, true, 0x8D, 1, SSA_AMD64_TMP0, rodata, offset); // lea rax, [rip+str]
+		ssa_amd64_store(g, 8, SSA_AMD64_TMP2, 0, SSA_AMD64_TMP0);
+		ssa_amd64_mov_imm(g, SSA_AMD64_TMP0, cast(u64)str.len);
+		ssa_amd64_store(g, 8, SSA_AMD64_TMP2, 8, SSA_AMD64_TMP0);
+	} break;
+
+	case ssaOp_Load: {
+		ssa_amd64_get(g, v->args[0], SSA_AMD64_TMP1);
+		ssa_amd64_load_value(g, v, SSA_AMD64_TMP1, 0);
+	} break;
+
+	case ssaOp_Store: {
+		Type *t = type_deref(v->args[0]->type);
+		i64 size = ssa_amd64_size_of(t);
+		switch (ssa_amd64_type_class(t)) {
+		case ssaAmd64Class_Int:
+			ssa_amd64_get(g, v->args[1], SSA_AMD64_TMP0);
+			ssa_amd64_get(g, v->args[0], SSA_AMD64_TMP1);
+			ssa_amd64_store(g, size, SSA_AMD64_TMP1, 0, SSA_AMD64_TMP0);
+			break;
+		case ssaAmd64Class_Float:
+			ssa_amd64_get(g, v->args[1], SSA_AMD64_FTMP0);
+			ssa_amd64_get(g, v->args[0], SSA_AMD64_TMP1);
+			ssa_amd64_store(g, size, SSA_AMD64_TMP1, 0, SSA_AMD64_FTMP0);
+			break;
+		case ssaAmd64Class_Memory:
+			ssa_amd64_get(g, v->args[1], SSA_AMD64_TMP1);
+			ssa_amd64_get(g, v->args[0], SSA_AMD64_TMP2);
+			ssa_amd64_copy(g, SSA_AMD64_TMP2, SSA_AMD64_TMP1, size);
+			break;
+		}
+	} break;
+
+	case ssaOp_Zero:
+		ssa_amd64_get(g, v->args[0], SSA_AMD64_TMP2);
+		ssa_amd64_zero(g, SSA_AMD64_TMP2, ssa_amd64_size_of(type_deref(v->type)));
+		break;
+
+	case ssaOp_Copy:
+		if (ssa_amd64_value_class(v) == ssaAmd64Class_Memory) {
+			ssa_amd64_get(g, v->args[0], SSA_AMD64_TMP1);
+			ssa_amd64_get(g, v, SSA_AMD64_TMP2);
+			ssa_amd64_copy(g, SSA_AMD64_TMP2, SSA_AMD64_TMP1, ssa_amd64_size_of(v->type));
+		} else if (ssa_amd64_value_class(v) == ssaAmd64Class_Float) {
+			ssa_amd64_get(g, v->args[0], SSA_AMD64_FTMP0);
+			ssa_amd64_set(g, v, SSA_AMD64_FTMP0);
+		} else {
+			ssa_amd64_get(g, v->args[0], SSA_AMD64_TMP0);
+			ssa_amd64_set(g, v, SSA_AMD64_TMP0);
+		}
+		break;
+
+	case ssaOp_PtrIndex: {
+		i64 offset = ssa_amd64_field_offset(type_deref(v->args[0]->type), big_int_to_i64(v->exact_value.value_integer));
+		ssa_amd64_get(g, v->args[0], SSA_AMD64_TMP0);
+		if (offset != 0) {
+			ssa_amd64_alu_imm(g, 0, SSA_AMD64_TMP0, cast(i32)offset);
+		}
+		ssa_amd64_set(g, v, SSA_AMD64_TMP0);
+	} break;
+
+	case ssaOp_ValueIndex: {
+		i64 offset = ssa_amd64_field_offset(v->args[0]->type, big_int_to_i64(v->exact_value.value_integer));
+		GB_ASSERT(ssa_amd64_value_class(v->args[0]) == ssaAmd64Class_Memory);
+		ssa_amd64_get(g, v->args[0], SSA_AMD64_TMP1);
+		ssa_amd64_load_value(g, v, SSA_AMD64_TMP1, cast(i32)offset);
+	} break;
+
+	case ssaOp_ArrayIndex:
+	case ssaOp_PtrOffset: {
+		Type *elem = NULL;
+		if (v->op == ssaOp_ArrayIndex) {
+			elem = type_deref(v->type);
+		} else {
+			elem = type_deref(v->args[0]->type);
+		}
+		Type *index_type = v->args[1]->type;
+		ssa_amd64_get(g, v->args[0], SSA_AMD64_TMP0);
+		ssa_amd64_get(g, v->args[1], SSA_AMD64_TMP1);
+		ssa_amd64_extend(g, SSA_AMD64_TMP1, ssa_amd64_size_of(index_type), ssa_amd64_is_signed(index_type));
+		ssa_amd64_rr(g, 0, true, 0x69, 1, SSA_AMD64_TMP1, SSA_AMD64_TMP1); // imul rcx, rcx, imm32
+		ssa_amd64_u32(g, cast(u32)type_size_of(a, elem));
+		ssa_amd64_alu(g, 0x03, 8, SSA_AMD64_TMP0, SSA_AMD64_TMP1);
+		ssa_amd64_set(g, v, SSA_AMD64_TMP0);
+	} break;
+
+	case ssaOp_Add8: case ssaOp_Add16: case ssaOp_Add32: case ssaOp_Add64: case ssaOp_AddPtr:
+		ssa_amd64_int_binary(g, v, 0x03);
+		break;
+	case ssaOp_Sub8: case ssaOp_Sub16: case ssaOp_Sub32: case ssaOp_Sub64: case ssaOp_SubPtr:
+		ssa_amd64_int_binary(g, v, 0x2B);
+		break;
+	case ssaOp_And8: case ssaOp_And16: case ssaOp_And32: case ssaOp_And64:
+		ssa_amd64_int_binary(g, v, 0x23);
+		break;
+	case ssaOp_Or8: case ssaOp_Or16: case ssaOp_Or32: case ssaOp_Or64:
+		ssa_amd64_int_binary(g, v, 0x0B);
+		break;
+	case ssaOp_Xor8: case ssaOp_Xor16: case ssaOp_Xor32: case ssaOp_Xor64:
+		ssa_amd64_int_binary(g, v, 0x33);
+		break;
+	case ssaOp_AndNot8: case ssaOp_AndNot16: case ssaOp_AndNot32: case ssaOp_AndNot64:
+		ssa_amd64_get(g, v->args[0], SSA_AMD64_TMP0);
+		ssa_amd64_get(g, v->args[1], SSA_AMD64_TMP1);
+		ssa_amd64_unary(g, 2, SSA_AMD64_TMP1);
+		ssa_amd64_alu(g, 0x23, 8, SSA_AMD64_TMP0, SSA_AMD64_TMP1);
+		ssa_amd64_set(g, v, SSA_AMD64_TMP0);
+		break;
+	case ssaOp_Mul8: case ssaOp_Mul16: case ssaOp_Mul32: case ssaOp_Mul64:
+		ssa_amd64_get(g, v->args[0], SSA_AMD64_TMP0);
+		ssa_amd64_get(g, v->args[1], SSA_AMD64_TMP1);
+		ssa_amd64_rr(g, 0, true, 0x0FAF, 2, SSA_AMD64_TMP0, SSA_AMD64_TMP1); // imul rax, rcx
+		ssa_amd64_set(g, v, SSA_AMD64_TMP0);
+		break;
+
+	case ssaOp_Div8:  case ssaOp_Div16:  case ssaOp_Div32:  case ssaOp_Div64:  ssa_amd64_div(g, v, true,  false); break;
+	case ssaOp_Div8U: case ssaOp_Div16U: case ssaOp_Div32U: case ssaOp_Div64U: ssa_amd64_div(g, v, false, false); break;
+	case ssaOp_Mod8:  case ssaOp_Mod16:  case ssaOp_Mod32:  case ssaOp_Mod64:  ssa_amd64_div(g, v, true,  true);  break;
+	case ssaOp_Mod8U: case ssaOp_Mod16U: case ssaOp_Mod32U: case ssaOp_Mod64U: ssa_amd64_div(g, v, false, true);  break;
+
+	case ssaOp_Lsh8x8:  case ssaOp_Lsh8x16:  case ssaOp_Lsh8x32:  case ssaOp_Lsh8x64:
+	case ssaOp_Lsh16x8: case ssaOp_Lsh16x16: case ssaOp_Lsh16x32: case ssaOp_Lsh16x64:
+	case ssaOp_Lsh32x8: case ssaOp_Lsh32x16: case ssaOp_Lsh32x32: case ssaOp_Lsh32x64:
+	case ssaOp_Lsh64x8: case ssaOp_Lsh64x16: case ssaOp_Lsh64x32: case ssaOp_Lsh64x64:
+		ssa_amd64_shift(g, v, 4, 8, false);
+		break;
+	case ssaOp_Rsh8x8:  case ssaOp_Rsh8x16:  case ssaOp_Rsh8x32:  case ssaOp_Rsh8x64:   ssa_amd64_shift(g, v, 7, 1, true);  break;
+	case ssaOp_Rsh16x8: case ssaOp_Rsh16x16: case ssaOp_Rsh16x32: case ssaOp_Rsh16x64:  ssa_amd64_shift(g, v, 7, 2, true);  break;
+	case ssaOp_Rsh32x8: case ssaOp_Rsh32x16: case ssaOp_Rsh32x32: case ssaOp_Rsh32x64:  ssa_amd64_shift(g, v, 7, 4, true);  break;
+	case ssaOp_Rsh64x8: case ssaOp_Rsh64x16: case ssaOp_Rsh64x32: case ssaOp_Rsh64x64:  ssa_amd64_shift(g, v, 7, 8, true);  break;
+	case ssaOp_Rsh8Ux8:  case ssaOp_Rsh8Ux16:  case ssaOp_Rsh8Ux32:  case ssaOp_Rsh8Ux64:  ssa_amd64_shift(g, v, 5, 1, false); break;
+	case ssaOp_Rsh16Ux8: case ssaOp_Rsh16Ux16: case ssaOp_Rsh16Ux32: case ssaOp_Rsh16Ux64: ssa_amd64_shift(g, v, 5, 2, false); break;
+	case ssaOp_Rsh32Ux8: case ssaOp_Rsh32Ux16: case ssaOp_Rsh32Ux32: case ssaOp_Rsh32Ux64: ssa_amd64_shift(g, v, 5, 4, false); break;
+	case ssaOp_Rsh64Ux8: case ssaOp_Rsh64Ux16: case ssaOp_Rsh64Ux32: case ssaOp_Rsh64Ux64: ssa_amd64_shift(g, v, 5, 8, false); break;
+
+	case ssaOp_Eq8: case ssaOp_Eq16: case ssaOp_Eq32: case ssaOp_Eq64: case ssaOp_EqPtr: case ssaOp_EqB:
+		ssa_amd64_int_compare(g, v, ssaAmd64Cond_E, ssaAmd64Cond_E);
+		break;
+	case ssaOp_Ne8: case ssaOp_Ne16: case ssaOp_Ne32: case ssaOp_Ne64: case ssaOp_NePtr: case ssaOp_NeB:
+		ssa_amd64_int_compare(g, v, ssaAmd64Cond_NE, ssaAmd64Cond_NE);
+		break;
+	case ssaOp_Lt8: case ssaOp_Lt16: case ssaOp_Lt32: case ssaOp_Lt64: case ssaOp_LtPtr:
+		ssa_amd64_int_compare(g, v, ssaAmd64Cond_L, ssaAmd64Cond_B);
+		break;
+	case ssaOp_Gt8: case ssaOp_Gt16: case ssaOp_Gt32: case ssaOp_Gt64: case ssaOp_GtPtr:
+		ssa_amd64_int_compare(g, v, ssaAmd64Cond_G, ssaAmd64Cond_A);
+		break;
+	case ssaOp_Le8: case ssaOp_Le16: case ssaOp_Le32: case ssaOp_Le64: case ssaOp_LePtr:
+		ssa_amd64_int_compare(g, v, ssaAmd64Cond_LE, ssaAmd64Cond_BE);
+		break;
+	case ssaOp_Ge8: case ssaOp_Ge16: case ssaOp_Ge32: case ssaOp_Ge64: case ssaOp_GePtr:
+		ssa_amd64_int_compare(g, v, ssaAmd64Cond_GE, ssaAmd64Cond_AE);
+		break;
+
+	case ssaOp_Eq32F: ssa_amd64_float_compare(g, v, Token_CmpEq, 4); break;
+	case ssaOp_Eq64F: ssa_amd64_float_compare(g, v, Token_CmpEq, 8); break;
+	case ssaOp_Ne32F: ssa_amd64_float_compare(g, v, Token_NotEq, 4); break;
+	case ssaOp_Ne64F: ssa_amd64_float_compare(g, v, Token_NotEq, 8); break;
+	case ssaOp_Lt32F: ssa_amd64_float_compare(g, v, Token_Lt,    4); break;
+	case ssaOp_Lt64F: ssa_amd64_float_compare(g, v, Token_Lt,    8); break;
+	case ssaOp_Gt32F: ssa_amd64_float_compare(g, v, Token_Gt,    4); break;
+	case ssaOp_Gt64F: ssa_amd64_float_compare(g, v, Token_Gt,    8); break;
+	case ssaOp_Le32F: ssa_amd64_float_compare(g, v, Token_LtEq,  4); break;
+	case ssaOp_Le64F: ssa_amd64_float_compare(g, v, Token_LtEq,  8); break;
+	case ssaOp_Ge32F: ssa_amd64_float_compare(g, v, Token_GtEq,  4); break;
+	case ssaOp_Ge64F: ssa_amd64_float_compare(g, v, Token_GtEq,  8); break;
+
+	case ssaOp_Add32F: ssa_amd64_float_binary(g, v, 0x0F58, 4); break;
+	case ssaOp_Add64F: ssa_amd64_float_binary(g, v, 0x0F58, 8); break;
+	case ssaOp_Sub32F: ssa_amd64_float_binary(g, v, 0x0F5C, 4); break;
+	case ssaOp_Sub64F: ssa_amd64_float_binary(g, v, 0x0F5C, 8); break;
+	case ssaOp_Mul32F: ssa_amd64_float_binary(g, v, 0x0F59, 4); break;
+	case ssaOp_Mul64F: ssa_amd64_float_binary(g, v, 0x0F59, 8); break;
+	case ssaOp_Div32F: ssa_amd64_float_binary(g, v, 0x0F5E, 4); break;
+	case ssaOp_Div64F: ssa_amd64_float_binary(g, v, 0x0F5E, 8); break;
+
+	case ssaOp_NotB:
+		ssa_amd64_get(g, v->args[0], SSA_AMD64_TMP0);
+		ssa_amd64_rr(g, 0, false, 0x83, 1, 6, SSA_AMD64_TMP0); // xor eax, 1
+		ssa_amd64_u8(g, 1);
+		ssa_amd64_set(g, v, SSA_AMD64_TMP0);
+		break;
+
+	case ssaOp_Neg8: case ssaOp_Neg16: case ssaOp_Neg32: case ssaOp_Neg64:
+		ssa_amd64_get(g, v->args[0], SSA_AMD64_TMP0);
+		ssa_amd64_unary(g, 3, SSA_AMD64_TMP0);
+		ssa_amd64_set(g, v, SSA_AMD64_TMP0);
+		break;
+	case ssaOp_Not8: case ssaOp_Not16: case ssaOp_Not32: case ssaOp_Not64:
+		ssa_amd64_get(g, v->args[0], SSA_AMD64_TMP0);
+		ssa_amd64_unary(g, 2, SSA_AMD64_TMP0);
+		ssa_amd64_set(g, v, SSA_AMD64_TMP0);
+		break;
+	case ssaOp_Neg32F:
+	case ssaOp_Neg64F: {
+		// NOTE: Flip the sign bit so that -0.0 and NaNs are handled correctly
+		u64 sign = v->op == ssaOp_Neg32F ? 0x80000000ull : 0x8000000000000000ull;
+		ssa_amd64_get(g, v->args[0], SSA_AMD64_FTMP0);
+		ssa_amd64_mov(g, SSA_AMD64_TMP0, SSA_AMD64_FTMP0);
+		ssa_amd64_mov_imm(g, SSA_AMD64_TMP1, sign);
+		ssa_amd64_alu(g, 0x33, 8, SSA_AMD64_TMP0, SSA_AMD64_TMP1);
+		ssa_amd64_mov(g, SSA_AMD64_FTMP0, SSA_AMD64_TMP0);
+		ssa_amd64_set(g, v, SSA_AMD64_FTMP0);
+	} break;
+
+	case ssaOp_SignExt8to16: case ssaOp_SignExt8to32: case ssaOp_SignExt8to64:
+	case ssaOp_SignExt16to32: case ssaOp_SignExt16to64:
+	case ssaOp_SignExt32to64:
+	case ssaOp_ZeroExt8to16: case ssaOp_ZeroExt8to32: case ssaOp_ZeroExt8to64:
+	case ssaOp_ZeroExt16to32: case ssaOp_ZeroExt16to64:
+	case ssaOp_ZeroExt32to64: {
+		bool is_signed = false;
+		switch (v->op) {
+		case ssaOp_SignExt8to16: case ssaOp_SignExt8to32: case ssaOp_SignExt8to64:
+		case ssaOp_SignExt16to32: case ssaOp_SignExt16to64:
+		case ssaOp_SignExt32to64:
+			is_signed = true;
+			break;
+		}
+		ssa_amd64_get(g, v->args[0], SSA_AMD64_TMP0);
+		ssa_amd64_extend(g, SSA_AMD64_TMP0, ssa_amd64_size_of(v->args[0]->type), is_signed);
+		ssa_amd64_set(g, v, SSA_AMD64_TMP0);
+	} break;
+
+	case ssaOp_Trunc16to8: case ssaOp_Trunc32to8: case ssaOp_Trunc32to16:
+	case ssaOp_Trunc64to8: case ssaOp_Trunc64to16: case ssaOp_Trunc64to32:
+		// NOTE: Only the low bits of a register are ever used
+		ssa_amd64_get(g, v->args[0], SSA_AMD64_TMP0);
+		ssa_amd64_set(g, v, SSA_AMD64_TMP0);
+		break;
+
+	case ssaOp_Cvt32to32F:  ssa_amd64_int_to_float(g, v, 4, 4, false); break;
+	case ssaOp_Cvt32to64F:  ssa_amd64_int_to_float(g, v, 4, 8, false); break;
+	case ssaOp_Cvt64to32F:  ssa_amd64_int_to_float(g, v, 8, 4, false); break;
+	case ssaOp_Cvt64to64F:  ssa_amd64_int_to_float(g, v, 8, 8, false); break;
+	case ssaOp_Cvt32Uto32F: ssa_amd64_int_to_float(g, v, 4, 4, true);  break;
+	case ssaOp_Cvt32Uto64F: ssa_amd64_int_to_float(g, v, 4, 8, true);  break;
+	case ssaOp_Cvt64Uto32F: ssa_amd64_int_to_float(g, v, 8, 4, true);  break;
+	case ssaOp_Cvt64Uto64F: ssa_amd64_int_to_float(g, v, 8, 8, true);  break;
+	case ssaOp_Cvt32Fto32:  ssa_amd64_float_to_int(g, v, 4, 4, false); break;
+	case ssaOp_Cvt32Fto64:  ssa_amd64_float_to_int(g, v, 4, 8, false); break;
+	case ssaOp_Cvt64Fto32:  ssa_amd64_float_to_int(g, v, 8, 4, false); break;
+	case ssaOp_Cvt64Fto64:  ssa_amd64_float_to_int(g, v, 8, 8, false); break;
+	case ssaOp_Cvt32Fto32U: ssa_amd64_float_to_int(g, v, 4, 4, true);  break;
+	case ssaOp_Cvt64Fto32U: ssa_amd64_float_to_int(g, v, 8, 4, true);  break;
+	case ssaOp_Cvt32Fto64U: ssa_amd64_float_to_int(g, v, 4, 8, true);  break;
+	case ssaOp_Cvt64Fto64U: ssa_amd64_float_to_int(g, v, 8, 8, true);  break;
+	case ssaOp_Cvt32Fto64F:
+	case ssaOp_Cvt64Fto32F:
+		ssa_amd64_get(g, v->args[0], SSA_AMD64_FTMP0);
+		ssa_amd64_sse(g, 0x0F5A, v->op == ssaOp_Cvt32Fto64F ? 4 : 8, SSA_AMD64_FTMP0, SSA_AMD64_FTMP0);
+		ssa_amd64_set(g, v, SSA_AMD64_FTMP0);
+		break;
+
+	case ssaOp_Bswap16:
+		ssa_amd64_get(g, v->args[0], SSA_AMD64_TMP0);
+		ssa_amd64_rr(g, 0x66, false, 0xC1, 1, 0, SSA_AMD64_TMP0); // rol ax, 8
+		ssa_amd64_u8(g, 8);
+		ssa_amd64_set(g, v, SSA_AMD64_TMP0);
+		break;
+	case ssaOp_Bswap32:
+	case ssaOp_Bswap64:
+		ssa_amd64_get(g, v->args[0], SSA_AMD64_TMP0);
+		ssa_amd64_prefixes(g, 0, v->op == ssaOp_Bswap64, 0, SSA_AMD64_TMP0, false);
+		ssa_amd64_u8(g, 0x0F);
+		ssa_amd64_u8(g, 0xC8 + SSA_AMD64_TMP0);
+		ssa_amd64_set(g, v, SSA_AMD64_TMP0);
+		break;
+
+	case ssaOp_BoundsCheck: {
+		// NOTE: The unsigned comparison also catches negative indices
+		Type *index_type = v->args[0]->type;
+		ssa_amd64_get(g, v->args[0], SSA_AMD64_TMP0);
+		ssa_amd64_extend(g, SSA_AMD64_TMP0, ssa_amd64_size_of(index_type), ssa_amd64_is_signed(index_type));
+		ssa_amd64_get(g, v->args[1], SSA_AMD64_TMP1);
+		ssa_amd64_alu(g, 0x3B, 8, SSA_AMD64_TMP0, SSA_AMD64_TMP1); // cmp rax, rcx
+		isize ok = ssa_amd64_jcc8(g, ssaAmd64Cond_B);
+		ssa_amd64_u8(g, 0x0F); ssa_amd64_u8(g, 0x0B); // ud2
+		ssa_amd64_patch8(g, ok);
+	} break;
+
+	case ssaOp_DebugTrap:
+		ssa_amd64_u8(g, 0xCC); // int3
+		break;
+	case ssaOp_Trap:
+		ssa_amd64_u8(g, 0x0F); ssa_amd64_u8(g, 0x0B); // ud2
+		break;
+	case ssaOp_ReadCycleCounter:
+		ssa_amd64_u8(g, 0x0F); ssa_amd64_u8(g, 0x31); // rdtsc
+		ssa_amd64_rr(g, 0, true, 0xC1, 1, 4, ssaAmd64_RDX); // shl rdx, 32
+		ssa_amd64_u8(g, 32);
+		ssa_amd64_alu(g, 0x0B, 8, ssaAmd64_RAX, ssaAmd64_RDX);
+		ssa_amd64_set(g, v, SSA_AMD64_TMP0);
+		break;
+
+	default:
+		g->unsupported = ssa_op_strings[v->op];
+		break;
+	}
+}
+
+// NOTE: Moves the phi arguments for the edge `from` -> `to`
+// Every argument is read before any phi is written, through the stack, so that phis
+// which use each other (e.g. swaps in loops) get the previous values
+void ssa_amd64_phi_moves(ssaAmd64Gen *g, ssaBlock *from, ssaBlock *to, isize edge) {
+	isize count = 0;
+	for_array(i, to->values) {
+		ssaValue *phi = to->values[i];
+		if (phi->op != ssaOp_Phi) {
+			continue;
+		}
+		ssaValue *arg = phi->args[edge];
+		switch (ssa_amd64_value_class(phi)) {
+		case ssaAmd64Class_Int:
+			ssa_amd64_get(g, arg, SSA_AMD64_TMP0);
+			ssa_amd64_push(g, SSA_AMD64_TMP0);
+			count++;
+			break;
+		case ssaAmd64Class_Float:
+			ssa_amd64_get(g, arg, SSA_AMD64_FTMP0);
+			ssa_amd64_mov(g, SSA_AMD64_TMP0, SSA_AMD64_FTMP0);
+			ssa_amd64_push(g, SSA_AMD64_TMP0);
+			count++;
+			break;
+		case ssaAmd64Class_Memory:
+			// NOTE: Aggregate phis have their own slots and are copied directly
+			ssa_amd64_get(g, arg, SSA_AMD64_TMP1);
+			ssa_amd64_get(g, phi, SSA_AMD64_TMP2);
+			ssa_amd64_copy(g, SSA_AMD64_TMP2, SSA_AMD64_TMP1, ssa_amd64_size_of(phi->type));
+			break;
+		}
+	}
+	if (count == 0) {
+		return;
+	}
+	for (isize i = to->values.count-1; i >= 0; i--) {
+		ssaValue *phi = to->values[i];
+		if (phi->op != ssaOp_Phi) {
+			continue;
+		}
+		switch (ssa_amd64_value_class(phi)) {
+		case ssaAmd64Class_Int:
+			ssa_amd64_pop(g, SSA_AMD64_TMP0);
+			ssa_amd64_set(g, phi, SSA_AMD64_TMP0);
+			break;
+		case ssaAmd64Class_Float:
+			ssa_amd64_pop(g, SSA_AMD64_TMP0);
+			ssa_amd64_mov(g, SSA_AMD64_FTMP0, SSA_AMD64_TMP0);
+			ssa_amd64_set(g, phi, SSA_AMD64_FTMP0);
+			break;
+		}
+	}
+}
+
+bool ssa_amd64_has_phis(ssaBlock *b) {
+	for_array(i, b->values) {
+		if (b->values[i]->op == ssaOp_Phi) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void ssa_amd64_prologue(ssaAmd64Gen *g) {
+	ssa_amd64_push(g, ssaAmd64_RBP);
+	ssa_amd64_mov(g, ssaAmd64_RBP, ssaAmd64_RSP);
+	if (g->frame_size > 0) {
+		ssa_amd64_alu_imm(g, 5, ssaAmd64_RSP, g->frame_size);
+	}
+	for (i32 reg = 0; reg < ssaAmd64_RegCount; reg++) {
+		if (g->used_regs[reg] && ssa_amd64_is_callee_saved(reg)) {
+			ssa_amd64_store(g, 8, ssaAmd64_RBP, g->callee_saved_offsets[reg], reg);
+		}
+	}
+
+	isize int_index = 0;
+	isize float_index = 0;
+	if (g->result_ptr_offset != 0) {
+		ssa_amd64_store(g, 8, ssaAmd64_RBP, g->result_ptr_offset, ssa_amd64_int_arg_regs[int_index++]);
+	}
+	ssaBlock *entry = g->proc->entry;
+	for_array(i, entry->values) {
+		ssaValue *v = entry->values[i];
+		if (v->op != ssaOp_Arg) {
+			continue;
+		}
+		i32 offset = g->arg_save_offsets[v->id];
+		if (offset > 0) {
+			continue; // NOTE: Passed on the stack
+		}
+		if (ssa_amd64_value_class(v) == ssaAmd64Class_Float) {
+			ssa_amd64_store(g, 8, ssaAmd64_RBP, offset, ssaAmd64_XMM0 + cast(i32)float_index++);
+		} else {
+			ssa_amd64_store(g, 8, ssaAmd64_RBP, offset, ssa_amd64_int_arg_regs[int_index++]);
+		}
+	}
+}
+
+void ssa_amd64_epilogue(ssaAmd64Gen *g) {
+	if (g->proc->entity == g->module->entry_point_entity) {
+		ssa_amd64_mov_imm(g, ssaAmd64_RAX, 0); // NOTE: `main` returns nothing but the C runtime exits with eax
+	}
+	for (i32 reg = 0; reg < ssaAmd64_RegCount; reg++) {
+		if (g->used_regs[reg] && ssa_amd64_is_callee_saved(reg)) {
+			ssa_amd64_load(g, 8, reg, ssaAmd64_RBP, g->callee_saved_offsets[reg]);
+		}
+	}
+	ssa_amd64_mov(g, ssaAmd64_RSP, ssaAmd64_RBP);
+	ssa_amd64_pop(g, ssaAmd64_RBP);
+	ssa_amd64_u8(g, 0xC3); // ret
+}
+
+void ssa_amd64_lower_block_end(ssaAmd64Gen *g, ssaBlock *b, ssaBlock *next) {
+	switch (b->kind) {
+	case ssaBlock_Entry:
+	case ssaBlock_Plain:
+	case ssaBlock_Defer:
+		if (b->succs.count == 0) {
+			ssa_amd64_u8(g, 0x0F); ssa_amd64_u8(g, 0x0B); // ud2, NOTE: Unterminated block
+			break;
+		}
+		GB_ASSERT(b->succs.count == 1);
+		ssa_amd64_phi_moves(g, b, b->succs[0].block, b->succs[0].index);
+		if (b->succs[0].block != next) {
+			ssa_amd64_jump(g, b->succs[0].block);
+		}
+		break;
+
+	case ssaBlock_If: {
+		GB_ASSERT(b->succs.count == 2);
+		ssaBlock *yes = b->succs[0].block;
+		ssaBlock *no  = b->succs[1].block;
+		ssa_amd64_get(g, b->control, SSA_AMD64_TMP0);
+		ssa_amd64_rr(g, 0, false, 0x84, 1, SSA_AMD64_TMP0, SSA_AMD64_TMP0); // test al, al
+		if (!ssa_amd64_has_phis(yes) && !ssa_amd64_has_phis(no)) {
+			if (yes == next) {
+				ssa_amd64_jcc(g, ssaAmd64Cond_E, no);
+			} else {
+				ssa_amd64_jcc(g, ssaAmd64Cond_NE, yes);
+				if (no != next) {
+					ssa_amd64_jump(g, no);
+				}
+			}
+			break;
+		}
+		// NOTE: The phi moves are placed on the edges themselves (critical edge splitting)
+		isize to_no = g->code->count + 2;
+		ssa_amd64_u8(g, 0x0F); ssa_amd64_u8(g, 0x80 | ssaAmd64Cond_E); ssa_amd64_u32(g, 0);
+		ssa_amd64_phi_moves(g, b, yes, b->succs[0].index);
+		ssa_amd64_jump(g, yes);
+		ssa_amd64_patch32(g, to_no, cast(i32)(g->code->count - (to_no+4)));
+		ssa_amd64_phi_moves(g, b, no, b->succs[1].index);
+		if (no != next) {
+			ssa_amd64_jump(g, no);
+		}
+	} break;
+
+	case ssaBlock_Ret:
+	case ssaBlock_RetJmp:
+		if (b->control != NULL) {
+			switch (ssa_amd64_value_class(b->control)) {
+			case ssaAmd64Class_Int:
+				ssa_amd64_get(g, b->control, ssaAmd64_RAX);
+				break;
+			case ssaAmd64Class_Float:
+				ssa_amd64_get(g, b->control, ssaAmd64_XMM0);
+				break;
+			case ssaAmd64Class_Memory:
+				// NOTE: Copy to the caller's result slot and return its address
+				ssa_amd64_load(g, 8, SSA_AMD64_TMP2, ssaAmd64_RBP, g->result_ptr_offset);
+				ssa_amd64_get(g, b->control, SSA_AMD64_TMP1);
+				ssa_amd64_copy(g, SSA_AMD64_TMP2, SSA_AMD64_TMP1, ssa_amd64_size_of(b->control->type));
+				ssa_amd64_load(g, 8, ssaAmd64_RAX, ssaAmd64_RBP, g->result_ptr_offset);
+				break;
+			}
+		}
+		ssa_amd64_epilogue(g);
+		break;
+
+	case ssaBlock_Exit:
+		ssa_amd64_epilogue(g);
+		break;
+
+	default:
+		GB_PANIC("Unknown block kind %d", b->kind);
+		break;
+	}
+}
+
+// NOTE: Appends the machine code for `p` to the .text section and defines its symbol
+// Returns the first operation which cannot be lowered yet, and appends nothing for `p`,
+// or an empty string
+String ssa_amd64_lower_proc(ssaModule *m, ssaObject *object, ssaProc *p) {
+	if (p->entry == NULL) {
+		return str_lit(""); // NOTE: Foreign or body-less procedure
+	}
+	isize trace = trace_begin(str_lit("ssa_amd64_lower_proc"), p->name);
+	defer (trace_end(trace));
+
+	gbAllocator a = heap_allocator();
+	isize value_count = gb_max(p->value_id, 1);
+	isize block_count = gb_max(p->block_id, 1);
+
+	ssaAmd64Gen g = {};
+	g.module = m;
+	g.object = object;
+	g.proc   = p;
+	g.code   = &object->sections[ssaObjectSection_Text];
+	array_init(&g.order,          a);
+	array_init(&g.fixups,         a);
+	array_init(&g.call_positions, a);
+	g.locations        = gb_alloc_array(a, ssaLocation, value_count);
+	g.arg_save_offsets = gb_alloc_array(a, i32,         value_count);
+	g.value_pos        = gb_alloc_array(a, i32,         value_count);
+	g.block_start      = gb_alloc_array(a, i32,         block_count);
+	g.block_end        = gb_alloc_array(a, i32,         block_count);
+	g.block_offsets    = gb_alloc_array(a, isize,       block_count);
+	gb_zero_size(g.locations,        gb_size_of(ssaLocation)*value_count);
+	gb_zero_size(g.arg_save_offsets, gb_size_of(i32)*value_count);
+	defer (array_free(&g.order));
+	defer (array_free(&g.fixups));
+	defer (array_free(&g.call_positions));
+	defer (gb_free(a, g.locations));
+	defer (gb_free(a, g.arg_save_offsets));
+	defer (gb_free(a, g.value_pos));
+	defer (gb_free(a, g.block_start));
+	defer (gb_free(a, g.block_end));
+	defer (gb_free(a, g.block_offsets));
+
+	ssa_amd64_linearise(&g);
+	ssa_amd64_assign_locations(&g);
+
+	// NOTE: Pad with int3
+	while (g.code->count % 16 != 0) {
+		ssa_amd64_u8(&g, 0xCC);
+	}
+	isize start = g.code->count;
+	isize relocation_start = object->relocations.count;
+
+	ssa_amd64_prologue(&g);
+	for_array(i, g.order) {
+		ssaBlock *b = g.order[i];
+		ssaBlock *next = NULL;
+		if (i+1 < g.order.count) {
+			next = g.order[i+1];
+		}
+		g.block_offsets[b->id] = g.code->count;
+		for_array(j, b->values) {
+			ssa_amd64_lower_value(&g, b->values[j]);
+			if (g.unsupported.len > 0) {
+				break;
+			}
+		}
+		if (g.unsupported.len > 0) {
+			break;
+		}
+		ssa_amd64_lower_block_end(&g, b, next);
+	}
+
+	if (g.unsupported.len > 0) {
+		// NOTE: Discard the partial body, the caller reports the error
+		g.code->count = start;
+		object->relocations.count = relocation_start;
+		return g.unsupported;
+	}
+
+	for_array(i, g.fixups) {
+		ssaAmd64Fixup f = g.fixups[i];
+		isize target = g.block_offsets[f.target->id];
+		ssa_amd64_patch32(&g, f.offset, cast(i32)(target - (f.offset+4)));
+	}
+
+	bool is_global = true;
+	ssa_object_define_symbol(object, p->name, ssaObjectSection_Text, start, g.code->count-start, true, is_global);
+	return g.unsupported;
+}
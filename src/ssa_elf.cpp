@@ -0,0 +1,432 @@
+// NOTE: In-memory object file for the custom backend, written out as a relocatable
+// ELF64 object (System V x86-64) which can be passed straight to the linker
+
+enum ssaObjectSectionKind {
+	ssaObjectSection_Undefined, // External symbols
+	ssaObjectSection_Text,
+	ssaObjectSection_Rodata,
+	ssaObjectSection_Data,
+	ssaObjectSection_Bss,
+
+	ssaObjectSection_Count,
+};
+
+String const ssa_object_section_names[ssaObjectSection_Count] = {
+	{cast(u8 *)"",        0},
+	{cast(u8 *)".text",   5},
+	{cast(u8 *)".rodata", 7},
+	{cast(u8 *)".data",   5},
+	{cast(u8 *)".bss",    4},
+};
+
+struct ssaObjectSymbol {
+	String               name;
+	ssaObjectSectionKind section;
+	i64                  offset;
+	i64                  size;
+	bool                 is_proc;
+	bool                 is_global;
+	bool                 is_section; // Refers to the start of `section`
+};
+
+enum ssaRelocationKind {
+	ssaRelocation_PC32,  // 32-bit PC-relative data reference
+	ssaRelocation_PLT32, // 32-bit PC-relative call
+	ssaRelocation_Abs64, // 64-bit absolute address
+};
+
+struct ssaRelocation {
+	ssaObjectSectionKind section; // Section being patched
+	i64                  offset;
+	isize                symbol;  // Index into `ssaObject.symbols`
+	ssaRelocationKind    kind;
+	i64                  addend;
+};
+
+struct ssaObject {
+	Array<u8>              sections[ssaObjectSection_Count];
+	i64                    bss_size; // NOTE: .bss has no contents
+	Array<ssaObjectSymbol> symbols;
+	Array<ssaRelocation>   relocations;
+	Map<isize>             symbol_map; // Key: String (symbol name)
+	Map<i64>               strings;    // Key: String (constant), Value: offset into .rodata
+};
+
+
+void ssa_object_init(ssaObject *o) {
+	for (isize i = 0; i < ssaObjectSection_Count; i++) {
+		array_init(&o->sections[i], heap_allocator());
+	}
+	array_init(&o->symbols,     heap_allocator());
+	array_init(&o->relocations, heap_allocator());
+	map_init(&o->symbol_map, heap_allocator());
+	map_init(&o->strings,    heap_allocator());
+
+	// NOTE: The section symbols come first so that `section` can be used as their index
+	for (isize i = 0; i < ssaObjectSection_Count; i++) {
+		ssaObjectSymbol s = {};
+		s.name       = ssa_object_section_names[i];
+		s.section    = cast(ssaObjectSectionKind)i;
+		s.is_section = true;
+		array_add(&o->symbols, s);
+	}
+}
+
+void ssa_object_destroy(ssaObject *o) {
+	for (isize i = 0; i < ssaObjectSection_Count; i++) {
+		array_free(&o->sections[i]);
+	}
+	array_free(&o->symbols);
+	array_free(&o->relocations);
+	map_destroy(&o->symbol_map);
+	map_destroy(&o->strings);
+}
+
+isize ssa_object_section_symbol(ssaObject *o, ssaObjectSectionKind section) {
+	GB_ASSERT(section != ssaObjectSection_Undefined);
+	return cast(isize)section;
+}
+
+// NOTE: Returns the index of the symbol, adding it as an undefined (external) symbol if it is unknown
+isize ssa_object_get_symbol(ssaObject *o, String name) {
+	HashKey key = hash_string(name);
+	isize *found = map_get(&o->symbol_map, key);
+	if (found != NULL) {
+		return *found;
+	}
+	ssaObjectSymbol s = {};
+	s.name      = name;
+	s.section   = ssaObjectSection_Undefined;
+	s.is_global = true;
+	isize index = o->symbols.count;
+	array_add(&o->symbols, s);
+	map_set(&o->symbol_map, key, index);
+	return index;
+}
+
+isize ssa_object_define_symbol(ssaObject *o, String name, ssaObjectSectionKind section, i64 offset, i64 size,
+                               bool is_proc, bool is_global) {
+	isize index = ssa_object_get_symbol(o, name);
+	ssaObjectSymbol *s = &o->symbols[index];
+	GB_ASSERT_MSG(s->section == ssaObjectSection_Undefined, "Symbol redefinition: %.*s", LIT(name));
+	s->section   = section;
+	s->offset    = offset;
+	s->size      = size;
+	s->is_proc   = is_proc;
+	s->is_global = is_global;
+	return index;
+}
+
+void ssa_object_add_relocation(ssaObject *o, ssaObjectSectionKind section, i64 offset,
+                               isize symbol, ssaRelocationKind kind, i64 addend) {
+	ssaRelocation r = {};
+	r.section = section;
+	r.offset  = offset;
+	r.symbol  = symbol;
+	r.kind    = kind;
+	r.addend  = addend;
+	array_add(&o->relocations, r);
+}
+
+i64 ssa_object_align_section(ssaObject *o, ssaObjectSectionKind section, i64 align) {
+	Array<u8> *data = &o->sections[section];
+	while (data->count % align != 0) {
+		array_add(data, cast(u8)0);
+	}
+	return data->count;
+}
+
+i64 ssa_object_reserve_bss(ssaObject *o, i64 size, i64 align) {
+	o->bss_size = align_formula(o->bss_size, align);
+	i64 offset = o->bss_size;
+	o->bss_size += size;
+	return offset;
+}
+
+// NOTE: String constants are NUL terminated and deduplicated
+i64 ssa_object_add_string(ssaObject *o, String str) {
+	HashKey key = hash_string(str);
+	i64 *found = map_get(&o->strings, key);
+	if (found != NULL) {
+		return *found;
+	}
+	Array<u8> *rodata = &o->sections[ssaObjectSection_Rodata];
+	i64 offset = rodata->count;
+	for (isize i = 0; i < str.len; i++) {
+		array_add(rodata, str[i]);
+	}
+	array_add(rodata, cast(u8)0);
+	map_set(&o->strings, key, offset);
+	return offset;
+}
+
+
+
+enum {
+	ssaElf_SHT_PROGBITS = 1,
+	ssaElf_SHT_SYMTAB   = 2,
+	ssaElf_SHT_STRTAB   = 3,
+	ssaElf_SHT_RELA     = 4,
+	ssaElf_SHT_NOBITS   = 8,
+
+	ssaElf_SHF_WRITE     = 0x1,
+	ssaElf_SHF_ALLOC     = 0x2,
+	ssaElf_SHF_EXECINSTR = 0x4,
+	ssaElf_SHF_INFO_LINK = 0x40,
+
+	ssaElf_STB_LOCAL  = 0,
+	ssaElf_STB_GLOBAL = 1,
+
+	ssaElf_STT_NOTYPE  = 0,
+	ssaElf_STT_OBJECT  = 1,
+	ssaElf_STT_FUNC    = 2,
+	ssaElf_STT_SECTION = 3,
+
+	ssaElf_R_X86_64_64    = 1,
+	ssaElf_R_X86_64_PC32  = 2,
+	ssaElf_R_X86_64_PLT32 = 4,
+};
+
+// NOTE: Section header indices within the written file
+enum ssaElfSection {
+	ssaElfSection_Null,
+	ssaElfSection_Text,
+	ssaElfSection_Rodata,
+	ssaElfSection_Data,
+	ssaElfSection_Bss,
+	ssaElfSection_RelaText,
+	ssaElfSection_RelaRodata,
+	ssaElfSection_RelaData,
+	ssaElfSection_Symtab,
+	ssaElfSection_Strtab,
+	ssaElfSection_Shstrtab,
+	ssaElfSection_NoteStack,
+
+	ssaElfSection_Count,
+};
+
+struct ssaElfSectionHeader {
+	u32 name;
+	u32 type;
+	u64 flags;
+	u64 offset;
+	u64 size;
+	u32 link;
+	u32 info;
+	u64 addralign;
+	u64 entsize;
+};
+
+void ssa_elf_write(Array<u8> *b, void const *data, isize size) {
+	u8 const *bytes = cast(u8 const *)data;
+	for (isize i = 0; i < size; i++) {
+		array_add(b, bytes[i]);
+	}
+}
+void ssa_elf_u8 (Array<u8> *b, u8  x) { ssa_elf_write(b, &x, 1); }
+void ssa_elf_u16(Array<u8> *b, u16 x) { ssa_elf_write(b, &x, 2); }
+void ssa_elf_u32(Array<u8> *b, u32 x) { ssa_elf_write(b, &x, 4); }
+void ssa_elf_u64(Array<u8> *b, u64 x) { ssa_elf_write(b, &x, 8); }
+
+void ssa_elf_align(Array<u8> *b, isize align) {
+	while (b->count % align != 0) {
+		array_add(b, cast(u8)0);
+	}
+}
+
+u32 ssa_elf_add_name(Array<u8> *strtab, String name) {
+	u32 offset = cast(u32)strtab->count;
+	ssa_elf_write(strtab, name.text, name.len);
+	array_add(strtab, cast(u8)0);
+	return offset;
+}
+
+u32 ssa_elf_section_index(ssaObjectSectionKind section) {
+	switch (section) {
+	case ssaObjectSection_Text:   return ssaElfSection_Text;
+	case ssaObjectSection_Rodata: return ssaElfSection_Rodata;
+	case ssaObjectSection_Data:   return ssaElfSection_Data;
+	case ssaObjectSection_Bss:    return ssaElfSection_Bss;
+	}
+	return 0; // SHN_UNDEF
+}
+
+bool ssa_object_write_elf(ssaObject *o, String path) {
+	Array<u8> file     = {};
+	Array<u8> strtab   = {};
+	Array<u8> shstrtab = {};
+	Array<u8> symtab   = {};
+	Array<u8> rela[ssaObjectSection_Count] = {};
+	array_init(&file,     heap_allocator(), 1<<16);
+	array_init(&strtab,   heap_allocator());
+	array_init(&shstrtab, heap_allocator());
+	array_init(&symtab,   heap_allocator());
+	for (isize i = 0; i < ssaObjectSection_Count; i++) {
+		array_init(&rela[i], heap_allocator());
+	}
+	defer (array_free(&file));
+	defer (array_free(&strtab));
+	defer (array_free(&shstrtab));
+	defer (array_free(&symtab));
+	defer (for (isize i = 0; i < ssaObjectSection_Count; i++) array_free(&rela[i]));
+
+	// NOTE: ELF requires every local symbol to come before the global ones
+	isize *elf_symbol_index = gb_alloc_array(heap_allocator(), isize, o->symbols.count);
+	defer (gb_free(heap_allocator(), elf_symbol_index));
+
+	array_add(&strtab, cast(u8)0);
+	for (isize i = 0; i < 24; i++) {
+		array_add(&symtab, cast(u8)0); // Null symbol
+	}
+
+	u32 symbol_count = 1;
+	u32 first_global = 0;
+	for (isize pass = 0; pass < 2; pass++) {
+		bool want_global = pass == 1;
+		if (want_global) {
+			first_global = symbol_count;
+		}
+		for_array(i, o->symbols) {
+			ssaObjectSymbol *s = &o->symbols[i];
+			if (s->section == ssaObjectSection_Undefined && s->is_section) {
+				continue; // NOTE: Placeholder for the undefined section
+			}
+			if (s->is_global != want_global) {
+				continue;
+			}
+			u8 bind = s->is_global ? ssaElf_STB_GLOBAL : ssaElf_STB_LOCAL;
+			u8 type = ssaElf_STT_NOTYPE;
+			u32 name = 0;
+			if (s->is_section) {
+				type = ssaElf_STT_SECTION;
+			} else {
+				name = ssa_elf_add_name(&strtab, s->name);
+				if (s->is_proc) {
+					type = ssaElf_STT_FUNC;
+				} else if (s->section != ssaObjectSection_Undefined) {
+					type = ssaElf_STT_OBJECT;
+				}
+			}
+
+			ssa_elf_u32(&symtab, name);
+			ssa_elf_u8 (&symtab, cast(u8)((bind<<4) | type));
+			ssa_elf_u8 (&symtab, 0);
+			ssa_elf_u16(&symtab, cast(u16)ssa_elf_section_index(s->section));
+			ssa_elf_u64(&symtab, cast(u64)s->offset);
+			ssa_elf_u64(&symtab, cast(u64)s->size);
+			elf_symbol_index[i] = symbol_count++;
+		}
+	}
+
+	for_array(i, o->relocations) {
+		ssaRelocation *r = &o->relocations[i];
+		GB_ASSERT(r->section != ssaObjectSection_Undefined && r->section != ssaObjectSection_Bss);
+		u64 type = 0;
+		switch (r->kind) {
+		case ssaRelocation_PC32:  type = ssaElf_R_X86_64_PC32;  break;
+		case ssaRelocation_PLT32: type = ssaElf_R_X86_64_PLT32; break;
+		case ssaRelocation_Abs64: type = ssaElf_R_X86_64_64;    break;
+		}
+		u64 sym = cast(u64)elf_symbol_index[r->symbol];
+		ssa_elf_u64(&rela[r->section], cast(u64)r->offset);
+		ssa_elf_u64(&rela[r->section], (sym << 32) | type);
+		ssa_elf_u64(&rela[r->section], cast(u64)r->addend);
+	}
+
+
+	ssaElfSectionHeader headers[ssaElfSection_Count] = {};
+	array_add(&shstrtab, cast(u8)0);
+
+	for (isize i = 0; i < 64; i++) {
+		array_add(&file, cast(u8)0); // NOTE: The ELF header is filled in at the end
+	}
+
+	#define SSA_ELF_SECTION(index_, name_, type_, flags_, data_, size_, align_, link_, info_, entsize_) do { \
+		ssaElfSectionHeader *h = &headers[index_]; \
+		ssa_elf_align(&file, (align_)); \
+		h->name      = ssa_elf_add_name(&shstrtab, str_lit(name_)); \
+		h->type      = (type_); \
+		h->flags     = (flags_); \
+		h->offset    = file.count; \
+		h->size      = (size_); \
+		h->link      = (link_); \
+		h->info      = (info_); \
+		h->addralign = (align_); \
+		h->entsize   = (entsize_); \
+		if ((data_) != NULL) { ssa_elf_write(&file, (data_)->data, (data_)->count); } \
+	} while (0)
+
+	Array<u8> *text   = &o->sections[ssaObjectSection_Text];
+	Array<u8> *rodata = &o->sections[ssaObjectSection_Rodata];
+	Array<u8> *data   = &o->sections[ssaObjectSection_Data];
+	Array<u8> *none   = NULL;
+
+	SSA_ELF_SECTION(ssaElfSection_Text,   ".text",   ssaElf_SHT_PROGBITS, ssaElf_SHF_ALLOC|ssaElf_SHF_EXECINSTR, text,   text->count,   16, 0, 0, 0);
+	SSA_ELF_SECTION(ssaElfSection_Rodata, ".rodata", ssaElf_SHT_PROGBITS, ssaElf_SHF_ALLOC,                      rodata, rodata->count, 16, 0, 0, 0);
+	SSA_ELF_SECTION(ssaElfSection_Data,   ".data",   ssaElf_SHT_PROGBITS, ssaElf_SHF_ALLOC|ssaElf_SHF_WRITE,     data,   data->count,   16, 0, 0, 0);
+	SSA_ELF_SECTION(ssaElfSection_Bss,    ".bss",    ssaElf_SHT_NOBITS,   ssaElf_SHF_ALLOC|ssaElf_SHF_WRITE,     none,   o->bss_size,   16, 0, 0, 0);
+
+	Array<u8> *rela_text   = &rela[ssaObjectSection_Text];
+	Array<u8> *rela_rodata = &rela[ssaObjectSection_Rodata];
+	Array<u8> *rela_data   = &rela[ssaObjectSection_Data];
+	SSA_ELF_SECTION(ssaElfSection_RelaText,   ".rela.text",   ssaElf_SHT_RELA, ssaElf_SHF_INFO_LINK, rela_text,   rela_text->count,   8, ssaElfSection_Symtab, ssaElfSection_Text,   24);
+	SSA_ELF_SECTION(ssaElfSection_RelaRodata, ".rela.rodata", ssaElf_SHT_RELA, ssaElf_SHF_INFO_LINK, rela_rodata, rela_rodata->count, 8, ssaElfSection_Symtab, ssaElfSection_Rodata, 24);
+	SSA_ELF_SECTION(ssaElfSection_RelaData,   ".rela.data",   ssaElf_SHT_RELA, ssaElf_SHF_INFO_LINK, rela_data,   rela_data->count,   8, ssaElfSection_Symtab, ssaElfSection_Data,   24);
+
+	SSA_ELF_SECTION(ssaElfSection_Symtab, ".symtab", ssaElf_SHT_SYMTAB, 0, &symtab, symtab.count, 8, ssaElfSection_Strtab, first_global, 24);
+	SSA_ELF_SECTION(ssaElfSection_Strtab, ".strtab", ssaElf_SHT_STRTAB, 0, &strtab, strtab.count, 1, 0, 0, 0);
+	// NOTE: Marks the stack as non-executable
+	SSA_ELF_SECTION(ssaElfSection_NoteStack, ".note.GNU-stack", ssaElf_SHT_PROGBITS, 0, none, 0, 1, 0, 0, 0);
+	// NOTE: .shstrtab must be written last as it contains its own name
+	SSA_ELF_SECTION(ssaElfSection_Shstrtab, ".shstrtab", ssaElf_SHT_STRTAB, 0, &shstrtab, shstrtab.count, 1, 0, 0, 0);
+
+	#undef SSA_ELF_SECTION
+
+	ssa_elf_align(&file, 8);
+	u64 section_header_offset = file.count;
+	for (isize i = 0; i < ssaElfSection_Count; i++) {
+		ssaElfSectionHeader *h = &headers[i];
+		ssa_elf_u32(&file, h->name);
+		ssa_elf_u32(&file, h->type);
+		ssa_elf_u64(&file, h->flags);
+		ssa_elf_u64(&file, 0); // addr
+		ssa_elf_u64(&file, h->offset);
+		ssa_elf_u64(&file, h->size);
+		ssa_elf_u32(&file, h->link);
+		ssa_elf_u32(&file, h->info);
+		ssa_elf_u64(&file, h->addralign);
+		ssa_elf_u64(&file, h->entsize);
+	}
+
+	{ // ELF header
+		Array<u8> header = {};
+		array_init(&header, heap_allocator(), 64);
+		defer (array_free(&header));
+
+		u8 ident[16] = {0x7f, 'E', 'L', 'F', 2 /* 64-bit */, 1 /* little endian */, 1 /* version */, 0 /* System V */};
+		ssa_elf_write(&header, ident, gb_size_of(ident));
+		ssa_elf_u16(&header, 1);  // ET_REL
+		ssa_elf_u16(&header, 62); // EM_X86_64
+		ssa_elf_u32(&header, 1);  // EV_CURRENT
+		ssa_elf_u64(&header, 0);  // entry
+		ssa_elf_u64(&header, 0);  // program header offset
+		ssa_elf_u64(&header, section_header_offset);
+		ssa_elf_u32(&header, 0);  // flags
+		ssa_elf_u16(&header, 64); // ELF header size
+		ssa_elf_u16(&header, 0);  // program header entry size
+		ssa_elf_u16(&header, 0);  // program header count
+		ssa_elf_u16(&header, 64); // section header entry size
+		ssa_elf_u16(&header, ssaElfSection_Count);
+		ssa_elf_u16(&header, ssaElfSection_Shstrtab);
+		GB_ASSERT(header.count == 64);
+		gb_memmove(file.data, header.data, 64);
+	}
+
+	gbFile f = {};
+	if (gb_file_create(&f, gb_bprintf("%.*s", LIT(path))) != gbFileError_None) {
+		gb_printf_err("Unable to create object file: %.*s\n", LIT(path));
+		return false;
+	}
+	defer (gb_file_close(&f));
+	return gb_file_write(&f, file.data, file.count);
+}
@@ -11,6 +11,7 @@
 	SSA_OP(Local)\
 	SSA_OP(Global)\
 	SSA_OP(Proc)\
+	SSA_OP(Arg) /* Incoming parameter, exact_value is its index */\
 \
 	SSA_OP(Load)\
 	SSA_OP(Store)\
@@ -0,0 +1,965 @@
+// NOTE: Machine independent optimisation passes over the SSA form
+//
+// Each pass rewrites a single procedure in place and returns the number of changes it made.
+// Values are never deleted while a pass is running, instead they are rewritten into a `Copy`
+// or left with no uses, and are then removed by the copy propagation and dead code passes.
+
+typedef isize ssaPassProc(ssaProc *p);
+
+struct ssaPass {
+	String       name;
+	String       counter_label; // Reported with -show-timings
+	ssaPassProc *proc;
+};
+
+
+bool ssa_op_is_const(ssaOp op) {
+	switch (op) {
+	case ssaOp_ConstBool:
+	case ssaOp_Const8:
+	case ssaOp_Const16:
+	case ssaOp_Const32:
+	case ssaOp_Const64:
+	case ssaOp_Const32F:
+	case ssaOp_Const64F:
+		return true;
+	}
+	return false;
+}
+
+// NOTE: A value that has no uses and no side effects may be removed
+bool ssa_op_has_side_effects(ssaOp op) {
+	switch (op) {
+	case ssaOp_Arg: // NOTE: Its position determines the incoming register
+	case ssaOp_Store:
+	case ssaOp_Move:
+	case ssaOp_StoreReg:
+	case ssaOp_Zero:
+	case ssaOp_CallOdin:
+	case ssaOp_CallC:
+	case ssaOp_CallStd:
+	case ssaOp_CallFast:
+	case ssaOp_BoundsCheck:
+	case ssaOp_SliceBoundsCheck:
+	case ssaOp_Assume:
+	case ssaOp_DebugTrap:
+	case ssaOp_Trap:
+	case ssaOp_ReadCycleCounter:
+		return true;
+	}
+	return false;
+}
+
+// NOTE: Two pure values with the same op, type, auxiliary value and arguments are equal
+bool ssa_op_is_pure(ssaOp op) {
+	if (ssa_op_has_side_effects(op)) {
+		return false;
+	}
+	switch (op) {
+	case ssaOp_Invalid:
+	case ssaOp_Unknown:
+	case ssaOp_Comment:
+	case ssaOp_SP:
+	case ssaOp_SB:
+	case ssaOp_Local:
+	case ssaOp_Global:
+	case ssaOp_Proc:
+	case ssaOp_Load:
+	case ssaOp_LoadReg:
+	case ssaOp_Phi:
+	case ssaOp_Copy:
+		return false;
+	}
+	return true;
+}
+
+// NOTE: Constants are stored sign extended from their size, see `ssa_const_int`
+i64 ssa_opt_normalise(i64 x, i64 size) {
+	switch (size) {
+	case 1: return cast(i64)cast(i8)x;
+	case 2: return cast(i64)cast(i16)x;
+	case 4: return cast(i64)cast(i32)x;
+	}
+	return x;
+}
+
+i64 ssa_opt_signed_min(i64 size) {
+	if (size >= 8) {
+		return I64_MIN;
+	}
+	return -(1ll << (size*8-1));
+}
+
+u64 ssa_opt_zero_extend(i64 x, i64 size) {
+	switch (size) {
+	case 1: return cast(u64)cast(u8)x;
+	case 2: return cast(u64)cast(u16)x;
+	case 4: return cast(u64)cast(u32)x;
+	}
+	return cast(u64)x;
+}
+
+i64 ssa_opt_size_of(Type *t) {
+	return type_size_of(heap_allocator(), default_type(t));
+}
+
+i64 ssa_opt_int(ssaValue *v) {
+	return big_int_to_i64(v->exact_value.value_integer);
+}
+
+void ssa_opt_set_int(ssaValue *v, i64 x) {
+	i64 size = ssa_opt_size_of(v->type);
+	ssaOp op = ssaOp_Invalid;
+	switch (size) {
+	case 1: op = ssaOp_Const8;  break;
+	case 2: op = ssaOp_Const16; break;
+	case 4: op = ssaOp_Const32; break;
+	case 8: op = ssaOp_Const64; break;
+	default: return;
+	}
+	ssa_reset(v, op);
+	v->exact_value = exact_value_i64(ssa_opt_normalise(x, size));
+}
+
+void ssa_opt_set_bool(ssaValue *v, bool b) {
+	ssa_reset(v, ssaOp_ConstBool);
+	v->exact_value = exact_value_bool(b);
+}
+
+void ssa_opt_set_float(ssaValue *v, f64 f) {
+	i64 size = ssa_opt_size_of(v->type);
+	if (size == 4) {
+		ssa_reset(v, ssaOp_Const32F);
+		f = cast(f64)cast(f32)f;
+	} else {
+		ssa_reset(v, ssaOp_Const64F);
+	}
+	v->exact_value = exact_value_float(f);
+}
+
+void ssa_opt_set_copy(ssaValue *v, ssaValue *x) {
+	x->uses++; // NOTE: `x` may be one of the arguments being reset
+	ssa_reset(v, ssaOp_Copy);
+	ssa_add_arg(&v->args, x);
+	x->uses--;
+}
+
+
+////////////////////////////////////////////////////////////////
+//
+// Control flow graph
+//
+////////////////////////////////////////////////////////////////
+
+// NOTE: Removes the `i`th predecessor of `b` and the matching phi arguments
+void ssa_remove_pred(ssaBlock *b, isize i) {
+	for (isize j = i+1; j < b->preds.count; j++) {
+		ssaEdge e = b->preds[j];
+		b->preds[j-1] = e;
+		e.block->succs[e.index].index = j-1;
+	}
+	array_pop(&b->preds);
+
+	for_array(k, b->values) {
+		ssaValue *v = b->values[k];
+		if (v->op != ssaOp_Phi) {
+			continue;
+		}
+		v->args[i]->uses--;
+		for (isize j = i+1; j < v->args.count; j++) {
+			v->args[j-1] = v->args[j];
+		}
+		v->args.count--;
+	}
+}
+
+void ssa_remove_edge(ssaBlock *b, isize i) {
+	ssaEdge e = b->succs[i];
+	for (isize j = i+1; j < b->succs.count; j++) {
+		ssaEdge s = b->succs[j];
+		b->succs[j-1] = s;
+		s.block->preds[s.index].index = j-1;
+	}
+	array_pop(&b->succs);
+	ssa_remove_pred(e.block, e.index);
+}
+
+// NOTE: `d` must not have any phis as there would be no argument for the new edge
+void ssa_redirect_edge(ssaBlock *b, isize i, ssaBlock *d) {
+	ssaEdge e = b->succs[i];
+	ssa_remove_pred(e.block, e.index);
+	ssaEdge s = {d, d->preds.count};
+	ssaEdge p = {b, i};
+	b->succs[i] = s;
+	array_add(&d->preds, p);
+}
+
+bool ssa_block_has_phis(ssaBlock *b) {
+	for_array(i, b->values) {
+		if (b->values[i]->op == ssaOp_Phi) {
+			return true;
+		}
+	}
+	return false;
+}
+
+struct ssaOptCfg {
+	Array<ssaBlock *> rpo;       // Reachable blocks in reverse postorder
+	i32 *             rpo_index; // Indexed by ssaBlock.id, -1 if unreachable
+	ssaBlock **       idom;      // Indexed by ssaBlock.id
+};
+
+void ssa_opt_cfg_postorder(ssaOptCfg *cfg, ssaBlock *b, bool *visited) {
+	visited[b->id] = true;
+	for_array(i, b->succs) {
+		ssaBlock *s = b->succs[i].block;
+		if (!visited[s->id]) {
+			ssa_opt_cfg_postorder(cfg, s, visited);
+		}
+	}
+	array_add(&cfg->rpo, b);
+}
+
+ssaBlock *ssa_opt_cfg_intersect(ssaOptCfg *cfg, ssaBlock *a, ssaBlock *b) {
+	while (a != b) {
+		while (cfg->rpo_index[a->id] > cfg->rpo_index[b->id]) {
+			a = cfg->idom[a->id];
+		}
+		while (cfg->rpo_index[b->id] > cfg->rpo_index[a->id]) {
+			b = cfg->idom[b->id];
+		}
+	}
+	return a;
+}
+
+// NOTE: Dominators are computed with "A Simple, Fast Dominance Algorithm" (Cooper, Harvey & Kennedy)
+void ssa_opt_cfg_init(ssaOptCfg *cfg, ssaProc *p) {
+	gbAllocator a = heap_allocator();
+	isize block_count = gb_max(p->block_id, 1);
+	array_init(&cfg->rpo, a, p->blocks.count);
+	cfg->rpo_index = gb_alloc_array(a, i32,        block_count);
+	cfg->idom      = gb_alloc_array(a, ssaBlock *, block_count);
+	bool *visited  = gb_alloc_array(a, bool,       block_count);
+	defer (gb_free(a, visited));
+	gb_zero_size(visited,   gb_size_of(bool)*block_count);
+	gb_zero_size(cfg->idom, gb_size_of(ssaBlock *)*block_count);
+	for (isize i = 0; i < block_count; i++) {
+		cfg->rpo_index[i] = -1;
+	}
+
+	ssa_opt_cfg_postorder(cfg, p->entry, visited);
+	for (isize i = 0, j = cfg->rpo.count-1; i < j; i++, j--) {
+		gb_swap(ssaBlock *, cfg->rpo[i], cfg->rpo[j]);
+	}
+	for_array(i, cfg->rpo) {
+		cfg->rpo_index[cfg->rpo[i]->id] = cast(i32)i;
+	}
+
+	cfg->idom[p->entry->id] = p->entry;
+	for (bool changed = true; changed; ) {
+		changed = false;
+		for (isize i = 1; i < cfg->rpo.count; i++) {
+			ssaBlock *b = cfg->rpo[i];
+			ssaBlock *new_idom = NULL;
+			for_array(j, b->preds) {
+				ssaBlock *pred = b->preds[j].block;
+				if (cfg->idom[pred->id] == NULL) {
+					continue;
+				}
+				if (new_idom == NULL) {
+					new_idom = pred;
+				} else {
+					new_idom = ssa_opt_cfg_intersect(cfg, pred, new_idom);
+				}
+			}
+			if (cfg->idom[b->id] != new_idom) {
+				cfg->idom[b->id] = new_idom;
+				changed = true;
+			}
+		}
+	}
+}
+
+void ssa_opt_cfg_destroy(ssaOptCfg *cfg) {
+	array_free(&cfg->rpo);
+	gb_free(heap_allocator(), cfg->rpo_index);
+	gb_free(heap_allocator(), cfg->idom);
+}
+
+bool ssa_opt_dominates(ssaOptCfg *cfg, ssaBlock *a, ssaBlock *b) {
+	if (cfg->rpo_index[a->id] < 0 || cfg->rpo_index[b->id] < 0) {
+		return false;
+	}
+	for (;;) {
+		if (a == b) {
+			return true;
+		}
+		ssaBlock *up = cfg->idom[b->id];
+		if (up == b) {
+			return false; // NOTE: Reached the entry block
+		}
+		b = up;
+	}
+}
+
+// NOTE: Removes the blocks that were cleared with `ssa_clear_block`
+void ssa_opt_compact_blocks(ssaProc *p) {
+	isize n = 0;
+	for_array(i, p->blocks) {
+		ssaBlock *b = p->blocks[i];
+		if (b->proc != NULL) {
+			p->blocks[n++] = b;
+		}
+	}
+	p->blocks.count = n;
+}
+
+// NOTE: The successor edges of every block being removed must be removed beforehand
+void ssa_opt_remove_block(ssaProc *p, ssaBlock *b) {
+	GB_ASSERT(b->succs.count == 0);
+	for_array(i, b->values) {
+		ssa_reset_value_args(b->values[i]);
+	}
+	ssa_set_control(b, NULL);
+	if (p->exit == b) {
+		p->exit = NULL;
+	}
+	ssa_clear_block(p, b);
+}
+
+
+////////////////////////////////////////////////////////////////
+//
+// Passes
+//
+////////////////////////////////////////////////////////////////
+
+bool ssa_opt_fold_value(ssaValue *v) {
+	if (v->args.count == 0 || (v->op != ssaOp_Copy && !ssa_op_is_pure(v->op))) {
+		return false;
+	}
+	ssaValue *x = v->args[0];
+	ssaValue *y = v->args.count > 1 ? v->args[1] : NULL;
+	bool cx = ssa_op_is_const(x->op);
+	bool cy = y != NULL && ssa_op_is_const(y->op);
+
+	switch (v->op) {
+	case ssaOp_Copy:
+		if (!cx) {
+			return false;
+		}
+		if (x->op == ssaOp_ConstBool) {
+			ssa_opt_set_bool(v, x->exact_value.value_bool);
+		} else if (x->op == ssaOp_Const32F || x->op == ssaOp_Const64F) {
+			ssa_opt_set_float(v, x->exact_value.value_float);
+		} else if (is_type_integer(core_type(default_type(v->type))) ||
+		           is_type_pointer(core_type(default_type(v->type)))) {
+			ssa_opt_set_int(v, ssa_opt_int(x));
+		} else {
+			return false;
+		}
+		return true;
+
+	case ssaOp_NotB:
+		if (!cx) return false;
+		ssa_opt_set_bool(v, !x->exact_value.value_bool);
+		return true;
+	case ssaOp_EqB:
+	case ssaOp_NeB:
+		if (!cx || !cy) return false;
+		ssa_opt_set_bool(v, (x->exact_value.value_bool == y->exact_value.value_bool) == (v->op == ssaOp_EqB));
+		return true;
+
+	case ssaOp_Neg8: case ssaOp_Neg16: case ssaOp_Neg32: case ssaOp_Neg64:
+		if (!cx) return false;
+		ssa_opt_set_int(v, cast(i64)(0ull - cast(u64)ssa_opt_int(x)));
+		return true;
+	case ssaOp_Not8: case ssaOp_Not16: case ssaOp_Not32: case ssaOp_Not64:
+		if (!cx) return false;
+		ssa_opt_set_int(v, ~ssa_opt_int(x));
+		return true;
+	case ssaOp_Neg32F: case ssaOp_Neg64F:
+		if (!cx) return false;
+		ssa_opt_set_float(v, -x->exact_value.value_float);
+		return true;
+
+	case ssaOp_SignExt8to16: case ssaOp_SignExt8to32: case ssaOp_SignExt8to64:
+	case ssaOp_SignExt16to32: case ssaOp_SignExt16to64:
+	case ssaOp_SignExt32to64:
+	case ssaOp_Trunc16to8: case ssaOp_Trunc32to8: case ssaOp_Trunc32to16:
+	case ssaOp_Trunc64to8: case ssaOp_Trunc64to16: case ssaOp_Trunc64to32:
+		if (!cx) return false;
+		ssa_opt_set_int(v, ssa_opt_int(x)); // NOTE: Normalised to the new size
+		return true;
+	case ssaOp_ZeroExt8to16: case ssaOp_ZeroExt8to32: case ssaOp_ZeroExt8to64:
+	case ssaOp_ZeroExt16to32: case ssaOp_ZeroExt16to64:
+	case ssaOp_ZeroExt32to64:
+		if (!cx) return false;
+		ssa_opt_set_int(v, cast(i64)ssa_opt_zero_extend(ssa_opt_int(x), ssa_opt_size_of(x->type)));
+		return true;
+
+	case ssaOp_Cvt32to32F: case ssaOp_Cvt32to64F: case ssaOp_Cvt64to32F: case ssaOp_Cvt64to64F:
+		if (!cx) return false;
+		ssa_opt_set_float(v, cast(f64)ssa_opt_int(x));
+		return true;
+	case ssaOp_Cvt32Uto32F: case ssaOp_Cvt32Uto64F: case ssaOp_Cvt64Uto32F: case ssaOp_Cvt64Uto64F:
+		if (!cx) return false;
+		ssa_opt_set_float(v, cast(f64)ssa_opt_zero_extend(ssa_opt_int(x), ssa_opt_size_of(x->type)));
+		return true;
+	case ssaOp_Cvt32Fto64F: case ssaOp_Cvt64Fto32F:
+		if (!cx) return false;
+		ssa_opt_set_float(v, x->exact_value.value_float);
+		return true;
+	case ssaOp_Cvt32Fto32: case ssaOp_Cvt32Fto64: case ssaOp_Cvt64Fto32: case ssaOp_Cvt64Fto64: {
+		if (!cx) return false;
+		f64 f = x->exact_value.value_float;
+		// NOTE: Out of range conversions are left to the target
+		if (!(f > -9223372036854775808.0 && f < 9223372036854775808.0)) return false;
+		ssa_opt_set_int(v, cast(i64)f);
+		return true;
+	}
+	}
+
+	if (!cx || !cy) {
+		// NOTE: Algebraic identities with a single constant operand
+		ssaValue *c = cy ? y : (cx ? x : NULL);
+		ssaValue *other = cy ? x : y;
+		if (c == NULL || other == NULL || c->op == ssaOp_ConstBool ||
+		    c->op == ssaOp_Const32F || c->op == ssaOp_Const64F ||
+		    !are_types_identical(other->type, v->type)) {
+			return false;
+		}
+		i64 k = ssa_opt_int(c);
+		switch (v->op) {
+		case ssaOp_Add8: case ssaOp_Add16: case ssaOp_Add32: case ssaOp_Add64:
+		case ssaOp_Or8:  case ssaOp_Or16:  case ssaOp_Or32:  case ssaOp_Or64:
+		case ssaOp_Xor8: case ssaOp_Xor16: case ssaOp_Xor32: case ssaOp_Xor64:
+			if (k == 0) {
+				ssa_opt_set_copy(v, other);
+				return true;
+			}
+			break;
+		case ssaOp_Sub8: case ssaOp_Sub16: case ssaOp_Sub32: case ssaOp_Sub64:
+			if (k == 0 && c == y) {
+				ssa_opt_set_copy(v, other);
+				return true;
+			}
+			break;
+		case ssaOp_Mul8: case ssaOp_Mul16: case ssaOp_Mul32: case ssaOp_Mul64:
+			if (k == 1) {
+				ssa_opt_set_copy(v, other);
+				return true;
+			} else if (k == 0) {
+				ssa_opt_set_int(v, 0);
+				return true;
+			}
+			break;
+		case ssaOp_And8: case ssaOp_And16: case ssaOp_And32: case ssaOp_And64:
+			if (k == 0) {
+				ssa_opt_set_int(v, 0);
+				return true;
+			} else if (k == -1) {
+				ssa_opt_set_copy(v, other);
+				return true;
+			}
+			break;
+		}
+		return false;
+	}
+
+	i64 a = ssa_opt_int(x);
+	i64 b = ssa_opt_int(y);
+	i64 size = ssa_opt_size_of(x->type);
+	u64 ua = ssa_opt_zero_extend(a, size);
+	u64 ub = ssa_opt_zero_extend(b, size);
+	bool is_unsigned = is_type_unsigned(core_type(default_type(x->type))) || is_type_pointer(core_type(x->type));
+	f64 fa = x->exact_value.value_float;
+	f64 fb = y->exact_value.value_float;
+
+	switch (v->op) {
+	case ssaOp_Add8: case ssaOp_Add16: case ssaOp_Add32: case ssaOp_Add64:
+		ssa_opt_set_int(v, cast(i64)(ua + ub));
+		return true;
+	case ssaOp_Sub8: case ssaOp_Sub16: case ssaOp_Sub32: case ssaOp_Sub64:
+		ssa_opt_set_int(v, cast(i64)(ua - ub));
+		return true;
+	case ssaOp_Mul8: case ssaOp_Mul16: case ssaOp_Mul32: case ssaOp_Mul64:
+		ssa_opt_set_int(v, cast(i64)(ua * ub));
+		return true;
+	case ssaOp_And8: case ssaOp_And16: case ssaOp_And32: case ssaOp_And64:
+		ssa_opt_set_int(v, a & b);
+		return true;
+	case ssaOp_Or8: case ssaOp_Or16: case ssaOp_Or32: case ssaOp_Or64:
+		ssa_opt_set_int(v, a | b);
+		return true;
+	case ssaOp_Xor8: case ssaOp_Xor16: case ssaOp_Xor32: case ssaOp_Xor64:
+		ssa_opt_set_int(v, a ^ b);
+		return true;
+	case ssaOp_AndNot8: case ssaOp_AndNot16: case ssaOp_AndNot32: case ssaOp_AndNot64:
+		ssa_opt_set_int(v, a & ~b);
+		return true;
+
+	// NOTE: Division by zero and overflow are left to trap at runtime
+	case ssaOp_Div8: case ssaOp_Div16: case ssaOp_Div32: case ssaOp_Div64:
+		if (b == 0 || (b == -1 && a == ssa_opt_signed_min(size))) return false;
+		ssa_opt_set_int(v, a / b);
+		return true;
+	case ssaOp_Mod8: case ssaOp_Mod16: case ssaOp_Mod32: case ssaOp_Mod64:
+		if (b == 0 || (b == -1 && a == ssa_opt_signed_min(size))) return false;
+		ssa_opt_set_int(v, a % b);
+		return true;
+	case ssaOp_Div8U: case ssaOp_Div16U: case ssaOp_Div32U: case ssaOp_Div64U:
+		if (ub == 0) return false;
+		ssa_opt_set_int(v, cast(i64)(ua / ub));
+		return true;
+	case ssaOp_Mod8U: case ssaOp_Mod16U: case ssaOp_Mod32U: case ssaOp_Mod64U:
+		if (ub == 0) return false;
+		ssa_opt_set_int(v, cast(i64)(ua % ub));
+		return true;
+
+	case ssaOp_Eq8: case ssaOp_Eq16: case ssaOp_Eq32: case ssaOp_Eq64:
+		ssa_opt_set_bool(v, a == b);
+		return true;
+	case ssaOp_Ne8: case ssaOp_Ne16: case ssaOp_Ne32: case ssaOp_Ne64:
+		ssa_opt_set_bool(v, a != b);
+		return true;
+	case ssaOp_Lt8: case ssaOp_Lt16: case ssaOp_Lt32: case ssaOp_Lt64:
+		ssa_opt_set_bool(v, is_unsigned ? ua < ub : a < b);
+		return true;
+	case ssaOp_Gt8: case ssaOp_Gt16: case ssaOp_Gt32: case ssaOp_Gt64:
+		ssa_opt_set_bool(v, is_unsigned ? ua > ub : a > b);
+		return true;
+	case ssaOp_Le8: case ssaOp_Le16: case ssaOp_Le32: case ssaOp_Le64:
+		ssa_opt_set_bool(v, is_unsigned ? ua <= ub : a <= b);
+		return true;
+	case ssaOp_Ge8: case ssaOp_Ge16: case ssaOp_Ge32: case ssaOp_Ge64:
+		ssa_opt_set_bool(v, is_unsigned ? ua >= ub : a >= b);
+		return true;
+
+	case ssaOp_Add32F: case ssaOp_Add64F: ssa_opt_set_float(v, fa + fb); return true;
+	case ssaOp_Sub32F: case ssaOp_Sub64F: ssa_opt_set_float(v, fa - fb); return true;
+	case ssaOp_Mul32F: case ssaOp_Mul64F: ssa_opt_set_float(v, fa * fb); return true;
+	case ssaOp_Div32F: case ssaOp_Div64F: ssa_opt_set_float(v, fa / fb); return true;
+
+	case ssaOp_Eq32F: case ssaOp_Eq64F: ssa_opt_set_bool(v, fa == fb); return true;
+	case ssaOp_Ne32F: case ssaOp_Ne64F: ssa_opt_set_bool(v, fa != fb); return true;
+	case ssaOp_Lt32F: case ssaOp_Lt64F: ssa_opt_set_bool(v, fa <  fb); return true;
+	case ssaOp_Gt32F: case ssaOp_Gt64F: ssa_opt_set_bool(v, fa >  fb); return true;
+	case ssaOp_Le32F: case ssaOp_Le64F: ssa_opt_set_bool(v, fa <= fb); return true;
+	case ssaOp_Ge32F: case ssaOp_Ge64F: ssa_opt_set_bool(v, fa >= fb); return true;
+	}
+
+	return false;
+}
+
+isize ssa_opt_const_fold(ssaProc *p) {
+	isize count = 0;
+	for (bool changed = true; changed; ) {
+		changed = false;
+		for_array(i, p->blocks) {
+			ssaBlock *b = p->blocks[i];
+			for_array(j, b->values) {
+				if (ssa_opt_fold_value(b->values[j])) {
+					changed = true;
+					count++;
+				}
+			}
+		}
+	}
+	return count;
+}
+
+
+// NOTE: Only copies between identical types are transparent, the others change how the value is
+// interpreted (e.g. the signedness of a comparison or the size of a store through a pointer)
+ssaValue *ssa_opt_copy_source(ssaValue *v) {
+	while (v->op == ssaOp_Copy && are_types_identical(v->type, v->args[0]->type)) {
+		v = v->args[0];
+	}
+	return v;
+}
+
+// NOTE: Returns the single value that a phi merges, if any
+ssaValue *ssa_opt_trivial_phi(ssaValue *phi) {
+	ssaValue *w = NULL;
+	for_array(i, phi->args) {
+		ssaValue *a = phi->args[i];
+		if (a == phi || a == w) {
+			continue;
+		}
+		if (w != NULL) {
+			return NULL;
+		}
+		w = a;
+	}
+	return w;
+}
+
+isize ssa_opt_copy_propagation(ssaProc *p) {
+	isize count = 0;
+	for (bool changed = true; changed; ) {
+		changed = false;
+		for_array(i, p->blocks) {
+			ssaBlock *b = p->blocks[i];
+			for_array(j, b->values) {
+				ssaValue *v = b->values[j];
+				if (v->op != ssaOp_Phi) {
+					continue;
+				}
+				ssaValue *w = ssa_opt_trivial_phi(v);
+				if (w != NULL && are_types_identical(v->type, w->type)) {
+					ssa_opt_set_copy(v, w);
+					changed = true;
+				}
+			}
+		}
+	}
+
+	for_array(i, p->blocks) {
+		ssaBlock *b = p->blocks[i];
+		for_array(j, b->values) {
+			ssaValue *v = b->values[j];
+			for_array(k, v->args) {
+				ssaValue *a = v->args[k];
+				ssaValue *w = ssa_opt_copy_source(a);
+				if (w != a) {
+					a->uses--;
+					w->uses++;
+					v->args[k] = w;
+					count++;
+				}
+			}
+		}
+		if (b->control != NULL) {
+			ssaValue *w = ssa_opt_copy_source(b->control);
+			if (w != b->control) {
+				ssa_set_control(b, w);
+				count++;
+			}
+		}
+	}
+	return count;
+}
+
+
+HashKey ssa_opt_value_hash(ssaValue *v) {
+	u64 data[4+SSA_DEFAULT_VALUE_ARG_CAPACITY] = {};
+	isize n = 0;
+	data[n++] = cast(u64)v->op;
+	data[n++] = cast(u64)ssa_opt_size_of(v->type);
+	switch (v->exact_value.kind) {
+	case ExactValue_Bool:    data[n++] = v->exact_value.value_bool; break;
+	case ExactValue_Integer: data[n++] = cast(u64)big_int_to_i64(v->exact_value.value_integer); break;
+	case ExactValue_Float:   gb_memmove(&data[n++], &v->exact_value.value_float, 8); break;
+	case ExactValue_String:  data[n++] = hash_string(v->exact_value.value_string).key; break;
+	}
+	for (isize i = 0; i < v->args.count && n < gb_count_of(data); i++) {
+		data[n++] = cast(u64)v->args[i]->id;
+	}
+	return hashing_proc(data, n*gb_size_of(u64));
+}
+
+bool ssa_opt_values_equal(ssaValue *a, ssaValue *b) {
+	if (a->op != b->op || a->args.count != b->args.count) {
+		return false;
+	}
+	if (!are_types_identical(a->type, b->type)) {
+		return false;
+	}
+	ExactValue x = a->exact_value;
+	ExactValue y = b->exact_value;
+	if (x.kind != y.kind) {
+		return false;
+	}
+	switch (x.kind) {
+	case ExactValue_Invalid: break;
+	case ExactValue_Bool:    if (x.value_bool != y.value_bool) return false; break;
+	case ExactValue_Integer: if (big_int_cmp(x.value_integer, y.value_integer) != 0) return false; break;
+	case ExactValue_Float:   if (gb_memcompare(&x.value_float, &y.value_float, 8) != 0) return false; break;
+	case ExactValue_String:  if (x.value_string != y.value_string) return false; break;
+	default:                 return false;
+	}
+	for_array(i, a->args) {
+		if (a->args[i] != b->args[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// NOTE: Global value numbering, a value is replaced by an equal value from a dominating block
+isize ssa_opt_cse(ssaProc *p) {
+	gbAllocator a = heap_allocator();
+	isize count = 0;
+
+	ssaOptCfg cfg = {};
+	ssa_opt_cfg_init(&cfg, p);
+	defer (ssa_opt_cfg_destroy(&cfg));
+
+	ssaValue **rewrite = gb_alloc_array(a, ssaValue *, gb_max(p->value_id, 1));
+	defer (gb_free(a, rewrite));
+	gb_zero_size(rewrite, gb_size_of(ssaValue *)*gb_max(p->value_id, 1));
+
+	Map<ssaValue *> table = {};
+	map_init(&table, a);
+	defer (map_destroy(&table));
+
+	for_array(i, cfg.rpo) {
+		ssaBlock *b = cfg.rpo[i];
+		for_array(j, b->values) {
+			ssaValue *v = b->values[j];
+			for_array(k, v->args) {
+				ssaValue *r = rewrite[v->args[k]->id];
+				if (r != NULL) {
+					v->args[k]->uses--;
+					r->uses++;
+					v->args[k] = r;
+				}
+			}
+			if (!ssa_op_is_pure(v->op)) {
+				continue;
+			}
+
+			HashKey key = ssa_opt_value_hash(v);
+			for (MapEntry<ssaValue *> *e = multi_map_find_first(&table, key);
+			     e != NULL;
+			     e = multi_map_find_next(&table, e)) {
+				ssaValue *w = e->value;
+				if (ssa_opt_values_equal(v, w) && ssa_opt_dominates(&cfg, w->block, b)) {
+					rewrite[v->id] = w;
+					count++;
+					break;
+				}
+			}
+			if (rewrite[v->id] == NULL) {
+				multi_map_insert(&table, key, v);
+			}
+		}
+	}
+
+	// NOTE: Phis and controls may refer to values later in the order
+	for_array(i, p->blocks) {
+		ssaBlock *b = p->blocks[i];
+		for_array(j, b->values) {
+			ssaValue *v = b->values[j];
+			for_array(k, v->args) {
+				ssaValue *r = rewrite[v->args[k]->id];
+				if (r != NULL) {
+					v->args[k]->uses--;
+					r->uses++;
+					v->args[k] = r;
+				}
+			}
+		}
+		if (b->control != NULL && rewrite[b->control->id] != NULL) {
+			ssa_set_control(b, rewrite[b->control->id]);
+		}
+	}
+	return count;
+}
+
+
+isize ssa_opt_simplify_cfg(ssaProc *p) {
+	isize count = 0;
+
+	// Constant branches and branches to the same block
+	for_array(i, p->blocks) {
+		ssaBlock *b = p->blocks[i];
+		if (b->kind != ssaBlock_If) {
+			continue;
+		}
+		GB_ASSERT(b->succs.count == 2);
+		isize dead = -1;
+		if (b->control->op == ssaOp_ConstBool) {
+			dead = b->control->exact_value.value_bool ? 1 : 0;
+		} else if (b->succs[0].block == b->succs[1].block && !ssa_block_has_phis(b->succs[0].block)) {
+			dead = 1;
+		}
+		if (dead >= 0) {
+			ssa_remove_edge(b, dead);
+			ssa_set_control(b, NULL);
+			b->kind = ssaBlock_Plain;
+			count++;
+		}
+	}
+
+	for (bool changed = true; changed; ) {
+		changed = false;
+
+		// Unreachable blocks
+		ssaOptCfg cfg = {};
+		ssa_opt_cfg_init(&cfg, p);
+		for_array(i, p->blocks) {
+			ssaBlock *b = p->blocks[i];
+			if (cfg.rpo_index[b->id] < 0) {
+				while (b->succs.count > 0) {
+					ssa_remove_edge(b, b->succs.count-1);
+				}
+			}
+		}
+		for_array(i, p->blocks) {
+			ssaBlock *b = p->blocks[i];
+			if (cfg.rpo_index[b->id] < 0) {
+				ssa_opt_remove_block(p, b);
+				changed = true;
+				count++;
+			}
+		}
+		ssa_opt_cfg_destroy(&cfg);
+		ssa_opt_compact_blocks(p);
+
+		for_array(i, p->blocks) {
+			ssaBlock *b = p->blocks[i];
+			if (b->proc == NULL || b->succs.count != 1) {
+				continue;
+			}
+			if (b->kind != ssaBlock_Plain && b->kind != ssaBlock_Entry) {
+				continue;
+			}
+			ssaBlock *c = b->succs[0].block;
+			if (c == b || c == p->entry) {
+				continue;
+			}
+
+			if (c->preds.count == 1) {
+				// Fuse `c` into `b`
+				for_array(j, c->values) {
+					ssaValue *v = c->values[j];
+					if (v->op == ssaOp_Phi) {
+						v->op = ssaOp_Copy;
+					}
+					v->block = b;
+					array_add(&b->values, v);
+				}
+				array_clear(&c->values);
+
+				array_free(&b->succs);
+				b->succs = c->succs;
+				array_init(&c->succs, heap_allocator());
+				for_array(j, b->succs) {
+					ssaEdge s = b->succs[j];
+					s.block->preds[s.index].block = b;
+				}
+				if (b->kind != ssaBlock_Entry || c->kind != ssaBlock_Plain) {
+					b->kind = c->kind;
+				}
+				b->control = c->control;
+				c->control = NULL;
+				if (p->exit == c) {
+					p->exit = b;
+				}
+				array_clear(&c->preds);
+				ssa_clear_block(p, c);
+				changed = true;
+				count++;
+			} else if (b->kind == ssaBlock_Plain && b->values.count == 0 && b != p->entry &&
+			           !ssa_block_has_phis(c)) {
+				// Jump threading through an empty block, `b` becomes unreachable
+				while (b->preds.count > 0) {
+					ssaEdge e = b->preds[0];
+					ssa_redirect_edge(e.block, e.index, c);
+				}
+				changed = true;
+				count++;
+			}
+		}
+		ssa_opt_compact_blocks(p);
+	}
+	return count;
+}
+
+
+isize ssa_opt_dead_code(ssaProc *p) {
+	isize count = 0;
+	for (bool changed = true; changed; ) {
+		changed = false;
+		for (isize i = p->blocks.count-1; i >= 0; i--) {
+			ssaBlock *b = p->blocks[i];
+			for (isize j = b->values.count-1; j >= 0; j--) {
+				ssaValue *v = b->values[j];
+				if (v->op != ssaOp_Invalid && v->uses == 0 && !ssa_op_has_side_effects(v->op)) {
+					ssa_reset_value_args(v);
+					v->op = ssaOp_Invalid;
+					changed = true;
+					count++;
+				}
+			}
+		}
+	}
+
+	for_array(i, p->blocks) {
+		ssaBlock *b = p->blocks[i];
+		isize n = 0;
+		for_array(j, b->values) {
+			ssaValue *v = b->values[j];
+			if (v->op != ssaOp_Invalid) {
+				b->values[n++] = v;
+			}
+		}
+		b->values.count = n;
+	}
+	return count;
+}
+
+
+gb_global ssaPass const ssa_passes[] = {
+	{str_lit("const fold"),       str_lit("ssa values folded"),       ssa_opt_const_fold},
+	{str_lit("copy propagation"), str_lit("ssa copies propagated"),   ssa_opt_copy_propagation},
+	{str_lit("cse"),              str_lit("ssa values numbered"),     ssa_opt_cse},
+	{str_lit("copy propagation"), str_lit("ssa copies propagated"),   ssa_opt_copy_propagation}, // NOTE: Phis may become trivial after CSE
+	{str_lit("simplify cfg"),     str_lit("ssa blocks simplified"),   ssa_opt_simplify_cfg},
+	{str_lit("dead code"),        str_lit("ssa dead values removed"), ssa_opt_dead_code},
+};
+
+isize ssa_opt_value_count(ssaProc *p) {
+	isize count = 0;
+	for_array(i, p->blocks) {
+		count += p->blocks[i]->values.count;
+	}
+	return count;
+}
+
+void ssa_opt_proc(ssaProc *p) {
+	if (p->entry == NULL) {
+		return;
+	}
+	for (isize i = 0; i < gb_count_of(ssa_passes); i++) {
+		ssa_passes[i].proc(p);
+	}
+}
+
+// NOTE: Each pass is run over every procedure in turn so that each one gets its own timings section
+void ssa_opt_procs(Array<ssaProc *> procs) {
+	isize values_before = 0;
+	for_array(i, procs) {
+		if (procs[i]->entry != NULL) {
+			values_before += ssa_opt_value_count(procs[i]);
+		}
+	}
+
+	for (isize pass_index = 0; pass_index < gb_count_of(ssa_passes); pass_index++) {
+		ssaPass const *pass = &ssa_passes[pass_index];
+		timings_begin_sub_section(&global_timings, pass->name);
+		isize changes = 0;
+		for_array(i, procs) {
+			ssaProc *p = procs[i];
+			if (p->entry == NULL) {
+				continue;
+			}
+			isize trace = trace_begin(pass->name, p->name);
+			changes += pass->proc(p);
+			trace_end(trace);
+		}
+		timings_end_sub_section(&global_timings);
+		timings_add_counter(&global_timings, pass->counter_label, changes);
+	}
+
+	isize values_after = 0;
+	for_array(i, procs) {
+		if (procs[i]->entry != NULL) {
+			values_after += ssa_opt_value_count(procs[i]);
+		}
+	}
+	timings_add_counter(&global_timings, str_lit("ssa values before opt"), values_before);
+	timings_add_counter(&global_timings, str_lit("ssa values after opt"),  values_after);
+}
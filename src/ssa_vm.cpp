@@ -0,0 +1,1344 @@
+// NOTE: Compile time execution of `#run` expressions
+//
+// The procedures called by #run expressions are built into SSA, optimised, and lowered into a
+// flat register bytecode which is then interpreted. Every ssaValue owns one 8 byte register in
+// its frame, values which do not fit into a register (strings, arrays, records, etc.) live in
+// the frame's memory and their register holds their address. Integers are always kept sign
+// extended from their size, the same as the SSA constants, so only the operations which can
+// overflow need to know their size.
+
+#define SSA_VM_STACK_SIZE (64ll*1024ll*1024ll)
+#define SSA_VM_STEP_LIMIT (1ll<<32) // NOTE: Executed jumps and calls before giving up
+
+enum ssaVmOp {
+	ssaVm_Invalid,
+
+	ssaVm_Move,        // dst = a
+	ssaVm_Copy,        // memmove(dst.ptr, a.ptr, imm)
+	ssaVm_Zero,        // memset(a.ptr, 0, imm)
+	ssaVm_Load,        // dst = `size` bytes at a.ptr+imm
+	ssaVm_Store,       // `size` bytes at a.ptr = b
+	ssaVm_Offset,      // dst = a.ptr + imm
+	ssaVm_Index,       // dst = a.ptr + b*imm
+	ssaVm_BoundsCheck, // 0 <= a < b
+
+	ssaVm_Add,
+	ssaVm_Sub,
+	ssaVm_Mul,
+	ssaVm_Div,
+	ssaVm_DivU,
+	ssaVm_Mod,
+	ssaVm_ModU,
+	ssaVm_And,
+	ssaVm_Or,
+	ssaVm_Xor,
+	ssaVm_AndNot,
+	ssaVm_Neg,
+	ssaVm_Not,
+	ssaVm_Shl,  // imm is the size of b
+	ssaVm_Shr,
+	ssaVm_ShrU,
+
+	ssaVm_Eq,
+	ssaVm_Ne,
+	ssaVm_Lt,
+	ssaVm_Le,
+	ssaVm_Gt,
+	ssaVm_Ge,
+	ssaVm_LtU,
+	ssaVm_LeU,
+	ssaVm_GtU,
+	ssaVm_GeU,
+	ssaVm_NotB,
+
+	ssaVm_SignExt, // Also used for truncation
+	ssaVm_ZeroExt,
+	ssaVm_Bswap,
+
+	ssaVm_AddF32,
+	ssaVm_SubF32,
+	ssaVm_MulF32,
+	ssaVm_DivF32,
+	ssaVm_NegF32,
+	ssaVm_EqF32,
+	ssaVm_NeF32,
+	ssaVm_LtF32,
+	ssaVm_LeF32,
+	ssaVm_GtF32,
+	ssaVm_GeF32,
+	ssaVm_AddF64,
+	ssaVm_SubF64,
+	ssaVm_MulF64,
+	ssaVm_DivF64,
+	ssaVm_NegF64,
+	ssaVm_EqF64,
+	ssaVm_NeF64,
+	ssaVm_LtF64,
+	ssaVm_LeF64,
+	ssaVm_GtF64,
+	ssaVm_GeF64,
+
+	ssaVm_IntToF32,  // size is the size of the integer
+	ssaVm_IntToF64,
+	ssaVm_UintToF32,
+	ssaVm_UintToF64,
+	ssaVm_F32ToInt,
+	ssaVm_F64ToInt,
+	ssaVm_F32ToUint,
+	ssaVm_F64ToUint,
+	ssaVm_F32ToF64,
+	ssaVm_F64ToF32,
+
+	ssaVm_Jump,   // pc = imm
+	ssaVm_Branch, // pc = a ? imm : b
+	ssaVm_Call,   // dst = procs[imm](call_args[a..a+b])
+	ssaVm_Ret,    // return a, or nothing when a == -1
+	ssaVm_Trap,
+
+	ssaVm_Count,
+};
+
+union ssaVmRegister {
+	i64  i;
+	u64  u;
+	f32  f;
+	f64  d;
+	u8 * ptr;
+};
+
+struct ssaVmInstr {
+	u8  op;
+	u8  size;
+	i32 dst;
+	i32 a;
+	i32 b;
+	i64 imm;
+};
+
+struct ssaVmSlot {
+	i32 reg;
+	i32 offset;
+};
+
+struct ssaVmProc {
+	Entity *          entity;
+	String            name;
+	bool              compiled;
+
+	Array<ssaVmInstr> code;
+	Array<i32>        call_args;
+	Array<ssaVmSlot>  slots;      // Frame memory whose address is placed in a register
+	Array<i32>        params;     // Register of each parameter, -1 if unused
+	ssaVmRegister *   initial_regs; // Constants, copied into every new frame
+	i32               reg_count;
+	i32               frame_size;
+	i64               result_size; // Non-zero when the result is returned in memory
+};
+
+struct ssaVmFrame {
+	ssaVmProc *     proc;
+	ssaVmRegister * regs;
+	ssaVmInstr *    return_pc;
+	isize           stack_base;
+	i32             result;     // Register of the caller receiving the result
+};
+
+struct ssaVm {
+	ssaModule *        module;
+	Array<ssaVmProc *> procs;
+	Map<i32>           proc_map; // Key: Entity *
+
+	u8 *               stack;
+	isize              stack_top;
+	Array<ssaVmFrame>  frames;
+
+	ssaVmRegister      result;
+	u8 *               result_memory;
+
+	i64                steps;
+	i64                instr_count;
+	char               error[512];
+};
+
+struct ssaVmFixup {
+	i32  instr;
+	bool is_b; // Patch the `b` target of a branch rather than `imm`
+	i32  block_id;
+};
+
+struct ssaVmLower {
+	ssaVm *           vm;
+	ssaVmProc *       proc;
+	ssaProc *         p;
+	i32 *             block_pc;
+	Array<ssaVmFixup> fixups;
+	i32               temp_count;
+};
+
+
+void ssa_vm_error(ssaVm *vm, char *fmt, ...) {
+	va_list va;
+	va_start(va, fmt);
+	gb_snprintf_va(vm->error, gb_size_of(vm->error), fmt, va);
+	va_end(va);
+}
+
+i64 ssa_vm_size_of(Type *t) {
+	return type_size_of(heap_allocator(), default_type(t));
+}
+
+// NOTE: The same values that the amd64 backend keeps in memory
+bool ssa_vm_type_in_memory(Type *t) {
+	t = core_type(default_type(t));
+	switch (t->kind) {
+	case Type_Basic:
+		switch (t->Basic.kind) {
+		case Basic_string:
+		case Basic_any:
+		case Basic_complex64:
+		case Basic_complex128:
+			return true;
+		}
+		return false;
+	case Type_Pointer:
+	case Type_Proc:
+		return false;
+	}
+	return true;
+}
+
+bool ssa_vm_is_unsigned(Type *t) {
+	t = core_type(t);
+	return !is_type_integer(t) || is_type_unsigned(t);
+}
+
+i64 ssa_vm_sign_extend(i64 x, i64 size) {
+	switch (size) {
+	case 1: return cast(i8)x;
+	case 2: return cast(i16)x;
+	case 4: return cast(i32)x;
+	}
+	return x;
+}
+
+u64 ssa_vm_zero_extend(i64 x, i64 size) {
+	switch (size) {
+	case 1: return cast(u8)x;
+	case 2: return cast(u16)x;
+	case 4: return cast(u32)x;
+	}
+	return cast(u64)x;
+}
+
+// NOTE: Out of range conversions give the "integer indefinite" value like cvttsd2si
+i64 ssa_vm_f64_to_i64(f64 f) {
+	if (f >= -9223372036854775808.0 && f < 9223372036854775808.0) {
+		return cast(i64)f;
+	}
+	return I64_MIN;
+}
+
+u64 ssa_vm_f64_to_u64(f64 f) {
+	if (f >= 9223372036854775808.0) {
+		return cast(u64)ssa_vm_f64_to_i64(f - 9223372036854775808.0) ^ (1ull<<63);
+	}
+	return cast(u64)ssa_vm_f64_to_i64(f);
+}
+
+
+void ssa_vm_init(ssaVm *vm, ssaModule *m) {
+	vm->module = m;
+	array_init(&vm->procs,  heap_allocator());
+	array_init(&vm->frames, heap_allocator());
+	map_init(&vm->proc_map, heap_allocator());
+}
+
+void ssa_vm_destroy(ssaVm *vm) {
+	for_array(i, vm->procs) {
+		ssaVmProc *vp = vm->procs[i];
+		array_free(&vp->code);
+		array_free(&vp->call_args);
+		array_free(&vp->slots);
+		array_free(&vp->params);
+		gb_free(heap_allocator(), vp->initial_regs);
+		gb_free(heap_allocator(), vp);
+	}
+	array_free(&vm->procs);
+	array_free(&vm->frames);
+	map_destroy(&vm->proc_map);
+	if (vm->stack != NULL) {
+		gb_free(heap_allocator(), vm->stack);
+	}
+}
+
+i32 ssa_vm_proc_index(ssaVm *vm, Entity *e) {
+	i32 *found = map_get(&vm->proc_map, hash_pointer(e));
+	if (found != NULL) {
+		return *found;
+	}
+	ssaVmProc *vp = gb_alloc_item(heap_allocator(), ssaVmProc);
+	vp->entity = e;
+	vp->name   = e->token.string;
+	i32 index = cast(i32)vm->procs.count;
+	array_add(&vm->procs, vp);
+	map_set(&vm->proc_map, hash_pointer(e), index);
+	return index;
+}
+
+
+i32 ssa_vm_emit(ssaVmLower *l, ssaVmOp op, i64 size, i32 dst, i32 a, i32 b, i64 imm) {
+	ssaVmInstr instr = {};
+	instr.op   = cast(u8)op;
+	instr.size = cast(u8)size;
+	instr.dst  = dst;
+	instr.a    = a;
+	instr.b    = b;
+	instr.imm  = imm;
+	array_add(&l->proc->code, instr);
+	return cast(i32)(l->proc->code.count-1);
+}
+
+void ssa_vm_emit_jump(ssaVmLower *l, ssaBlock *target) {
+	ssaVmFixup fixup = {ssa_vm_emit(l, ssaVm_Jump, 0, -1, -1, -1, 0), false, target->id};
+	array_add(&l->fixups, fixup);
+}
+
+void ssa_vm_add_slot(ssaVmLower *l, ssaValue *v, Type *t) {
+	i64 align = gb_max(type_align_of(heap_allocator(), t), 1);
+	l->proc->frame_size = cast(i32)align_formula(l->proc->frame_size, align);
+	ssaVmSlot slot = {v->id, l->proc->frame_size};
+	array_add(&l->proc->slots, slot);
+	l->proc->frame_size += cast(i32)ssa_vm_size_of(t);
+}
+
+void ssa_vm_binary(ssaVmLower *l, ssaValue *v, ssaVmOp op) {
+	ssa_vm_emit(l, op, ssa_vm_size_of(v->type), v->id, v->args[0]->id, v->args[1]->id, 0);
+}
+
+void ssa_vm_unary(ssaVmLower *l, ssaValue *v, ssaVmOp op, i64 size) {
+	ssa_vm_emit(l, op, size, v->id, v->args[0]->id, -1, 0);
+}
+
+void ssa_vm_compare(ssaVmLower *l, ssaValue *v, ssaVmOp signed_op, ssaVmOp unsigned_op) {
+	ssaVmOp op = ssa_vm_is_unsigned(v->args[0]->type) ? unsigned_op : signed_op;
+	ssa_vm_emit(l, op, 0, v->id, v->args[0]->id, v->args[1]->id, 0);
+}
+
+void ssa_vm_shift(ssaVmLower *l, ssaValue *v, ssaVmOp op) {
+	ssa_vm_emit(l, op, ssa_vm_size_of(v->type), v->id, v->args[0]->id, v->args[1]->id,
+	            ssa_vm_size_of(v->args[1]->type));
+}
+
+bool ssa_vm_lower_call(ssaVmLower *l, ssaValue *v) {
+	ssaValue *proc = v->args[0];
+	if (proc->op != ssaOp_Proc || proc->entity == NULL) {
+		ssa_vm_error(l->vm, "indirect procedure calls are not supported");
+		return false;
+	}
+	i32 index = ssa_vm_proc_index(l->vm, proc->entity);
+	i32 arg_offset = cast(i32)l->proc->call_args.count;
+	for (isize i = 1; i < v->args.count; i++) {
+		array_add(&l->proc->call_args, v->args[i]->id);
+	}
+	i32 dst = -1;
+	if (v->type != NULL) {
+		dst = v->id;
+		if (ssa_vm_type_in_memory(v->type)) {
+			ssa_vm_add_slot(l, v, v->type);
+		}
+	}
+	ssa_vm_emit(l, ssaVm_Call, 0, dst, arg_offset, cast(i32)(v->args.count-1), index);
+	return true;
+}
+
+bool ssa_vm_lower_value(ssaVmLower *l, ssaValue *v) {
+	switch (v->op) {
+	case ssaOp_Comment:
+	case ssaOp_Assume:
+	case ssaOp_Proc:
+	case ssaOp_Phi:
+		return true;
+
+	case ssaOp_ConstBool:
+	case ssaOp_Const8:
+	case ssaOp_Const16:
+	case ssaOp_Const32:
+	case ssaOp_Const64:
+	case ssaOp_Const32F:
+	case ssaOp_Const64F:
+	case ssaOp_ConstString:
+	case ssaOp_ConstNil:
+		return true; // NOTE: Set in the initial registers
+
+	case ssaOp_Arg: {
+		isize index = cast(isize)big_int_to_i64(v->exact_value.value_integer);
+		l->proc->params[index] = v->id;
+	} return true;
+
+	case ssaOp_Local:
+		ssa_vm_add_slot(l, v, type_deref(v->type));
+		return true;
+
+	case ssaOp_Load: {
+		if (ssa_vm_type_in_memory(v->type)) {
+			ssa_vm_add_slot(l, v, v->type);
+			ssa_vm_emit(l, ssaVm_Copy, 0, v->id, v->args[0]->id, -1, ssa_vm_size_of(v->type));
+		} else {
+			ssa_vm_emit(l, ssaVm_Load, ssa_vm_size_of(v->type), v->id, v->args[0]->id, -1, 0);
+		}
+	} return true;
+
+	case ssaOp_Store: {
+		Type *t = type_deref(v->args[0]->type);
+		if (ssa_vm_type_in_memory(t)) {
+			ssa_vm_emit(l, ssaVm_Copy, 0, v->args[0]->id, v->args[1]->id, -1, ssa_vm_size_of(t));
+		} else {
+			ssa_vm_emit(l, ssaVm_Store, ssa_vm_size_of(t), -1, v->args[0]->id, v->args[1]->id, 0);
+		}
+	} return true;
+
+	case ssaOp_Zero:
+		ssa_vm_emit(l, ssaVm_Zero, 0, -1, v->args[0]->id, -1, ssa_vm_size_of(type_deref(v->type)));
+		return true;
+
+	case ssaOp_Copy:
+		// NOTE: Values are immutable so aggregates may share their memory
+		ssa_vm_unary(l, v, ssaVm_Move, 8);
+		return true;
+
+	case ssaOp_PtrIndex: {
+		i64 index = big_int_to_i64(v->exact_value.value_integer);
+		i64 offset = ssa_amd64_field_offset(type_deref(v->args[0]->type), index);
+		ssa_vm_emit(l, ssaVm_Offset, 0, v->id, v->args[0]->id, -1, offset);
+	} return true;
+
+	case ssaOp_ValueIndex: {
+		i64 index = big_int_to_i64(v->exact_value.value_integer);
+		i64 offset = ssa_amd64_field_offset(v->args[0]->type, index);
+		if (ssa_vm_type_in_memory(v->type)) {
+			ssa_vm_emit(l, ssaVm_Offset, 0, v->id, v->args[0]->id, -1, offset);
+		} else {
+			ssa_vm_emit(l, ssaVm_Load, ssa_vm_size_of(v->type), v->id, v->args[0]->id, -1, offset);
+		}
+	} return true;
+
+	case ssaOp_ArrayIndex:
+		ssa_vm_emit(l, ssaVm_Index, 0, v->id, v->args[0]->id, v->args[1]->id, ssa_vm_size_of(type_deref(v->type)));
+		return true;
+	case ssaOp_PtrOffset:
+		ssa_vm_emit(l, ssaVm_Index, 0, v->id, v->args[0]->id, v->args[1]->id, ssa_vm_size_of(type_deref(v->args[0]->type)));
+		return true;
+
+	case ssaOp_CallOdin:
+	case ssaOp_CallC:
+	case ssaOp_CallStd:
+	case ssaOp_CallFast:
+		return ssa_vm_lower_call(l, v);
+
+	case ssaOp_BoundsCheck:
+		ssa_vm_emit(l, ssaVm_BoundsCheck, 0, -1, v->args[0]->id, v->args[1]->id, 0);
+		return true;
+
+	case ssaOp_DebugTrap:
+	case ssaOp_Trap:
+		ssa_vm_emit(l, ssaVm_Trap, 0, -1, -1, -1, 0);
+		return true;
+
+	case ssaOp_Bswap16: ssa_vm_unary(l, v, ssaVm_Bswap, 2); return true;
+	case ssaOp_Bswap32: ssa_vm_unary(l, v, ssaVm_Bswap, 4); return true;
+	case ssaOp_Bswap64: ssa_vm_unary(l, v, ssaVm_Bswap, 8); return true;
+
+	case ssaOp_Add8: case ssaOp_Add16: case ssaOp_Add32: case ssaOp_Add64: case ssaOp_AddPtr:
+		ssa_vm_binary(l, v, ssaVm_Add);
+		return true;
+	case ssaOp_Sub8: case ssaOp_Sub16: case ssaOp_Sub32: case ssaOp_Sub64: case ssaOp_SubPtr:
+		ssa_vm_binary(l, v, ssaVm_Sub);
+		return true;
+	case ssaOp_Mul8: case ssaOp_Mul16: case ssaOp_Mul32: case ssaOp_Mul64:
+		ssa_vm_binary(l, v, ssaVm_Mul);
+		return true;
+	case ssaOp_Div8:  case ssaOp_Div16:  case ssaOp_Div32:  case ssaOp_Div64:  ssa_vm_binary(l, v, ssaVm_Div);  return true;
+	case ssaOp_Div8U: case ssaOp_Div16U: case ssaOp_Div32U: case ssaOp_Div64U: ssa_vm_binary(l, v, ssaVm_DivU); return true;
+	case ssaOp_Mod8:  case ssaOp_Mod16:  case ssaOp_Mod32:  case ssaOp_Mod64:  ssa_vm_binary(l, v, ssaVm_Mod);  return true;
+	case ssaOp_Mod8U: case ssaOp_Mod16U: case ssaOp_Mod32U: case ssaOp_Mod64U: ssa_vm_binary(l, v, ssaVm_ModU); return true;
+
+	case ssaOp_And8:    case ssaOp_And16:    case ssaOp_And32:    case ssaOp_And64:    ssa_vm_binary(l, v, ssaVm_And);    return true;
+	case ssaOp_Or8:     case ssaOp_Or16:     case ssaOp_Or32:     case ssaOp_Or64:     ssa_vm_binary(l, v, ssaVm_Or);     return true;
+	case ssaOp_Xor8:    case ssaOp_Xor16:    case ssaOp_Xor32:    case ssaOp_Xor64:    ssa_vm_binary(l, v, ssaVm_Xor);    return true;
+	case ssaOp_AndNot8: case ssaOp_AndNot16: case ssaOp_AndNot32: case ssaOp_AndNot64: ssa_vm_binary(l, v, ssaVm_AndNot); return true;
+
+	case ssaOp_Neg8: case ssaOp_Neg16: case ssaOp_Neg32: case ssaOp_Neg64:
+		ssa_vm_unary(l, v, ssaVm_Neg, ssa_vm_size_of(v->type));
+		return true;
+	case ssaOp_Not8: case ssaOp_Not16: case ssaOp_Not32: case ssaOp_Not64:
+		ssa_vm_unary(l, v, ssaVm_Not, ssa_vm_size_of(v->type));
+		return true;
+	case ssaOp_NotB:
+		ssa_vm_unary(l, v, ssaVm_NotB, 1);
+		return true;
+
+	case ssaOp_Eq8: case ssaOp_Eq16: case ssaOp_Eq32: case ssaOp_Eq64: case ssaOp_EqPtr: case ssaOp_EqB:
+		ssa_vm_compare(l, v, ssaVm_Eq, ssaVm_Eq);
+		return true;
+	case ssaOp_Ne8: case ssaOp_Ne16: case ssaOp_Ne32: case ssaOp_Ne64: case ssaOp_NePtr: case ssaOp_NeB:
+		ssa_vm_compare(l, v, ssaVm_Ne, ssaVm_Ne);
+		return true;
+	case ssaOp_Lt8: case ssaOp_Lt16: case ssaOp_Lt32: case ssaOp_Lt64: case ssaOp_LtPtr:
+		ssa_vm_compare(l, v, ssaVm_Lt, ssaVm_LtU);
+		return true;
+	case ssaOp_Le8: case ssaOp_Le16: case ssaOp_Le32: case ssaOp_Le64: case ssaOp_LePtr:
+		ssa_vm_compare(l, v, ssaVm_Le, ssaVm_LeU);
+		return true;
+	case ssaOp_Gt8: case ssaOp_Gt16: case ssaOp_Gt32: case ssaOp_Gt64: case ssaOp_GtPtr:
+		ssa_vm_compare(l, v, ssaVm_Gt, ssaVm_GtU);
+		return true;
+	case ssaOp_Ge8: case ssaOp_Ge16: case ssaOp_Ge32: case ssaOp_Ge64: case ssaOp_GePtr:
+		ssa_vm_compare(l, v, ssaVm_Ge, ssaVm_GeU);
+		return true;
+
+	case ssaOp_Lsh8x8:  case ssaOp_Lsh8x16:  case ssaOp_Lsh8x32:  case ssaOp_Lsh8x64:
+	case ssaOp_Lsh16x8: case ssaOp_Lsh16x16: case ssaOp_Lsh16x32: case ssaOp_Lsh16x64:
+	case ssaOp_Lsh32x8: case ssaOp_Lsh32x16: case ssaOp_Lsh32x32: case ssaOp_Lsh32x64:
+	case ssaOp_Lsh64x8: case ssaOp_Lsh64x16: case ssaOp_Lsh64x32: case ssaOp_Lsh64x64:
+		ssa_vm_shift(l, v, ssaVm_Shl);
+		return true;
+	case ssaOp_Rsh8x8:  case ssaOp_Rsh8x16:  case ssaOp_Rsh8x32:  case ssaOp_Rsh8x64:
+	case ssaOp_Rsh16x8: case ssaOp_Rsh16x16: case ssaOp_Rsh16x32: case ssaOp_Rsh16x64:
+	case ssaOp_Rsh32x8: case ssaOp_Rsh32x16: case ssaOp_Rsh32x32: case ssaOp_Rsh32x64:
+	case ssaOp_Rsh64x8: case ssaOp_Rsh64x16: case ssaOp_Rsh64x32: case ssaOp_Rsh64x64:
+		ssa_vm_shift(l, v, ssaVm_Shr);
+		return true;
+	case ssaOp_Rsh8Ux8:  case ssaOp_Rsh8Ux16:  case ssaOp_Rsh8Ux32:  case ssaOp_Rsh8Ux64:
+	case ssaOp_Rsh16Ux8: case ssaOp_Rsh16Ux16: case ssaOp_Rsh16Ux32: case ssaOp_Rsh16Ux64:
+	case ssaOp_Rsh32Ux8: case ssaOp_Rsh32Ux16: case ssaOp_Rsh32Ux32: case ssaOp_Rsh32Ux64:
+	case ssaOp_Rsh64Ux8: case ssaOp_Rsh64Ux16: case ssaOp_Rsh64Ux32: case ssaOp_Rsh64Ux64:
+		ssa_vm_shift(l, v, ssaVm_ShrU);
+		return true;
+
+	case ssaOp_SignExt8to16:  case ssaOp_SignExt8to32:  case ssaOp_SignExt8to64:
+	case ssaOp_SignExt16to32: case ssaOp_SignExt16to64: case ssaOp_SignExt32to64:
+		// NOTE: Registers are already sign extended
+		ssa_vm_unary(l, v, ssaVm_Move, 8);
+		return true;
+	case ssaOp_ZeroExt8to16:  case ssaOp_ZeroExt8to32:  case ssaOp_ZeroExt8to64:
+		ssa_vm_unary(l, v, ssaVm_ZeroExt, 1);
+		return true;
+	case ssaOp_ZeroExt16to32: case ssaOp_ZeroExt16to64:
+		ssa_vm_unary(l, v, ssaVm_ZeroExt, 2);
+		return true;
+	case ssaOp_ZeroExt32to64:
+		ssa_vm_unary(l, v, ssaVm_ZeroExt, 4);
+		return true;
+	case ssaOp_Trunc16to8: case ssaOp_Trunc32to8: case ssaOp_Trunc64to8:
+		ssa_vm_unary(l, v, ssaVm_SignExt, 1);
+		return true;
+	case ssaOp_Trunc32to16: case ssaOp_Trunc64to16:
+		ssa_vm_unary(l, v, ssaVm_SignExt, 2);
+		return true;
+	case ssaOp_Trunc64to32:
+		ssa_vm_unary(l, v, ssaVm_SignExt, 4);
+		return true;
+
+	case ssaOp_Add32F: ssa_vm_binary(l, v, ssaVm_AddF32); return true;
+	case ssaOp_Sub32F: ssa_vm_binary(l, v, ssaVm_SubF32); return true;
+	case ssaOp_Mul32F: ssa_vm_binary(l, v, ssaVm_MulF32); return true;
+	case ssaOp_Div32F: ssa_vm_binary(l, v, ssaVm_DivF32); return true;
+	case ssaOp_Neg32F: ssa_vm_unary(l, v, ssaVm_NegF32, 4); return true;
+	case ssaOp_Eq32F:  ssa_vm_binary(l, v, ssaVm_EqF32);  return true;
+	case ssaOp_Ne32F:  ssa_vm_binary(l, v, ssaVm_NeF32);  return true;
+	case ssaOp_Lt32F:  ssa_vm_binary(l, v, ssaVm_LtF32);  return true;
+	case ssaOp_Le32F:  ssa_vm_binary(l, v, ssaVm_LeF32);  return true;
+	case ssaOp_Gt32F:  ssa_vm_binary(l, v, ssaVm_GtF32);  return true;
+	case ssaOp_Ge32F:  ssa_vm_binary(l, v, ssaVm_GeF32);  return true;
+	case ssaOp_Add64F: ssa_vm_binary(l, v, ssaVm_AddF64); return true;
+	case ssaOp_Sub64F: ssa_vm_binary(l, v, ssaVm_SubF64); return true;
+	case ssaOp_Mul64F: ssa_vm_binary(l, v, ssaVm_MulF64); return true;
+	case ssaOp_Div64F: ssa_vm_binary(l, v, ssaVm_DivF64); return true;
+	case ssaOp_Neg64F: ssa_vm_unary(l, v, ssaVm_NegF64, 8); return true;
+	case ssaOp_Eq64F:  ssa_vm_binary(l, v, ssaVm_EqF64);  return true;
+	case ssaOp_Ne64F:  ssa_vm_binary(l, v, ssaVm_NeF64);  return true;
+	case ssaOp_Lt64F:  ssa_vm_binary(l, v, ssaVm_LtF64);  return true;
+	case ssaOp_Le64F:  ssa_vm_binary(l, v, ssaVm_LeF64);  return true;
+	case ssaOp_Gt64F:  ssa_vm_binary(l, v, ssaVm_GtF64);  return true;
+	case ssaOp_Ge64F:  ssa_vm_binary(l, v, ssaVm_GeF64);  return true;
+
+	case ssaOp_Cvt32to32F:  ssa_vm_unary(l, v, ssaVm_IntToF32,  4); return true;
+	case ssaOp_Cvt64to32F:  ssa_vm_unary(l, v, ssaVm_IntToF32,  8); return true;
+	case ssaOp_Cvt32to64F:  ssa_vm_unary(l, v, ssaVm_IntToF64,  4); return true;
+	case ssaOp_Cvt64to64F:  ssa_vm_unary(l, v, ssaVm_IntToF64,  8); return true;
+	case ssaOp_Cvt32Uto32F: ssa_vm_unary(l, v, ssaVm_UintToF32, 4); return true;
+	case ssaOp_Cvt64Uto32F: ssa_vm_unary(l, v, ssaVm_UintToF32, 8); return true;
+	case ssaOp_Cvt32Uto64F: ssa_vm_unary(l, v, ssaVm_UintToF64, 4); return true;
+	case ssaOp_Cvt64Uto64F: ssa_vm_unary(l, v, ssaVm_UintToF64, 8); return true;
+	case ssaOp_Cvt32Fto32:  ssa_vm_unary(l, v, ssaVm_F32ToInt,  4); return true;
+	case ssaOp_Cvt32Fto64:  ssa_vm_unary(l, v, ssaVm_F32ToInt,  8); return true;
+	case ssaOp_Cvt64Fto32:  ssa_vm_unary(l, v, ssaVm_F64ToInt,  4); return true;
+	case ssaOp_Cvt64Fto64:  ssa_vm_unary(l, v, ssaVm_F64ToInt,  8); return true;
+	case ssaOp_Cvt32Fto32U: ssa_vm_unary(l, v, ssaVm_F32ToUint, 4); return true;
+	case ssaOp_Cvt32Fto64U: ssa_vm_unary(l, v, ssaVm_F32ToUint, 8); return true;
+	case ssaOp_Cvt64Fto32U: ssa_vm_unary(l, v, ssaVm_F64ToUint, 4); return true;
+	case ssaOp_Cvt64Fto64U: ssa_vm_unary(l, v, ssaVm_F64ToUint, 8); return true;
+	case ssaOp_Cvt32Fto64F: ssa_vm_unary(l, v, ssaVm_F32ToF64,  8); return true;
+	case ssaOp_Cvt64Fto32F: ssa_vm_unary(l, v, ssaVm_F64ToF32,  4); return true;
+	}
+
+	ssa_vm_error(l->vm, "`%.*s` is not supported at compile time", LIT(ssa_op_strings[v->op]));
+	return false;
+}
+
+bool ssa_vm_has_phis(ssaBlock *b) {
+	for_array(i, b->values) {
+		if (b->values[i]->op == ssaOp_Phi) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// NOTE: Register phis are moved through temporaries so that they are all read before any is written
+void ssa_vm_phi_moves(ssaVmLower *l, ssaBlock *to, isize edge) {
+	i32 temp = l->p->value_id;
+	i32 count = 0;
+	for_array(i, to->values) {
+		ssaValue *phi = to->values[i];
+		if (phi->op != ssaOp_Phi) {
+			continue;
+		}
+		ssaValue *arg = phi->args[edge];
+		if (ssa_vm_type_in_memory(phi->type)) {
+			ssa_vm_emit(l, ssaVm_Copy, 0, phi->id, arg->id, -1, ssa_vm_size_of(phi->type));
+		} else if (arg != phi) {
+			ssa_vm_emit(l, ssaVm_Move, 8, temp+count, arg->id, -1, 0);
+			count++;
+		}
+	}
+	l->temp_count = gb_max(l->temp_count, count);
+
+	count = 0;
+	for_array(i, to->values) {
+		ssaValue *phi = to->values[i];
+		if (phi->op != ssaOp_Phi || ssa_vm_type_in_memory(phi->type) || phi->args[edge] == phi) {
+			continue;
+		}
+		ssa_vm_emit(l, ssaVm_Move, 8, phi->id, temp+count, -1, 0);
+		count++;
+	}
+}
+
+bool ssa_vm_lower_block_end(ssaVmLower *l, ssaBlock *b, ssaBlock *next) {
+	switch (b->kind) {
+	case ssaBlock_Entry:
+	case ssaBlock_Plain:
+	case ssaBlock_Defer:
+		if (b->succs.count == 0) {
+			ssa_vm_emit(l, ssaVm_Trap, 0, -1, -1, -1, 0); // NOTE: Unterminated block
+			break;
+		}
+		GB_ASSERT(b->succs.count == 1);
+		ssa_vm_phi_moves(l, b->succs[0].block, b->succs[0].index);
+		if (b->succs[0].block != next) {
+			ssa_vm_emit_jump(l, b->succs[0].block);
+		}
+		break;
+
+	case ssaBlock_If: {
+		GB_ASSERT(b->succs.count == 2);
+		ssaBlock *yes = b->succs[0].block;
+		ssaBlock *no  = b->succs[1].block;
+		i32 branch = ssa_vm_emit(l, ssaVm_Branch, 0, -1, b->control->id, -1, 0);
+		// NOTE: The phi moves are placed on the edges themselves
+		if (ssa_vm_has_phis(yes)) {
+			l->proc->code[branch].imm = cast(i64)l->proc->code.count;
+			ssa_vm_phi_moves(l, yes, b->succs[0].index);
+			ssa_vm_emit_jump(l, yes);
+		} else {
+			ssaVmFixup fixup = {branch, false, yes->id};
+			array_add(&l->fixups, fixup);
+		}
+		if (ssa_vm_has_phis(no)) {
+			l->proc->code[branch].b = cast(i32)l->proc->code.count;
+			ssa_vm_phi_moves(l, no, b->succs[1].index);
+			ssa_vm_emit_jump(l, no);
+		} else {
+			ssaVmFixup fixup = {branch, true, no->id};
+			array_add(&l->fixups, fixup);
+		}
+	} break;
+
+	case ssaBlock_Ret:
+	case ssaBlock_RetJmp:
+		ssa_vm_emit(l, ssaVm_Ret, 0, -1, b->control != NULL ? b->control->id : -1, -1, 0);
+		break;
+
+	case ssaBlock_Exit:
+		ssa_vm_emit(l, ssaVm_Ret, 0, -1, -1, -1, 0);
+		break;
+
+	default:
+		ssa_vm_error(l->vm, "unknown block kind %d", b->kind);
+		return false;
+	}
+	return true;
+}
+
+void ssa_vm_set_constant(ssaVm *vm, ssaVmRegister *r, ssaValue *v) {
+	switch (v->op) {
+	case ssaOp_ConstBool:
+		r->i = v->exact_value.value_bool ? 1 : 0;
+		break;
+	case ssaOp_Const8:
+	case ssaOp_Const16:
+	case ssaOp_Const32:
+	case ssaOp_Const64:
+		r->i = ssa_vm_sign_extend(big_int_to_i64(v->exact_value.value_integer), ssa_vm_size_of(v->type));
+		break;
+	case ssaOp_Const32F:
+		r->f = cast(f32)v->exact_value.value_float;
+		break;
+	case ssaOp_Const64F:
+		r->d = v->exact_value.value_float;
+		break;
+	case ssaOp_ConstString: {
+		String s = v->exact_value.value_string;
+		String *str = gb_alloc_item(vm->module->allocator, String);
+		*str = s;
+		r->ptr = cast(u8 *)str;
+	} break;
+	case ssaOp_ConstNil:
+		if (ssa_vm_type_in_memory(v->type)) {
+			i64 size = ssa_vm_size_of(v->type);
+			r->ptr = cast(u8 *)gb_alloc(vm->module->allocator, size);
+			gb_zero_size(r->ptr, size);
+		}
+		break;
+	}
+}
+
+bool ssa_vm_compile(ssaVm *vm, ssaVmProc *vp) {
+	if (vp->compiled) {
+		return true;
+	}
+	Entity *e = vp->entity;
+	CheckerInfo *info = vm->module->info;
+	DeclInfo *decl = decl_info_of_entity(info, e);
+	if (e->kind != Entity_Procedure || decl == NULL || decl->proc_decl == NULL ||
+	    decl->proc_decl->kind != AstNode_ProcDecl || decl->proc_decl->ProcDecl.body == NULL) {
+		ssa_vm_error(vm, "`%.*s` has no body to execute", LIT(vp->name));
+		return false;
+	}
+	TypeProc *pt = &base_type(e->type)->Proc;
+	if (pt->is_generic || pt->variadic) {
+		ssa_vm_error(vm, "`%.*s` cannot be executed as it is polymorphic or variadic", LIT(vp->name));
+		return false;
+	}
+	if (pt->result_count > 1) {
+		ssa_vm_error(vm, "`%.*s` cannot be executed as it has multiple return values", LIT(vp->name));
+		return false;
+	}
+
+	isize trace = trace_begin(str_lit("ssa_vm_compile"), vp->name);
+	defer (trace_end(trace));
+
+	ssaProc *p = ssa_new_proc(vm->module, vp->name, e, decl);
+	ssa_build_proc(vm->module, p);
+	if (p->unsupported.len > 0) {
+		ssa_vm_error(vm, "`%.*s` cannot be executed at compile time (unsupported %.*s)", LIT(vp->name), LIT(p->unsupported));
+		return false;
+	}
+	ssa_opt_proc(p);
+
+	array_init(&vp->code,      heap_allocator());
+	array_init(&vp->call_args, heap_allocator());
+	array_init(&vp->slots,     heap_allocator());
+	array_init_count(&vp->params, heap_allocator(), pt->param_count);
+	for_array(i, vp->params) {
+		vp->params[i] = -1;
+	}
+	if (pt->result_count == 1 && ssa_vm_type_in_memory(pt->results->Tuple.variables[0]->type)) {
+		vp->result_size = ssa_vm_size_of(pt->results->Tuple.variables[0]->type);
+	}
+
+	ssaVmLower l = {};
+	l.vm   = vm;
+	l.proc = vp;
+	l.p    = p;
+	l.block_pc = gb_alloc_array(heap_allocator(), i32, p->block_id+1);
+	array_init(&l.fixups, heap_allocator());
+	defer (gb_free(heap_allocator(), l.block_pc));
+	defer (array_free(&l.fixups));
+
+	Array<ssaBlock *> order = {};
+	array_init(&order, heap_allocator());
+	defer (array_free(&order));
+	for_array(i, p->blocks) {
+		if (p->blocks[i]->proc != NULL) {
+			array_add(&order, p->blocks[i]);
+		}
+	}
+
+	for_array(i, order) {
+		ssaBlock *b = order[i];
+		l.block_pc[b->id] = cast(i32)vp->code.count;
+		for_array(j, b->values) {
+			ssaValue *v = b->values[j];
+			if (!ssa_vm_lower_value(&l, v)) {
+				return false;
+			}
+			if (v->op == ssaOp_Phi && ssa_vm_type_in_memory(v->type)) {
+				ssa_vm_add_slot(&l, v, v->type);
+			}
+		}
+		ssaBlock *next = i+1 < order.count ? order[i+1] : NULL;
+		if (!ssa_vm_lower_block_end(&l, b, next)) {
+			return false;
+		}
+	}
+	if (vp->code.count == 0) {
+		ssa_vm_emit(&l, ssaVm_Ret, 0, -1, -1, -1, 0);
+	}
+
+	for_array(i, l.fixups) {
+		ssaVmFixup *f = &l.fixups[i];
+		if (f->is_b) {
+			vp->code[f->instr].b = l.block_pc[f->block_id];
+		} else {
+			vp->code[f->instr].imm = l.block_pc[f->block_id];
+		}
+	}
+
+	vp->reg_count  = p->value_id + l.temp_count;
+	vp->frame_size = cast(i32)align_formula(vp->frame_size, 16);
+	vp->initial_regs = gb_alloc_array(heap_allocator(), ssaVmRegister, vp->reg_count);
+	gb_zero_size(vp->initial_regs, vp->reg_count*gb_size_of(ssaVmRegister));
+	for_array(i, order) {
+		ssaBlock *b = order[i];
+		for_array(j, b->values) {
+			ssaValue *v = b->values[j];
+			ssa_vm_set_constant(vm, &vp->initial_regs[v->id], v);
+		}
+	}
+
+	vp->compiled = true;
+	vm->instr_count += vp->code.count;
+	return true;
+}
+
+
+ssaVmRegister *ssa_vm_push_frame(ssaVm *vm, ssaVmProc *vp, ssaVmInstr *return_pc, i32 result) {
+	isize regs_size = align_formula(vp->reg_count*gb_size_of(ssaVmRegister), 16);
+	isize size = regs_size + vp->frame_size;
+	if (vm->stack_top + size > SSA_VM_STACK_SIZE) {
+		ssa_vm_error(vm, "stack overflow in `%.*s`", LIT(vp->name));
+		return NULL;
+	}
+	u8 *base = vm->stack + vm->stack_top;
+	ssaVmRegister *regs = cast(ssaVmRegister *)base;
+	gb_memcopy(regs, vp->initial_regs, vp->reg_count*gb_size_of(ssaVmRegister));
+	for_array(i, vp->slots) {
+		regs[vp->slots[i].reg].ptr = base + regs_size + vp->slots[i].offset;
+	}
+
+	ssaVmFrame frame = {};
+	frame.proc       = vp;
+	frame.regs       = regs;
+	frame.return_pc  = return_pc;
+	frame.stack_base = vm->stack_top;
+	frame.result     = result;
+	array_add(&vm->frames, frame);
+	vm->stack_top += size;
+	return regs;
+}
+
+// NOTE: Executes `vp` with its arguments already in `args`, the result is left in `vm->result`
+// or copied to `vm->result_memory`
+bool ssa_vm_execute(ssaVm *vm, ssaVmProc *vp, ssaVmRegister *args) {
+	if (vm->stack == NULL) {
+		vm->stack = cast(u8 *)gb_alloc_align(heap_allocator(), SSA_VM_STACK_SIZE, 16);
+	}
+	vm->stack_top = 0;
+	array_clear(&vm->frames);
+
+	ssaVmRegister *r = ssa_vm_push_frame(vm, vp, NULL, -1);
+	if (r == NULL) {
+		return false;
+	}
+	for_array(i, vp->params) {
+		if (vp->params[i] >= 0) {
+			r[vp->params[i]] = args[i];
+		}
+	}
+
+	ssaVmInstr *code = vp->code.data;
+	ssaVmInstr *pc = code;
+	i64 steps = 0;
+	char *fault = NULL;
+
+	for (;;) {
+		ssaVmInstr *i = pc++;
+		switch (i->op) {
+		case ssaVm_Move:
+			r[i->dst] = r[i->a];
+			break;
+		case ssaVm_Copy:
+			if (r[i->dst].ptr == NULL || r[i->a].ptr == NULL) { fault = "nil pointer dereference"; goto fail; }
+			gb_memmove(r[i->dst].ptr, r[i->a].ptr, i->imm);
+			break;
+		case ssaVm_Zero:
+			if (r[i->a].ptr == NULL) { fault = "nil pointer dereference"; goto fail; }
+			gb_zero_size(r[i->a].ptr, i->imm);
+			break;
+		case ssaVm_Load: {
+			u8 *ptr = r[i->a].ptr;
+			if (ptr == NULL) { fault = "nil pointer dereference"; goto fail; }
+			ptr += i->imm;
+			switch (i->size) {
+			case 1: r[i->dst].i = *cast(i8  *)ptr; break;
+			case 2: r[i->dst].i = *cast(i16 *)ptr; break;
+			case 4: r[i->dst].i = *cast(i32 *)ptr; break;
+			case 8: r[i->dst].i = *cast(i64 *)ptr; break;
+			}
+		} break;
+		case ssaVm_Store: {
+			u8 *ptr = r[i->a].ptr;
+			if (ptr == NULL) { fault = "nil pointer dereference"; goto fail; }
+			gb_memcopy(ptr, &r[i->b], i->size);
+		} break;
+		case ssaVm_Offset:
+			r[i->dst].ptr = r[i->a].ptr + i->imm;
+			break;
+		case ssaVm_Index:
+			r[i->dst].ptr = r[i->a].ptr + r[i->b].i*i->imm;
+			break;
+		case ssaVm_BoundsCheck:
+			if (r[i->a].u >= r[i->b].u) { fault = "index out of bounds"; goto fail; }
+			break;
+
+		case ssaVm_Add:    r[i->dst].i = ssa_vm_sign_extend(r[i->a].u + r[i->b].u, i->size); break;
+		case ssaVm_Sub:    r[i->dst].i = ssa_vm_sign_extend(r[i->a].u - r[i->b].u, i->size); break;
+		case ssaVm_Mul:    r[i->dst].i = ssa_vm_sign_extend(r[i->a].u * r[i->b].u, i->size); break;
+		case ssaVm_And:    r[i->dst].i = r[i->a].i &  r[i->b].i; break;
+		case ssaVm_Or:     r[i->dst].i = r[i->a].i |  r[i->b].i; break;
+		case ssaVm_Xor:    r[i->dst].i = r[i->a].i ^  r[i->b].i; break;
+		case ssaVm_AndNot: r[i->dst].i = r[i->a].i & ~r[i->b].i; break;
+		case ssaVm_Neg:    r[i->dst].i = ssa_vm_sign_extend(0ull - r[i->a].u, i->size); break;
+		case ssaVm_Not:    r[i->dst].i = ~r[i->a].i; break;
+
+		case ssaVm_Div:
+		case ssaVm_Mod: {
+			i64 x = r[i->a].i, y = r[i->b].i;
+			if (y == 0) { fault = "integer division by zero"; goto fail; }
+			i64 z = 0;
+			if (y == -1) {
+				// NOTE: Avoids the overflow of the most negative value
+				z = i->op == ssaVm_Div ? cast(i64)(0ull - cast(u64)x) : 0;
+			} else {
+				z = i->op == ssaVm_Div ? x / y : x % y;
+			}
+			r[i->dst].i = ssa_vm_sign_extend(z, i->size);
+		} break;
+		case ssaVm_DivU:
+		case ssaVm_ModU: {
+			u64 x = ssa_vm_zero_extend(r[i->a].i, i->size);
+			u64 y = ssa_vm_zero_extend(r[i->b].i, i->size);
+			if (y == 0) { fault = "integer division by zero"; goto fail; }
+			r[i->dst].i = ssa_vm_sign_extend(i->op == ssaVm_DivU ? x / y : x % y, i->size);
+		} break;
+
+		case ssaVm_Shl:
+		case ssaVm_Shr:
+		case ssaVm_ShrU: {
+			// NOTE: Shifting by the width of the type or more gives zero or the sign
+			u64 amount = ssa_vm_zero_extend(r[i->b].i, i->imm);
+			i64 x = r[i->a].i;
+			i64 z = 0;
+			if (amount >= cast(u64)(8*i->size)) {
+				z = (i->op == ssaVm_Shr && x < 0) ? -1 : 0;
+			} else if (i->op == ssaVm_Shl) {
+				z = ssa_vm_sign_extend(cast(u64)x << amount, i->size);
+			} else if (i->op == ssaVm_Shr) {
+				z = x >> amount;
+			} else {
+				z = ssa_vm_sign_extend(ssa_vm_zero_extend(x, i->size) >> amount, i->size);
+			}
+			r[i->dst].i = z;
+		} break;
+
+		case ssaVm_Eq:  r[i->dst].i = r[i->a].i == r[i->b].i; break;
+		case ssaVm_Ne:  r[i->dst].i = r[i->a].i != r[i->b].i; break;
+		case ssaVm_Lt:  r[i->dst].i = r[i->a].i <  r[i->b].i; break;
+		case ssaVm_Le:  r[i->dst].i = r[i->a].i <= r[i->b].i; break;
+		case ssaVm_Gt:  r[i->dst].i = r[i->a].i >  r[i->b].i; break;
+		case ssaVm_Ge:  r[i->dst].i = r[i->a].i >= r[i->b].i; break;
+		case ssaVm_LtU: r[i->dst].i = r[i->a].u <  r[i->b].u; break;
+		case ssaVm_LeU: r[i->dst].i = r[i->a].u <= r[i->b].u; break;
+		case ssaVm_GtU: r[i->dst].i = r[i->a].u >  r[i->b].u; break;
+		case ssaVm_GeU: r[i->dst].i = r[i->a].u >= r[i->b].u; break;
+		case ssaVm_NotB: r[i->dst].i = r[i->a].i == 0; break;
+
+		case ssaVm_SignExt: r[i->dst].i = ssa_vm_sign_extend(r[i->a].i, i->size); break;
+		case ssaVm_ZeroExt: r[i->dst].u = ssa_vm_zero_extend(r[i->a].i, i->size); break;
+		case ssaVm_Bswap:
+			switch (i->size) {
+			case 2: r[i->dst].i = cast(i16)gb_endian_swap16(cast(u16)r[i->a].u); break;
+			case 4: r[i->dst].i = cast(i32)gb_endian_swap32(cast(u32)r[i->a].u); break;
+			case 8: r[i->dst].u = gb_endian_swap64(r[i->a].u);                    break;
+			}
+			break;
+
+		case ssaVm_AddF32: r[i->dst].f = r[i->a].f + r[i->b].f; break;
+		case ssaVm_SubF32: r[i->dst].f = r[i->a].f - r[i->b].f; break;
+		case ssaVm_MulF32: r[i->dst].f = r[i->a].f * r[i->b].f; break;
+		case ssaVm_DivF32: r[i->dst].f = r[i->a].f / r[i->b].f; break;
+		case ssaVm_NegF32: r[i->dst].f = -r[i->a].f;            break;
+		case ssaVm_EqF32:  r[i->dst].i = r[i->a].f == r[i->b].f; break;
+		case ssaVm_NeF32:  r[i->dst].i = r[i->a].f != r[i->b].f; break;
+		case ssaVm_LtF32:  r[i->dst].i = r[i->a].f <  r[i->b].f; break;
+		case ssaVm_LeF32:  r[i->dst].i = r[i->a].f <= r[i->b].f; break;
+		case ssaVm_GtF32:  r[i->dst].i = r[i->a].f >  r[i->b].f; break;
+		case ssaVm_GeF32:  r[i->dst].i = r[i->a].f >= r[i->b].f; break;
+		case ssaVm_AddF64: r[i->dst].d = r[i->a].d + r[i->b].d; break;
+		case ssaVm_SubF64: r[i->dst].d = r[i->a].d - r[i->b].d; break;
+		case ssaVm_MulF64: r[i->dst].d = r[i->a].d * r[i->b].d; break;
+		case ssaVm_DivF64: r[i->dst].d = r[i->a].d / r[i->b].d; break;
+		case ssaVm_NegF64: r[i->dst].d = -r[i->a].d;            break;
+		case ssaVm_EqF64:  r[i->dst].i = r[i->a].d == r[i->b].d; break;
+		case ssaVm_NeF64:  r[i->dst].i = r[i->a].d != r[i->b].d; break;
+		case ssaVm_LtF64:  r[i->dst].i = r[i->a].d <  r[i->b].d; break;
+		case ssaVm_LeF64:  r[i->dst].i = r[i->a].d <= r[i->b].d; break;
+		case ssaVm_GtF64:  r[i->dst].i = r[i->a].d >  r[i->b].d; break;
+		case ssaVm_GeF64:  r[i->dst].i = r[i->a].d >= r[i->b].d; break;
+
+		case ssaVm_IntToF32:  r[i->dst].f = cast(f32)r[i->a].i; break;
+		case ssaVm_IntToF64:  r[i->dst].d = cast(f64)r[i->a].i; break;
+		case ssaVm_UintToF32: r[i->dst].f = cast(f32)ssa_vm_zero_extend(r[i->a].i, i->size); break;
+		case ssaVm_UintToF64: r[i->dst].d = cast(f64)ssa_vm_zero_extend(r[i->a].i, i->size); break;
+		case ssaVm_F32ToInt:  r[i->dst].i = ssa_vm_sign_extend(ssa_vm_f64_to_i64(r[i->a].f), i->size); break;
+		case ssaVm_F64ToInt:  r[i->dst].i = ssa_vm_sign_extend(ssa_vm_f64_to_i64(r[i->a].d), i->size); break;
+		case ssaVm_F32ToUint: r[i->dst].i = ssa_vm_sign_extend(ssa_vm_f64_to_u64(r[i->a].f), i->size); break;
+		case ssaVm_F64ToUint: r[i->dst].i = ssa_vm_sign_extend(ssa_vm_f64_to_u64(r[i->a].d), i->size); break;
+		case ssaVm_F32ToF64:  r[i->dst].d = r[i->a].f;            break;
+		case ssaVm_F64ToF32:  r[i->dst].f = cast(f32)r[i->a].d;   break;
+
+		case ssaVm_Jump:
+			pc = code + i->imm;
+			if (++steps >= SSA_VM_STEP_LIMIT) { fault = "step limit reached"; goto fail; }
+			break;
+		case ssaVm_Branch:
+			pc = code + (r[i->a].i != 0 ? i->imm : i->b);
+			if (++steps >= SSA_VM_STEP_LIMIT) { fault = "step limit reached"; goto fail; }
+			break;
+
+		case ssaVm_Call: {
+			ssaVmProc *callee = vm->procs[cast(isize)i->imm];
+			if (!ssa_vm_compile(vm, callee)) {
+				vm->steps += steps;
+				return false;
+			}
+			i32 *call_args = vm->frames[vm->frames.count-1].proc->call_args.data + i->a;
+			ssaVmRegister *regs = ssa_vm_push_frame(vm, callee, pc, i->dst);
+			if (regs == NULL) {
+				vm->steps += steps;
+				return false;
+			}
+			for (i32 j = 0; j < i->b; j++) {
+				if (callee->params[j] >= 0) {
+					regs[callee->params[j]] = r[call_args[j]];
+				}
+			}
+			r = regs;
+			code = callee->code.data;
+			pc = code;
+			if (++steps >= SSA_VM_STEP_LIMIT) { fault = "step limit reached"; goto fail; }
+		} break;
+
+		case ssaVm_Ret: {
+			ssaVmFrame *frame = &vm->frames[vm->frames.count-1];
+			ssaVmRegister value = {};
+			if (i->a >= 0) {
+				value = r[i->a];
+			}
+			if (vm->frames.count == 1) {
+				if (frame->proc->result_size > 0) {
+					gb_memmove(vm->result_memory, value.ptr, frame->proc->result_size);
+				} else {
+					vm->result = value;
+				}
+				array_pop(&vm->frames);
+				vm->steps += steps;
+				return true;
+			}
+			ssaVmFrame *caller = &vm->frames[vm->frames.count-2];
+			if (frame->result >= 0 && i->a >= 0) {
+				if (frame->proc->result_size > 0) {
+					gb_memmove(caller->regs[frame->result].ptr, value.ptr, frame->proc->result_size);
+				} else {
+					caller->regs[frame->result] = value;
+				}
+			}
+			pc = frame->return_pc;
+			vm->stack_top = frame->stack_base;
+			r = caller->regs;
+			code = caller->proc->code.data;
+			array_pop(&vm->frames);
+		} break;
+
+		case ssaVm_Trap:
+			fault = "trap";
+			goto fail;
+
+		default:
+			GB_PANIC("Unknown ssaVmOp %d", i->op);
+			break;
+		}
+	}
+
+fail:
+	vm->steps += steps;
+	ssa_vm_error(vm, "%s in `%.*s`", fault, LIT(vm->frames[vm->frames.count-1].proc->name));
+	return false;
+}
+
+
+// NOTE: Converts a constant argument into the register it is passed in
+bool ssa_vm_register_from_value(ssaVm *vm, Type *type, ExactValue value, ssaVmRegister *r) {
+	Type *t = core_type(type);
+	value = convert_exact_value_for_type(value, t);
+	r->u = 0;
+	if (is_type_boolean(t) && value.kind == ExactValue_Bool) {
+		r->i = value.value_bool;
+		return true;
+	} else if (is_type_integer(t) && value.kind == ExactValue_Integer) {
+		r->i = ssa_vm_sign_extend(big_int_to_i64(value.value_integer), ssa_vm_size_of(t));
+		return true;
+	} else if (is_type_float(t) && value.kind == ExactValue_Float) {
+		if (ssa_vm_size_of(t) == 4) {
+			r->f = cast(f32)value.value_float;
+		} else {
+			r->d = value.value_float;
+		}
+		return true;
+	} else if (is_type_string(t) && value.kind == ExactValue_String) {
+		String *str = gb_alloc_item(vm->module->allocator, String);
+		*str = value.value_string;
+		r->ptr = cast(u8 *)str;
+		return true;
+	}
+	return false;
+}
+
+// NOTE: Arrays of scalars become packed arrays, other aggregates become a compound literal whose
+// elements are each given a constant value
+bool ssa_vm_exact_value(ssaVm *vm, AstFile *f, Token token, Type *type, u8 *data, ExactValue *out) {
+	CheckerInfo *info = vm->module->info;
+	Type *t = core_type(type);
+	i64 size = ssa_vm_size_of(t);
+
+	if (t->kind == Type_Basic) {
+		if (is_type_boolean(t)) {
+			*out = exact_value_bool(*data != 0);
+		} else if (is_type_integer(t)) {
+			i64 x = 0;
+			gb_memcopy(&x, data, size);
+			if (is_type_unsigned(t)) {
+				u64 u = ssa_vm_zero_extend(x, size);
+				*out = exact_value_u64(u);
+			} else {
+				*out = exact_value_i64(ssa_vm_sign_extend(x, size));
+			}
+		} else if (is_type_float(t)) {
+			if (size == 4) {
+				*out = exact_value_float(*cast(f32 *)data);
+			} else {
+				*out = exact_value_float(*cast(f64 *)data);
+			}
+		} else if (is_type_complex(t)) {
+			if (size == 8) {
+				*out = exact_value_complex((cast(f32 *)data)[0], (cast(f32 *)data)[1]);
+			} else {
+				*out = exact_value_complex((cast(f64 *)data)[0], (cast(f64 *)data)[1]);
+			}
+		} else if (is_type_string(t)) {
+			String s = *cast(String *)data;
+			if (s.len < 0 || (s.len > 0 && s.text == NULL)) {
+				ssa_vm_error(vm, "invalid string result");
+				return false;
+			}
+			u8 *text = gb_alloc_array(heap_allocator(), u8, s.len);
+			gb_memcopy(text, s.text, s.len);
+			*out = exact_value_string(make_string(text, s.len));
+		} else {
+			ssa_vm_error(vm, "unsupported result type");
+			return false;
+		}
+		return true;
+	}
+
+	if (t->kind == Type_Array) {
+		PackedArray *packed = make_packed_array(heap_allocator(), t->Array.elem, t->Array.count);
+		if (packed != NULL) {
+			for (i64 i = 0; i < packed->count; i++) {
+				ExactValue value = {};
+				if (!ssa_vm_exact_value(vm, f, token, t->Array.elem, data + i*packed->elem_size, &value)) {
+					return false;
+				}
+				packed_array_set(packed, i, value);
+			}
+			*out = exact_value_packed(packed);
+			return true;
+		}
+	}
+
+	Array<AstNode *> elems = {};
+	switch (t->kind) {
+	case Type_Array:
+	case Type_Vector: {
+		Type *elem = t->kind == Type_Array ? t->Array.elem  : t->Vector.elem;
+		i64 count  = t->kind == Type_Array ? t->Array.count : t->Vector.count;
+		i64 elem_size = ssa_vm_size_of(elem);
+		array_init(&elems, heap_allocator(), count);
+		for (i64 i = 0; i < count; i++) {
+			ExactValue value = {};
+			if (!ssa_vm_exact_value(vm, f, token, elem, data + i*elem_size, &value)) {
+				return false;
+			}
+			AstNode *node = ast_basic_lit(f, token);
+			add_type_and_value(info, node, Addressing_Constant, elem, value);
+			array_add(&elems, node);
+		}
+	} break;
+
+	case Type_Record: {
+		if (t->Record.kind != TypeRecord_Struct) {
+			ssa_vm_error(vm, "unsupported result type");
+			return false;
+		}
+		array_init(&elems, heap_allocator(), t->Record.field_count);
+		for (isize i = 0; i < t->Record.field_count; i++) {
+			Entity *field = t->Record.fields_in_src_order[i];
+			i64 offset = type_offset_of(heap_allocator(), t, field->Variable.field_index);
+			ExactValue value = {};
+			if (!ssa_vm_exact_value(vm, f, token, field->type, data + offset, &value)) {
+				return false;
+			}
+			AstNode *node = ast_basic_lit(f, token);
+			add_type_and_value(info, node, Addressing_Constant, field->type, value);
+			array_add(&elems, node);
+		}
+	} break;
+
+	default:
+		ssa_vm_error(vm, "unsupported result type");
+		return false;
+	}
+
+	*out = exact_value_compound(ast_compound_lit(f, NULL, elems, token, token));
+	return true;
+}
+
+bool ssa_vm_run_expr(ssaVm *vm, AstNode *node) {
+	CheckerInfo *info = vm->module->info;
+	ast_node(re, RunExpr, node);
+	AstNode *call = unparen_expr(re->expr);
+	ast_node(ce, CallExpr, call);
+
+	Entity *e = ssa_call_entity(info, call);
+	if (e == NULL) {
+		error(node, "#run requires a call to a named procedure");
+		return false;
+	}
+	TypeProc *pt = &base_type(e->type)->Proc;
+	if (e->Procedure.is_foreign) {
+		error(node, "Foreign procedure `%.*s` cannot be executed at compile time", LIT(e->token.string));
+		return false;
+	}
+	if (ce->ellipsis.pos.line != 0 || ce->args.count != pt->param_count) {
+		error(node, "#run does not yet support default or variadic arguments");
+		return false;
+	}
+
+	isize trace = trace_begin(str_lit("ssa_vm_run_expr"), e->token.string);
+	defer (trace_end(trace));
+
+	ssaVmProc *vp = vm->procs[ssa_vm_proc_index(vm, e)];
+	if (!ssa_vm_compile(vm, vp)) {
+		error(node, "Compile time execution failed: %s", vm->error);
+		return false;
+	}
+
+	ssaVmRegister *args = gb_alloc_array(heap_allocator(), ssaVmRegister, ce->args.count+1);
+	defer (gb_free(heap_allocator(), args));
+	for_array(i, ce->args) {
+		AstNode *arg = ce->args[i];
+		if (arg->kind == AstNode_FieldValue) {
+			error(arg, "#run does not yet support named arguments");
+			return false;
+		}
+		Type *param_type = pt->params->Tuple.variables[i]->type;
+		TypeAndValue tav = type_and_value_of_expr(info, arg);
+		if (tav.mode != Addressing_Constant) {
+			gbString expr_str = expr_to_string(arg);
+			error(arg, "Arguments to #run must be constant, got `%s`", expr_str);
+			gb_string_free(expr_str);
+			return false;
+		}
+		if (!ssa_vm_register_from_value(vm, param_type, tav.value, &args[i])) {
+			gbString type_str = type_to_string(param_type);
+			error(arg, "`%s` arguments cannot yet be passed to #run", type_str);
+			gb_string_free(type_str);
+			return false;
+		}
+	}
+
+	TypeAndValue tav = type_and_value_of_expr(info, node);
+	Type *type = tav.type;
+	u8 *result = cast(u8 *)&vm->result;
+	u8 *result_memory = NULL;
+	if (vp->result_size > 0) {
+		result_memory = cast(u8 *)gb_alloc_align(heap_allocator(), vp->result_size, 16);
+		result = result_memory;
+	}
+	defer (gb_free(heap_allocator(), result_memory));
+
+	vm->result.u = 0;
+	vm->result_memory = result_memory;
+	if (!ssa_vm_execute(vm, vp, args)) {
+		error(node, "Compile time execution failed: %s", vm->error);
+		return false;
+	}
+
+	Token token = ast_node_token(node);
+	AstFile *f = ast_file_of_filename(info, token.pos.file);
+	GB_ASSERT(f != NULL);
+	ExactValue value = {};
+	if (!ssa_vm_exact_value(vm, f, token, type, result, &value)) {
+		gbString type_str = type_to_string(type);
+		error(node, "`%s` cannot be the result of a #run expression: %s", type_str, vm->error);
+		gb_string_free(type_str);
+		return false;
+	}
+	add_type_and_value(info, node, Addressing_Constant, type, value);
+	return true;
+}
+
+// NOTE: Executes every #run expression and folds its result into a constant
+bool ssa_execute_run_exprs(CheckerInfo *info, isize token_count) {
+	ssaModule m = {0};
+	ssa_module_init(&m, info, token_count);
+	defer (ssa_module_destroy(&m));
+
+	ssaVm vm = {0};
+	ssa_vm_init(&vm, &m);
+	defer (ssa_vm_destroy(&vm));
+
+	bool ok = true;
+	for_array(i, info->run_exprs) {
+		if (!ssa_vm_run_expr(&vm, info->run_exprs[i])) {
+			ok = false;
+		}
+	}
+
+	timings_add_counter(&global_timings, str_lit("cte procedures compiled"), vm.procs.count);
+	timings_add_counter(&global_timings, str_lit("cte instructions"),        vm.instr_count);
+	timings_add_counter(&global_timings, str_lit("cte steps executed"),      vm.steps);
+	return ok;
+}
@@ -138,6 +138,10 @@ int string_compare(String x, String y) {
 				return cast(int)x[offset] - cast(int)y[offset];
 			}
 		}
+
+		if (x.len != y.len) {
+			return x.len < y.len ? -1 : +1;
+		}
 	}
 	return 0;
 }
@@ -255,6 +259,7 @@ String filename_from_path(String s) {
 		}
 		s.text += j+1;
 		s.len = i-j-1;
+		return s;
 	}
 	return make_string(NULL, 0);
 }
@@ -1,15 +1,27 @@
 struct TimeStamp {
 	u64    start;
 	u64    finish;
+	u64    cpu_start;  // NOTE: In nanoseconds
+	u64    cpu_finish; // NOTE: In nanoseconds
 	String label;
+	isize  depth;
+};
+
+struct TimingsCounter {
+	String label;
+	i64    value;
 };
 
 struct Timings {
-	TimeStamp        total;
-	Array<TimeStamp> sections;
-	u64              freq;
+	TimeStamp             total;
+	Array<TimeStamp>      sections;
+	Array<isize>          open_sections; // NOTE: Indices into `sections`, innermost last
+	Array<TimingsCounter> counters;
+	u64                   freq;
 };
 
+gb_global Timings global_timings = {0};
+
 
 #if defined(GB_SYSTEM_WINDOWS)
 u64 win32_time_stamp_time_now(void) {
@@ -28,27 +40,47 @@ u64 win32_time_stamp__freq(void) {
 	return win32_perf_count_freq.QuadPart;
 }
 
+u64 win32_time_stamp_cpu_time_now(void) {
+	// NOTE: This does not include the time spent in child processes (opt, llc, link)
+	FILETIME creation_time, exit_time, kernel_time, user_time;
+	if (!GetProcessTimes(GetCurrentProcess(), &creation_time, &exit_time, &kernel_time, &user_time)) {
+		return 0;
+	}
+	u64 kernel = (cast(u64)kernel_time.dwHighDateTime << 32) | kernel_time.dwLowDateTime;
+	u64 user   = (cast(u64)user_time.dwHighDateTime   << 32) | user_time.dwLowDateTime;
+	return (kernel + user) * 100; // NOTE: FILETIME is in 100 ns intervals
+}
+
 #elif defined(GB_SYSTEM_OSX) || defined(GB_SYSTEM_UNIX)
 
 #include <time.h>
+#include <sys/resource.h>
 
 u64 unix_time_stamp_time_now(void) {
+	// NOTE: Wall-clock time, CPU time is measured separately with `unix_time_stamp_cpu_time_now`
 	struct timespec ts;
-	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+	clock_gettime(CLOCK_MONOTONIC, &ts);
 
 	return (ts.tv_sec * 1000000000) + ts.tv_nsec;
 }
 
 u64 unix_time_stamp__freq(void) {
-	gb_local_persist u64 freq = 0;
+	return 1000000000ull;
+}
 
-	if (freq == 0) {
-		struct timespec ts;
-		clock_getres(CLOCK_PROCESS_CPUTIME_ID, &ts);
-		freq = cast(u64) ((1.0 / ts.tv_nsec) * 1000000000.0);
+u64 unix__rusage_cpu_time(int who) {
+	struct rusage usage = {};
+	if (getrusage(who, &usage) != 0) {
+		return 0;
 	}
+	u64 user   = cast(u64)usage.ru_utime.tv_sec*1000000000ull + cast(u64)usage.ru_utime.tv_usec*1000ull;
+	u64 system = cast(u64)usage.ru_stime.tv_sec*1000000000ull + cast(u64)usage.ru_stime.tv_usec*1000ull;
+	return user + system;
+}
 
-	return freq;
+u64 unix_time_stamp_cpu_time_now(void) {
+	// NOTE: Include the child processes (opt, llc, link) once they have been waited upon
+	return unix__rusage_cpu_time(RUSAGE_SELF) + unix__rusage_cpu_time(RUSAGE_CHILDREN);
 }
 
 #else
@@ -75,32 +107,87 @@ u64 time_stamp__freq(void) {
 #endif
 }
 
+u64 time_stamp_cpu_time_now(void) {
+#if defined(GB_SYSTEM_WINDOWS)
+	return win32_time_stamp_cpu_time_now();
+#elif defined(GB_SYSTEM_OSX) || defined(GB_SYSTEM_UNIX)
+	return unix_time_stamp_cpu_time_now();
+#else
+#error time_stamp_cpu_time_now
+#endif
+}
+
 TimeStamp make_time_stamp(String label) {
 	TimeStamp ts = {0};
-	ts.start = time_stamp_time_now();
-	ts.label = label;
+	ts.start     = time_stamp_time_now();
+	ts.cpu_start = time_stamp_cpu_time_now();
+	ts.label     = label;
 	return ts;
 }
 
+void time_stamp_finish(TimeStamp *ts) {
+	ts->finish     = time_stamp_time_now();
+	ts->cpu_finish = time_stamp_cpu_time_now();
+}
+
 void timings_init(Timings *t, String label, isize buffer_size) {
-	array_init(&t->sections, heap_allocator(), buffer_size);
+	array_init(&t->sections,      heap_allocator(), buffer_size);
+	array_init(&t->open_sections, heap_allocator(), 16);
+	array_init(&t->counters,      heap_allocator(), 16);
 	t->total = make_time_stamp(label);
 	t->freq  = time_stamp__freq();
 }
 
 void timings_destroy(Timings *t) {
 	array_free(&t->sections);
+	array_free(&t->open_sections);
+	array_free(&t->counters);
 }
 
-void timings__stop_current_section(Timings *t) {
-	if (t->sections.count > 0) {
-		t->sections[t->sections.count-1].finish = time_stamp_time_now();
+void timings__stop_sections_to_depth(Timings *t, isize depth) {
+	while (t->open_sections.count > depth) {
+		isize index = t->open_sections[t->open_sections.count-1];
+		time_stamp_finish(&t->sections[index]);
+		array_pop(&t->open_sections);
 	}
 }
 
+void timings__stop_current_section(Timings *t) {
+	timings__stop_sections_to_depth(t, 0);
+}
+
+void timings__push_section(Timings *t, String label) {
+	TimeStamp ts = make_time_stamp(label);
+	ts.depth = t->open_sections.count;
+	array_add(&t->sections, ts);
+	array_add(&t->open_sections, t->sections.count-1);
+}
+
+// NOTE: Top-level sections follow on from each other, ending any open sub-sections
 void timings_start_section(Timings *t, String label) {
 	timings__stop_current_section(t);
-	array_add(&t->sections, make_time_stamp(label));
+	timings__push_section(t, label);
+}
+
+// NOTE: Sub-sections nest within the current section and must be ended explicitly
+void timings_begin_sub_section(Timings *t, String label) {
+	timings__push_section(t, label);
+}
+
+void timings_end_sub_section(Timings *t) {
+	GB_ASSERT_MSG(t->open_sections.count > 1, "No sub-section to end");
+	timings__stop_sections_to_depth(t, t->open_sections.count-1);
+}
+
+void timings_add_counter(Timings *t, String label, i64 value) {
+	for_array(i, t->counters) {
+		if (t->counters[i].label == label) {
+			t->counters[i].value += value;
+			return;
+		}
+	}
+	TimingsCounter c = {label, value};
+	array_add(&t->counters, c);
 }
 
 f64 time_stamp_as_ms(TimeStamp ts, u64 freq) {
@@ -108,31 +195,124 @@ f64 time_stamp_as_ms(TimeStamp ts, u64 freq) {
 	return 1000.0 * cast(f64)(ts.finish - ts.start) / cast(f64)freq;
 }
 
+f64 time_stamp_cpu_as_ms(TimeStamp ts) {
+	if (ts.cpu_finish < ts.cpu_start) {
+		return 0;
+	}
+	return cast(f64)(ts.cpu_finish - ts.cpu_start) / 1000000.0;
+}
+
+void timings__finish_all(Timings *t) {
+	timings__stop_current_section(t);
+	time_stamp_finish(&t->total);
+}
+
 void timings_print_all(Timings *t) {
 	char const SPACES[] = "                                                                ";
+	isize const INDENT = 2;
 	isize max_len;
 
-	timings__stop_current_section(t);
-	t->total.finish = time_stamp_time_now();
+	timings__finish_all(t);
 
 	max_len = t->total.label.len;
 	for_array(i, t->sections) {
 		TimeStamp ts = t->sections[i];
-		max_len = gb_max(max_len, ts.label.len);
+		max_len = gb_max(max_len, INDENT*ts.depth + ts.label.len);
+	}
+	for_array(i, t->counters) {
+		max_len = gb_max(max_len, t->counters[i].label.len);
 	}
+	max_len = gb_min(max_len, gb_size_of(SPACES)-1);
 
-	GB_ASSERT(max_len <= gb_size_of(SPACES)-1);
+	f64 total_ms = time_stamp_as_ms(t->total, t->freq);
 
-	gb_printf("%.*s%.*s - %.3f ms\n",
+	gb_printf("%.*s%.*s - %.3f ms wall, %.3f ms cpu\n",
 	          LIT(t->total.label),
 	          cast(int)(max_len-t->total.label.len), SPACES,
-	          time_stamp_as_ms(t->total, t->freq));
+	          total_ms, time_stamp_cpu_as_ms(t->total));
 
 	for_array(i, t->sections) {
 		TimeStamp ts = t->sections[i];
-		gb_printf("%.*s%.*s - %.3f ms\n",
-		          LIT(ts.label),
-	              cast(int)(max_len-ts.label.len), SPACES,
-		          time_stamp_as_ms(ts, t->freq));
+		String label = ts.label;
+		isize indent = gb_min(INDENT*ts.depth, max_len);
+		label.len = gb_min(label.len, max_len-indent);
+		f64 ms = time_stamp_as_ms(ts, t->freq);
+		gb_printf("%.*s%.*s%.*s - %.3f ms wall, %.3f ms cpu (%.1f%%)\n",
+		          cast(int)indent, SPACES,
+		          LIT(label),
+		          cast(int)(max_len-indent-label.len), SPACES,
+		          ms, time_stamp_cpu_as_ms(ts),
+		          total_ms > 0 ? 100.0*ms/total_ms : 0.0);
+	}
+
+	if (t->counters.count > 0) {
+		gb_printf("\n");
+		for_array(i, t->counters) {
+			TimingsCounter c = t->counters[i];
+			gb_printf("%.*s%.*s - %lld\n",
+			          LIT(c.label),
+			          cast(int)(max_len-c.label.len), SPACES,
+			          cast(long long)c.value);
+		}
+	}
+}
+
+void timings__fprint_json_string(gbFile *f, String s) {
+	gb_fprintf(f, "\"");
+	for (isize i = 0; i < s.len; i++) {
+		u8 c = s[i];
+		switch (c) {
+		case '"':  gb_fprintf(f, "\\\""); break;
+		case '\\': gb_fprintf(f, "\\\\"); break;
+		case '\n': gb_fprintf(f, "\\n");  break;
+		case '\t': gb_fprintf(f, "\\t");  break;
+		default:
+			if (c < 0x20) {
+				gb_fprintf(f, "\\u%04x", c);
+			} else {
+				gb_fprintf(f, "%c", c);
+			}
+			break;
+		}
+	}
+	gb_fprintf(f, "\"");
+}
+
+// NOTE: Sections are written in order with their depth, so the nesting can be rebuilt
+bool timings_export_json(Timings *t, String path) {
+	gbFile f = {};
+	if (gb_file_create(&f, gb_bprintf("%.*s", LIT(path))) != gbFileError_None) {
+		gb_printf_err("Unable to create timings file: %.*s\n", LIT(path));
+		return false;
+	}
+	defer (gb_file_close(&f));
+
+	timings__finish_all(t);
+
+	gb_fprintf(&f, "{\n");
+	gb_fprintf(&f, "\t\"total\": {\"label\": ");
+	timings__fprint_json_string(&f, t->total.label);
+	gb_fprintf(&f, ", \"wall_ms\": %f, \"cpu_ms\": %f},\n",
+	           time_stamp_as_ms(t->total, t->freq), time_stamp_cpu_as_ms(t->total));
+
+	gb_fprintf(&f, "\t\"sections\": [");
+	for_array(i, t->sections) {
+		TimeStamp ts = t->sections[i];
+		gb_fprintf(&f, "%s\n\t\t{\"label\": ", i > 0 ? "," : "");
+		timings__fprint_json_string(&f, ts.label);
+		gb_fprintf(&f, ", \"depth\": %td, \"wall_ms\": %f, \"cpu_ms\": %f}",
+		           ts.depth, time_stamp_as_ms(ts, t->freq), time_stamp_cpu_as_ms(ts));
+	}
+	gb_fprintf(&f, "\n\t],\n");
+
+	gb_fprintf(&f, "\t\"counters\": {");
+	for_array(i, t->counters) {
+		TimingsCounter c = t->counters[i];
+		gb_fprintf(&f, "%s\n\t\t", i > 0 ? "," : "");
+		timings__fprint_json_string(&f, c.label);
+		gb_fprintf(&f, ": %lld", cast(long long)c.value);
 	}
+	gb_fprintf(&f, "\n\t}\n");
+	gb_fprintf(&f, "}\n");
+	return true;
 }
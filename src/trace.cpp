@@ -0,0 +1,135 @@
+// NOTE: Records instrumentation scopes as Chrome trace events (chrome://tracing, Perfetto, speedscope)
+// Usage:
+//     isize trace = trace_begin(str_lit("check_proc_body"), proc_name);
+//     defer (trace_end(trace));
+// When tracing is disabled, `trace_begin` returns -1 and nothing is recorded
+
+struct TraceEvent {
+	String name;
+	String detail;
+	u64    start;
+	u64    finish;
+	u32    thread_id;
+};
+
+struct Trace {
+	bool              enabled;
+	Array<TraceEvent> events;
+	DynamicArena      details; // NOTE: Copies of the details, which may outlive the arenas they came from
+	gbMutex           mutex;
+};
+
+gb_global Trace global_trace = {0};
+
+
+void trace_init(Trace *t) {
+	array_init(&t->events, heap_allocator(), 1<<12);
+	init_dynamic_arena(&t->details, 1<<16);
+	gb_mutex_init(&t->mutex);
+	t->enabled = true;
+}
+
+void trace_destroy(Trace *t) {
+	if (t->enabled) {
+		array_free(&t->events);
+		destroy_dynamic_arena(&t->details);
+		gb_mutex_destroy(&t->mutex);
+		t->enabled = false;
+	}
+}
+
+isize trace_begin(String name, String detail) {
+	Trace *t = &global_trace;
+	if (!t->enabled) {
+		return -1;
+	}
+	TraceEvent e = {};
+	e.name      = name;
+	e.thread_id = gb_thread_current_id();
+
+	gb_mutex_lock(&t->mutex);
+	if (detail.len > 0) {
+		u8 *text = cast(u8 *)gb_alloc(dynamic_arena_allocator(&t->details), detail.len);
+		gb_memmove(text, detail.text, detail.len);
+		e.detail = make_string(text, detail.len);
+	}
+	isize index = t->events.count;
+	array_add(&t->events, e);
+	t->events[index].start = time_stamp_time_now();
+	gb_mutex_unlock(&t->mutex);
+	return index;
+}
+
+void trace_end(isize index) {
+	if (index < 0) {
+		return;
+	}
+	Trace *t = &global_trace;
+	u64 finish = time_stamp_time_now();
+	gb_mutex_lock(&t->mutex);
+	t->events[index].finish = finish;
+	gb_mutex_unlock(&t->mutex);
+}
+
+
+void trace__fprint_event(gbFile *f, bool *first, String name, String detail, char *category,
+                         u64 start, u64 finish, u64 origin, u64 freq, u32 thread_id) {
+	if (finish < start) {
+		finish = start;
+	}
+	f64 ts  = 1000000.0 * cast(f64)(start - origin) / cast(f64)freq;
+	f64 dur = 1000000.0 * cast(f64)(finish - start) / cast(f64)freq;
+
+	gb_fprintf(f, "%s\n\t{\"name\": ", *first ? "" : ",");
+	timings__fprint_json_string(f, name);
+	gb_fprintf(f, ", \"cat\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": %u, \"ts\": %.3f, \"dur\": %.3f",
+	           category, thread_id, ts, dur);
+	if (detail.len > 0) {
+		gb_fprintf(f, ", \"args\": {\"detail\": ");
+		timings__fprint_json_string(f, detail);
+		gb_fprintf(f, "}");
+	}
+	gb_fprintf(f, "}");
+	*first = false;
+}
+
+// NOTE: The timings sections are written as well so that the phases show up on the main thread's track
+bool trace_export_json(Trace *t, Timings *timings, String path) {
+	gbFile f = {};
+	if (gb_file_create(&f, gb_bprintf("%.*s", LIT(path))) != gbFileError_None) {
+		gb_printf_err("Unable to create trace file: %.*s\n", LIT(path));
+		return false;
+	}
+	defer (gb_file_close(&f));
+
+	timings__finish_all(timings);
+
+	u64 origin = timings->total.start;
+	u64 freq   = timings->freq;
+	u32 main_thread_id = gb_thread_current_id();
+
+	bool first = true;
+	gb_fprintf(&f, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [");
+
+	gb_fprintf(&f, "\n\t{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %u, \"args\": {\"name\": \"main\"}}", main_thread_id);
+	first = false;
+
+	trace__fprint_event(&f, &first, timings->total.label, make_string(NULL, 0), "phase",
+	                    timings->total.start, timings->total.finish, origin, freq, main_thread_id);
+	for_array(i, timings->sections) {
+		TimeStamp ts = timings->sections[i];
+		trace__fprint_event(&f, &first, ts.label, make_string(NULL, 0), "phase",
+		                    ts.start, ts.finish, origin, freq, main_thread_id);
+	}
+
+	gb_mutex_lock(&t->mutex);
+	for_array(i, t->events) {
+		TraceEvent e = t->events[i];
+		trace__fprint_event(&f, &first, e.name, e.detail, "scope",
+		                    e.start, e.finish, origin, freq, e.thread_id);
+	}
+	gb_mutex_unlock(&t->mutex);
+
+	gb_fprintf(&f, "\n]}\n");
+	return true;
+}
@@ -464,8 +464,11 @@ void set_base_type(Type *t, Type *base) {
 }
 
 
+gb_global isize global_type_count = 0;
+
 Type *alloc_type(gbAllocator a, TypeKind kind) {
 	Type *t = gb_alloc_item(a, Type);
+	global_type_count++;
 	gb_zero_item(t);
 	t->kind = kind;
 	return t;
@@ -823,6 +826,16 @@ bool is_type_vector(Type *t) {
 	t = base_type(t);
 	return t->kind == Type_Vector;
 }
+// NOTE: Vectors of integers and floats are native LLVM vectors `<N x T>`, the others (booleans and
+// complex numbers) are stored as arrays as LLVM packs `<N x i1>` into bits
+bool is_type_simd_vector(Type *t) {
+	t = base_type(t);
+	if (t->kind != Type_Vector) {
+		return false;
+	}
+	Type *elem = base_type(t->Vector.elem);
+	return is_type_integer(elem) || is_type_float(elem);
+}
 bool is_type_proc(Type *t) {
 	t = base_type(t);
 	return t->kind == Type_Proc;
@@ -1779,6 +1792,10 @@ i64 type_align_of_internal(gbAllocator allocator, Type *t, TypePath *path) {
 		}
 		i64 size = type_size_of_internal(allocator, t->Vector.elem, path);
 		type_path_pop(path);
+		if (is_type_simd_vector(t)) {
+			// NOTE: This must match LLVM, which aligns `<N x T>` to its size rounded up to a power of two
+			return gb_max(next_pow2(size * t->Vector.count), 1);
+		}
 		i64 count = gb_max(prev_pow2(t->Vector.count), 1);
 		i64 total = size * count;
 		return gb_clamp(total, 1, build_context.max_align);